@@ -40,11 +40,24 @@ define_overridable_option(ANJ_WITH_EXTRA_WARNINGS BOOL ON "Enable extra compilat
 define_overridable_option(ANJ_IN_MSG_BUFFER_SIZE STRING 1200 "Input message buffer size")
 define_overridable_option(ANJ_OUT_MSG_BUFFER_SIZE STRING 1200 "Output message buffer size")
 define_overridable_option(ANJ_OUT_PAYLOAD_BUFFER_SIZE STRING 1024 "Payload buffer size")
+define_overridable_option(ANJ_WITH_IN_PLACE_PAYLOAD BOOL OFF "Prepare outgoing payload directly in the output message buffer")
+
+# exchange configuration
+define_overridable_option(ANJ_EXCHANGE_NSTART STRING 1 "Max number of outstanding confirmable client requests")
+define_overridable_option(ANJ_WITH_ADAPTIVE_RTO BOOL OFF "Enable estimating retransmission timeout from measured round-trip times")
+
+# core configuration
+define_overridable_option(ANJ_WITH_CORE_POLL_INFO BOOL OFF "Enable reporting of awaited socket events and step deadlines")
+define_overridable_option(ANJ_WITH_RESPONSE_CACHE BOOL OFF "Enable answering retransmitted LwM2M Server requests with cached responses")
+define_overridable_option(ANJ_RESPONSE_CACHE_SIZE STRING 4 "Max number of cached responses")
+define_overridable_option(ANJ_RESPONSE_CACHE_MAX_MSG_SIZE STRING 64 "Max size of a cached response")
+define_overridable_option(ANJ_WITH_ADAPTIVE_BLOCK_SIZE BOOL OFF "Enable adjusting outgoing block size to packet losses and path MTU changes")
 
 # data model configuration
 define_overridable_option(ANJ_DM_MAX_OBJECTS_NUMBER STRING 10 "Max LwM2M Objects defined in data model")
 define_overridable_option(ANJ_WITH_COMPOSITE_OPERATIONS BOOL ON "Enable composite operations support")
 define_overridable_option(ANJ_DM_MAX_COMPOSITE_ENTRIES STRING 5 "Max entries (paths) in a composite operations")
+define_overridable_option(ANJ_DM_WITH_BINARY_SEARCH BOOL OFF "Use binary search for Object, Instance and Resource lookups")
 
 # device object configuration
 define_overridable_option(ANJ_WITH_DEFAULT_DEVICE_OBJ BOOL ON "Enable default implementation of Device Object")
@@ -86,14 +99,24 @@ define_overridable_option(ANJ_WITH_DISCOVER_ATTR BOOL ON "Enable Discover to rea
 # LwM2M Send
 define_overridable_option(ANJ_WITH_LWM2M_SEND BOOL ON "Enable LwM2M SEND operation support")
 define_overridable_option(ANJ_LWM2M_SEND_QUEUE_SIZE STRING 1 "Max LwM2M SEND messages queued number")
+define_overridable_option(ANJ_LWM2M_SEND_WITH_COALESCING BOOL OFF "Enable merging of queued LwM2M SEND requests into a single message")
+
+# offline store configuration
+define_overridable_option(ANJ_WITH_OFFLINE_STORE BOOL OFF "Enable storing of undelivered LwM2M SEND and Notify payloads")
+define_overridable_option(ANJ_OFFLINE_STORE_FLUSH_BATCH_SIZE STRING 4 "Max number of stored entries delivered in a single LwM2M SEND message")
 
 # compat layer configuration
 define_overridable_option(ANJ_WITH_TIME_POSIX_COMPAT BOOL ON "Enable POSIX-compliant integration of time API")
 define_overridable_option(ANJ_WITH_SOCKET_POSIX_COMPAT BOOL ON "Enable POSIX-compliant integration of socket API")
+define_overridable_option(ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT BOOL ON "Enable file based implementation of offline store API")
+define_overridable_option(ANJ_WITH_RNG_POSIX_COMPAT BOOL ON "Enable /dev/urandom based implementation of secure RNG API")
 define_overridable_option(ANJ_NET_WITH_IPV4 BOOL ON "Enable communication over IPv4")
 define_overridable_option(ANJ_NET_WITH_IPV6 BOOL OFF "Enable communication over IPv6")
 define_overridable_option(ANJ_NET_WITH_UDP BOOL ON "Enable communication over UDP")
 define_overridable_option(ANJ_NET_WITH_TCP BOOL OFF "Enable communication over TCP")
+define_overridable_option(ANJ_NET_WITH_BATCHED_IO BOOL OFF "Enable receiving and sending of multiple UDP datagrams in a single call")
+define_overridable_option(ANJ_NET_RECV_BATCH_SIZE STRING 4 "Max number of UDP datagrams received in a single call")
+define_overridable_option(ANJ_NET_WITH_SEND_IOV BOOL OFF "Send CoAP header and payload from separate buffers without copying the payload")
 
 # data formats configuration
 define_overridable_option(ANJ_WITH_CBOR BOOL ON "Enable CBOR format support")
@@ -105,7 +128,7 @@ define_overridable_option(ANJ_WITH_LWM2M_CBOR BOOL ON "Enable LwM2M CBOR format
 define_overridable_option(ANJ_WITH_SENML_CBOR BOOL ON "Enable SenML CBOR format support")
 define_overridable_option(ANJ_WITH_PLAINTEXT BOOL ON "Enable Plaintext format support")
 define_overridable_option(ANJ_WITH_OPAQUE BOOL ON "Enable Opaque format support")
-define_overridable_option(ANJ_WITH_TLV BOOL ON "Enable TLV format support (decoder only)")
+define_overridable_option(ANJ_WITH_TLV BOOL ON "Enable TLV format support")
 define_overridable_option(ANJ_WITH_EXTERNAL_DATA BOOL OFF "Enable External Data Type support")
 
 # CoAP related configuration
@@ -115,6 +138,9 @@ define_overridable_option(ANJ_COAP_MAX_OPTIONS_NUMBER STRING 15 "Max number of C
 define_overridable_option(ANJ_COAP_MAX_ATTR_OPTION_SIZE STRING 40 "Max Attribute-related CoAP option size")
 define_overridable_option(ANJ_COAP_MAX_LOCATION_PATHS_NUMBER STRING 2 "Max CoAP Location-Paths number in Registration Interface")
 define_overridable_option(ANJ_COAP_MAX_LOCATION_PATH_SIZE STRING 40 "Max size of a single CoAP Location-Path in Registration Interface")
+define_overridable_option(ANJ_COAP_WITH_QBLOCK BOOL OFF "Enable RFC 9177 Q-Block1 and Q-Block2 options in LwM2M Server requests")
+define_overridable_option(ANJ_COAP_QBLOCK_MAX_PAYLOADS STRING 10 "Number of Q-Block payloads sent or received before an acknowledgement")
+define_overridable_option(ANJ_COAP_WITH_SECURE_RNG BOOL OFF "Generate CoAP tokens with a cryptographically secure RNG provided by the compat layer")
 
 # logger configuration
 define_overridable_option(ANJ_LOG_FULL BOOL ON "Enable full logger: includes module, level, file, and line info")
@@ -131,6 +157,7 @@ define_overridable_option(ANJ_LOG_FILTERING_CONFIG_HEADER STRING "" "Path to hea
 # other configuration
 define_overridable_option(ANJ_WITH_LWM2M12 BOOL ON "Enable LwM2M protocol version 1.2 support")
 define_overridable_option(ANJ_WITH_CUSTOM_CONVERSION_FUNCTIONS BOOL ON "Enable custom string<->number conversion function")
+define_overridable_option(ANJ_WITH_EXACT_STRING_TO_DOUBLE BOOL OFF "Enable correctly rounded custom string to double conversion")
 define_overridable_option(ANJ_PLATFORM_BIG_ENDIAN BOOL OFF "Define platform endianess as big endian")
 
 set(repo_root "${CMAKE_CURRENT_LIST_DIR}/..")
@@ -0,0 +1,287 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <inttypes.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <sys/resource.h>
+
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/compat/time.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/device_object.h>
+#include <anj/dm/security_object.h>
+#include <anj/dm/server_object.h>
+#include <anj/log/log.h>
+
+#include "server_stub.h"
+
+#define log(...) anj_log(example_log, __VA_ARGS__)
+
+#define DEFAULT_CLIENTS_COUNT 100
+#define DEFAULT_DURATION_S 10
+#define REGISTRATION_TIMEOUT_MS 60000
+#define READ_RETRY_TIMEOUT_MS 2000
+// upper limit of poll() timeout, so that the main loop checks its own timers
+#define MAX_POLL_TIMEOUT_MS 100
+
+// Everything a single LwM2M Client needs: Anjay Lite object, the mandatory
+// Objects and the endpoint name that must outlive the Anjay Lite object.
+typedef struct {
+    anj_t anj;
+    anj_dm_device_obj_t device_obj;
+    anj_dm_server_obj_t server_obj;
+    anj_dm_security_obj_t security_obj;
+    char endpoint_name[32];
+    uint64_t next_step_time;
+} client_t;
+
+static size_t g_registered_clients;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000 + (uint64_t) ts.tv_nsec / 1000000;
+}
+
+static void connection_status_callback(void *arg,
+                                       anj_t *anj,
+                                       anj_conn_status_t conn_status) {
+    (void) anj;
+    bool *registered = (bool *) arg;
+    bool now_registered = conn_status == ANJ_CONN_STATUS_REGISTERED
+                          || conn_status == ANJ_CONN_STATUS_QUEUE_MODE
+                          || conn_status == ANJ_CONN_STATUS_ENTERING_QUEUE_MODE;
+    if (now_registered != *registered) {
+        *registered = now_registered;
+        if (now_registered) {
+            g_registered_clients++;
+        } else {
+            g_registered_clients--;
+        }
+    }
+}
+
+static int install_device_obj(anj_t *anj, anj_dm_device_obj_t *device_obj) {
+    anj_dm_device_object_init_t device_obj_conf = {
+        .firmware_version = "0.1"
+    };
+    return anj_dm_device_obj_install(anj, device_obj, &device_obj_conf);
+}
+
+static int install_server_obj(anj_t *anj, anj_dm_server_obj_t *server_obj) {
+    anj_dm_server_instance_init_t server_inst = {
+        .ssid = 1,
+        .lifetime = 300,
+        .binding = "U",
+        .bootstrap_on_registration_failure = &(bool) { false },
+    };
+    anj_dm_server_obj_init(server_obj);
+    if (anj_dm_server_obj_add_instance(server_obj, &server_inst)
+            || anj_dm_server_obj_install(anj, server_obj)) {
+        return -1;
+    }
+    return 0;
+}
+
+static int install_security_obj(anj_t *anj,
+                                anj_dm_security_obj_t *security_obj,
+                                const char *server_uri) {
+    anj_dm_security_instance_init_t security_inst = {
+        .ssid = 1,
+        .server_uri = server_uri,
+        .security_mode = ANJ_DM_SECURITY_NOSEC
+    };
+    anj_dm_security_obj_init(security_obj);
+    if (anj_dm_security_obj_add_instance(security_obj, &security_inst)
+            || anj_dm_security_obj_install(anj, security_obj)) {
+        return -1;
+    }
+    return 0;
+}
+
+static int client_init(client_t *client,
+                       size_t index,
+                       bool *registered,
+                       const char *server_uri) {
+    snprintf(client->endpoint_name, sizeof(client->endpoint_name),
+             "anjay-lite-%zu", index);
+    anj_configuration_t config = {
+        .endpoint_name = client->endpoint_name,
+        .connection_status_cb = connection_status_callback,
+        .connection_status_cb_arg = registered
+    };
+    if (anj_core_init(&client->anj, &config)
+            || install_device_obj(&client->anj, &client->device_obj)
+            || install_security_obj(&client->anj, &client->security_obj,
+                                    server_uri)
+            || install_server_obj(&client->anj, &client->server_obj)) {
+        return -1;
+    }
+    return 0;
+}
+
+// Every client has its own socket, so the default limit of open descriptors is
+// usually too low for thousands of clients.
+static void raise_open_files_limit(size_t clients_count) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit)) {
+        return;
+    }
+    rlim_t needed = (rlim_t) clients_count + 64;
+    if (limit.rlim_cur < needed) {
+        limit.rlim_cur =
+                limit.rlim_max == RLIM_INFINITY || limit.rlim_max > needed
+                        ? needed
+                        : limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// Fills pollfd structures of all clients; returns poll() timeout for the
+// earliest of the client deadlines.
+static int prepare_poll(client_t *clients,
+                        struct pollfd *fds,
+                        size_t clients_count,
+                        uint64_t now) {
+    uint64_t earliest = now + MAX_POLL_TIMEOUT_MS;
+    for (size_t i = 0; i < clients_count; i++) {
+        anj_core_poll_info_t info;
+        anj_core_poll_info(&clients[i].anj, &info);
+        fds[i].fd = info.system_socket ? *(const int *) info.system_socket : -1;
+        fds[i].events = (short) (((info.events & ANJ_CORE_POLL_IN) ? POLLIN : 0)
+                                 | ((info.events & ANJ_CORE_POLL_OUT) ? POLLOUT
+                                                                      : 0));
+        fds[i].revents = 0;
+        clients[i].next_step_time = info.timeout_ms == ANJ_TIME_UNDEFINED
+                                            ? UINT64_MAX
+                                            : now + info.timeout_ms;
+        if (clients[i].next_step_time < earliest) {
+            earliest = clients[i].next_step_time;
+        }
+    }
+    return (int) (earliest - now);
+}
+
+int main(int argc, char *argv[]) {
+    size_t clients_count =
+            argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : DEFAULT_CLIENTS_COUNT;
+    uint64_t duration_ms =
+            (argc > 2 ? strtoull(argv[2], NULL, 10) : DEFAULT_DURATION_S) * 1000;
+    if (!clients_count) {
+        log(L_ERROR, "Usage: %s [clients count] [duration in seconds]", argv[0]);
+        return -1;
+    }
+    raise_open_files_limit(clients_count);
+
+    server_stub_t stub;
+    if (server_stub_init(&stub, clients_count)) {
+        log(L_ERROR, "Failed to start LwM2M Server stand-in");
+        return -1;
+    }
+    char server_uri[32];
+    snprintf(server_uri, sizeof(server_uri), "coap://127.0.0.1:%u",
+             (unsigned) stub.port);
+
+    client_t *clients = (client_t *) calloc(clients_count, sizeof(*clients));
+    bool *registered = (bool *) calloc(clients_count, sizeof(*registered));
+    // the last entry is used by the server stand-in
+    struct pollfd *fds =
+            (struct pollfd *) calloc(clients_count + 1, sizeof(*fds));
+    if (!clients || !registered || !fds) {
+        log(L_ERROR, "Out of memory");
+        return -1;
+    }
+    for (size_t i = 0; i < clients_count; i++) {
+        if (client_init(&clients[i], i, &registered[i], server_uri)) {
+            log(L_ERROR, "Failed to initialize client %zu", i);
+            return -1;
+        }
+    }
+
+    printf("Clients:            %zu\n", clients_count);
+    printf("Per-client memory:  %zu B (anj_t %zu B, Device Object %zu B, "
+           "Server Object %zu B, Security Object %zu B)\n",
+           sizeof(client_t), sizeof(anj_t), sizeof(anj_dm_device_obj_t),
+           sizeof(anj_dm_server_obj_t), sizeof(anj_dm_security_obj_t));
+    printf("Total memory:       %zu kB\n",
+           clients_count * sizeof(client_t) / 1024);
+
+    uint64_t start_time = now_ms();
+    uint64_t measurement_start = 0;
+    uint64_t last_retry_check = start_time;
+    while (true) {
+        uint64_t now = now_ms();
+        if (!measurement_start) {
+            if (g_registered_clients == clients_count) {
+                printf("Registration time:  %" PRIu64 " ms\n", now - start_time);
+                measurement_start = now;
+                stub.messages = 0;
+                stub.reads_completed = 0;
+                server_stub_start_reads(&stub, now);
+            } else if (now - start_time > REGISTRATION_TIMEOUT_MS) {
+                log(L_ERROR, "Only %zu of %zu clients registered",
+                    g_registered_clients, clients_count);
+                break;
+            }
+        } else if (now - measurement_start >= duration_ms) {
+            break;
+        }
+        if (now - last_retry_check >= READ_RETRY_TIMEOUT_MS) {
+            server_stub_retry_stalled(&stub, now, READ_RETRY_TIMEOUT_MS);
+            last_retry_check = now;
+        }
+
+        int timeout = prepare_poll(clients, fds, clients_count, now);
+        fds[clients_count] = (struct pollfd) {
+            .fd = stub.sockfd,
+            .events = POLLIN
+        };
+        poll(fds, (nfds_t) clients_count + 1, timeout);
+
+        now = now_ms();
+        if (fds[clients_count].revents) {
+            server_stub_process(&stub, now);
+        }
+        for (size_t i = 0; i < clients_count; i++) {
+            if (fds[i].revents || fds[i].fd < 0
+                    || clients[i].next_step_time <= now) {
+                anj_core_step(&clients[i].anj);
+            }
+        }
+    }
+
+    if (measurement_start) {
+        uint64_t elapsed = now_ms() - measurement_start;
+        printf("Measurement time:   %" PRIu64 " ms\n", elapsed);
+        printf("Messages:           %" PRIu64 " (%.0f msg/s)\n", stub.messages,
+               (double) stub.messages * 1000.0 / (double) elapsed);
+        printf("Completed Reads:    %" PRIu64 " (%.0f req/s)\n",
+               stub.reads_completed,
+               (double) stub.reads_completed * 1000.0 / (double) elapsed);
+    }
+
+    for (size_t i = 0; i < clients_count; i++) {
+        while (anj_core_shutdown(&clients[i].anj) == ANJ_NET_EAGAIN) {
+        }
+    }
+    server_stub_cleanup(&stub);
+    free(fds);
+    free(registered);
+    free(clients);
+    return measurement_start ? 0 : -1;
+}
@@ -0,0 +1,302 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "server_stub.h"
+
+#define COAP_TYPE_CON 0
+#define COAP_TYPE_NON 1
+#define COAP_TYPE_ACK 2
+
+#define COAP_CODE_GET 0x01
+#define COAP_CODE_POST 0x02
+#define COAP_CODE_DELETE 0x04
+#define COAP_CODE_CREATED 0x41
+#define COAP_CODE_DELETED 0x42
+#define COAP_CODE_CHANGED 0x44
+#define COAP_CODE_METHOD_NOT_ALLOWED 0x85
+
+#define COAP_OPTION_LOCATION_PATH 8
+#define COAP_OPTION_URI_PATH 11
+
+#define MAX_DATAGRAM_SIZE 1500
+
+struct server_stub_peer {
+    struct sockaddr_in addr;
+    bool registered;
+    bool read_outstanding;
+    uint16_t read_msg_id;
+    uint64_t read_sent_ms;
+};
+
+static void send_datagram(server_stub_t *stub,
+                          struct server_stub_peer *peer,
+                          const uint8_t *buff,
+                          size_t len) {
+    if (sendto(stub->sockfd, buff, len, 0, (const struct sockaddr *) &peer->addr,
+               sizeof(peer->addr))
+            == (ssize_t) len) {
+        stub->messages++;
+    }
+}
+
+// Sends Read request on /3/0/3 (Firmware Version), the resource is present in
+// every client, so each request is answered with a short payload.
+static void send_read(server_stub_t *stub,
+                      struct server_stub_peer *peer,
+                      uint64_t now_ms) {
+    uint16_t msg_id = stub->next_msg_id++;
+    uint8_t msg[] = {
+        0x40 | (COAP_TYPE_CON << 4) | 2, COAP_CODE_GET,
+        (uint8_t) (msg_id >> 8),         (uint8_t) msg_id,
+        (uint8_t) (msg_id >> 8),         (uint8_t) msg_id,
+        (COAP_OPTION_URI_PATH << 4) | 1, '3',
+        0x01,                            '0',
+        0x01,                            '3'
+    };
+    peer->read_outstanding = true;
+    peer->read_msg_id = msg_id;
+    peer->read_sent_ms = now_ms;
+    send_datagram(stub, peer, msg, sizeof(msg));
+}
+
+// Returns the number of Uri-Path options, or -1 if the message is malformed.
+static int count_uri_path_options(const uint8_t *options, size_t len) {
+    int count = 0;
+    uint32_t number = 0;
+    size_t pos = 0;
+    while (pos < len && options[pos] != 0xFF) {
+        uint32_t delta = options[pos] >> 4;
+        uint32_t length = options[pos] & 0x0F;
+        pos++;
+        uint32_t *fields[] = { &delta, &length };
+        for (size_t i = 0; i < 2; i++) {
+            if (*fields[i] == 13) {
+                if (pos + 1 > len) {
+                    return -1;
+                }
+                *fields[i] = 13U + options[pos];
+                pos += 1;
+            } else if (*fields[i] == 14) {
+                if (pos + 2 > len) {
+                    return -1;
+                }
+                *fields[i] =
+                        269U + (uint32_t) ((options[pos] << 8) | options[pos + 1]);
+                pos += 2;
+            } else if (*fields[i] == 15) {
+                return -1;
+            }
+        }
+        number += delta;
+        if (number == COAP_OPTION_URI_PATH) {
+            count++;
+        }
+        pos += length;
+    }
+    return pos <= len ? count : -1;
+}
+
+static struct server_stub_peer *get_peer(server_stub_t *stub,
+                                         const struct sockaddr_in *addr,
+                                         bool create) {
+    uint16_t port = ntohs(addr->sin_port);
+    if (stub->peer_by_port[port]) {
+        return &stub->peers[stub->peer_by_port[port] - 1];
+    }
+    if (!create || stub->peers_count == stub->max_peers) {
+        return NULL;
+    }
+    struct server_stub_peer *peer = &stub->peers[stub->peers_count++];
+    memset(peer, 0, sizeof(*peer));
+    peer->addr = *addr;
+    stub->peer_by_port[port] = (uint32_t) stub->peers_count;
+    return peer;
+}
+
+static void handle_request(server_stub_t *stub,
+                           const struct sockaddr_in *addr,
+                           const uint8_t *msg,
+                           size_t len,
+                           uint64_t now_ms) {
+    uint8_t type = (msg[0] >> 4) & 0x03;
+    uint8_t tkl = msg[0] & 0x0F;
+    int uri_path_count = count_uri_path_options(&msg[4 + tkl], len - 4 - tkl);
+    if (uri_path_count < 0) {
+        return;
+    }
+    bool is_register = msg[1] == COAP_CODE_POST && uri_path_count == 1;
+    struct server_stub_peer *peer = get_peer(stub, addr, is_register);
+    if (!peer) {
+        return;
+    }
+
+    uint8_t response[4 + 8 + 16];
+    size_t response_len = 4 + tkl;
+    memcpy(response, msg, response_len);
+    if (type == COAP_TYPE_CON) {
+        response[0] = (uint8_t) (0x40 | (COAP_TYPE_ACK << 4) | tkl);
+    } else {
+        uint16_t msg_id = stub->next_msg_id++;
+        response[0] = (uint8_t) (0x40 | (COAP_TYPE_NON << 4) | tkl);
+        response[2] = (uint8_t) (msg_id >> 8);
+        response[3] = (uint8_t) msg_id;
+    }
+
+    if (is_register) {
+        // Location-Path: /rd/<peer index>
+        char id[12];
+        int id_len =
+                snprintf(id, sizeof(id), "%u", (unsigned) (peer - stub->peers));
+        response[1] = COAP_CODE_CREATED;
+        response[response_len++] = (COAP_OPTION_LOCATION_PATH << 4) | 2;
+        response[response_len++] = 'r';
+        response[response_len++] = 'd';
+        response[response_len++] = (uint8_t) id_len;
+        memcpy(&response[response_len], id, (size_t) id_len);
+        response_len += (size_t) id_len;
+    } else if (msg[1] == COAP_CODE_POST) {
+        response[1] = COAP_CODE_CHANGED;
+    } else if (msg[1] == COAP_CODE_DELETE) {
+        response[1] = COAP_CODE_DELETED;
+    } else {
+        response[1] = COAP_CODE_METHOD_NOT_ALLOWED;
+    }
+    send_datagram(stub, peer, response, response_len);
+
+    if (is_register) {
+        peer->registered = true;
+        if (stub->reads_started) {
+            send_read(stub, peer, now_ms);
+        }
+    } else if (msg[1] == COAP_CODE_DELETE) {
+        peer->registered = false;
+        peer->read_outstanding = false;
+    }
+}
+
+static void handle_response(server_stub_t *stub,
+                            const struct sockaddr_in *addr,
+                            const uint8_t *msg,
+                            uint64_t now_ms) {
+    struct server_stub_peer *peer = get_peer(stub, addr, false);
+    uint16_t msg_id = (uint16_t) ((msg[2] << 8) | msg[3]);
+    if (!peer || !peer->read_outstanding || peer->read_msg_id != msg_id) {
+        return;
+    }
+    peer->read_outstanding = false;
+    stub->reads_completed++;
+    if (peer->registered) {
+        send_read(stub, peer, now_ms);
+    }
+}
+
+int server_stub_init(server_stub_t *stub, size_t max_peers) {
+    memset(stub, 0, sizeof(*stub));
+    stub->sockfd = -1;
+    stub->max_peers = max_peers;
+    stub->peers = (struct server_stub_peer *) calloc(max_peers,
+                                                     sizeof(*stub->peers));
+    stub->peer_by_port =
+            (uint32_t *) calloc(UINT16_MAX + 1, sizeof(*stub->peer_by_port));
+    if (!stub->peers || !stub->peer_by_port) {
+        server_stub_cleanup(stub);
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    int rcvbuf = 4 * 1024 * 1024;
+    stub->sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (stub->sockfd < 0
+            || setsockopt(stub->sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+                          sizeof(rcvbuf))
+            || bind(stub->sockfd, (struct sockaddr *) &addr, sizeof(addr))
+            || getsockname(stub->sockfd, (struct sockaddr *) &addr, &addr_len)
+            || fcntl(stub->sockfd, F_SETFL, O_NONBLOCK)) {
+        server_stub_cleanup(stub);
+        return -1;
+    }
+    stub->port = ntohs(addr.sin_port);
+    return 0;
+}
+
+void server_stub_cleanup(server_stub_t *stub) {
+    if (stub->sockfd >= 0) {
+        close(stub->sockfd);
+        stub->sockfd = -1;
+    }
+    free(stub->peers);
+    stub->peers = NULL;
+    free(stub->peer_by_port);
+    stub->peer_by_port = NULL;
+}
+
+void server_stub_process(server_stub_t *stub, uint64_t now_ms) {
+    uint8_t msg[MAX_DATAGRAM_SIZE];
+    while (true) {
+        struct sockaddr_in addr;
+        socklen_t addr_len = sizeof(addr);
+        ssize_t len = recvfrom(stub->sockfd, msg, sizeof(msg), 0,
+                               (struct sockaddr *) &addr, &addr_len);
+        if (len < 0) {
+            return;
+        }
+        stub->messages++;
+        // CoAP header is 4 bytes long, version must be 1, token up to 8 bytes
+        if (len < 4 || (msg[0] >> 6) != 1 || (msg[0] & 0x0F) > 8
+                || (size_t) len < 4U + (msg[0] & 0x0F)) {
+            continue;
+        }
+        uint8_t type = (msg[0] >> 4) & 0x03;
+        uint8_t code_class = msg[1] >> 5;
+        if (type == COAP_TYPE_ACK) {
+            handle_response(stub, &addr, msg, now_ms);
+        } else if (code_class == 0 && msg[1] != 0) {
+            handle_request(stub, &addr, msg, (size_t) len, now_ms);
+        }
+    }
+}
+
+void server_stub_start_reads(server_stub_t *stub, uint64_t now_ms) {
+    stub->reads_started = true;
+    for (size_t i = 0; i < stub->peers_count; i++) {
+        if (stub->peers[i].registered) {
+            send_read(stub, &stub->peers[i], now_ms);
+        }
+    }
+}
+
+void server_stub_retry_stalled(server_stub_t *stub,
+                               uint64_t now_ms,
+                               uint64_t timeout_ms) {
+    for (size_t i = 0; i < stub->peers_count; i++) {
+        struct server_stub_peer *peer = &stub->peers[i];
+        if (peer->registered && peer->read_outstanding
+                && now_ms - peer->read_sent_ms > timeout_ms) {
+            send_read(stub, peer, now_ms);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef SERVER_STUB_H
+#define SERVER_STUB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Minimal LwM2M Server stand-in, listening on a local UDP port. It accepts
+ * Register, Update and De-register requests of any number of clients. Once
+ * @ref server_stub_start_reads is called, it keeps every registered client busy
+ * with Read requests: the next request is sent as soon as the previous one is
+ * answered.
+ */
+typedef struct {
+    int sockfd;
+    uint16_t port;
+    size_t max_peers;
+    size_t peers_count;
+    struct server_stub_peer *peers;
+    // peer index + 1 for every local UDP port, 0 if the port is unknown
+    uint32_t *peer_by_port;
+    uint16_t next_msg_id;
+    bool reads_started;
+    uint64_t messages;
+    uint64_t reads_completed;
+} server_stub_t;
+
+int server_stub_init(server_stub_t *stub, size_t max_peers);
+
+void server_stub_cleanup(server_stub_t *stub);
+
+// Handles all datagrams waiting in the socket.
+void server_stub_process(server_stub_t *stub, uint64_t now_ms);
+
+// Sends the first Read request to every registered peer.
+void server_stub_start_reads(server_stub_t *stub, uint64_t now_ms);
+
+// Sends a new Read request to every registered peer that did not respond to the
+// previous one within timeout_ms.
+void server_stub_retry_stalled(server_stub_t *stub,
+                               uint64_t now_ms,
+                               uint64_t timeout_ms);
+
+#endif // SERVER_STUB_H
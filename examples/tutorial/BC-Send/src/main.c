@@ -187,9 +187,14 @@ int main(int argc, char *argv[]) {
                 .records = records
             };
 
-            if (anj_send_new_request(&anj, &send_req, &send_id)) {
+            int res = anj_send_new_request(&anj, &send_req, &send_id);
+            if (res < 0) {
                 log(L_ERROR, "Failed to request new send");
                 data.send_in_progress = false;
+            } else if (res > 0) {
+                /* Records already put in the offline store, the handler won't
+                 * be called */
+                send_finished_handler(&anj, send_id, res, &data);
             }
         }
     }
@@ -515,6 +515,131 @@ typedef int anj_net_recv_t(anj_net_ctx_t *ctx,
                            uint8_t *buf,
                            size_t length);
 
+#ifdef ANJ_NET_WITH_BATCHED_IO
+/**
+ * Single datagram used with @ref anj_net_recv_batch_t and
+ * @ref anj_net_send_batch_t.
+ */
+typedef struct {
+    /**
+     * Message buffer. Not modified by @ref anj_net_send_batch_t.
+     */
+    uint8_t *buf;
+
+    /**
+     * Size of the buffer when receiving, length of the message when sending.
+     */
+    size_t length;
+
+    /**
+     * Set by @ref anj_net_recv_batch_t to the number of bytes received.
+     */
+    size_t bytes_received;
+
+    /**
+     * Set by @ref anj_net_recv_batch_t if the datagram did not fit in the
+     * buffer. Such datagram should be dropped.
+     */
+    bool truncated;
+} anj_net_datagram_t;
+
+/**
+ * Receives up to @p count datagrams from the specified connection context
+ * with as few system calls as possible, preferably one.
+ *
+ * Only datagram-oriented bindings are expected to implement this function,
+ * others may return @ref ANJ_NET_ENOTSUP, in which case Anjay falls back to
+ * @ref anj_net_recv_t.
+ *
+ * NOTE: This function does not block.
+ *
+ * @param      ctx        Pointer to a socket context.
+ * @param[in,out] datagrams  Array of @p count datagrams, @c buf and @c length
+ *                        fields must be set by the caller.
+ * @param      count      Number of elements in @p datagrams.
+ * @param[out] out_count  Number of datagrams received, these are the first
+ *                        elements of @p datagrams.
+ *
+ * @returns @ref ANJ_NET_OK if at least one datagram was received,
+ *          @ref ANJ_NET_EAGAIN if no data was received and the operation would
+ *          block, @ref ANJ_NET_ENOTSUP if not implemented, other negative
+ *          value in case of other errors.
+ */
+typedef int anj_net_recv_batch_t(anj_net_ctx_t *ctx,
+                                 anj_net_datagram_t *datagrams,
+                                 size_t count,
+                                 size_t *out_count);
+
+/**
+ * Sends @p count datagrams, in order, through the given connection context
+ * with as few system calls as possible, preferably one.
+ *
+ * If the underlying operation would block after some datagrams have been
+ * sent, the function returns @ref ANJ_NET_OK and @p out_count indicates how
+ * many of them were sent. The caller may retry with the remaining ones.
+ *
+ * NOTE: This function does not block.
+ *
+ * @param      ctx        Pointer to a socket context.
+ * @param      datagrams  Array of @p count datagrams to send.
+ * @param      count      Number of elements in @p datagrams.
+ * @param[out] out_count  Number of datagrams sent.
+ *
+ * @returns @ref ANJ_NET_OK if at least one datagram was sent,
+ *          @ref ANJ_NET_EAGAIN if nothing was sent and the operation would
+ *          block, @ref ANJ_NET_ENOTSUP if not implemented, other negative
+ *          value in case of other errors.
+ */
+typedef int anj_net_send_batch_t(anj_net_ctx_t *ctx,
+                                 const anj_net_datagram_t *datagrams,
+                                 size_t count,
+                                 size_t *out_count);
+#endif // ANJ_NET_WITH_BATCHED_IO
+
+#ifdef ANJ_NET_WITH_SEND_IOV
+/**
+ * Single part of a message sent with @ref anj_net_send_iov_t.
+ */
+typedef struct {
+    /**
+     * Pointer to the data. Not modified by @ref anj_net_send_iov_t.
+     */
+    const uint8_t *buf;
+
+    /**
+     * Length of the data.
+     */
+    size_t length;
+} anj_net_iovec_t;
+
+/**
+ * Sends a single message, gathered from @p iov_count buffers, through the given
+ * connection context. For datagram-oriented bindings all parts are sent as a
+ * single datagram.
+ *
+ * Partial send is handled just like in @ref anj_net_send_t: @p bytes_sent
+ * indicates the total amount of data transmitted, counted from the beginning of
+ * the first buffer, and the caller should retry the operation with the
+ * remaining data.
+ *
+ * NOTE: This function does not block.
+ *
+ * @param ctx         Pointer to a socket context.
+ * @param bytes_sent  Output parameter indicating the number of bytes sent.
+ * @param iov         Array of @p iov_count buffers to send, in order.
+ * @param iov_count   Number of elements in @p iov.
+ *
+ * @returns ANJ_NET_OK if all data was sent or partial data was sent
+ * successfully, @ref ANJ_NET_EAGAIN if no data was sent and the operation would
+ * block, @ref ANJ_NET_ENOTSUP if not implemented. A negative value in case of
+ * an error.
+ */
+typedef int anj_net_send_iov_t(anj_net_ctx_t *ctx,
+                               size_t *bytes_sent,
+                               const anj_net_iovec_t *iov,
+                               size_t iov_count);
+#endif // ANJ_NET_WITH_SEND_IOV
+
 /**
  * Binds a socket associated with @p ctx the to the previous port number used by
  * this context. If bind operation is not supported the function return
@@ -195,6 +195,58 @@ static inline int anj_net_recv(anj_net_binding_type_t type,
     }
 }
 
+#ifdef ANJ_NET_WITH_BATCHED_IO
+// Wrapper for recv_batch, only UDP binding provides batched I/O
+static inline int anj_net_recv_batch(anj_net_binding_type_t type,
+                                     anj_net_ctx_t *ctx,
+                                     anj_net_datagram_t *datagrams,
+                                     size_t count,
+                                     size_t *out_count) {
+    switch (type) {
+    case ANJ_NET_BINDING_UDP:
+        return anj_udp_recv_batch(ctx, datagrams, count, out_count);
+    default:
+        return ANJ_NET_ENOTSUP;
+    }
+}
+
+// Wrapper for send_batch, only UDP binding provides batched I/O
+static inline int anj_net_send_batch(anj_net_binding_type_t type,
+                                     anj_net_ctx_t *ctx,
+                                     const anj_net_datagram_t *datagrams,
+                                     size_t count,
+                                     size_t *out_count) {
+    switch (type) {
+    case ANJ_NET_BINDING_UDP:
+        return anj_udp_send_batch(ctx, datagrams, count, out_count);
+    default:
+        return ANJ_NET_ENOTSUP;
+    }
+}
+#endif // ANJ_NET_WITH_BATCHED_IO
+
+#ifdef ANJ_NET_WITH_SEND_IOV
+// Wrapper for send_iov, provided by UDP and TCP bindings
+static inline int anj_net_send_iov(anj_net_binding_type_t type,
+                                   anj_net_ctx_t *ctx,
+                                   size_t *bytes_sent,
+                                   const anj_net_iovec_t *iov,
+                                   size_t iov_count) {
+    switch (type) {
+#    if defined(ANJ_NET_WITH_UDP)
+    case ANJ_NET_BINDING_UDP:
+        return anj_udp_send_iov(ctx, bytes_sent, iov, iov_count);
+#    endif // defined(ANJ_NET_WITH_UDP)
+#    if defined(ANJ_NET_WITH_TCP)
+    case ANJ_NET_BINDING_TCP:
+        return anj_tcp_send_iov(ctx, bytes_sent, iov, iov_count);
+#    endif // defined(ANJ_NET_WITH_TCP)
+    default:
+        return ANJ_NET_ENOTSUP;
+    }
+}
+#endif // ANJ_NET_WITH_SEND_IOV
+
 // Wrapper for close
 static inline int anj_net_close(anj_net_binding_type_t type,
                                 anj_net_ctx_t *ctx) {
@@ -26,6 +26,9 @@ anj_net_connect_t anj_tcp_connect;
 anj_net_create_ctx_t anj_tcp_create_ctx;
 anj_net_send_t anj_tcp_send;
 anj_net_recv_t anj_tcp_recv;
+#    ifdef ANJ_NET_WITH_SEND_IOV
+anj_net_send_iov_t anj_tcp_send_iov;
+#    endif // ANJ_NET_WITH_SEND_IOV
 anj_net_shutdown_t anj_tcp_shutdown;
 anj_net_cleanup_ctx_t anj_tcp_cleanup_ctx;
 anj_net_reuse_last_port_t anj_tcp_reuse_last_port;
@@ -26,6 +26,13 @@ anj_net_connect_t anj_udp_connect;
 anj_net_create_ctx_t anj_udp_create_ctx;
 anj_net_send_t anj_udp_send;
 anj_net_recv_t anj_udp_recv;
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+anj_net_recv_batch_t anj_udp_recv_batch;
+anj_net_send_batch_t anj_udp_send_batch;
+#    endif // ANJ_NET_WITH_BATCHED_IO
+#    ifdef ANJ_NET_WITH_SEND_IOV
+anj_net_send_iov_t anj_udp_send_iov;
+#    endif // ANJ_NET_WITH_SEND_IOV
 anj_net_shutdown_t anj_udp_shutdown;
 anj_net_cleanup_ctx_t anj_udp_cleanup_ctx;
 anj_net_reuse_last_port_t anj_udp_reuse_last_port;
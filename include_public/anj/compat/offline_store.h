@@ -0,0 +1,187 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef ANJ_OFFLINE_STORE_H
+#define ANJ_OFFLINE_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <anj/anj_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ANJ_WITH_OFFLINE_STORE
+
+/**
+ * Returned by @ref anj_offline_store_get_entry_t if there is no entry with
+ * given index.
+ */
+#    define ANJ_OFFLINE_STORE_NO_ENTRY 1
+
+/**
+ * Starts a new entry. The entry is built with subsequent calls to
+ * @ref anj_offline_store_append_t and becomes visible only after
+ * @ref anj_offline_store_end_t is called with @p commit set to true.
+ *
+ * @param arg             Opaque argument from @ref anj_offline_store_t.
+ * @param content_format  CoAP Content-Format of the entry payload.
+ *
+ * @return 0 on success, a positive number of the oldest entries dropped to make
+ *         room for the new one, a negative value in case of an error.
+ */
+typedef int anj_offline_store_begin_t(void *arg, uint16_t content_format);
+
+/**
+ * Appends a chunk of payload to the entry started with
+ * @ref anj_offline_store_begin_t. If there is not enough space, the oldest
+ * entries should be dropped to make room for the new one.
+ *
+ * Dropped entries must be reported, as the oldest entries might be in the
+ * middle of delivery to the LwM2M Server, and would be removed again with
+ * @ref anj_offline_store_drop_t once the delivery is finished.
+ *
+ * @param arg     Opaque argument from @ref anj_offline_store_t.
+ * @param data    Payload chunk.
+ * @param length  Length of the chunk.
+ *
+ * @return 0 on success, a positive number of the oldest entries dropped to make
+ *         room for the chunk, a negative value in case of an error, e.g. if the
+ *         entry is larger than the whole store.
+ */
+typedef int
+anj_offline_store_append_t(void *arg, const uint8_t *data, size_t length);
+
+/**
+ * Finishes the entry started with @ref anj_offline_store_begin_t.
+ *
+ * @param arg     Opaque argument from @ref anj_offline_store_t.
+ * @param commit  If true, the entry is stored as the newest one, otherwise it
+ *                is discarded.
+ *
+ * @return 0 on success, a negative value in case of an error.
+ */
+typedef int anj_offline_store_end_t(void *arg, bool commit);
+
+/**
+ * Gets information about a stored entry.
+ *
+ * @param      arg                 Opaque argument from @ref
+ *                                 anj_offline_store_t.
+ * @param      index               Index of the entry, 0 is the oldest one.
+ * @param[out] out_content_format  CoAP Content-Format of the entry payload.
+ * @param[out] out_length          Length of the entry payload.
+ *
+ * @return 0 on success, @ref ANJ_OFFLINE_STORE_NO_ENTRY if there are less than
+ *         @p index + 1 entries, a negative value in case of an error.
+ */
+typedef int anj_offline_store_get_entry_t(void *arg,
+                                          size_t index,
+                                          uint16_t *out_content_format,
+                                          size_t *out_length);
+
+/**
+ * Reads a part of the payload of a stored entry.
+ *
+ * @param      arg     Opaque argument from @ref anj_offline_store_t.
+ * @param      index   Index of the entry, 0 is the oldest one.
+ * @param      offset  Offset within the entry payload.
+ * @param[out] buff    Buffer for the payload.
+ * @param      length  Number of bytes to read, never exceeds the remaining
+ *                     length of the entry.
+ *
+ * @return 0 on success, a negative value in case of an error.
+ */
+typedef int anj_offline_store_read_t(
+        void *arg, size_t index, size_t offset, uint8_t *buff, size_t length);
+
+/**
+ * Removes the oldest entries.
+ *
+ * @param arg    Opaque argument from @ref anj_offline_store_t.
+ * @param count  Number of entries to remove.
+ *
+ * @return 0 on success, a negative value in case of an error.
+ */
+typedef int anj_offline_store_drop_t(void *arg, size_t count);
+
+/**
+ * Persistent FIFO storage for LwM2M Send and Notify payloads that could not be
+ * delivered to the LwM2M Server. Entries are delivered in order once the client
+ * is registered again.
+ *
+ * All handlers are mandatory. Only one entry is built at a time.
+ */
+typedef struct {
+    anj_offline_store_begin_t *begin;
+    anj_offline_store_append_t *append;
+    anj_offline_store_end_t *end;
+    anj_offline_store_get_entry_t *get_entry;
+    anj_offline_store_read_t *read;
+    anj_offline_store_drop_t *drop;
+    /** Opaque argument passed to all handlers. */
+    void *arg;
+} anj_offline_store_t;
+
+#    ifdef ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT
+/**
+ * File backed ring buffer implementation of @ref anj_offline_store_t. All
+ * fields are private.
+ */
+typedef struct {
+    void *file;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t used;
+    uint32_t count;
+    bool entry_in_progress;
+    uint32_t entry_start;
+    uint32_t entry_length;
+    uint16_t entry_format;
+} anj_offline_store_file_t;
+
+/**
+ * Opens the file backed store. If the file already contains a store with the
+ * same capacity, its entries are preserved, so data survives a reboot.
+ * Otherwise, the file is (re)initialized. When the store is full, the oldest
+ * entries are overwritten.
+ *
+ * @param[out] ctx       Store context, must remain valid as long as the store
+ *                       is used.
+ * @param      path      Path to the file.
+ * @param      capacity  Space available for the entries, including 6 bytes of
+ *                       per-entry overhead.
+ * @param[out] out_store Filled with handlers operating on @p ctx.
+ *
+ * @return 0 on success, a negative value in case of an error.
+ */
+int anj_offline_store_file_open(anj_offline_store_file_t *ctx,
+                                const char *path,
+                                size_t capacity,
+                                anj_offline_store_t *out_store);
+
+/**
+ * Closes the file opened with @ref anj_offline_store_file_open. Stored entries
+ * are kept in the file.
+ *
+ * @param ctx  Store context.
+ */
+void anj_offline_store_file_close(anj_offline_store_file_t *ctx);
+#    endif // ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT
+
+#endif // ANJ_WITH_OFFLINE_STORE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANJ_OFFLINE_STORE_H
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef ANJ_RNG_H
+#define ANJ_RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <anj/anj_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ANJ_COAP_WITH_SECURE_RNG
+
+/**
+ * Fills @p buffer with random bytes from a cryptographically secure random
+ * number generator. Used to generate CoAP tokens if
+ * @ref ANJ_COAP_WITH_SECURE_RNG is enabled.
+ *
+ * Default implementation is provided if @ref ANJ_WITH_RNG_POSIX_COMPAT is
+ * enabled.
+ *
+ * @param[out] buffer  Buffer to fill.
+ * @param      size    Number of bytes to generate.
+ *
+ * @return 0 on success, a non-zero value if random data could not be obtained.
+ */
+int anj_rng_generate(uint8_t *buffer, size_t size);
+
+#endif // ANJ_COAP_WITH_SECURE_RNG
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANJ_RNG_H
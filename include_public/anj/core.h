@@ -29,6 +29,10 @@
 #    include <anj/lwm2m_send.h>
 #endif // ANJ_WITH_LWM2M_SEND
 
+#ifdef ANJ_WITH_OFFLINE_STORE
+#    include <anj/compat/offline_store.h>
+#endif // ANJ_WITH_OFFLINE_STORE
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -58,6 +62,46 @@ extern "C" {
 #    error "if composite observations are enabled, observations and composite operations have to be enabled"
 #endif
 
+#if defined(ANJ_WITH_OFFLINE_STORE) && !defined(ANJ_WITH_LWM2M_SEND)
+#    error "if offline store is enabled, LwM2M Send has to be enabled"
+#endif
+
+#if defined(ANJ_NET_WITH_BATCHED_IO)                                     \
+        && (!defined(ANJ_NET_WITH_UDP) || !defined(ANJ_NET_RECV_BATCH_SIZE) \
+            || ANJ_NET_RECV_BATCH_SIZE < 2)
+#    error "if batched I/O is enabled, UDP has to be enabled and ANJ_NET_RECV_BATCH_SIZE has to be at least 2"
+#endif
+
+#if defined(ANJ_NET_WITH_SEND_IOV) \
+        && ANJ_OUT_PAYLOAD_BUFFER_SIZE >= ANJ_OUT_MSG_BUFFER_SIZE
+#    error "if scatter/gather send is enabled, ANJ_OUT_PAYLOAD_BUFFER_SIZE has to be lower than ANJ_OUT_MSG_BUFFER_SIZE"
+#endif
+
+#if defined(ANJ_WITH_IN_PLACE_PAYLOAD)     \
+        && (defined(ANJ_NET_WITH_SEND_IOV) \
+            || ANJ_OUT_PAYLOAD_BUFFER_SIZE >= ANJ_OUT_MSG_BUFFER_SIZE)
+#    error "if in-place payload is enabled, scatter/gather send has to be disabled and ANJ_OUT_PAYLOAD_BUFFER_SIZE has to be lower than ANJ_OUT_MSG_BUFFER_SIZE"
+#endif
+
+#if defined(ANJ_COAP_WITH_TCP) \
+        && (defined(ANJ_NET_WITH_SEND_IOV) || defined(ANJ_WITH_IN_PLACE_PAYLOAD))
+#    error "if CoAP over TCP is enabled, scatter/gather send and in-place payload have to be disabled"
+#endif
+
+#if defined(ANJ_WITH_RESPONSE_CACHE)                                  \
+        && (!defined(ANJ_COAP_WITH_UDP) || !defined(ANJ_RESPONSE_CACHE_SIZE) \
+            || !defined(ANJ_RESPONSE_CACHE_MAX_MSG_SIZE)                 \
+            || ANJ_RESPONSE_CACHE_SIZE < 1)
+#    error "if response cache is enabled, UDP has to be enabled and its parameters have to be defined"
+#endif
+
+#if defined(ANJ_COAP_WITH_QBLOCK)                     \
+        && (!defined(ANJ_COAP_WITH_UDP)               \
+            || !defined(ANJ_COAP_QBLOCK_MAX_PAYLOADS) \
+            || ANJ_COAP_QBLOCK_MAX_PAYLOADS < 1)
+#    error "if Q-Block options are enabled, UDP has to be enabled and ANJ_COAP_QBLOCK_MAX_PAYLOADS has to be at least 1"
+#endif
+
 /**
  * This enum represents the possible states of a server connection.
  */
@@ -154,6 +198,37 @@ typedef void anj_connection_status_callback_t(void *arg,
                                               anj_t *anj,
                                               anj_conn_status_t conn_status);
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+/** The socket should be checked for incoming data. */
+#    define ANJ_CORE_POLL_IN 0x01
+/** The socket should be checked for the possibility of sending data. */
+#    define ANJ_CORE_POLL_OUT 0x02
+
+/**
+ * Describes what @ref anj_core_step is waiting for. Filled by
+ * @ref anj_core_poll_info.
+ */
+typedef struct {
+    /**
+     * System socket of the connection with the LwM2M Server, as returned by
+     * <c>anj_net_get_system_socket</c>, or NULL if no socket events are
+     * awaited.
+     */
+    const void *system_socket;
+    /**
+     * Bitmask of @ref ANJ_CORE_POLL_IN and @ref ANJ_CORE_POLL_OUT, events of
+     * @ref system_socket after which @ref anj_core_step should be called.
+     */
+    uint8_t events;
+    /**
+     * Time in milliseconds after which @ref anj_core_step should be called
+     * even if none of the events occurred, or @ref ANJ_TIME_UNDEFINED if
+     * there is no such time.
+     */
+    uint64_t timeout_ms;
+} anj_core_poll_info_t;
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 /**
  * Anjay Lite configuration. Provided in @ref anj_core_init() function.
  */
@@ -254,6 +329,19 @@ typedef struct anjay_configuration_struct {
      */
     uint32_t bootstrap_timeout;
 #endif // ANJ_WITH_BOOTSTRAP
+#ifdef ANJ_WITH_OFFLINE_STORE
+
+    /**
+     * Storage for LwM2M Send and Notify payloads that could not be delivered
+     * because the LwM2M Server was unreachable. Stored entries are delivered
+     * in order, as LwM2M Send messages, once the client is registered again.
+     * If NULL, undelivered data is dropped.
+     *
+     * NOTE: The structure must stay valid for the whole lifetime of the
+     * Anjay.
+     */
+    const anj_offline_store_t *offline_store;
+#endif // ANJ_WITH_OFFLINE_STORE
 } anj_configuration_t;
 
 /**
@@ -325,6 +413,52 @@ void anj_core_step(anj_t *anj);
  */
 uint64_t anj_core_next_step_time(anj_t *anj);
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * Reports when the next call to @ref anj_core_step is required, in every
+ * connection state.
+ *
+ * Unlike @ref anj_core_next_step_time, the timeout covers all scheduled
+ * activities: retransmissions and timeouts of the ongoing exchange and of the
+ * requests awaiting acknowledgement, Notifications (pmin/pmax), Registration
+ * Updates, LwM2M Send requests, entering queue mode and retries of the
+ * Registration and Bootstrap. Additionally, the socket events that the client
+ * waits for are reported, so that @ref anj_core_step is called only after one
+ * of them occurs or the timeout expires. This allows a single <c>poll()</c>,
+ * <c>epoll</c> or similar event loop to handle many Anjay objects without
+ * wakeups while they are idle:
+ *
+ * @code
+ * anj_core_poll_info_t info;
+ * anj_core_poll_info(&anj, &info);
+ * if (info.system_socket) {
+ *     struct pollfd pfd = {
+ *         .fd = *(const int *) info.system_socket,
+ *         .events = ((info.events & ANJ_CORE_POLL_IN) ? POLLIN : 0)
+ *                   | ((info.events & ANJ_CORE_POLL_OUT) ? POLLOUT : 0)
+ *     };
+ *     poll(&pfd, 1, info.timeout_ms == ANJ_TIME_UNDEFINED
+ *                           ? -1 : (int) info.timeout_ms);
+ * } else if (info.timeout_ms != ANJ_TIME_UNDEFINED) {
+ *     sleep_ms(info.timeout_ms);
+ * }
+ * anj_core_step(&anj);
+ * @endcode
+ *
+ * While the connection is being established or closed, the progress of the
+ * network layer can't be observed, so @p out_info->timeout_ms is 0. The same
+ * applies to network bindings that don't provide the system socket.
+ *
+ * @note Returned information is valid until @ref anj_core_step or any other
+ *       function that changes the state of the client (e.g.
+ *       @ref anj_core_data_model_changed, @ref anj_send_new_request) is called.
+ *
+ * @param      anj       Anjay object to operate on.
+ * @param[out] out_info  Awaited socket events and the timeout.
+ */
+void anj_core_poll_info(anj_t *anj, anj_core_poll_info_t *out_info);
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 /**
  * Checks if there is an ongoing exchange between the client and the server.
  * User must not process operations on the data model if this function returns
@@ -407,6 +541,25 @@ void anj_core_data_model_changed(anj_t *anj,
                                  const anj_uri_path_t *path,
                                  anj_core_change_type_t change_type);
 
+/**
+ * Notifies the library that a number of paths in the data model changed in
+ * the same way. It is equivalent to calling @ref anj_core_data_model_changed
+ * for each element of @p paths, but all of the observations are evaluated in
+ * a single pass and the value of each observed Resource is read at most once.
+ * Use it e.g. when a single sensor reading updates multiple Resources.
+ *
+ * @param anj          Anjay object to operate on.
+ * @param paths        Array of paths of the Resources that changed, or the
+ *                     Instances that were added/removed.
+ * @param paths_count  Number of elements in @p paths.
+ * @param change_type  Type of change, common for all @p paths;
+ *                     @ref anj_core_change_type_t.
+ */
+void anj_core_data_model_changed_batch(anj_t *anj,
+                                       const anj_uri_path_t *paths,
+                                       size_t paths_count,
+                                       anj_core_change_type_t change_type);
+
 /**
  * Disables the LwM2M Server connection for a specified timeout.
  * If the server is already disabled, this call will only update the timeout
@@ -170,6 +170,14 @@ typedef struct anj_dm_obj_struct {
  * more than assign the relevant addresses to the pointers in the @ref
  * anj_res_value_t::external_data structure.
  *
+ * IMPORTANT: If @ref ANJ_WITH_TLV is enabled and the LwM2M Server requests
+ * TLV for a Read or Observe on an Object, Object Instance or multi-instance
+ * Resource, this handler is called twice for every value: first to calculate
+ * the lengths written in TLV headers, then to encode the value. Numeric values
+ * are then encoded on a fixed number of bytes, but strings and opaque values
+ * must have the same length in both calls. Otherwise the whole operation fails
+ * and @ref ANJ_COAP_CODE_INTERNAL_SERVER_ERROR is sent in response.
+ *
  * @param      anj        Anjay object to operate on.
  * @param      obj        Object definition pointer.
  * @param      iid        Object Instance ID.
@@ -80,6 +80,16 @@ extern "C" {
  */
 #    define ANJ_SEND_ERR_DATA_NOT_VALID -7
 
+#    ifdef ANJ_WITH_OFFLINE_STORE
+/**
+ * Returned by @ref anj_send_new_request, or passed to
+ * #anj_send_finished_handler_t: the message could not be delivered, so its
+ * payload was serialized into the offline store. It will be sent once the
+ * client is registered again, and the request structure is no longer used.
+ */
+#        define ANJ_SEND_STORED 1
+#    endif // ANJ_WITH_OFFLINE_STORE
+
 /**
  * Content format of the message payload to be sent.
  */
@@ -171,7 +181,14 @@ typedef struct {
  *                          associated @ref anj_send_finished_handler_t is
  *                          invoked.
  *
- * @returns 0 on success, a negative value in case of an error:
+ * @note If @ref ANJ_WITH_OFFLINE_STORE is enabled and the client is not
+ *       registered, the payload is serialized into the offline store right
+ *       away, @ref ANJ_SEND_STORED is returned and the finished handler is not
+ *       called.
+ *
+ * @returns 0 on success, @ref ANJ_SEND_STORED (a positive value) if the
+ *          payload was put in the offline store instead of being queued, a
+ *          negative value in case of an error:
  *          - @ref ANJ_SEND_ERR_NO_SPACE if there is no space for new request,
  *          - @ref ANJ_SEND_ERR_NOT_ALLOWED if the request can't be sent in
  *            current state of the library,
@@ -220,8 +220,10 @@ size_t anj_int64_to_string_value(char *out_buff, int64_t value);
  *
  * IMPORTANT: This function doesn't use sprintf() if @ref
  * ANJ_WITH_CUSTOM_CONVERSION_FUNCTIONS is defined and is intended to be
- * lightweight. For very large and very small numbers, a rounding error may
- * occur.
+ * lightweight. In that case the result always converts back to exactly the
+ * same double and in almost all cases it is the shortest such representation,
+ * e.g. <c>0.1</c> is written as "0.1". Exponential notation is also used if
+ * the decimal one would be longer than @ref ANJ_DOUBLE_STR_MAX_LEN.
  *
  * @param[out] out_buff   Output buffer.
  * @param      value      Input value.
@@ -299,6 +301,12 @@ int anj_string_to_objlnk_value(anj_objlnk_value_t *out, const char *objlnk);
  * support infinitive and NAN values (LwM2M attributes representation doesn't
  * allow for this).
  *
+ * If @ref ANJ_WITH_EXACT_STRING_TO_DOUBLE is defined, the result is the double
+ * closest to the parsed value, the same as returned by strtod(). Values with
+ * more than 19 significant digits close to halfway between two doubles need
+ * a slower, exact comparison. Otherwise the custom implementation sums the
+ * digits in floating point and the result may be a few ULPs off.
+ *
  * @param[out] out_val   Output value.
  * @param      buff      Input buffer.
  * @param      buff_len  Input buffer length.
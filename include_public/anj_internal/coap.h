@@ -91,6 +91,10 @@ typedef struct {
     bool more_flag;
     uint32_t number;
     uint16_t size;
+#ifdef ANJ_COAP_WITH_QBLOCK
+    // Q-Block1/Q-Block2 option (RFC 9177) instead of Block1/Block2
+    bool q_block;
+#endif // ANJ_COAP_WITH_QBLOCK
 } _anj_block_t;
 
 /**
@@ -40,6 +40,19 @@ extern "C" {
  */
 #define _ANJ_SSID_BOOTSTRAP 0
 
+/**
+ * @anj_internal_api_do_not_use
+ * Size of the outgoing message buffer. If scatter/gather send is enabled, only
+ * CoAP header and options are encoded there, and payload is sent directly from
+ * the payload buffer.
+ */
+#ifdef ANJ_NET_WITH_SEND_IOV
+#    define _ANJ_OUT_BUFFER_SIZE \
+        (ANJ_OUT_MSG_BUFFER_SIZE - ANJ_OUT_PAYLOAD_BUFFER_SIZE)
+#else  // ANJ_NET_WITH_SEND_IOV
+#    define _ANJ_OUT_BUFFER_SIZE ANJ_OUT_MSG_BUFFER_SIZE
+#endif // ANJ_NET_WITH_SEND_IOV
+
 /** @anj_internal_api_do_not_use */
 #ifdef ANJ_WITH_LWM2M12
 #    define _ANJ_LWM2M_VERSION_STR "1.2"
@@ -47,6 +60,16 @@ extern "C" {
 #    define _ANJ_LWM2M_VERSION_STR "1.1"
 #endif // ANJ_WITH_LWM2M12
 
+#ifdef ANJ_COAP_WITH_TCP
+/**
+ * @anj_internal_api_do_not_use
+ * Space for CoAP signalling messages waiting to be sent: CSM with
+ * Max-Message-Size and Block-Wise-Transfer options, and Pong with the token of
+ * the Ping and Custody option.
+ */
+#    define _ANJ_SERVER_SIGNALLING_BUFFER_SIZE 32
+#endif // ANJ_COAP_WITH_TCP
+
 /** @anj_internal_api_do_not_use */
 typedef struct anj_server_connection_ctx_struct {
     anj_net_ctx_t *net_ctx;
@@ -54,8 +77,112 @@ typedef struct anj_server_connection_ctx_struct {
     size_t bytes_sent;
     anj_net_binding_type_t type;
     bool send_in_progress;
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+    // upper limit of the outgoing block size, lowered after losses and raised
+    // back after a series of exchanges without them
+    uint16_t block_size_limit;
+    uint16_t exchanges_without_loss;
+    // message of the ongoing exchange was lost at least once
+    bool loss_in_exchange;
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+#ifdef ANJ_COAP_WITH_TCP
+    // signalling messages are sent in between the other messages, never in the
+    // middle of one, signalling_len set to 0 means that there are none
+    uint8_t signalling_buffer[_ANJ_SERVER_SIGNALLING_BUFFER_SIZE];
+    size_t signalling_len;
+    size_t signalling_sent;
+    // Max-Message-Size of the LwM2M Server, RFC 8323 5.3.1
+    uint32_t peer_max_msg_size;
+    // part of the stream kept in the receive buffer of the caller: messages
+    // between stream_begin and stream_end are not handled yet, the last one
+    // may be incomplete
+    size_t stream_begin;
+    size_t stream_end;
+    // remaining bytes of the message that doesn't fit in the receive buffer
+    size_t stream_skip;
+#endif // ANJ_COAP_WITH_TCP
+#ifdef ANJ_NET_WITH_BATCHED_IO
+    // datagrams received in a single call but not handled yet, the first one
+    // is always received directly to the buffer of the caller
+    uint8_t recv_batch[ANJ_NET_RECV_BATCH_SIZE - 1][ANJ_IN_MSG_BUFFER_SIZE];
+    size_t recv_batch_length[ANJ_NET_RECV_BATCH_SIZE - 1];
+    size_t recv_batch_count;
+    size_t recv_batch_idx;
+#endif // ANJ_NET_WITH_BATCHED_IO
 } _anj_server_connection_ctx_t;
 
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+/**
+ * @anj_internal_api_do_not_use
+ * Confirmable client request that was sent and awaits the acknowledgement
+ * outside of the main exchange context.
+ */
+typedef struct {
+    // exchange.op set to ANJ_OP_NONE means that the slot is free
+    _anj_exchange_in_flight_t exchange;
+#    ifdef ANJ_WITH_OBSERVE
+    uint16_t ssid;
+#        ifdef ANJ_WITH_OFFLINE_STORE
+    // real time in seconds at which the notification was prepared
+    double notification_time;
+#        endif // ANJ_WITH_OFFLINE_STORE
+#    endif // ANJ_WITH_OBSERVE
+#    ifdef ANJ_WITH_LWM2M_SEND
+    // Send requests carried by the message
+    uint16_t send_ids[ANJ_LWM2M_SEND_QUEUE_SIZE];
+    const anj_send_request_t *send_requests[ANJ_LWM2M_SEND_QUEUE_SIZE];
+    size_t send_count;
+#    endif // ANJ_WITH_LWM2M_SEND
+    // copy of the message, used for retransmissions
+    uint8_t msg[ANJ_OUT_MSG_BUFFER_SIZE];
+    size_t msg_len;
+} _anj_in_flight_request_t;
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
+#ifdef ANJ_WITH_OFFLINE_STORE
+/** @anj_internal_api_do_not_use */
+typedef struct {
+    const anj_offline_store_t *store;
+    // set when delivery of stored entries failed, cleared after registration
+    bool flush_paused;
+    // variables related to the ongoing delivery of stored entries
+    bool flush_in_progress;
+    uint16_t format;
+    size_t entries_in_msg;
+    // entries of the message dropped by the store to make room for new ones
+    size_t dropped_in_flight;
+    size_t entry_idx;
+    size_t entry_offset;
+    size_t entry_length[ANJ_OFFLINE_STORE_FLUSH_BATCH_SIZE];
+    // length of the SenML CBOR array header of the merged entries
+    uint8_t entry_skip[ANJ_OFFLINE_STORE_FLUSH_BATCH_SIZE];
+    // SenML CBOR array header of the message with merged entries
+    uint8_t header[5];
+    size_t header_length;
+    size_t header_offset;
+#    ifdef ANJ_WITH_OBSERVE
+    // handlers of the ongoing notification exchange
+    _anj_exchange_handlers_t notification_handlers;
+    // real time in seconds at which the notification was prepared
+    double notification_time;
+#    endif // ANJ_WITH_OBSERVE
+} _anj_offline_store_ctx_t;
+#endif // ANJ_WITH_OFFLINE_STORE
+
+#ifdef ANJ_WITH_RESPONSE_CACHE
+/**
+ * @anj_internal_api_do_not_use
+ * Encoded response to the LwM2M Server request, message ID and token of the
+ * request are read from the header of the response.
+ */
+typedef struct {
+    uint64_t expiration_time;
+    // msg_len set to 0 means that the entry is free
+    size_t msg_len;
+    uint8_t msg[ANJ_RESPONSE_CACHE_MAX_MSG_SIZE];
+} _anj_response_cache_entry_t;
+#endif // ANJ_WITH_RESPONSE_CACHE
+
 /**
  * @anj_internal_api_do_not_use
  * Anjay object containing all information required for LwM2M communication.
@@ -86,6 +213,10 @@ typedef struct anj_struct {
     _anj_send_ctx_t send_ctx;
 #endif // ANJ_WITH_LWM2M_SEND
 
+#ifdef ANJ_WITH_OFFLINE_STORE
+    _anj_offline_store_ctx_t offline_store;
+#endif // ANJ_WITH_OFFLINE_STORE
+
     union {
         /** Used to prepare outgoing message payload. */
         _anj_io_out_ctx_t out_ctx;
@@ -169,10 +300,32 @@ typedef struct anj_struct {
     } security_instance;
 
     uint8_t in_buffer[ANJ_IN_MSG_BUFFER_SIZE];
-    uint8_t out_buffer[ANJ_OUT_MSG_BUFFER_SIZE];
+    uint8_t out_buffer[_ANJ_OUT_BUFFER_SIZE];
+#ifndef ANJ_WITH_IN_PLACE_PAYLOAD
     uint8_t payload_buffer[ANJ_OUT_PAYLOAD_BUFFER_SIZE];
+#endif // ANJ_WITH_IN_PLACE_PAYLOAD
     _anj_exchange_ctx_t exchange_ctx;
+    // length of the whole outgoing message, including payload
     size_t out_msg_len;
+#ifdef ANJ_WITH_IN_PLACE_PAYLOAD
+    // outgoing message starts at out_buffer[out_msg_offset], header is placed
+    // right in front of the payload
+    size_t out_msg_offset;
+#endif // ANJ_WITH_IN_PLACE_PAYLOAD
+#ifdef ANJ_NET_WITH_SEND_IOV
+    // out_buffer contains out_header_len bytes, payload marker and payload
+    // follow it only when the message is sent
+    size_t out_header_len;
+    const uint8_t *out_payload;
+    size_t out_payload_len;
+#endif // ANJ_NET_WITH_SEND_IOV
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    // exchange_ctx is the first of ANJ_EXCHANGE_NSTART slots
+    _anj_in_flight_request_t in_flight[ANJ_EXCHANGE_NSTART - 1];
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+#ifdef ANJ_WITH_RESPONSE_CACHE
+    _anj_response_cache_entry_t response_cache[ANJ_RESPONSE_CACHE_SIZE];
+#endif // ANJ_WITH_RESPONSE_CACHE
 } _anj_t;
 
 #ifdef __cplusplus
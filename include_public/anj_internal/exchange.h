@@ -26,6 +26,19 @@
 extern "C" {
 #endif
 
+#if defined(ANJ_EXCHANGE_NSTART) && ANJ_EXCHANGE_NSTART < 1
+#    error "ANJ_EXCHANGE_NSTART must be at least 1"
+#endif
+
+/**
+ * @anj_internal_api_do_not_use
+ * Defined if confirmable client requests may be kept outstanding outside of
+ * the main exchange context.
+ */
+#if defined(ANJ_EXCHANGE_NSTART) && ANJ_EXCHANGE_NSTART > 1
+#    define _ANJ_WITH_IN_FLIGHT_REQUESTS
+#endif
+
 /**
  *  @anj_internal_api_do_not_use
  *  All possible states of exchange
@@ -58,6 +71,32 @@ typedef struct {
     uint16_t max_retransmit;
 } _anj_exchange_udp_tx_params_t;
 
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+/**
+ * @anj_internal_api_do_not_use
+ * Smoothed round-trip time and its variation, as defined in RFC 6298.
+ */
+typedef struct {
+    bool initialized;
+    uint64_t srtt_ms;
+    uint64_t rttvar_ms;
+} _anj_exchange_rtt_estimator_t;
+
+/**
+ * @anj_internal_api_do_not_use
+ * Retransmission timeout estimated with CoCoA algorithm. The strong estimator is
+ * updated with RTT of exchanges without retransmissions, the weak one with RTT
+ * of exchanges with 1 or 2 retransmissions.
+ */
+typedef struct {
+    _anj_exchange_rtt_estimator_t strong;
+    _anj_exchange_rtt_estimator_t weak;
+    uint64_t rto_ms;
+    // used for aging of the estimate that is not updated
+    uint64_t last_update_timestamp_ms;
+} _anj_exchange_rto_t;
+#endif // ANJ_WITH_ADAPTIVE_RTO
+
 /**
  * Output parameters returned from @ref anj_exchange_read_payload_t handler.
  *
@@ -179,6 +218,14 @@ typedef struct {
     // used in separate response mode
     bool request_prepared;
     uint32_t block_number;
+#ifdef ANJ_COAP_WITH_QBLOCK
+    // LwM2M Server uses Q-Block1/Q-Block2 options (RFC 9177) in the exchange
+    bool q_block;
+#endif // ANJ_COAP_WITH_QBLOCK
+#ifdef ANJ_COAP_WITH_TCP
+    // CoAP over TCP or TLS is used, there are no ACKs and retransmissions
+    bool reliable_transport;
+#endif // ANJ_COAP_WITH_TCP
 
     uint64_t server_exchange_timeout;
     _anj_exchange_udp_tx_params_t tx_params;
@@ -189,12 +236,39 @@ typedef struct {
     // based on pseudo-random number generator, used for timeout calculation
     // subsequent requests should have different timeout values
     _anj_rand_seed_t timeout_rand_seed;
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    _anj_exchange_rto_t rto;
+    // first transmission of the current message, RTT is measured from it
+    uint64_t transmission_timestamp_ms;
+#endif // ANJ_WITH_ADAPTIVE_RTO
 
     uint8_t msg_code;
     _anj_coap_msg_t base_msg;
     _anj_op_t op;
 } _anj_exchange_ctx_t;
 
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+/**
+ * @anj_internal_api_do_not_use
+ * State of a confirmable client request detached from the exchange context
+ * after it was sent. Such a request is matched with incoming messages by
+ * message ID (empty ACK, Reset) and token (separate response).
+ */
+typedef struct {
+    uint16_t message_id;
+    _anj_coap_token_t token;
+    _anj_op_t op;
+    // empty ACK was received, waiting for the separate response
+    bool separate_response;
+    uint16_t retry_count;
+    uint64_t timeout_ms;
+    uint64_t timeout_timestamp_ms;
+#    ifdef ANJ_WITH_ADAPTIVE_RTO
+    uint64_t transmission_timestamp_ms;
+#    endif // ANJ_WITH_ADAPTIVE_RTO
+} _anj_exchange_in_flight_t;
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
 #ifdef __cplusplus
 }
 #endif
@@ -87,6 +87,14 @@ extern "C" {
 /** @anj_internal_api_do_not_use */
 #define _ANJ_IO_PLAINTEXT_SIMPLE_RECORD_MAX_LENGTH ANJ_DOUBLE_STR_MAX_LEN
 
+/**
+ * @anj_internal_api_do_not_use
+ * Largest possible single TLV record, opens an Object Instance and a Multiple
+ * Resource and contains a 64-bit value. Every header may take up to 6 bytes:
+ * type, 16-bit identifier and 24-bit length.
+ */
+#define _ANJ_IO_TLV_SIMPLE_RECORD_MAX_LENGTH (3 * 6 + 8)
+
 /** @anj_internal_api_do_not_use */
 #define _ANJ_IO_CTX_BUFFER_LENGTH _ANJ_IO_SENML_CBOR_SIMPLE_RECORD_MAX_LENGTH
 
@@ -105,7 +113,9 @@ ANJ_STATIC_ASSERT(
                 && _ANJ_IO_CTX_BUFFER_LENGTH >= _ANJ_IO_ATTRIBUTE_RECORD_MAX_LEN
                 && _ANJ_IO_CTX_BUFFER_LENGTH >= _ANJ_IO_DISCOVER_RECORD_MAX_LEN
                 && _ANJ_IO_CTX_BUFFER_LENGTH
-                           >= _ANJ_IO_PLAINTEXT_SIMPLE_RECORD_MAX_LENGTH,
+                           >= _ANJ_IO_PLAINTEXT_SIMPLE_RECORD_MAX_LENGTH
+                && _ANJ_IO_CTX_BUFFER_LENGTH
+                           >= _ANJ_IO_TLV_SIMPLE_RECORD_MAX_LENGTH,
         internal_buff_badly_defined);
 
 #if defined(ANJ_WITH_SENML_CBOR) || defined(ANJ_WITH_LWM2M_CBOR) \
@@ -187,6 +197,9 @@ typedef struct {
     size_t bytes_in_internal_buff;
     bool is_extended_type;
     uint8_t internal_buff[_ANJ_IO_CTX_BUFFER_LENGTH];
+    // if set, the record is encoded into the payload buffer of the caller
+    // instead of internal_buff, see _anj_io_out_ctx_add_entry()
+    uint8_t *direct_buff;
     _anj_text_encoder_b64_cache_t b64_cache;
 
 #ifdef ANJ_WITH_EXTERNAL_DATA
@@ -232,6 +245,31 @@ typedef struct {
 } _anj_senml_cbor_encoder_t;
 #endif // ANJ_WITH_SENML_CBOR
 
+#ifdef ANJ_WITH_TLV
+/**
+ * @anj_internal_api_do_not_use
+ * Calculates the length of the value of TLV aggregate pointed by @p path, i.e.
+ * Object Instance or Multiple Resource, which is a sum of lengths of all the
+ * nested records.
+ */
+typedef int _anj_io_tlv_length_cb_t(void *arg,
+                                    const anj_uri_path_t *path,
+                                    size_t *out_length);
+
+/** @anj_internal_api_do_not_use */
+typedef struct {
+    anj_uri_path_t base_path;
+    anj_uri_path_t last_path;
+    size_t items_count;
+    // bytes of the currently open Object Instance and Multiple Resource that
+    // have not been encoded yet
+    size_t instance_remaining;
+    size_t multi_res_remaining;
+    _anj_io_tlv_length_cb_t *length_cb;
+    void *length_cb_arg;
+} _anj_tlv_encoder_t;
+#endif // ANJ_WITH_TLV
+
 #if defined(ANJ_WITH_SENML_CBOR) || defined(ANJ_WITH_LWM2M_CBOR) \
         || defined(ANJ_WITH_CBOR)
 /** @anj_internal_api_do_not_use */
@@ -649,6 +687,9 @@ typedef struct {
 #ifdef ANJ_WITH_LWM2M_CBOR
         _anj_lwm2m_cbor_encoder_t lwm2m;
 #endif // ANJ_WITH_LWM2M_CBOR
+#ifdef ANJ_WITH_TLV
+        _anj_tlv_encoder_t tlv;
+#endif // ANJ_WITH_TLV
     } encoder;
 } _anj_io_out_ctx_t;
 
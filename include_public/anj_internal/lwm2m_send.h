@@ -24,14 +24,29 @@ extern "C" {
 typedef struct _anj_send_ctx_struct {
     const anj_send_request_t *requests_queue[ANJ_LWM2M_SEND_QUEUE_SIZE];
     // ids == 0 means that the slot is free, each ids[x] corresponds to a
-    // requests_queue slot, active_exchange is always related to ids[0]
+    // requests_queue slot, active_exchange is always related to ids[0] and
+    // the following requests merged with it
     uint16_t ids[ANJ_LWM2M_SEND_QUEUE_SIZE];
     bool active_exchange;
     // set when aborting all requests
     bool abort_in_progress;
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    // set when the active exchange is terminated by anj_send_abort(), so the
+    // request is not moved to the offline store
+    bool user_abort;
+#    endif // ANJ_WITH_OFFLINE_STORE
     uint16_t send_id_counter;
-    // variables used to process the message payload
+    // number of requests, starting from ids[0], sent in the active exchange
+    size_t requests_in_msg;
+#    ifdef ANJ_LWM2M_SEND_WITH_COALESCING
+    // set when the active exchange is terminated, but the requests sent in it
+    // have to stay in the queue
+    bool requeue_active;
+#    endif // ANJ_LWM2M_SEND_WITH_COALESCING
+    // variables used to process the message payload, op_count refers to the
+    // records of requests_queue[request_idx]
     bool data_to_copy;
+    size_t request_idx;
     size_t op_count;
 } _anj_send_ctx_t;
 
@@ -46,11 +46,13 @@ struct _anj_observe_observation_struct {
     anj_uri_path_t path;
     _anj_coap_token_t token;
     uint32_t observe_number;
-#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
-    // These two fields are needed in case we receive a composite observation
-    // with the same token again; we then need to compare if all the CoAP
-    // options match.
+    // Format of the notifications, _ANJ_COAP_FORMAT_NOT_DEFINED if the
+    // initial request had no Accept option.
     uint16_t accept_opt;
+#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
+    // This field, together with accept_opt, is needed in case we receive a
+    // composite observation with the same token again; we then need to
+    // compare if all the CoAP options match.
     uint16_t content_format_opt;
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
 
@@ -123,12 +125,38 @@ typedef struct anj_observe_server_state_struct {
 #    endif // ANJ_WITH_LWM2M12
 } _anj_observe_server_state_t;
 
+/**
+ * @anj_internal_api_do_not_use
+ * Cached result of the last full scan of observations. As long as it is valid,
+ * checking whether any notification has to be sent, or calculating the time
+ * until the next one, does not require iterating over all observations.
+ */
+typedef struct {
+    /** Set to false whenever observation timing parameters change. */
+    bool valid;
+    /**
+     * Earliest time at which any observation may require sending a
+     * notification, or ANJ_TIME_UNDEFINED if there is no such observation.
+     */
+    uint64_t next_check_timestamp;
+    /** Time at which the schedule was calculated. */
+    uint64_t calculated_at;
+    /** Server state for which the schedule was calculated. */
+    _anj_observe_server_state_t server_state;
+} _anj_observe_schedule_t;
+
 /** @anj_internal_api_do_not_use */
 typedef struct {
     _anj_observe_observation_t
             observations[ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER];
     _anj_observe_attr_storage_t
             attributes_storage[ANJ_OBSERVE_MAX_WRITE_ATTRIBUTES_NUMBER];
+    _anj_observe_schedule_t schedule;
+    /* Indexes of used observations, sorted by path. Observations whose path
+     * lies under a common base occupy a contiguous range of this array. */
+    uint16_t path_index[ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER];
+    uint16_t path_index_size;
+    bool path_index_valid;
 
     /* Fields related to currently process operation */
     int in_progress_type;
@@ -72,9 +72,11 @@ extern "C" {
 
 /**
  * @anj_internal_api_do_not_use
- * Type used as a PRNG seed.
+ * State of the xoshiro128** PRNG, initialized with @ref _anj_rand_seed.
  */
-typedef unsigned int _anj_rand_seed_t;
+typedef struct {
+    uint32_t s[4];
+} _anj_rand_seed_t;
 
 #ifdef __cplusplus
 }
@@ -11,6 +11,9 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <anj/anj_config.h>
+#include <anj/utils.h>
+
 #include "block.h"
 #include "coap.h"
 #include "options.h"
@@ -29,23 +32,36 @@
 #define _ANJ_BLOCK_2_BYTE_NUM_MAX_VALUE 4095
 #define _ANJ_BLOCK_NUM_MAX_VALUE 0x000FFFFF
 
+static const struct {
+    uint16_t option_number;
+    _anj_block_option_t block_type;
+    bool q_block;
+} BLOCK_OPTIONS[] = {
+    { _ANJ_COAP_OPTION_BLOCK1, ANJ_OPTION_BLOCK_1, false },
+#ifdef ANJ_COAP_WITH_QBLOCK
+    { _ANJ_COAP_OPTION_Q_BLOCK1, ANJ_OPTION_BLOCK_1, true },
+#endif // ANJ_COAP_WITH_QBLOCK
+    { _ANJ_COAP_OPTION_BLOCK2, ANJ_OPTION_BLOCK_2, false },
+#ifdef ANJ_COAP_WITH_QBLOCK
+    { _ANJ_COAP_OPTION_Q_BLOCK2, ANJ_OPTION_BLOCK_2, true },
+#endif // ANJ_COAP_WITH_QBLOCK
+};
+
 int _anj_block_decode(anj_coap_options_t *opts, _anj_block_t *block) {
-    bool check_block2_opt = false;
     uint8_t block_buff[_ANJ_BLOCK_OPTION_MAX_SIZE];
     size_t block_option_size = 0;
+    size_t opt_idx = 0;
 
     memset(block, 0, sizeof(_anj_block_t));
 
-    int res = _anj_coap_options_get_data_iterate(opts, _ANJ_COAP_OPTION_BLOCK1,
-                                                 NULL, &block_option_size,
-                                                 block_buff,
-                                                 _ANJ_BLOCK_OPTION_MAX_SIZE);
-    if (res == _ANJ_COAP_OPTION_MISSING) {
-        res = _anj_coap_options_get_data_iterate(opts, _ANJ_COAP_OPTION_BLOCK2,
-                                                 NULL, &block_option_size,
-                                                 block_buff,
-                                                 _ANJ_BLOCK_OPTION_MAX_SIZE);
-        check_block2_opt = true;
+    int res = _ANJ_COAP_OPTION_MISSING;
+    for (; opt_idx < ANJ_ARRAY_SIZE(BLOCK_OPTIONS); opt_idx++) {
+        res = _anj_coap_options_get_data_iterate(
+                opts, BLOCK_OPTIONS[opt_idx].option_number, NULL,
+                &block_option_size, block_buff, _ANJ_BLOCK_OPTION_MAX_SIZE);
+        if (res != _ANJ_COAP_OPTION_MISSING) {
+            break;
+        }
     }
     if (res == _ANJ_COAP_OPTION_MISSING) {
         return 0;
@@ -55,8 +71,10 @@ int _anj_block_decode(anj_coap_options_t *opts, _anj_block_t *block) {
         // dont't allow empty block option
         return _ANJ_ERR_MALFORMED_MESSAGE;
     } else if (!res && block_option_size <= _ANJ_BLOCK_OPTION_MAX_SIZE) {
-        block->block_type =
-                check_block2_opt ? ANJ_OPTION_BLOCK_2 : ANJ_OPTION_BLOCK_1;
+        block->block_type = BLOCK_OPTIONS[opt_idx].block_type;
+#ifdef ANJ_COAP_WITH_QBLOCK
+        block->q_block = BLOCK_OPTIONS[opt_idx].q_block;
+#endif // ANJ_COAP_WITH_QBLOCK
         block->more_flag = !!(block_buff[block_option_size - 1]
                               & _ANJ_BLOCK_OPTION_M_MASK);
 
@@ -103,6 +121,13 @@ int _anj_block_prepare(anj_coap_options_t *opts, const _anj_block_t *block) {
     } else {
         return _ANJ_ERR_INPUT_ARG;
     }
+#ifdef ANJ_COAP_WITH_QBLOCK
+    if (block->q_block) {
+        opt_number = block->block_type == ANJ_OPTION_BLOCK_1
+                             ? _ANJ_COAP_OPTION_Q_BLOCK1
+                             : _ANJ_COAP_OPTION_Q_BLOCK2;
+    }
+#endif // ANJ_COAP_WITH_QBLOCK
 
     // prepare SZX parameter
     uint8_t SZX = 0xFF;
@@ -46,6 +46,7 @@ extern "C" {
 #define _ANJ_COAP_FORMAT_CBOR 60
 #define _ANJ_COAP_FORMAT_SENML_JSON 110
 #define _ANJ_COAP_FORMAT_SENML_CBOR 112
+#define _ANJ_COAP_FORMAT_MISSING_BLOCKS_CBOR_SEQ 272
 #define _ANJ_COAP_FORMAT_SENML_ETCH_JSON 320
 #define _ANJ_COAP_FORMAT_SENML_ETCH_CBOR 322
 #define _ANJ_COAP_FORMAT_OMA_LWM2M_TLV 11542
@@ -104,6 +105,15 @@ extern "C" {
  */
 #define _ANJ_COAP_UDP_RESPONSE_MSG_HEADER_MAX_SIZE 25
 
+#ifdef ANJ_COAP_WITH_TCP
+/**
+ * CoAP over TCP header (RFC 8323, 3.2) is up to 6 bytes long: Len and TKL byte,
+ * up to 4 bytes of Extended Length and Code. Maximum header sizes above are
+ * calculated for the 4 bytes long CoAP over UDP header.
+ */
+#    define _ANJ_COAP_TCP_HEADER_EXTRA_SIZE 2
+#endif // ANJ_COAP_WITH_TCP
+
 #ifdef ANJ_COAP_WITH_UDP
 /**
  * Based on @p msg decodes CoAP message, compliant with the LwM2M version 1.1
@@ -155,6 +165,24 @@ int _anj_coap_decode_tcp(uint8_t *msg,
                          size_t msg_size,
                          _anj_coap_msg_t *out_data,
                          size_t *out_new_data_offset);
+
+/**
+ * Reads the length of the CoAP over TCP message that starts at @p msg, based
+ * only on the Len, TKL and Extended Length fields. It allows to find message
+ * boundaries in the stream before the whole message is received.
+ *
+ * @param      msg             Beginning of the message.
+ * @param      msg_size        Amount of data available at @p msg.
+ * @param[out] out_frame_size  Total size of the message, including the header.
+ *
+ * @return
+ * - 0 on success,
+ * - negative value if the Extended Length field is invalid,
+ * - _ANJ_INF_COAP_TCP_INCOMPLETE_MESSAGE if the header isn't received yet.
+ */
+int _anj_coap_tcp_frame_size(uint8_t *msg,
+                             size_t msg_size,
+                             size_t *out_frame_size);
 #endif // ANJ_COAP_WITH_TCP
 #ifdef ANJ_COAP_WITH_UDP
 /**
@@ -179,6 +207,27 @@ int _anj_coap_encode_udp(_anj_coap_msg_t *msg,
                          uint8_t *out_buff,
                          size_t out_buff_size,
                          size_t *out_msg_size);
+
+#    if defined(ANJ_NET_WITH_SEND_IOV) || defined(ANJ_WITH_IN_PLACE_PAYLOAD)
+/**
+ * Works like @ref _anj_coap_encode_udp, but only CoAP header and options are
+ * placed in @p out_buff. Payload marker and payload, if @p msg.payload_size is
+ * not <c>0</c> after the call, have to be sent right after the header.
+ *
+ * @param      msg              Structured LwM2M message.
+ * @param[out] out_buff         Buffer for serialized CoAP header and options.
+ * @param      out_buff_size    Buffer size.
+ * @param[out] out_header_size  Size of the prepared header and options.
+ *
+ * @return 0 on success, or an one of the error codes defined at the top of this
+ * file.
+ */
+int _anj_coap_encode_udp_header(_anj_coap_msg_t *msg,
+                                uint8_t *out_buff,
+                                size_t out_buff_size,
+                                size_t *out_header_size);
+#    endif // defined(ANJ_NET_WITH_SEND_IOV) ||
+           // defined(ANJ_WITH_IN_PLACE_PAYLOAD)
 #endif // ANJ_COAP_WITH_UDP
 #ifdef ANJ_COAP_WITH_TCP
 /**
@@ -219,7 +268,8 @@ int _anj_coap_encode_tcp(_anj_coap_msg_t *msg,
 size_t _anj_coap_calculate_msg_header_max_size(const _anj_coap_msg_t *msg);
 
 /**
- * Creates a new CoAP token. The token is a pseudo-random 8-byte value.
+ * Creates a new CoAP token. The token is a pseudo-random 8-byte value, taken
+ * from @ref anj_rng_generate if @ref ANJ_COAP_WITH_SECURE_RNG is enabled.
  * Message ID is also generated. During @ref _anj_coap_encode_udp call token and
  * message ID are not created again.
  *
@@ -231,6 +281,8 @@ void _anj_coap_init_coap_udp_credentials(_anj_coap_msg_t *msg);
  * Should be called once to initialize the module.
  *
  * @param random_seed  PRNG seed value, used in CoAP token generation process.
+ *                     Ignored if @ref ANJ_COAP_WITH_SECURE_RNG is enabled and
+ *                     @ref anj_rng_generate succeeds.
  */
 void _anj_coap_init(uint32_t random_seed);
 
@@ -355,6 +355,23 @@ static int get_location_path(anj_coap_options_t *opt,
 }
 
 #ifdef ANJ_COAP_WITH_UDP
+// RFC 9177: Q-Block transfers are preferably Non-confirmable, other
+// Non-confirmable requests are allowed only for Execute
+static bool has_q_block_option(const anj_coap_options_t *opts) {
+#    ifdef ANJ_COAP_WITH_QBLOCK
+    for (size_t i = 0; i < opts->options_number; i++) {
+        if (opts->options[i].option_number == _ANJ_COAP_OPTION_Q_BLOCK1
+                || opts->options[i].option_number
+                               == _ANJ_COAP_OPTION_Q_BLOCK2) {
+            return true;
+        }
+    }
+#    else  // ANJ_COAP_WITH_QBLOCK
+    (void) opts;
+#    endif // ANJ_COAP_WITH_QBLOCK
+    return false;
+}
+
 static int recognize_operation_and_options_udp(anj_coap_message_t *out_coap_msg,
                                                _anj_coap_msg_t *inout_data) {
     _anj_coap_options_get_u16_iterate(out_coap_msg->options,
@@ -378,7 +395,7 @@ static int recognize_operation_and_options_udp(anj_coap_message_t *out_coap_msg,
                 == ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE) {
             if (inout_data->msg_code == ANJ_COAP_CODE_POST) {
                 inout_data->operation = ANJ_OP_DM_EXECUTE;
-            } else {
+            } else if (!has_q_block_option(out_coap_msg->options)) {
                 return _ANJ_ERR_MALFORMED_MESSAGE;
             }
         }
@@ -774,6 +791,21 @@ static int _anj_coap_tcp_frame_decode(void *segment,
     return recognize_operation_and_options_tcp(&out_coap_msg, out_data);
 }
 
+int _anj_coap_tcp_frame_size(uint8_t *msg,
+                             size_t msg_size,
+                             size_t *out_frame_size) {
+    assert(msg && out_frame_size);
+    if (!msg_size) {
+        return _ANJ_INF_COAP_TCP_INCOMPLETE_MESSAGE;
+    }
+    // Len and TKL field followed by Extended Length
+    uint8_t msg_length = _anj_coap_tcp_header_get_message_length(*msg);
+    if (msg_size < sizeof(uint8_t) + extended_length_bytes(msg_length)) {
+        return _ANJ_INF_COAP_TCP_INCOMPLETE_MESSAGE;
+    }
+    return get_coap_tcp_frame_length(msg, msg_size, out_frame_size);
+}
+
 int _anj_coap_decode_tcp(uint8_t *segment,
                          size_t segment_size,
                          _anj_coap_msg_t *out_data,
@@ -781,22 +813,14 @@ int _anj_coap_decode_tcp(uint8_t *segment,
     assert(segment && out_data && out_new_data_offset && segment_size > 0);
 
     size_t frame_size;
-    int res;
-
-    if (segment_size
-            < sizeof(uint8_t)
-                          + extended_length_bytes(
-                                    _anj_coap_tcp_header_get_message_length(
-                                            *segment))) {
-        return _ANJ_INF_COAP_TCP_INCOMPLETE_MESSAGE;
+    int res = _anj_coap_tcp_frame_size(segment, segment_size, &frame_size);
+    if (res) {
+        return res;
     }
 
     out_data->accept = _ANJ_COAP_FORMAT_NOT_DEFINED;
     out_data->content_format = _ANJ_COAP_FORMAT_NOT_DEFINED;
 
-    res = get_coap_tcp_frame_length(segment, segment_size, &frame_size);
-    _RET_IF_ERROR(res);
-
     if (segment_size < frame_size) {
         return _ANJ_INF_COAP_TCP_INCOMPLETE_MESSAGE;
     }
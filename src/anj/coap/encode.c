@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include <anj/anj_config.h>
+#include <anj/compat/rng.h>
 #include <anj/defs.h>
 #include <anj/utils.h>
 
@@ -30,11 +31,20 @@
 #include "options.h"
 
 static uint16_t g_anj_msg_id;
-static _anj_rand_seed_t g_rand_seed;
+// any state other than all zeros is valid, it's replaced in _anj_coap_init()
+static _anj_rand_seed_t g_rand_seed = {
+    .s = { 1, 0, 0, 0 }
+};
 
 static void anj_token_create(_anj_coap_token_t *token) {
     token->size = _ANJ_COAP_MAX_TOKEN_LENGTH;
     assert(_ANJ_COAP_MAX_TOKEN_LENGTH == 8);
+#ifdef ANJ_COAP_WITH_SECURE_RNG
+    if (!anj_rng_generate((uint8_t *) token->bytes,
+                          _ANJ_COAP_MAX_TOKEN_LENGTH)) {
+        return;
+    }
+#endif // ANJ_COAP_WITH_SECURE_RNG
     uint64_t random_val = _anj_rand64_r(&g_rand_seed);
     memcpy(token->bytes, &random_val, sizeof(random_val));
 }
@@ -300,10 +310,11 @@ static int _anj_coap_udp_header_serialize(anj_coap_message_t *msg,
     return 0;
 }
 
-int _anj_coap_encode_udp(_anj_coap_msg_t *msg,
-                         uint8_t *out_buff,
-                         size_t out_buff_size,
-                         size_t *out_msg_size) {
+static int encode_udp(_anj_coap_msg_t *msg,
+                      uint8_t *out_buff,
+                      size_t out_buff_size,
+                      size_t *out_msg_size,
+                      bool with_payload) {
     assert(msg);
     assert(out_buff);
     assert(out_msg_size);
@@ -319,8 +330,18 @@ int _anj_coap_encode_udp(_anj_coap_msg_t *msg,
         assert(msg->token.size != 0);
         msg->coap_binding_data.udp.type = ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE;
         msg->coap_binding_data.udp.message_id = ++g_anj_msg_id;
-    } else if (msg->operation == ANJ_OP_RESPONSE
-               || msg->operation == ANJ_OP_INF_INITIAL_NOTIFY) {
+    }
+#    ifdef ANJ_COAP_WITH_QBLOCK
+    else if (msg->operation == ANJ_OP_RESPONSE
+             && msg->coap_binding_data.udp.type
+                        == ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE) {
+        // response to Non-confirmable request: new msg_id, token reuse
+        assert(msg->token.size != 0);
+        msg->coap_binding_data.udp.message_id = ++g_anj_msg_id;
+    }
+#    endif // ANJ_COAP_WITH_QBLOCK
+    else if (msg->operation == ANJ_OP_RESPONSE
+             || msg->operation == ANJ_OP_INF_INITIAL_NOTIFY) {
         // msg_id and token reuse
         assert(msg->token.size != 0);
         msg->coap_binding_data.udp.type = ANJ_COAP_UDP_TYPE_ACKNOWLEDGEMENT;
@@ -368,8 +389,8 @@ int _anj_coap_encode_udp(_anj_coap_msg_t *msg,
                 msg->msg_code,
                 msg->coap_binding_data.udp.message_id),
         .options = &opts,
-        .payload = msg->payload,
-        .payload_size = msg->payload_size,
+        .payload = with_payload ? msg->payload : NULL,
+        .payload_size = with_payload ? msg->payload_size : 0,
     };
     memcpy(coap_msg.token, msg->token.bytes, msg->token.size);
 
@@ -382,6 +403,23 @@ int _anj_coap_encode_udp(_anj_coap_msg_t *msg,
     return _anj_coap_payload_serialize(&coap_msg, out_buff, out_buff_size,
                                        out_msg_size);
 }
+
+int _anj_coap_encode_udp(_anj_coap_msg_t *msg,
+                         uint8_t *out_buff,
+                         size_t out_buff_size,
+                         size_t *out_msg_size) {
+    return encode_udp(msg, out_buff, out_buff_size, out_msg_size, true);
+}
+
+#    if defined(ANJ_NET_WITH_SEND_IOV) || defined(ANJ_WITH_IN_PLACE_PAYLOAD)
+int _anj_coap_encode_udp_header(_anj_coap_msg_t *msg,
+                                uint8_t *out_buff,
+                                size_t out_buff_size,
+                                size_t *out_header_size) {
+    return encode_udp(msg, out_buff, out_buff_size, out_header_size, false);
+}
+#    endif // defined(ANJ_NET_WITH_SEND_IOV) ||
+           // defined(ANJ_WITH_IN_PLACE_PAYLOAD)
 #endif // ANJ_COAP_WITH_UDP
 
 #ifdef ANJ_COAP_WITH_TCP
@@ -553,10 +591,12 @@ int _anj_coap_encode_tcp(_anj_coap_msg_t *msg,
     assert(out_buff);
     assert(out_msg_size);
 
-    if (msg->operation == ANJ_OP_COAP_PONG || msg->operation == ANJ_OP_RESPONSE
-            || msg->operation == ANJ_OP_INF_INITIAL_NOTIFY
-            || msg->operation == ANJ_OP_INF_NON_CON_NOTIFY
-            || msg->operation == ANJ_OP_INF_CON_NOTIFY) {
+    if (msg->operation == ANJ_OP_COAP_PONG) {
+        // token of the Ping is reused, it might be empty (RFC 8323 5.4)
+    } else if (msg->operation == ANJ_OP_RESPONSE
+               || msg->operation == ANJ_OP_INF_INITIAL_NOTIFY
+               || msg->operation == ANJ_OP_INF_NON_CON_NOTIFY
+               || msg->operation == ANJ_OP_INF_CON_NOTIFY) {
         // token reuse
         assert(msg->token.size != 0);
     } else if (msg->operation == ANJ_OP_COAP_EMPTY_MSG) {
@@ -603,7 +643,17 @@ int _anj_coap_encode_tcp(_anj_coap_msg_t *msg,
 #endif // ANJ_COAP_WITH_TCP
 
 void _anj_coap_init(uint32_t random_seed) {
-    g_rand_seed = (_anj_rand_seed_t) random_seed;
+    _anj_rand_seed(&g_rand_seed, random_seed);
+#ifdef ANJ_COAP_WITH_SECURE_RNG
+    // PRNG is a fallback for failed anj_rng_generate() calls, don't make it
+    // predictable from the time of initialization if possible
+    _anj_rand_seed_t secure_seed;
+    if (!anj_rng_generate((uint8_t *) secure_seed.s, sizeof(secure_seed.s))
+            && (secure_seed.s[0] | secure_seed.s[1] | secure_seed.s[2]
+                | secure_seed.s[3])) {
+        g_rand_seed = secure_seed;
+    }
+#endif // ANJ_COAP_WITH_SECURE_RNG
     g_anj_msg_id = (uint16_t) _anj_rand32_r(&g_rand_seed);
 }
 
@@ -33,9 +33,11 @@
 #define _ANJ_COAP_OPTION_MAX_AGE           14
 #define _ANJ_COAP_OPTION_URI_QUERY         15
 #define _ANJ_COAP_OPTION_ACCEPT            17
+#define _ANJ_COAP_OPTION_Q_BLOCK1          19
 #define _ANJ_COAP_OPTION_LOCATION_QUERY    20
 #define _ANJ_COAP_OPTION_BLOCK2            23
 #define _ANJ_COAP_OPTION_BLOCK1            27
+#define _ANJ_COAP_OPTION_Q_BLOCK2          31
 #define _ANJ_COAP_OPTION_PROXY_URI         35
 #define _ANJ_COAP_OPTION_PROXY_SCHEME      39
 #define _ANJ_COAP_OPTION_SIZE1             60
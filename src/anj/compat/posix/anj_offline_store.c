@@ -0,0 +1,300 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/compat/offline_store.h>
+#include <anj/log/log.h>
+
+#if defined(ANJ_WITH_OFFLINE_STORE) \
+        && defined(ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT)
+
+#    define store_log(...) anj_log(offline_store, __VA_ARGS__)
+
+/*
+ * File layout:
+ *   - header: magic, capacity, head, used, count (32-bit little endian each),
+ *   - ring buffer of capacity bytes, each entry is prefixed with 32-bit payload
+ *     length and 16-bit content format.
+ * The header is rewritten whenever entries are added or removed, so the entries
+ * it describes are always complete.
+ */
+#    define MAGIC 0x534A4E41UL // "ANJS"
+#    define HEADER_SIZE 20
+#    define ENTRY_HEADER_SIZE 6
+
+static void put_u32(uint8_t *buff, uint32_t value) {
+    for (size_t i = 0; i < 4; i++) {
+        buff[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const uint8_t *buff) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; i++) {
+        value |= (uint32_t) buff[i] << (8 * i);
+    }
+    return value;
+}
+
+static int file_io(anj_offline_store_file_t *ctx,
+                   long position,
+                   void *buff,
+                   size_t length,
+                   bool write) {
+    FILE *file = (FILE *) ctx->file;
+    if (fseek(file, position, SEEK_SET)) {
+        return -1;
+    }
+    size_t result = write ? fwrite(buff, 1, length, file)
+                          : fread(buff, 1, length, file);
+    return result == length ? 0 : -1;
+}
+
+static int ring_io(anj_offline_store_file_t *ctx,
+                   uint32_t position,
+                   void *buff,
+                   size_t length,
+                   bool write) {
+    assert(length <= ctx->capacity);
+    position %= ctx->capacity;
+    size_t first_part = ctx->capacity - position;
+    if (first_part > length) {
+        first_part = length;
+    }
+    if (file_io(ctx, (long) (HEADER_SIZE + position), buff, first_part, write)
+            || (length > first_part
+                && file_io(ctx, HEADER_SIZE, (uint8_t *) buff + first_part,
+                           length - first_part, write))) {
+        store_log(L_ERROR, "File access failed");
+        return -1;
+    }
+    return 0;
+}
+
+static int write_header(anj_offline_store_file_t *ctx) {
+    uint8_t header[HEADER_SIZE];
+    put_u32(&header[0], (uint32_t) MAGIC);
+    put_u32(&header[4], ctx->capacity);
+    put_u32(&header[8], ctx->head);
+    put_u32(&header[12], ctx->used);
+    put_u32(&header[16], ctx->count);
+    if (file_io(ctx, 0, header, sizeof(header), true)
+            || fflush((FILE *) ctx->file)) {
+        store_log(L_ERROR, "Could not write header");
+        return -1;
+    }
+    return 0;
+}
+
+static int read_entry_header(anj_offline_store_file_t *ctx,
+                             uint32_t position,
+                             uint32_t *out_length,
+                             uint16_t *out_format) {
+    uint8_t header[ENTRY_HEADER_SIZE];
+    if (ring_io(ctx, position, header, sizeof(header), false)) {
+        return -1;
+    }
+    *out_length = get_u32(header);
+    *out_format = (uint16_t) (header[4] | (header[5] << 8));
+    return 0;
+}
+
+static int find_entry(anj_offline_store_file_t *ctx,
+                      size_t index,
+                      uint32_t *out_position,
+                      uint32_t *out_length,
+                      uint16_t *out_format) {
+    if (index >= ctx->count) {
+        return ANJ_OFFLINE_STORE_NO_ENTRY;
+    }
+    uint32_t position = ctx->head;
+    for (size_t i = 0;; i++) {
+        if (read_entry_header(ctx, position, out_length, out_format)) {
+            return -1;
+        }
+        if (i == index) {
+            *out_position = position;
+            return 0;
+        }
+        position = (position + ENTRY_HEADER_SIZE + *out_length) % ctx->capacity;
+    }
+}
+
+static int drop_entries(anj_offline_store_file_t *ctx, size_t count) {
+    for (size_t i = 0; i < count && ctx->count; i++) {
+        uint32_t length;
+        uint16_t format;
+        if (read_entry_header(ctx, ctx->head, &length, &format)) {
+            return -1;
+        }
+        ctx->head = (ctx->head + ENTRY_HEADER_SIZE + length) % ctx->capacity;
+        ctx->used -= ENTRY_HEADER_SIZE + length;
+        ctx->count--;
+    }
+    return write_header(ctx);
+}
+
+static int store_begin(void *arg, uint16_t content_format) {
+    anj_offline_store_file_t *ctx = (anj_offline_store_file_t *) arg;
+    int dropped = 0;
+    if (ctx->used + ENTRY_HEADER_SIZE > ctx->capacity) {
+        if (drop_entries(ctx, 1)) {
+            return -1;
+        }
+        dropped++;
+    }
+    ctx->entry_in_progress = true;
+    ctx->entry_start = (ctx->head + ctx->used) % ctx->capacity;
+    ctx->entry_length = 0;
+    ctx->entry_format = content_format;
+    return dropped;
+}
+
+static int store_append(void *arg, const uint8_t *data, size_t length) {
+    anj_offline_store_file_t *ctx = (anj_offline_store_file_t *) arg;
+    assert(ctx->entry_in_progress);
+    if (length > ctx->capacity - ENTRY_HEADER_SIZE - ctx->entry_length) {
+        store_log(L_ERROR, "Entry too large");
+        return -1;
+    }
+    // overwrite the oldest entries if there is not enough space
+    int dropped = 0;
+    while (ctx->used + ENTRY_HEADER_SIZE + ctx->entry_length + length
+           > ctx->capacity) {
+        store_log(L_WARNING, "Store full, dropping the oldest entry");
+        if (drop_entries(ctx, 1)) {
+            return -1;
+        }
+        dropped++;
+    }
+    if (ring_io(ctx, ctx->entry_start + ENTRY_HEADER_SIZE + ctx->entry_length,
+                (void *) (intptr_t) data, length, true)) {
+        return -1;
+    }
+    ctx->entry_length += (uint32_t) length;
+    return dropped;
+}
+
+static int store_end(void *arg, bool commit) {
+    anj_offline_store_file_t *ctx = (anj_offline_store_file_t *) arg;
+    assert(ctx->entry_in_progress);
+    ctx->entry_in_progress = false;
+    if (!commit) {
+        return 0;
+    }
+    uint8_t header[ENTRY_HEADER_SIZE];
+    put_u32(header, ctx->entry_length);
+    header[4] = (uint8_t) ctx->entry_format;
+    header[5] = (uint8_t) (ctx->entry_format >> 8);
+    if (ring_io(ctx, ctx->entry_start, header, sizeof(header), true)) {
+        return -1;
+    }
+    ctx->used += ENTRY_HEADER_SIZE + ctx->entry_length;
+    ctx->count++;
+    return write_header(ctx);
+}
+
+static int store_get_entry(void *arg,
+                           size_t index,
+                           uint16_t *out_content_format,
+                           size_t *out_length) {
+    anj_offline_store_file_t *ctx = (anj_offline_store_file_t *) arg;
+    uint32_t position;
+    uint32_t length;
+    int res = find_entry(ctx, index, &position, &length, out_content_format);
+    if (!res) {
+        *out_length = length;
+    }
+    return res;
+}
+
+static int store_read(
+        void *arg, size_t index, size_t offset, uint8_t *buff, size_t length) {
+    anj_offline_store_file_t *ctx = (anj_offline_store_file_t *) arg;
+    uint32_t position;
+    uint32_t entry_length;
+    uint16_t format;
+    if (find_entry(ctx, index, &position, &entry_length, &format)
+            || offset + length > entry_length) {
+        return -1;
+    }
+    return ring_io(ctx, position + ENTRY_HEADER_SIZE + (uint32_t) offset, buff,
+                   length, false);
+}
+
+static int store_drop(void *arg, size_t count) {
+    return drop_entries((anj_offline_store_file_t *) arg, count);
+}
+
+int anj_offline_store_file_open(anj_offline_store_file_t *ctx,
+                                const char *path,
+                                size_t capacity,
+                                anj_offline_store_t *out_store) {
+    assert(ctx && path && out_store);
+    if (capacity <= ENTRY_HEADER_SIZE || capacity > INT32_MAX - HEADER_SIZE) {
+        store_log(L_ERROR, "Invalid capacity");
+        return -1;
+    }
+    memset(ctx, 0, sizeof(*ctx));
+    FILE *file = fopen(path, "r+b");
+    if (!file) {
+        file = fopen(path, "w+b");
+    }
+    if (!file) {
+        store_log(L_ERROR, "Could not open %s", path);
+        return -1;
+    }
+    ctx->file = file;
+    ctx->capacity = (uint32_t) capacity;
+
+    uint8_t header[HEADER_SIZE];
+    if (!file_io(ctx, 0, header, sizeof(header), false)
+            && get_u32(&header[0]) == MAGIC
+            && get_u32(&header[4]) == ctx->capacity
+            && get_u32(&header[8]) < ctx->capacity
+            && get_u32(&header[12]) <= ctx->capacity) {
+        ctx->head = get_u32(&header[8]);
+        ctx->used = get_u32(&header[12]);
+        ctx->count = get_u32(&header[16]);
+        store_log(L_INFO, "Restored %u stored entries", (unsigned) ctx->count);
+    } else if (write_header(ctx)) {
+        fclose(file);
+        ctx->file = NULL;
+        return -1;
+    }
+
+    *out_store = (anj_offline_store_t) {
+        .begin = store_begin,
+        .append = store_append,
+        .end = store_end,
+        .get_entry = store_get_entry,
+        .read = store_read,
+        .drop = store_drop,
+        .arg = ctx
+    };
+    return 0;
+}
+
+void anj_offline_store_file_close(anj_offline_store_file_t *ctx) {
+    assert(ctx);
+    if (ctx->file) {
+        fclose((FILE *) ctx->file);
+        ctx->file = NULL;
+    }
+}
+
+#endif // defined(ANJ_WITH_OFFLINE_STORE) &&
+       // defined(ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT)
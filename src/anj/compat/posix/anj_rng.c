@@ -0,0 +1,32 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <anj/anj_config.h>
+#include <anj/compat/rng.h>
+
+#if defined(ANJ_COAP_WITH_SECURE_RNG) && defined(ANJ_WITH_RNG_POSIX_COMPAT)
+
+int anj_rng_generate(uint8_t *buffer, size_t size) {
+    FILE *urandom = fopen("/dev/urandom", "rb");
+    if (!urandom) {
+        return -1;
+    }
+    // tokens are small, don't read ahead a whole stdio buffer
+    setvbuf(urandom, NULL, _IONBF, 0);
+    size_t read = fread(buffer, 1, size, urandom);
+    fclose(urandom);
+    return read == size ? 0 : -1;
+}
+
+#endif // defined(ANJ_COAP_WITH_SECURE_RNG) &&
+       // defined(ANJ_WITH_RNG_POSIX_COMPAT)
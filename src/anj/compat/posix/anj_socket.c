@@ -11,6 +11,13 @@
 // IWYU pragma: no_include <bits/socket-constants.h>
 
 #ifdef ANJ_WITH_SOCKET_POSIX_COMPAT
+#    if defined(ANJ_NET_WITH_BATCHED_IO) && defined(__linux__)
+// recvmmsg() and sendmmsg() are Linux extensions
+#        ifndef _GNU_SOURCE
+#            define _GNU_SOURCE
+#        endif
+#        define WITH_MMSG
+#    endif
 // TODO: Instead of defining this, consider providing the option to configure
 // a custom header to add definitions per specific platform, e.g. POSIX or lwIP.
 #    if !defined(_POSIX_C_SOURCE) && !defined(__APPLE__)
@@ -269,11 +276,14 @@ static int create_net_socket(anj_net_ctx_posix_impl_t *ctx, sa_family_t af) {
         return ANJ_NET_ENOMEM;
     }
 
-    /* Always allow for reuse of address */
+    /* Allow for reuse of address of TCP sockets in TIME_WAIT state. It is not
+     * set for UDP sockets, because then the kernel may assign the same
+     * ephemeral port to several sockets connected to the same server. */
     int reuse_addr = 1;
     errno = 0;
-    if (setsockopt(ctx->sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse_addr,
-                   sizeof(reuse_addr))) {
+    if (ctx->sock_type == SOCK_STREAM
+            && setsockopt(ctx->sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse_addr,
+                          sizeof(reuse_addr))) {
         int ret = failure_from_errno();
         net_log(L_ERROR, "Failed to set socket opt");
         net_close_internal(ctx);
@@ -570,12 +580,10 @@ net_connect(anj_net_ctx_t *ctx_, const char *hostname, const char *port_str) {
     return ret;
 }
 
-static int net_send_internal(anj_net_ctx_posix_impl_t *ctx,
-                             size_t *bytes_sent,
-                             const uint8_t *data,
-                             const size_t data_size) {
-    errno = 0;
-    ssize_t result = send(ctx->sockfd, data, data_size, 0);
+static int handle_send_result(anj_net_ctx_posix_impl_t *ctx,
+                              size_t *bytes_sent,
+                              ssize_t result,
+                              const size_t data_size) {
     if (result < 0) {
         return failure_from_errno();
     }
@@ -593,6 +601,15 @@ static int net_send_internal(anj_net_ctx_posix_impl_t *ctx,
     return ANJ_NET_OK;
 }
 
+static int net_send_internal(anj_net_ctx_posix_impl_t *ctx,
+                             size_t *bytes_sent,
+                             const uint8_t *data,
+                             const size_t data_size) {
+    errno = 0;
+    ssize_t result = send(ctx->sockfd, data, data_size, 0);
+    return handle_send_result(ctx, bytes_sent, result, data_size);
+}
+
 static int net_send(anj_net_ctx_t *ctx_,
                     size_t *bytes_sent,
                     const uint8_t *buf,
@@ -614,6 +631,47 @@ static int net_send(anj_net_ctx_t *ctx_,
     return net_send_internal(ctx, bytes_sent, buf, length);
 }
 
+#    ifdef ANJ_NET_WITH_SEND_IOV
+// Upper bound of the number of buffers gathered with a single system call,
+// limits the stack usage
+#        define MAX_IOV_COUNT 8
+
+static int net_send_iov(anj_net_ctx_t *ctx_,
+                        size_t *bytes_sent,
+                        const anj_net_iovec_t *iov,
+                        size_t iov_count) {
+    if (!ctx_) {
+        return ANJ_NET_EBADFD;
+    }
+
+    if (!bytes_sent || !iov || !iov_count || iov_count > MAX_IOV_COUNT) {
+        return ANJ_NET_EINVAL;
+    }
+    *bytes_sent = 0;
+
+    anj_net_ctx_posix_impl_t *ctx = (anj_net_ctx_posix_impl_t *) ctx_;
+    if (ctx->sockfd < 0) {
+        return ANJ_NET_EBADFD;
+    }
+
+    struct iovec iovecs[MAX_IOV_COUNT];
+    size_t data_size = 0;
+    for (size_t i = 0; i < iov_count; i++) {
+        // sendmsg() doesn't modify the data, iovec just isn't const-qualified
+        iovecs[i].iov_base = (void *) (uintptr_t) iov[i].buf;
+        iovecs[i].iov_len = iov[i].length;
+        data_size += iov[i].length;
+    }
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iovecs;
+    msg.msg_iovlen = iov_count;
+    errno = 0;
+    ssize_t result = sendmsg(ctx->sockfd, &msg, 0);
+    return handle_send_result(ctx, bytes_sent, result, data_size);
+}
+#    endif // ANJ_NET_WITH_SEND_IOV
+
 static int net_recv_internal(anj_net_ctx_posix_impl_t *ctx,
                              size_t *bytes_received,
                              uint8_t *data,
@@ -664,6 +722,169 @@ static int net_recv(anj_net_ctx_t *ctx_,
     return net_recv_internal(ctx, bytes_received, buf, length);
 }
 
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+// Upper bound of the number of datagrams handled with a single system call,
+// limits the stack usage
+#        define MAX_BATCH_SIZE 16
+
+// Loop of single datagram calls, used on platforms without recvmmsg() and
+// sendmmsg(), saves nothing but keeps the semantics of the batched API
+static int net_recv_batch_fallback(anj_net_ctx_posix_impl_t *ctx,
+                                   anj_net_datagram_t *datagrams,
+                                   size_t count,
+                                   size_t *out_count) {
+    count = ANJ_MIN(count, MAX_BATCH_SIZE);
+    size_t received = 0;
+    int result = ANJ_NET_OK;
+    while (received < count) {
+        anj_net_datagram_t *datagram = &datagrams[received];
+        result = net_recv_internal(ctx, &datagram->bytes_received,
+                                   datagram->buf, datagram->length);
+        datagram->truncated = result == ANJ_NET_EMSGSIZE;
+        if (result && !datagram->truncated) {
+            break;
+        }
+        received++;
+    }
+    *out_count = received;
+    // error is reported with the next call if some datagrams were received
+    return received ? ANJ_NET_OK : result;
+}
+
+static int net_send_batch_fallback(anj_net_ctx_posix_impl_t *ctx,
+                                   const anj_net_datagram_t *datagrams,
+                                   size_t count,
+                                   size_t *out_count) {
+    count = ANJ_MIN(count, MAX_BATCH_SIZE);
+    size_t sent = 0;
+    int result = ANJ_NET_OK;
+    while (sent < count) {
+        size_t bytes_sent;
+        result = net_send_internal(ctx, &bytes_sent, datagrams[sent].buf,
+                                   datagrams[sent].length);
+        if (result) {
+            break;
+        }
+        sent++;
+    }
+    *out_count = sent;
+    return sent ? ANJ_NET_OK : result;
+}
+
+#        ifdef WITH_MMSG
+static int net_recv_batch_mmsg(anj_net_ctx_posix_impl_t *ctx,
+                               anj_net_datagram_t *datagrams,
+                               size_t count,
+                               size_t *out_count) {
+    struct mmsghdr msgs[MAX_BATCH_SIZE];
+    struct iovec iovecs[MAX_BATCH_SIZE];
+    count = ANJ_MIN(count, MAX_BATCH_SIZE);
+    memset(msgs, 0, count * sizeof(msgs[0]));
+    for (size_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = datagrams[i].buf;
+        iovecs[i].iov_len = datagrams[i].length;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    errno = 0;
+    int result = recvmmsg(ctx->sockfd, msgs, (unsigned int) count, 0, NULL);
+    if (result < 0) {
+        // system call may be unavailable at runtime, e.g. filtered by seccomp
+        if (errno == ENOSYS) {
+            return net_recv_batch_fallback(ctx, datagrams, count, out_count);
+        }
+        return failure_from_errno();
+    }
+    for (size_t i = 0; i < (size_t) result; i++) {
+        datagrams[i].bytes_received = msgs[i].msg_len;
+        datagrams[i].truncated = !!(msgs[i].msg_hdr.msg_flags & MSG_TRUNC);
+        ctx->bytes_received += msgs[i].msg_len;
+    }
+    *out_count = (size_t) result;
+    return ANJ_NET_OK;
+}
+
+static int net_send_batch_mmsg(anj_net_ctx_posix_impl_t *ctx,
+                               const anj_net_datagram_t *datagrams,
+                               size_t count,
+                               size_t *out_count) {
+    struct mmsghdr msgs[MAX_BATCH_SIZE];
+    struct iovec iovecs[MAX_BATCH_SIZE];
+    count = ANJ_MIN(count, MAX_BATCH_SIZE);
+    memset(msgs, 0, count * sizeof(msgs[0]));
+    for (size_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = datagrams[i].buf;
+        iovecs[i].iov_len = datagrams[i].length;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    errno = 0;
+    int result = sendmmsg(ctx->sockfd, msgs, (unsigned int) count, 0);
+    if (result < 0) {
+        if (errno == ENOSYS) {
+            return net_send_batch_fallback(ctx, datagrams, count, out_count);
+        }
+        return failure_from_errno();
+    }
+    for (size_t i = 0; i < (size_t) result; i++) {
+        ctx->bytes_sent += msgs[i].msg_len;
+    }
+    *out_count = (size_t) result;
+    return ANJ_NET_OK;
+}
+#        endif // WITH_MMSG
+
+static int net_recv_batch(anj_net_ctx_t *ctx_,
+                          anj_net_datagram_t *datagrams,
+                          size_t count,
+                          size_t *out_count) {
+    if (!ctx_) {
+        return ANJ_NET_EBADFD;
+    }
+
+    if (!datagrams || !count || !out_count) {
+        return ANJ_NET_EINVAL;
+    }
+    *out_count = 0;
+
+    anj_net_ctx_posix_impl_t *ctx = (anj_net_ctx_posix_impl_t *) ctx_;
+    if (ctx->sockfd < 0) {
+        return ANJ_NET_EBADFD;
+    }
+
+#        ifdef WITH_MMSG
+    return net_recv_batch_mmsg(ctx, datagrams, count, out_count);
+#        else  // WITH_MMSG
+    return net_recv_batch_fallback(ctx, datagrams, count, out_count);
+#        endif // WITH_MMSG
+}
+
+static int net_send_batch(anj_net_ctx_t *ctx_,
+                          const anj_net_datagram_t *datagrams,
+                          size_t count,
+                          size_t *out_count) {
+    if (!ctx_) {
+        return ANJ_NET_EBADFD;
+    }
+
+    if (!datagrams || !count || !out_count) {
+        return ANJ_NET_EINVAL;
+    }
+    *out_count = 0;
+
+    anj_net_ctx_posix_impl_t *ctx = (anj_net_ctx_posix_impl_t *) ctx_;
+    if (ctx->sockfd < 0) {
+        return ANJ_NET_EBADFD;
+    }
+
+#        ifdef WITH_MMSG
+    return net_send_batch_mmsg(ctx, datagrams, count, out_count);
+#        else  // WITH_MMSG
+    return net_send_batch_fallback(ctx, datagrams, count, out_count);
+#        endif // WITH_MMSG
+}
+#    endif // ANJ_NET_WITH_BATCHED_IO
+
 static int net_bind_internal(anj_net_ctx_posix_impl_t *ctx,
                              struct addrinfo **serverinfo,
                              const char *address,
@@ -943,6 +1164,15 @@ int anj_tcp_recv(anj_net_ctx_t *ctx,
     return net_recv(ctx, bytes_received, buf, length);
 }
 
+#        ifdef ANJ_NET_WITH_SEND_IOV
+int anj_tcp_send_iov(anj_net_ctx_t *ctx,
+                     size_t *bytes_sent,
+                     const anj_net_iovec_t *iov,
+                     size_t iov_count) {
+    return net_send_iov(ctx, bytes_sent, iov, iov_count);
+}
+#        endif // ANJ_NET_WITH_SEND_IOV
+
 int anj_tcp_shutdown(anj_net_ctx_t *ctx) {
     return net_shutdown(ctx);
 }
@@ -1004,6 +1234,31 @@ int anj_udp_recv(anj_net_ctx_t *ctx,
     return net_recv(ctx, bytes_received, buf, length);
 }
 
+#        ifdef ANJ_NET_WITH_SEND_IOV
+int anj_udp_send_iov(anj_net_ctx_t *ctx,
+                     size_t *bytes_sent,
+                     const anj_net_iovec_t *iov,
+                     size_t iov_count) {
+    return net_send_iov(ctx, bytes_sent, iov, iov_count);
+}
+#        endif // ANJ_NET_WITH_SEND_IOV
+
+#        ifdef ANJ_NET_WITH_BATCHED_IO
+int anj_udp_recv_batch(anj_net_ctx_t *ctx,
+                       anj_net_datagram_t *datagrams,
+                       size_t count,
+                       size_t *out_count) {
+    return net_recv_batch(ctx, datagrams, count, out_count);
+}
+
+int anj_udp_send_batch(anj_net_ctx_t *ctx,
+                       const anj_net_datagram_t *datagrams,
+                       size_t count,
+                       size_t *out_count) {
+    return net_send_batch(ctx, datagrams, count, out_count);
+}
+#        endif // ANJ_NET_WITH_BATCHED_IO
+
 int anj_udp_shutdown(anj_net_ctx_t *ctx) {
     return net_shutdown(ctx);
 }
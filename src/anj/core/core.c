@@ -38,11 +38,16 @@
 #include "../utils.h"
 #include "core.h"
 #include "core_utils.h"
+#include "in_flight.h"
 #include "reg_session.h"
 #include "register.h"
 #include "server.h"
 #include "server_register.h"
 
+#ifdef ANJ_WITH_LWM2M_SEND
+#    include "lwm2m_send.h"
+#endif // ANJ_WITH_LWM2M_SEND
+
 #ifdef ANJ_WITH_BOOTSTRAP
 #    include "server_bootstrap.h"
 #    define _ANJ_CORE_BOOTSTRAP_DEFAULT_TIMEOUT 247
@@ -110,6 +115,18 @@ int anj_core_init(anj_t *anj, const anj_configuration_t *config) {
     _anj_observe_init(anj);
 #endif // ANJ_WITH_OBSERVE
 
+#ifdef ANJ_WITH_OFFLINE_STORE
+    if (config->offline_store) {
+        const anj_offline_store_t *store = config->offline_store;
+        if (!store->begin || !store->append || !store->end
+                || !store->get_entry || !store->read || !store->drop) {
+            log(L_ERROR, "Offline store handlers not provided");
+            return -1;
+        }
+        anj->offline_store.store = store;
+    }
+#endif // ANJ_WITH_OFFLINE_STORE
+
     if (config->connection_status_cb) {
         anj->conn_status_cb = config->connection_status_cb;
         anj->conn_status_cb_arg = config->connection_status_cb_arg;
@@ -168,39 +185,66 @@ void anj_core_request_update(anj_t *anj) {
     anj->server_state.registration_update_triggered = true;
 }
 
-void _anj_core_data_model_changed_with_ssid(anj_t *anj,
-                                            const anj_uri_path_t *path,
-                                            anj_core_change_type_t change_type,
-                                            uint16_t ssid) {
+static void data_model_changed(anj_t *anj,
+                               const anj_uri_path_t *paths,
+                               size_t paths_count,
+                               anj_core_change_type_t change_type,
+                               uint16_t ssid) {
     // we don't to check the return value of this function
 #ifdef ANJ_WITH_OBSERVE
-    anj_observe_data_model_changed(
-            anj, path, (anj_observe_change_type_t) change_type, ssid);
+    anj_observe_data_model_changed_batch(
+            anj, paths, paths_count, (anj_observe_change_type_t) change_type,
+            ssid);
 #endif // ANJ_WITH_OBSERVE
     if (!_anj_core_client_registered(anj)) {
         return;
     }
-    // check if Server object resources were changed
-    if (change_type == ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED
-            && path->ids[ANJ_ID_OID] == ANJ_OBJ_ID_SERVER) {
+    bool server_obj_changed = false;
+    bool registration_changed = false;
+    for (size_t i = 0; i < paths_count; i++) {
+        // check if Server object resources were changed
+        if (change_type == ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED
+                && paths[i].ids[ANJ_ID_OID] == ANJ_OBJ_ID_SERVER) {
+            server_obj_changed = true;
+        }
+        // check if user added or removed object or object instance
+        if (ssid == 0 && change_type != ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED
+                && !anj_uri_path_has(&paths[i], ANJ_ID_RID)) {
+            registration_changed = true;
+        }
+    }
+    if (server_obj_changed) {
         int64_t last_lifetime = anj->server_instance.lifetime;
         _anj_reg_session_refresh_registration_related_resources(anj);
         if (last_lifetime != anj->server_instance.lifetime) {
             anj->server_state.details.registered.update_with_lifetime = true;
         }
     }
-    // check if user added or removed object or object instance
-    if (ssid == 0 && change_type != ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED
-            && !anj_uri_path_has(path, ANJ_ID_RID)) {
+    if (registration_changed) {
         anj->server_state.details.registered.update_with_payload = true;
     }
 }
 
+void _anj_core_data_model_changed_with_ssid(anj_t *anj,
+                                            const anj_uri_path_t *path,
+                                            anj_core_change_type_t change_type,
+                                            uint16_t ssid) {
+    data_model_changed(anj, path, 1, change_type, ssid);
+}
+
 void anj_core_data_model_changed(anj_t *anj,
                                  const anj_uri_path_t *path,
                                  anj_core_change_type_t change_type) {
     assert(anj && path);
-    _anj_core_data_model_changed_with_ssid(anj, path, change_type, 0);
+    data_model_changed(anj, path, 1, change_type, 0);
+}
+
+void anj_core_data_model_changed_batch(anj_t *anj,
+                                       const anj_uri_path_t *paths,
+                                       size_t paths_count,
+                                       anj_core_change_type_t change_type) {
+    assert(anj && (paths || !paths_count));
+    data_model_changed(anj, paths, paths_count, change_type, 0);
 }
 
 bool anj_core_ongoing_operation(anj_t *anj) {
@@ -368,6 +412,68 @@ uint64_t anj_core_next_step_time(anj_t *anj) {
     return 0;
 }
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+void anj_core_poll_info(anj_t *anj, anj_core_poll_info_t *out_info) {
+    assert(anj && out_info);
+    uint8_t events = 0;
+    uint64_t deadline = 0;
+    if (!_anj_core_client_registered(anj)
+            && _anj_core_state_transition_forced(anj)) {
+        // connection is closed in the next step
+        deadline = 0;
+    } else {
+        switch (anj->server_state.conn_status) {
+#    ifdef ANJ_WITH_BOOTSTRAP
+        case ANJ_CONN_STATUS_BOOTSTRAPPING:
+            deadline = _anj_server_bootstrap_poll_deadline(anj, &events);
+            break;
+#    endif // ANJ_WITH_BOOTSTRAP
+        case ANJ_CONN_STATUS_REGISTERING:
+            deadline = _anj_server_register_poll_deadline(anj, &events);
+            break;
+        case ANJ_CONN_STATUS_REGISTERED:
+        case ANJ_CONN_STATUS_ENTERING_QUEUE_MODE:
+        case ANJ_CONN_STATUS_QUEUE_MODE:
+            deadline = _anj_reg_session_poll_deadline(anj, &events);
+            break;
+        case ANJ_CONN_STATUS_SUSPENDED:
+            deadline = ANJ_MAX(anj->server_state.enable_time_user_triggered,
+                               anj->server_state.enable_time);
+            break;
+        case ANJ_CONN_STATUS_FAILURE:
+            // nothing happens until the client is restarted
+            deadline = ANJ_TIME_UNDEFINED;
+            break;
+        default:
+            break;
+        }
+    }
+
+    out_info->system_socket = NULL;
+    if (events && anj->connection_ctx.net_ctx) {
+        out_info->system_socket =
+                anj_net_get_system_socket(anj->connection_ctx.type,
+                                          anj->connection_ctx.net_ctx);
+    }
+    if (!out_info->system_socket) {
+        // readiness can't be reported, the network layer must be polled
+        if (events) {
+            deadline = 0;
+        }
+        events = 0;
+    }
+    out_info->events = events;
+
+    uint64_t current_time = anj_time_real_now();
+    if (deadline == ANJ_TIME_UNDEFINED) {
+        out_info->timeout_ms = ANJ_TIME_UNDEFINED;
+    } else {
+        out_info->timeout_ms =
+                deadline > current_time ? deadline - current_time : 0;
+    }
+}
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 void anj_core_disable_server(anj_t *anj, uint64_t timeout_ms) {
     assert(anj);
     log(L_INFO, "Disable called");
@@ -384,6 +490,9 @@ void anj_core_disable_server(anj_t *anj, uint64_t timeout_ms) {
         return;
     }
     _anj_exchange_terminate(&anj->exchange_ctx);
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    _anj_in_flight_terminate(anj);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
     anj->server_state.disable_triggered = true;
 }
 
@@ -397,6 +506,9 @@ void anj_core_request_bootstrap(anj_t *anj) {
         return;
     }
     _anj_exchange_terminate(&anj->exchange_ctx);
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    _anj_in_flight_terminate(anj);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
     anj->server_state.bootstrap_request_triggered = true;
 }
 
@@ -408,6 +520,9 @@ void anj_core_restart(anj_t *anj) {
         return;
     }
     _anj_exchange_terminate(&anj->exchange_ctx);
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    _anj_in_flight_terminate(anj);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
     anj->server_state.restart_triggered = true;
 }
 
@@ -417,7 +532,14 @@ int anj_core_shutdown(anj_t *anj) {
     // initiated.
     assert(anj);
     _anj_exchange_terminate(&anj->exchange_ctx);
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    _anj_in_flight_terminate(anj);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
 #ifdef ANJ_WITH_LWM2M_SEND
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    // keep the data that was not sent yet
+    _anj_lwm2m_send_store_queued(anj);
+#    endif // ANJ_WITH_OFFLINE_STORE
     // abort all queued send request to call finish callbacks
     anj_send_abort(anj, ANJ_SEND_ID_ALL);
 #endif // ANJ_WITH_LWM2M_SEND
@@ -13,6 +13,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <anj/compat/time.h>
 #include <anj/core.h>
 #include <anj/defs.h>
 
@@ -53,4 +54,15 @@ bool _anj_core_client_registered(anj_t *anj);
 bool _anj_core_state_transition_forced(anj_t *anj);
 void _anj_core_state_transition_clear(anj_t *anj);
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * Returns the first moment after @p timestamp, for the timers that are checked
+ * with a strict comparison of the current time. @ref ANJ_TIME_UNDEFINED is
+ * returned unchanged.
+ */
+static inline uint64_t _anj_core_time_after(uint64_t timestamp) {
+    return timestamp == ANJ_TIME_UNDEFINED ? timestamp : timestamp + 1;
+}
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 #endif // ANJ_SRC_CORE_CORE_H
@@ -19,6 +19,7 @@
 #include <anj/utils.h>
 
 #include "../dm/dm_io.h"
+#include "../exchange.h"
 #include "../utils.h"
 #include "core_utils.h"
 
@@ -46,11 +47,33 @@ int _anj_server_get_resolved_server_uri(anj_t *anj) {
         // HACK: DTLS is not supported yet
         anj->security_instance.type = ANJ_NET_BINDING_DTLS;
         uri_start += sizeof("coaps://") - 1;
-    } // TODO: implement other schemes
+    }
+#ifdef ANJ_COAP_WITH_TCP
+    else if (strncmp(uri_start, "coap+tcp://", sizeof("coap+tcp://") - 1)
+             == 0) {
+        anj->security_instance.type = ANJ_NET_BINDING_TCP;
+        uri_start += sizeof("coap+tcp://") - 1;
+    } else if (strncmp(uri_start, "coaps+tcp://", sizeof("coaps+tcp://") - 1)
+               == 0) {
+        anj->security_instance.type = ANJ_NET_BINDING_TLS;
+        uri_start += sizeof("coaps+tcp://") - 1;
+    }
+#endif // ANJ_COAP_WITH_TCP
     else {
         log(L_ERROR, "Unsupported URI scheme");
         return -1;
     }
+#ifdef ANJ_COAP_WITH_TCP
+    _anj_exchange_set_reliable_transport(
+            &anj->exchange_ctx,
+            anj->security_instance.type == ANJ_NET_BINDING_TCP
+                    || anj->security_instance.type == ANJ_NET_BINDING_TLS);
+#endif // ANJ_COAP_WITH_TCP
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    // round-trip times measured with the previous LwM2M Server are not
+    // relevant anymore
+    _anj_exchange_reset_rto(&anj->exchange_ctx);
+#endif // ANJ_WITH_ADAPTIVE_RTO
 
     // find uri start
     // if uri contains IPv6 address, it contains many ':'
@@ -0,0 +1,370 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/compat/time.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/log/log.h>
+#include <anj/utils.h>
+
+#ifdef ANJ_WITH_OBSERVE
+#    include "../observe/observe.h"
+#endif // ANJ_WITH_OBSERVE
+
+#include "../coap/coap.h"
+#include "../exchange.h"
+#include "../utils.h"
+#include "core_utils.h"
+#include "in_flight.h"
+#include "server.h"
+
+#ifdef ANJ_WITH_LWM2M_SEND
+#    include "lwm2m_send.h"
+#endif // ANJ_WITH_LWM2M_SEND
+
+#ifdef ANJ_WITH_OFFLINE_STORE
+#    include "offline_store.h"
+#endif // ANJ_WITH_OFFLINE_STORE
+
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+
+#    define IN_FLIGHT_SLOTS (ANJ_EXCHANGE_NSTART - 1)
+
+// Empty ACK consists of the CoAP UDP header only, but encoder requires some
+// additional space
+#    define EMPTY_ACK_BUFFER_SIZE 8
+
+static bool slot_used(const _anj_in_flight_request_t *request) {
+    return request->exchange.op != ANJ_OP_NONE;
+}
+
+static void finish_request(anj_t *anj,
+                           _anj_in_flight_request_t *request,
+                           int result) {
+    _anj_op_t op = request->exchange.op;
+    // free the slot first, handlers below may schedule new requests
+    request->exchange.op = ANJ_OP_NONE;
+
+    switch (op) {
+#    ifdef ANJ_WITH_OBSERVE
+    case ANJ_OP_INF_CON_NOTIFY:
+        if (result) {
+#        ifdef ANJ_WITH_OFFLINE_STORE
+            _anj_offline_store_notification(anj, request->msg,
+                                            request->msg_len,
+                                            request->notification_time);
+#        endif // ANJ_WITH_OFFLINE_STORE
+            _anj_observe_detached_notification_failed(anj, request->ssid,
+                                                      &request->exchange.token);
+        } else {
+            log(L_DEBUG, "Notification acknowledged");
+        }
+        break;
+#    endif // ANJ_WITH_OBSERVE
+#    ifdef ANJ_WITH_LWM2M_SEND
+    case ANJ_OP_INF_CON_SEND:
+        _anj_lwm2m_send_detached_finished(anj, request->send_ids,
+                                          request->send_requests,
+                                          request->send_count, result);
+        break;
+#    endif // ANJ_WITH_LWM2M_SEND
+    default:
+        ANJ_UNREACHABLE("Invalid operation");
+        break;
+    }
+}
+
+// failed send of the single datagram is treated like a lost one, connection
+// related errors are detected by the main exchange
+static void send_msg(anj_t *anj, const uint8_t *msg, size_t msg_len) {
+    int res = _anj_server_send(&anj->connection_ctx, msg, msg_len);
+    if (res) {
+        log(L_WARNING, "Could not send message: %d", res);
+        anj->connection_ctx.bytes_sent = 0;
+        anj->connection_ctx.send_in_progress = false;
+    }
+}
+
+static void send_empty_ack(anj_t *anj, const _anj_coap_msg_t *msg) {
+    _anj_coap_msg_t ack;
+    memset(&ack, 0, sizeof(ack));
+    ack.operation = ANJ_OP_COAP_EMPTY_MSG;
+    ack.coap_binding_data.udp.message_id = msg->coap_binding_data.udp.message_id;
+
+    uint8_t buff[EMPTY_ACK_BUFFER_SIZE];
+    size_t msg_len;
+    int res = _anj_coap_encode_udp(&ack, buff, sizeof(buff), &msg_len);
+    if (res) {
+        ANJ_CORE_LOG_COAP_ERROR(res);
+        return;
+    }
+    send_msg(anj, buff, msg_len);
+}
+
+#    ifdef ANJ_WITH_OBSERVE
+// Notification of the same observation which is still being retransmitted
+// carries an older value, so the new one takes its place (RFC 7641 4.5.2)
+static _anj_in_flight_request_t *find_replaced_notification(anj_t *anj) {
+    const _anj_coap_msg_t *msg = &anj->exchange_ctx.base_msg;
+    if (msg->operation != ANJ_OP_INF_CON_NOTIFY) {
+        return NULL;
+    }
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        _anj_in_flight_request_t *request = &anj->in_flight[i];
+        if (request->exchange.op == ANJ_OP_INF_CON_NOTIFY
+                && request->ssid == anj->server_instance.ssid
+                && _anj_tokens_equal(&request->exchange.token, &msg->token)) {
+            return request;
+        }
+    }
+    return NULL;
+}
+#    endif // ANJ_WITH_OBSERVE
+
+bool _anj_in_flight_detach(anj_t *anj) {
+    assert(anj);
+    if (!_anj_exchange_can_detach(&anj->exchange_ctx)) {
+        return false;
+    }
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    // delivery of stored entries is not related to the Send queue
+    if (anj->offline_store.flush_in_progress) {
+        return false;
+    }
+#    endif // ANJ_WITH_OFFLINE_STORE
+    _anj_in_flight_request_t *request = NULL;
+#    ifdef ANJ_WITH_OBSERVE
+    _anj_in_flight_request_t *replaced = find_replaced_notification(anj);
+    _anj_exchange_in_flight_t replaced_exchange;
+    if (replaced) {
+        replaced_exchange = replaced->exchange;
+        request = replaced;
+    }
+#    endif // ANJ_WITH_OBSERVE
+    for (size_t i = 0; !request && i < IN_FLIGHT_SLOTS; i++) {
+        if (!slot_used(&anj->in_flight[i])) {
+            request = &anj->in_flight[i];
+        }
+    }
+    if (!request) {
+        return false;
+    }
+
+    // message ID of notification is assigned during encoding, so it is taken
+    // from the header of the message that was actually sent (RFC 7252 3)
+    assert(anj->out_msg_len >= 4);
+    const uint8_t *out_msg = _anj_server_out_msg(anj);
+    uint16_t message_id = (uint16_t) ((out_msg[2] << 8) | out_msg[3]);
+    _anj_exchange_detach(&anj->exchange_ctx, message_id, &request->exchange);
+    _anj_server_copy_out_msg(anj, request->msg);
+    request->msg_len = anj->out_msg_len;
+#    ifdef ANJ_WITH_OBSERVE
+    if (replaced) {
+        // older notification is not retransmitted anymore, the new one is
+        // retransmitted as if it was the older one
+        request->exchange.retry_count = replaced_exchange.retry_count;
+        request->exchange.timeout_ms = replaced_exchange.timeout_ms;
+        request->exchange.timeout_timestamp_ms =
+                replaced_exchange.timeout_timestamp_ms;
+        log(L_DEBUG,
+            "Notification with message ID %" PRIu16 " replaced by a newer one",
+            replaced_exchange.message_id);
+    }
+#    endif // ANJ_WITH_OBSERVE
+
+    switch (request->exchange.op) {
+#    ifdef ANJ_WITH_OBSERVE
+    case ANJ_OP_INF_CON_NOTIFY:
+        request->ssid = anj->server_instance.ssid;
+#        ifdef ANJ_WITH_OFFLINE_STORE
+        request->notification_time = anj->offline_store.notification_time;
+#        endif // ANJ_WITH_OFFLINE_STORE
+        _anj_observe_notification_detached(anj);
+        break;
+#    endif // ANJ_WITH_OBSERVE
+#    ifdef ANJ_WITH_LWM2M_SEND
+    case ANJ_OP_INF_CON_SEND:
+        request->send_count = _anj_lwm2m_send_detach(anj, request->send_ids,
+                                                     request->send_requests);
+        break;
+#    endif // ANJ_WITH_LWM2M_SEND
+    default:
+        ANJ_UNREACHABLE("Invalid operation");
+        break;
+    }
+    log(L_DEBUG, "Request with message ID %" PRIu16 " moved to in-flight slot",
+        message_id);
+    return true;
+}
+
+bool _anj_in_flight_handle_msg(anj_t *anj, const _anj_coap_msg_t *msg) {
+    assert(anj && msg);
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        _anj_in_flight_request_t *request = &anj->in_flight[i];
+        if (!slot_used(request)) {
+            continue;
+        }
+        int result = 0;
+        _anj_exchange_in_flight_state_t state =
+                _anj_exchange_in_flight_handle_msg(&anj->exchange_ctx,
+                                                   &request->exchange, msg,
+                                                   &result);
+        if (state == _ANJ_EXCHANGE_IN_FLIGHT_NOT_MATCHED) {
+            continue;
+        }
+        if (state == _ANJ_EXCHANGE_IN_FLIGHT_FINISHED) {
+            // there are no message types in CoAP over TCP
+            if (msg->operation == ANJ_OP_RESPONSE
+                    && !_anj_server_reliable_transport(&anj->connection_ctx)
+                    && msg->coap_binding_data.udp.type
+                                   == ANJ_COAP_UDP_TYPE_CONFIRMABLE) {
+                send_empty_ack(anj, msg);
+            }
+            finish_request(anj, request, result);
+        }
+        return true;
+    }
+    return false;
+}
+
+void _anj_in_flight_process(anj_t *anj) {
+    assert(anj);
+    if (anj->connection_ctx.send_in_progress) {
+        return;
+    }
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+    // due retransmissions are sent together, and timed out requests are
+    // finished afterwards, because their handlers may reuse the slots
+    anj_net_datagram_t retransmissions[IN_FLIGHT_SLOTS];
+    size_t retransmissions_count = 0;
+    _anj_in_flight_request_t *timed_out[IN_FLIGHT_SLOTS];
+    size_t timed_out_count = 0;
+#    endif // ANJ_NET_WITH_BATCHED_IO
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        _anj_in_flight_request_t *request = &anj->in_flight[i];
+        if (!slot_used(request)) {
+            continue;
+        }
+        _anj_exchange_in_flight_state_t state =
+                _anj_exchange_in_flight_process(&anj->exchange_ctx,
+                                                &request->exchange);
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+        if (state == _ANJ_EXCHANGE_IN_FLIGHT_RETRANSMIT) {
+            retransmissions[retransmissions_count++] = (anj_net_datagram_t) {
+                .buf = request->msg,
+                .length = request->msg_len
+            };
+        } else if (state == _ANJ_EXCHANGE_IN_FLIGHT_FINISHED) {
+            timed_out[timed_out_count++] = request;
+        }
+#    else  // ANJ_NET_WITH_BATCHED_IO
+        if (state == _ANJ_EXCHANGE_IN_FLIGHT_RETRANSMIT) {
+            send_msg(anj, request->msg, request->msg_len);
+        } else if (state == _ANJ_EXCHANGE_IN_FLIGHT_FINISHED) {
+            finish_request(anj, request, _ANJ_EXCHANGE_ERROR_TIMEOUT);
+        }
+#    endif // ANJ_NET_WITH_BATCHED_IO
+    }
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+    if (retransmissions_count) {
+        int res = _anj_server_send_batch(&anj->connection_ctx, retransmissions,
+                                         retransmissions_count);
+        if (res) {
+            // not sent datagrams are treated like lost ones
+            log(L_WARNING, "Could not send retransmissions: %d", res);
+        }
+    }
+    for (size_t i = 0; i < timed_out_count; i++) {
+        finish_request(anj, timed_out[i], _ANJ_EXCHANGE_ERROR_TIMEOUT);
+    }
+#    endif // ANJ_NET_WITH_BATCHED_IO
+}
+
+bool _anj_in_flight_pending(anj_t *anj) {
+    assert(anj);
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        if (slot_used(&anj->in_flight[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+uint64_t _anj_in_flight_deadline(anj_t *anj) {
+    assert(anj);
+    uint64_t deadline = ANJ_TIME_UNDEFINED;
+    if (anj->connection_ctx.send_in_progress) {
+        return deadline;
+    }
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        if (slot_used(&anj->in_flight[i])) {
+            deadline = ANJ_MIN(deadline,
+                               anj->in_flight[i].exchange.timeout_timestamp_ms);
+        }
+    }
+    return deadline;
+}
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
+void _anj_in_flight_terminate(anj_t *anj) {
+    assert(anj);
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        if (slot_used(&anj->in_flight[i])) {
+            finish_request(anj, &anj->in_flight[i],
+                           _ANJ_EXCHANGE_ERROR_TERMINATED);
+        }
+    }
+}
+
+#    ifdef ANJ_WITH_LWM2M_SEND
+bool _anj_in_flight_abort_send(anj_t *anj, uint16_t send_id) {
+    assert(anj);
+    bool found = false;
+    for (size_t i = 0; i < IN_FLIGHT_SLOTS; i++) {
+        _anj_in_flight_request_t *request = &anj->in_flight[i];
+        if (request->exchange.op != ANJ_OP_INF_CON_SEND) {
+            continue;
+        }
+        if (send_id == ANJ_SEND_ID_ALL) {
+            finish_request(anj, request, _ANJ_EXCHANGE_ERROR_TERMINATED);
+            found = true;
+            continue;
+        }
+        for (size_t j = 0; j < request->send_count; j++) {
+            if (request->send_ids[j] != send_id) {
+                continue;
+            }
+            const anj_send_request_t *send_request = request->send_requests[j];
+            // the message is still retransmitted if it carries other requests
+            for (size_t k = j + 1; k < request->send_count; k++) {
+                request->send_ids[k - 1] = request->send_ids[k];
+                request->send_requests[k - 1] = request->send_requests[k];
+            }
+            if (!--request->send_count) {
+                request->exchange.op = ANJ_OP_NONE;
+            }
+            _anj_lwm2m_send_detached_finished(anj, &send_id, &send_request, 1,
+                                              _ANJ_EXCHANGE_ERROR_TERMINATED);
+            return true;
+        }
+    }
+    return found;
+}
+#    endif // ANJ_WITH_LWM2M_SEND
+
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
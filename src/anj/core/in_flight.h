@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef ANJ_SRC_CORE_IN_FLIGHT_H
+#define ANJ_SRC_CORE_IN_FLIGHT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <anj/anj_config.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+
+#include "../coap/coap.h"
+#include "../exchange.h"
+
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+
+/**
+ * Moves the ongoing confirmable Notify or Send exchange, which was already sent
+ * and is waiting for the response, to a free in-flight slot, so that the next
+ * exchange can be started. The message stored in anj->out_buffer is copied for
+ * the purpose of retransmissions.
+ *
+ * If a confirmable Notify of the same observation is already in flight, the new
+ * one replaces it in its slot and takes over its retransmission counter and
+ * timeout, so only the newest value is retransmitted (RFC 7641 4.5.2).
+ *
+ * @param anj  Anjay object to operate on.
+ *
+ * @returns True if the exchange was detached, false if it is not possible or
+ *          there is no free slot.
+ */
+bool _anj_in_flight_detach(anj_t *anj);
+
+/**
+ * Checks if the incoming message is related to any of the in-flight requests
+ * and handles it, including sending an empty ACK for confirmable separate
+ * responses.
+ *
+ * @param anj  Anjay object to operate on.
+ * @param msg  Decoded incoming message.
+ *
+ * @returns True if the message was consumed and must not be processed further.
+ */
+bool _anj_in_flight_handle_msg(anj_t *anj, const _anj_coap_msg_t *msg);
+
+/**
+ * Handles retransmissions and timeouts of in-flight requests. Does nothing if
+ * any message is being sent at the moment.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_in_flight_process(anj_t *anj);
+
+/**
+ * @param anj  Anjay object to operate on.
+ *
+ * @returns True if any in-flight request awaits the response.
+ */
+bool _anj_in_flight_pending(anj_t *anj);
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * @param anj  Anjay object to operate on.
+ *
+ * @returns Time of the nearest retransmission or timeout of in-flight requests,
+ *          as returned by @ref anj_time_real_now, or @ref ANJ_TIME_UNDEFINED if
+ *          there is none or they are postponed until the message being sent at
+ *          the moment is sent.
+ */
+uint64_t _anj_in_flight_deadline(anj_t *anj);
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
+/**
+ * Terminates all in-flight requests. Related Send requests are finished with
+ * @ref ANJ_SEND_ERR_ABORT result.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_in_flight_terminate(anj_t *anj);
+
+#    ifdef ANJ_WITH_LWM2M_SEND
+/**
+ * Terminates in-flight Send request with given ID, or all Send requests if
+ * @p send_id is @ref ANJ_SEND_ID_ALL.
+ *
+ * @param anj      Anjay object to operate on.
+ * @param send_id  ID of the Send request.
+ *
+ * @returns True if any request was terminated.
+ */
+bool _anj_in_flight_abort_send(anj_t *anj, uint16_t send_id);
+#    endif // ANJ_WITH_LWM2M_SEND
+
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
+#endif // ANJ_SRC_CORE_IN_FLIGHT_H
@@ -25,10 +25,27 @@
 #include "../utils.h"
 #include "core.h"
 #include "core_utils.h"
+#include "in_flight.h"
 #include "lwm2m_send.h"
+#include "offline_store.h"
+#include "server.h"
 
 #ifdef ANJ_WITH_LWM2M_SEND
 
+uint16_t _anj_lwm2m_send_content_format(const anj_send_request_t *request) {
+#    if defined(ANJ_WITH_SENML_CBOR) && defined(ANJ_WITH_LWM2M_CBOR)
+    return request->content_format == ANJ_SEND_CONTENT_FORMAT_SENML_CBOR
+                   ? _ANJ_COAP_FORMAT_SENML_CBOR
+                   : _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
+#    elif defined(ANJ_WITH_SENML_CBOR)
+    (void) request;
+    return _ANJ_COAP_FORMAT_SENML_CBOR;
+#    elif defined(ANJ_WITH_LWM2M_CBOR)
+    (void) request;
+    return _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
+#    endif
+}
+
 int anj_send_new_request(anj_t *anj,
                          const anj_send_request_t *send_request,
                          uint16_t *out_send_id) {
@@ -58,6 +75,11 @@ int anj_send_new_request(anj_t *anj,
 #    endif // ANJ_WITH_LWM2M_CBOR
     }
     if (!_anj_core_client_registered(anj)) {
+#    ifdef ANJ_WITH_OFFLINE_STORE
+        if (!_anj_offline_store_send_request(anj, send_request)) {
+            return ANJ_SEND_STORED;
+        }
+#    endif // ANJ_WITH_OFFLINE_STORE
         log(L_ERROR, "Client not registered");
         return ANJ_SEND_ERR_NOT_ALLOWED;
     }
@@ -107,6 +129,16 @@ int anj_send_abort(anj_t *anj, uint16_t send_id) {
         log(L_ERROR, "Abort already in progress");
         return ANJ_SEND_ERR_ABORT;
     }
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    // requests that were already sent are no longer in the queue
+    ctx->abort_in_progress = true;
+    bool in_flight_aborted = _anj_in_flight_abort_send(anj, send_id);
+    ctx->abort_in_progress = false;
+    if (in_flight_aborted && send_id != ANJ_SEND_ID_ALL) {
+        log(L_INFO, "Aborted in-flight Send request");
+        return 0;
+    }
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
     if (!ctx->ids[0]) {
         // If the first element is empty then the whole Send queue empty,
         // nothing to do
@@ -116,15 +148,38 @@ int anj_send_abort(anj_t *anj, uint16_t send_id) {
     // exchange, if all requests are to be aborted, terminate the active
     // exchange only if it is Send request (active_exchange is set)
     if (ctx->active_exchange
-            && (send_id == ANJ_SEND_ID_ALL || send_id == ctx->ids[0])) {
+            && (send_id == ANJ_SEND_ID_ALL || send_id == ctx->ids[0])
+            && ctx->requests_in_msg == 1) {
         // active exchange will be cleared in send_completion_callback
+#    ifdef ANJ_WITH_OFFLINE_STORE
+        ctx->user_abort = true;
+#    endif // ANJ_WITH_OFFLINE_STORE
         _anj_exchange_terminate(&anj->exchange_ctx);
+#    ifdef ANJ_WITH_OFFLINE_STORE
+        ctx->user_abort = false;
+#    endif // ANJ_WITH_OFFLINE_STORE
         log(L_INFO, "Aborted active Send request");
         // clear other requests if no specific ID is given
         if (send_id != ANJ_SEND_ID_ALL) {
             return 0;
         }
     }
+#    ifdef ANJ_LWM2M_SEND_WITH_COALESCING
+    else if (ctx->active_exchange) {
+        bool in_active_msg = send_id == ANJ_SEND_ID_ALL;
+        for (size_t i = 0; i < ctx->requests_in_msg; i++) {
+            in_active_msg = in_active_msg || ctx->ids[i] == send_id;
+        }
+        if (in_active_msg) {
+            // other requests merged into the same message stay in the queue
+            // and will be sent again, the aborted one is removed below
+            ctx->requeue_active = true;
+            _anj_exchange_terminate(&anj->exchange_ctx);
+            ctx->requeue_active = false;
+            log(L_INFO, "Aborted active Send message");
+        }
+    }
+#    endif // ANJ_LWM2M_SEND_WITH_COALESCING
 
     if (send_id == ANJ_SEND_ID_ALL) {
         ctx->abort_in_progress = true;
@@ -182,21 +237,30 @@ static uint8_t send_read_payload(void *arg_ptr,
 
     while (true) {
         if (!ctx->data_to_copy) {
-            res = _anj_io_out_ctx_new_entry(
-                    &anj->anj_io.out_ctx,
-                    &ctx->requests_queue[0]->records[ctx->op_count++]);
-            if (res) {
-                log(L_ERROR, "anj_io out ctx error %d", res);
-                return ANJ_COAP_CODE_INTERNAL_SERVER_ERROR;
+            if (ctx->op_count
+                    == ctx->requests_queue[ctx->request_idx]->records_cnt) {
+                // continue with records of the next merged request
+                ctx->request_idx++;
+                ctx->op_count = 0;
+                assert(ctx->request_idx < ctx->requests_in_msg);
             }
+            res = _anj_io_out_ctx_add_entry(
+                    &anj->anj_io.out_ctx,
+                    &ctx->requests_queue[ctx->request_idx]
+                             ->records[ctx->op_count++],
+                    &buff[out_params->payload_len],
+                    buff_len - out_params->payload_len, &copied_bytes);
+        } else {
+            res = _anj_io_out_ctx_get_payload(
+                    &anj->anj_io.out_ctx, &buff[out_params->payload_len],
+                    buff_len - out_params->payload_len, &copied_bytes);
         }
-        res = _anj_io_out_ctx_get_payload(&anj->anj_io.out_ctx,
-                                          &buff[out_params->payload_len],
-                                          buff_len - out_params->payload_len,
-                                          &copied_bytes);
         out_params->payload_len += copied_bytes;
         // last record copied
-        if (res == 0 && ctx->op_count == ctx->requests_queue[0]->records_cnt) {
+        if (res == 0 && ctx->request_idx + 1 == ctx->requests_in_msg
+                && ctx->op_count
+                               == ctx->requests_queue[ctx->request_idx]
+                                          ->records_cnt) {
             return 0;
         }
         if (res == ANJ_IO_NEED_NEXT_CALL) {
@@ -215,6 +279,79 @@ static uint8_t send_read_payload(void *arg_ptr,
     }
 }
 
+static int get_send_result(uint16_t send_id, int result) {
+    if (!result) {
+        log(L_INFO, "Send request completed successfully: %" PRIu16, send_id);
+        return ANJ_SEND_SUCCESS;
+    } else if (result == _ANJ_EXCHANGE_ERROR_TERMINATED) {
+        log(L_ERROR, "Send request terminated: %" PRIu16, send_id);
+        return ANJ_SEND_ERR_ABORT;
+    } else if (result == _ANJ_EXCHANGE_ERROR_TIMEOUT) {
+        log(L_DEBUG, "Send request timeout: %" PRIu16, send_id);
+        return ANJ_SEND_ERR_TIMEOUT;
+    }
+    log(L_ERROR, "Send request failed: %" PRIu16 " with %" PRIu8 " error code",
+        send_id, result);
+    return ANJ_SEND_ERR_REJECTED;
+}
+
+static void clear_active_exchange(_anj_send_ctx_t *ctx) {
+    ctx->active_exchange = false;
+    ctx->requests_in_msg = 0;
+    ctx->data_to_copy = false;
+    ctx->request_idx = 0;
+    ctx->op_count = 0;
+}
+
+// Removes requests sent in the active exchange from the queue, their IDs and
+// pointers are stored in out_ids and out_requests.
+static size_t remove_active_requests(_anj_send_ctx_t *ctx,
+                                     uint16_t *out_ids,
+                                     const anj_send_request_t **out_requests) {
+    size_t count = ctx->requests_in_msg;
+    assert(count > 0 && count <= ANJ_LWM2M_SEND_QUEUE_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        out_ids[i] = ctx->ids[i];
+        out_requests[i] = ctx->requests_queue[i];
+    }
+    // move all index and free the last ones
+    for (size_t i = count; i < ANJ_LWM2M_SEND_QUEUE_SIZE; i++) {
+        ctx->requests_queue[i - count] = ctx->requests_queue[i];
+        ctx->ids[i - count] = ctx->ids[i];
+    }
+    for (size_t i = ANJ_LWM2M_SEND_QUEUE_SIZE - count;
+         i < ANJ_LWM2M_SEND_QUEUE_SIZE;
+         i++) {
+        ctx->ids[i] = 0;
+    }
+    clear_active_exchange(ctx);
+    return count;
+}
+
+static void call_finished_handlers(anj_t *anj,
+                                   const uint16_t *ids,
+                                   const anj_send_request_t *const *requests,
+                                   size_t count,
+                                   int result) {
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    // message was not delivered, unless the user aborted it
+    bool store = result == _ANJ_EXCHANGE_ERROR_TIMEOUT
+                 || (result == _ANJ_EXCHANGE_ERROR_TERMINATED
+                     && !anj->send_ctx.abort_in_progress
+                     && !anj->send_ctx.user_abort);
+#    endif // ANJ_WITH_OFFLINE_STORE
+    for (size_t i = 0; i < count; i++) {
+        int send_result = get_send_result(ids[i], result);
+#    ifdef ANJ_WITH_OFFLINE_STORE
+        if (store && !_anj_offline_store_send_request(anj, requests[i])) {
+            send_result = ANJ_SEND_STORED;
+        }
+#    endif // ANJ_WITH_OFFLINE_STORE
+        requests[i]->finished_handler(anj, ids[i], send_result,
+                                      requests[i]->data);
+    }
+}
+
 static void send_completion_callback(void *arg_ptr,
                                      const _anj_coap_msg_t *response,
                                      int result) {
@@ -223,28 +360,11 @@ static void send_completion_callback(void *arg_ptr,
     _anj_send_ctx_t *ctx = &anj->send_ctx;
     assert(ctx->active_exchange);
 
-    int send_result;
-    if (!result) {
-        log(L_INFO, "Send request completed successfully: %" PRIu16,
-            ctx->ids[0]);
-        send_result = ANJ_SEND_SUCCESS;
-    } else if (result == _ANJ_EXCHANGE_ERROR_TERMINATED) {
-        log(L_ERROR, "Send request terminated: %" PRIu16, ctx->ids[0]);
-        send_result = ANJ_SEND_ERR_ABORT;
-    } else if (result == _ANJ_EXCHANGE_ERROR_TIMEOUT) {
-        log(L_DEBUG, "Send request timeout: %" PRIu16, ctx->ids[0]);
-        send_result = ANJ_SEND_ERR_TIMEOUT;
-    } else {
-        log(L_ERROR,
-            "Send request failed: %" PRIu16 " with %" PRIu8 " error code",
-            ctx->ids[0], result);
-        send_result = ANJ_SEND_ERR_REJECTED;
-    }
-
 #    ifdef ANJ_WITH_EXTERNAL_DATA
     if (ctx->op_count != 0) {
         const anj_io_out_entry_t *record =
-                &ctx->requests_queue[0]->records[ctx->op_count - 1];
+                &ctx->requests_queue[ctx->request_idx]
+                         ->records[ctx->op_count - 1];
         if (result != 0 && (record->type & ANJ_DATA_TYPE_FLAG_EXTERNAL)
                 && ctx->data_to_copy) {
             _anj_io_out_ctx_close_external_data_cb(record);
@@ -252,24 +372,142 @@ static void send_completion_callback(void *arg_ptr,
     }
 #    endif // ANJ_WITH_EXTERNAL_DATA
 
-    void *user_data = ctx->requests_queue[0]->data;
-    uint16_t send_id = ctx->ids[0];
-    anj_send_finished_handler_t *finished_handler =
-            ctx->requests_queue[0]->finished_handler;
-    // first move all index and free the last one..
-    for (size_t i = 1; i < ANJ_LWM2M_SEND_QUEUE_SIZE; i++) {
-        ctx->requests_queue[i - 1] = ctx->requests_queue[i];
-        ctx->ids[i - 1] = ctx->ids[i];
+#    ifdef ANJ_LWM2M_SEND_WITH_COALESCING
+    if (ctx->requeue_active) {
+        clear_active_exchange(ctx);
+        return;
     }
-    ctx->ids[ANJ_LWM2M_SEND_QUEUE_SIZE - 1] = 0;
+#    endif // ANJ_LWM2M_SEND_WITH_COALESCING
 
-    ctx->active_exchange = false;
-    ctx->data_to_copy = false;
-    ctx->op_count = 0;
+    uint16_t ids[ANJ_LWM2M_SEND_QUEUE_SIZE];
+    const anj_send_request_t *requests[ANJ_LWM2M_SEND_QUEUE_SIZE];
+    // first remove the requests from the queue..
+    size_t count = remove_active_requests(ctx, ids, requests);
+    // ..then call the finished handlers
+    call_finished_handlers(anj, ids, requests, count, result);
+}
 
-    // ..then call the finished handler
-    finished_handler(anj, send_id, send_result, user_data);
+#    ifdef ANJ_WITH_OFFLINE_STORE
+void _anj_lwm2m_send_store_queued(anj_t *anj) {
+    assert(anj);
+    _anj_send_ctx_t *ctx = &anj->send_ctx;
+    // requests of the active exchange are stored when it is finished
+    size_t first = ctx->active_exchange ? ctx->requests_in_msg : 0;
+    size_t kept = first;
+    for (size_t i = first; i < ANJ_LWM2M_SEND_QUEUE_SIZE && ctx->ids[i]; i++) {
+        uint16_t id = ctx->ids[i];
+        const anj_send_request_t *request = ctx->requests_queue[i];
+        if (_anj_offline_store_send_request(anj, request)) {
+            ctx->ids[kept] = id;
+            ctx->requests_queue[kept++] = request;
+            continue;
+        }
+        ctx->ids[i] = 0;
+        log(L_INFO, "Send request with ID: %" PRIu16 " stored", id);
+        request->finished_handler(anj, id, ANJ_SEND_STORED, request->data);
+    }
+    for (size_t i = kept; i < ANJ_LWM2M_SEND_QUEUE_SIZE; i++) {
+        ctx->ids[i] = 0;
+    }
 }
+#    endif // ANJ_WITH_OFFLINE_STORE
+
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+size_t _anj_lwm2m_send_detach(anj_t *anj,
+                              uint16_t *out_ids,
+                              const anj_send_request_t **out_requests) {
+    assert(anj && out_ids && out_requests);
+    _anj_send_ctx_t *ctx = &anj->send_ctx;
+    assert(ctx->active_exchange);
+    return remove_active_requests(ctx, out_ids, out_requests);
+}
+
+void _anj_lwm2m_send_detached_finished(anj_t *anj,
+                                       const uint16_t *ids,
+                                       const anj_send_request_t *const *requests,
+                                       size_t count,
+                                       int result) {
+    assert(anj && ids && requests);
+    call_finished_handlers(anj, ids, requests, count, result);
+}
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
+#    ifdef ANJ_LWM2M_SEND_WITH_COALESCING
+// Upper bound of the SenML CBOR record size without the value: map header,
+// name with the longest possible path, time and value labels
+#        define RECORD_MAX_OVERHEAD 40
+// Upper bound of any encoded value other than bytes and string
+#        define RECORD_MAX_VALUE_SIZE 16
+// Upper bound of the SenML CBOR array header
+#        define PAYLOAD_MAX_HEADER_SIZE 5
+
+// Returns 0 if the size of the request cannot be estimated.
+static size_t request_max_size(const anj_send_request_t *request) {
+    size_t size = 0;
+    for (size_t i = 0; i < request->records_cnt; i++) {
+        const anj_io_out_entry_t *record = &request->records[i];
+#        ifdef ANJ_WITH_EXTERNAL_DATA
+        if (record->type & ANJ_DATA_TYPE_FLAG_EXTERNAL) {
+            return 0;
+        }
+#        endif // ANJ_WITH_EXTERNAL_DATA
+        size_t value_size = RECORD_MAX_VALUE_SIZE;
+        if (record->type == ANJ_DATA_TYPE_BYTES
+                || record->type == ANJ_DATA_TYPE_STRING) {
+            const anj_bytes_or_string_value_t *value =
+                    &record->value.bytes_or_string;
+            value_size += value->chunk_length;
+            if (record->type == ANJ_DATA_TYPE_STRING && value->data
+                    && !value->chunk_length && !value->full_length_hint) {
+                value_size += strlen((const char *) value->data);
+            }
+        }
+        size += RECORD_MAX_OVERHEAD + value_size;
+    }
+    return size;
+}
+
+// Returns the number of requests, starting from the first one in the queue,
+// that will be sent in a single message. Requests are merged only if they use
+// SenML CBOR, do not contain external data and all of them fit in a single
+// block. LwM2M CBOR is never merged because records of separate requests could
+// produce duplicated keys of the nested maps.
+static size_t
+requests_to_coalesce(anj_t *anj, _anj_coap_msg_t *msg, uint16_t format) {
+    _anj_send_ctx_t *ctx = &anj->send_ctx;
+    size_t payload_size;
+    if (format != _ANJ_COAP_FORMAT_SENML_CBOR
+            || _anj_server_calculate_max_payload_size(
+                       &anj->connection_ctx, msg, ANJ_OUT_PAYLOAD_BUFFER_SIZE,
+                       ANJ_OUT_MSG_BUFFER_SIZE, false, &payload_size)) {
+        return 1;
+    }
+    // if the message does not fit in a single block, it will be sent with
+    // block transfer, and only the first block size is taken into account
+    payload_size = _anj_determine_block_buffer_size(payload_size);
+
+    size_t total_size = PAYLOAD_MAX_HEADER_SIZE;
+    size_t count = 0;
+    while (count < ANJ_LWM2M_SEND_QUEUE_SIZE && ctx->ids[count] != 0
+           && ctx->requests_queue[count]->content_format
+                      == ctx->requests_queue[0]->content_format) {
+        size_t request_size = request_max_size(ctx->requests_queue[count]);
+        if (!request_size || total_size + request_size > payload_size) {
+            break;
+        }
+        total_size += request_size;
+        count++;
+    }
+    return count ? count : 1;
+}
+#    endif // ANJ_LWM2M_SEND_WITH_COALESCING
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+bool _anj_lwm2m_send_pending(anj_t *anj) {
+    assert(anj);
+    return anj->send_ctx.ids[0] != 0 && !anj->send_ctx.active_exchange;
+}
+#    endif // ANJ_WITH_CORE_POLL_INFO
 
 void _anj_lwm2m_send_process(anj_t *anj,
                              _anj_exchange_handlers_t *out_handlers,
@@ -292,22 +530,27 @@ void _anj_lwm2m_send_process(anj_t *anj,
         return;
     }
 
-#    if defined(ANJ_WITH_SENML_CBOR) && defined(ANJ_WITH_LWM2M_CBOR)
-    uint16_t format = (ctx->requests_queue[0]->content_format
-                       == ANJ_SEND_CONTENT_FORMAT_SENML_CBOR)
-                              ? _ANJ_COAP_FORMAT_SENML_CBOR
-                              : _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
-#    elif defined(ANJ_WITH_SENML_CBOR)
-    uint16_t format = _ANJ_COAP_FORMAT_SENML_CBOR;
-#    elif defined(ANJ_WITH_LWM2M_CBOR)
-    uint16_t format = _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
-#    endif
+    uint16_t format = _anj_lwm2m_send_content_format(ctx->requests_queue[0]);
+
+    out_msg->operation = ANJ_OP_INF_CON_SEND;
+    size_t requests_in_msg = 1;
+    size_t records_cnt = ctx->requests_queue[0]->records_cnt;
+#    ifdef ANJ_LWM2M_SEND_WITH_COALESCING
+    requests_in_msg = requests_to_coalesce(anj, out_msg, format);
+    for (size_t i = 1; i < requests_in_msg; i++) {
+        records_cnt += ctx->requests_queue[i]->records_cnt;
+    }
+    if (requests_in_msg > 1) {
+        log(L_DEBUG, "Sending %u queued requests in a single message",
+            (unsigned) requests_in_msg);
+    }
+#    endif // ANJ_LWM2M_SEND_WITH_COALESCING
 
     int res = _anj_io_out_ctx_init(&anj->anj_io.out_ctx, ANJ_OP_INF_CON_SEND,
-                                   NULL, ctx->requests_queue[0]->records_cnt,
-                                   format);
+                                   NULL, records_cnt, format);
     if (res) {
         log(L_ERROR, "anj_io out ctx error %d", res);
+        out_msg->operation = ANJ_OP_NONE;
         anj_send_abort(anj, ctx->ids[0]);
         return;
     }
@@ -316,8 +559,9 @@ void _anj_lwm2m_send_process(anj_t *anj,
         .read_payload = send_read_payload,
         .arg = anj
     };
-    out_msg->operation = ANJ_OP_INF_CON_SEND;
     ctx->active_exchange = true;
+    ctx->requests_in_msg = requests_in_msg;
+    ctx->request_idx = 0;
     ctx->data_to_copy = false;
     ctx->op_count = 0;
 }
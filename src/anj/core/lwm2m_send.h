@@ -34,6 +34,72 @@ void _anj_lwm2m_send_process(anj_t *anj,
                              _anj_exchange_handlers_t *out_handlers,
                              _anj_coap_msg_t *out_msg);
 
+/**
+ * Returns CoAP Content-Format used to encode the payload of the Send request.
+ *
+ * @param request  Send request.
+ */
+uint16_t _anj_lwm2m_send_content_format(const anj_send_request_t *request);
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * @param anj  Anjay object to operate on.
+ *
+ * @returns True if there are queued Send requests that
+ *          @ref _anj_lwm2m_send_process would handle.
+ */
+bool _anj_lwm2m_send_pending(anj_t *anj);
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
+#    ifdef ANJ_WITH_OFFLINE_STORE
+/**
+ * Moves the queued Send requests, except for the ones related to the ongoing
+ * exchange, to the offline store. Finished handlers of stored requests are
+ * called with @ref ANJ_SEND_STORED. Requests that could not be stored stay in
+ * the queue.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_lwm2m_send_store_queued(anj_t *anj);
+#    endif // ANJ_WITH_OFFLINE_STORE
+
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+/**
+ * Removes the Send requests related to the ongoing exchange from the queue,
+ * without calling their finished handlers. Used when the exchange is detached
+ * after sending, the requests are finished later with @ref
+ * _anj_lwm2m_send_detached_finished.
+ *
+ * @param      anj           Anjay object to operate on.
+ * @param[out] out_ids       IDs of the removed requests, array of
+ *                           @ref ANJ_LWM2M_SEND_QUEUE_SIZE elements.
+ * @param[out] out_requests  Removed requests, array of
+ *                           @ref ANJ_LWM2M_SEND_QUEUE_SIZE elements.
+ *
+ * @return Number of removed requests.
+ */
+size_t _anj_lwm2m_send_detach(anj_t *anj,
+                              uint16_t *out_ids,
+                              const anj_send_request_t **out_requests);
+
+/**
+ * Calls the finished handlers of the requests removed from the queue with
+ * @ref _anj_lwm2m_send_detach.
+ *
+ * @param anj       Anjay object to operate on.
+ * @param ids       IDs of the requests.
+ * @param requests  Send requests.
+ * @param count     Number of requests.
+ * @param result    Result of the exchange, as passed to @ref
+ *                  _anj_exchange_completion_t.
+ */
+void _anj_lwm2m_send_detached_finished(anj_t *anj,
+                                       const uint16_t *ids,
+                                       const anj_send_request_t *const *requests,
+                                       size_t count,
+                                       int result);
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
 #endif // ANJ_WITH_LWM2M_SEND
 
 #endif // ANJ_SRC_LWM2M_SEND_H
@@ -0,0 +1,658 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/compat/offline_store.h>
+#include <anj/compat/time.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/log/log.h>
+#include <anj/lwm2m_send.h>
+#include <anj/utils.h>
+
+#include "../coap/coap.h"
+#include "../dm/dm_io.h"
+#include "../exchange.h"
+#include "../io/io.h"
+#include "../utils.h"
+#include "core_utils.h"
+#include "lwm2m_send.h"
+#include "offline_store.h"
+#include "server.h"
+
+#ifdef ANJ_WITH_SENML_CBOR
+#    include "../io/cbor_encoder_ll.h"
+#endif // ANJ_WITH_SENML_CBOR
+
+#ifdef ANJ_WITH_OFFLINE_STORE
+
+#    define SERIALIZE_CHUNK_SIZE 64
+
+// SenML CBOR labels used to recognize the first record of the stored entry
+#    define SENML_NAME 0x00
+#    define SENML_BASE_NAME 0x21
+#    define SENML_BASE_TIME 0x22
+// Enough to reach the base time label: array, map and name with the longest
+// possible path
+#    define SENML_FIRST_RECORD_PREFIX_SIZE 40
+// label and double value
+#    define SENML_BASE_TIME_MAX_SIZE 10
+
+// the store drops the oldest entries when it's full, they might be the ones
+// that are being delivered right now
+static int handle_store_result(_anj_offline_store_ctx_t *ctx, int result) {
+    if (result <= 0) {
+        return result;
+    }
+    if (ctx->flush_in_progress) {
+        ctx->dropped_in_flight = ANJ_MIN(ctx->entries_in_msg,
+                                         ctx->dropped_in_flight
+                                                 + (size_t) result);
+    }
+    return 0;
+}
+
+// Serializes a single record and appends it to the stored entry
+static int store_record(anj_t *anj,
+                        _anj_io_out_ctx_t *out_ctx,
+                        const anj_io_out_entry_t *record) {
+    const anj_offline_store_t *store = anj->offline_store.store;
+    int res = _anj_io_out_ctx_new_entry(out_ctx, record);
+    while (!res || res == ANJ_IO_NEED_NEXT_CALL) {
+        uint8_t chunk[SERIALIZE_CHUNK_SIZE];
+        size_t copied_bytes;
+        res = _anj_io_out_ctx_get_payload(out_ctx, chunk, sizeof(chunk),
+                                          &copied_bytes);
+        if ((!res || res == ANJ_IO_NEED_NEXT_CALL)
+                && handle_store_result(&anj->offline_store,
+                                       store->append(store->arg, chunk,
+                                                     copied_bytes))) {
+#    ifdef ANJ_WITH_EXTERNAL_DATA
+            if (res == ANJ_IO_NEED_NEXT_CALL
+                    && (record->type & ANJ_DATA_TYPE_FLAG_EXTERNAL)) {
+                _anj_io_out_ctx_close_external_data_cb(record);
+            }
+#    endif // ANJ_WITH_EXTERNAL_DATA
+            res = -1;
+        }
+        if (!res) {
+            break;
+        }
+    }
+    return res;
+}
+
+int _anj_offline_store_send_request(anj_t *anj,
+                                    const anj_send_request_t *request) {
+    const anj_offline_store_t *store = anj->offline_store.store;
+    if (!store) {
+        return -1;
+    }
+    uint16_t format = _anj_lwm2m_send_content_format(request);
+    _anj_io_out_ctx_t out_ctx;
+    if (_anj_io_out_ctx_init(&out_ctx, ANJ_OP_INF_CON_SEND, NULL,
+                             request->records_cnt, format)
+            || handle_store_result(&anj->offline_store,
+                                   store->begin(store->arg, format))) {
+        return -1;
+    }
+    // data read now is delivered later, so it has to be timestamped
+    double now = (double) anj_time_real_now() / 1000.0;
+    int res = 0;
+    for (size_t i = 0; i < request->records_cnt && !res; i++) {
+        anj_io_out_entry_t record = request->records[i];
+        if (isnan(record.timestamp)) {
+            record.timestamp = now;
+        }
+        res = store_record(anj, &out_ctx, &record);
+    }
+    if (res) {
+        log(L_ERROR, "Could not store Send request: %d", res);
+        store->end(store->arg, false);
+        return -1;
+    }
+    if (store->end(store->arg, true)) {
+        return -1;
+    }
+    log(L_INFO, "Send request stored");
+    return 0;
+}
+
+#    ifdef ANJ_WITH_SENML_CBOR
+// Returns the length of the definite length array header at the beginning of
+// SenML CBOR pack, or 0 if there is no such header.
+static size_t senml_array_header_length(const uint8_t *buff,
+                                        size_t buff_len,
+                                        size_t *out_items) {
+    if (!buff_len || (buff[0] & 0xE0) != 0x80 || (buff[0] & 0x1F) > 26) {
+        return 0;
+    }
+    uint8_t additional_info = buff[0] & 0x1F;
+    if (additional_info < 24) {
+        *out_items = additional_info;
+        return 1;
+    }
+    size_t header_len = (size_t) 1 + ((size_t) 1 << (additional_info - 24));
+    *out_items = 0;
+    for (size_t i = 1; i < header_len && i < buff_len; i++) {
+        *out_items = (*out_items << 8) | buff[i];
+    }
+    return header_len;
+}
+
+// Returns the position right after the text string at @p pos, or 0 if there
+// is no text string there. Paths are never longer than 255 bytes.
+static size_t
+senml_skip_text(const uint8_t *buff, size_t buff_len, size_t pos) {
+    if (pos >= buff_len) {
+        return 0;
+    }
+    if (buff[pos] >= 0x60 && buff[pos] < 0x78) {
+        return pos + 1 + (size_t) (buff[pos] - 0x60);
+    }
+    if (buff[pos] == 0x78 && pos + 1 < buff_len) {
+        return pos + 2 + buff[pos + 1];
+    }
+    return 0;
+}
+#    endif // ANJ_WITH_SENML_CBOR
+
+#    ifdef ANJ_WITH_OBSERVE
+#        ifdef ANJ_WITH_SENML_CBOR
+// Base time label is added to the first record, after its base name and name,
+// so that the stored pack can be merged like the Send ones. Returns false if
+// the payload can't be parsed.
+static bool append_timestamped_notification(const anj_offline_store_t *store,
+                                            _anj_offline_store_ctx_t *ctx,
+                                            const uint8_t *payload,
+                                            size_t payload_len,
+                                            double timestamp) {
+    size_t items;
+    size_t map_pos = senml_array_header_length(payload, payload_len, &items);
+    // map of the first record can't grow beyond the single byte header
+    if (!map_pos || !items || map_pos >= payload_len
+            || payload[map_pos] < 0xA1 || payload[map_pos] >= 0xB7) {
+        return false;
+    }
+    size_t map_size = payload[map_pos] & 0x1F;
+    size_t pos = map_pos + 1;
+    for (size_t i = 0; i < map_size && pos < payload_len; i++) {
+        if (payload[pos] == SENML_BASE_TIME) {
+            // already timestamped
+            return !handle_store_result(ctx, store->append(store->arg, payload,
+                                                           payload_len));
+        }
+        if (payload[pos] != SENML_NAME && payload[pos] != SENML_BASE_NAME) {
+            break;
+        }
+        pos = senml_skip_text(payload, payload_len, pos + 1);
+        if (!pos) {
+            return false;
+        }
+    }
+    if (pos >= payload_len) {
+        return false;
+    }
+    uint8_t base_time[SENML_BASE_TIME_MAX_SIZE];
+    base_time[0] = SENML_BASE_TIME;
+    size_t base_time_len = 1 + anj_cbor_ll_encode_double(&base_time[1],
+                                                         timestamp);
+    uint8_t map_header = (uint8_t) (payload[map_pos] + 1);
+    return !handle_store_result(ctx, store->append(store->arg, payload,
+                                                   map_pos))
+           && !handle_store_result(ctx,
+                                   store->append(store->arg, &map_header, 1))
+           && !handle_store_result(ctx, store->append(store->arg,
+                                                      &payload[map_pos + 1],
+                                                      pos - map_pos - 1))
+           && !handle_store_result(ctx, store->append(store->arg, base_time,
+                                                      base_time_len))
+           && !handle_store_result(ctx, store->append(store->arg,
+                                                      &payload[pos],
+                                                      payload_len - pos));
+}
+
+#            ifdef ANJ_WITH_LWM2M_CBOR
+static int decode_notification_record(anj_t *anj,
+                                      _anj_io_in_ctx_t *in_ctx,
+                                      anj_io_out_entry_t *out_record) {
+    anj_data_type_t type = ANJ_DATA_TYPE_ANY;
+    const anj_res_value_t *value;
+    const anj_uri_path_t *path;
+    int res = _anj_io_in_ctx_get_entry(in_ctx, &type, &value, &path);
+    if (res == _ANJ_IO_WANT_TYPE_DISAMBIGUATION) {
+        if (!path || _anj_dm_get_resource_type(anj, path, &type)) {
+            return -1;
+        }
+        res = _anj_io_in_ctx_get_entry(in_ctx, &type, &value, &path);
+    }
+    if (res) {
+        return res;
+    }
+    if (!value || !path) {
+        return -1;
+    }
+    out_record->path = *path;
+    out_record->type = type;
+    out_record->value = *value;
+    if (type == ANJ_DATA_TYPE_BYTES || type == ANJ_DATA_TYPE_STRING) {
+        // whole payload is available, so values are never split into chunks
+        if (value->bytes_or_string.offset
+                || value->bytes_or_string.chunk_length
+                               != value->bytes_or_string.full_length_hint) {
+            return -1;
+        }
+        // empty string would be taken for a null-terminated one
+        if (!value->bytes_or_string.chunk_length) {
+            out_record->value.bytes_or_string.data = NULL;
+        }
+    }
+    return 0;
+}
+
+// LwM2M CBOR has no timestamps, so the notification is stored as SenML CBOR
+// pack. Payload is decoded twice, as the number of records has to be known
+// before encoding. Returns false if the payload can't be converted.
+static bool append_reencoded_notification(anj_t *anj,
+                                          uint8_t *payload,
+                                          size_t payload_len,
+                                          double timestamp) {
+    const anj_uri_path_t base_path = ANJ_MAKE_ROOT_PATH();
+    _anj_io_in_ctx_t in_ctx;
+    anj_io_out_entry_t record;
+    size_t records_cnt = 0;
+    int res;
+    if (_anj_io_in_ctx_init(&in_ctx, ANJ_OP_DM_WRITE_COMP, &base_path,
+                            _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR)
+            || _anj_io_in_ctx_feed_payload(&in_ctx, payload, payload_len,
+                                           true)) {
+        return false;
+    }
+    while (!(res = decode_notification_record(anj, &in_ctx, &record))) {
+        records_cnt++;
+    }
+    _anj_io_out_ctx_t out_ctx;
+    if (res != _ANJ_IO_EOF || !records_cnt
+            || _anj_io_out_ctx_init(&out_ctx, ANJ_OP_INF_CON_SEND, NULL,
+                                    records_cnt, _ANJ_COAP_FORMAT_SENML_CBOR)
+            || _anj_io_in_ctx_init(&in_ctx, ANJ_OP_DM_WRITE_COMP, &base_path,
+                                   _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR)
+            || _anj_io_in_ctx_feed_payload(&in_ctx, payload, payload_len,
+                                           true)) {
+        return false;
+    }
+    for (size_t i = 0; i < records_cnt; i++) {
+        if (decode_notification_record(anj, &in_ctx, &record)) {
+            return false;
+        }
+        record.timestamp = timestamp;
+        if (store_record(anj, &out_ctx, &record)) {
+            return false;
+        }
+    }
+    return true;
+}
+#            endif // ANJ_WITH_LWM2M_CBOR
+#        endif // ANJ_WITH_SENML_CBOR
+
+static void store_notification(anj_t *anj,
+                               const _anj_coap_msg_t *notification,
+                               double timestamp) {
+    const anj_offline_store_t *store = anj->offline_store.store;
+    if (!store || !anj->server_instance.observe_state.notify_store
+            || notification->block.block_type != ANJ_OPTION_BLOCK_NOT_DEFINED
+            || !notification->payload_size) {
+        return;
+    }
+#        ifdef ANJ_WITH_SENML_CBOR
+    // values are delivered later, so they have to be timestamped, which is
+    // possible only in SenML CBOR
+    bool senml = notification->content_format == _ANJ_COAP_FORMAT_SENML_CBOR;
+#            ifdef ANJ_WITH_LWM2M_CBOR
+    bool lwm2m_cbor = notification->content_format
+                      == _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
+#            else  // ANJ_WITH_LWM2M_CBOR
+    bool lwm2m_cbor = false;
+#            endif // ANJ_WITH_LWM2M_CBOR
+    if (!senml && !lwm2m_cbor) {
+        log(L_DEBUG, "Notification can't be timestamped, not stored");
+        return;
+    }
+    _anj_offline_store_ctx_t *ctx = &anj->offline_store;
+    if (handle_store_result(ctx, store->begin(store->arg,
+                                              _ANJ_COAP_FORMAT_SENML_CBOR))) {
+        return;
+    }
+    bool stored = false;
+    if (senml) {
+        stored = append_timestamped_notification(store, ctx,
+                                                 notification->payload,
+                                                 notification->payload_size,
+                                                 timestamp);
+    }
+#            ifdef ANJ_WITH_LWM2M_CBOR
+    else if (lwm2m_cbor) {
+        stored = append_reencoded_notification(anj, notification->payload,
+                                               notification->payload_size,
+                                               timestamp);
+    }
+#            endif // ANJ_WITH_LWM2M_CBOR
+    if (!store->end(store->arg, stored) && stored) {
+        log(L_INFO, "Notification stored");
+    }
+#        else  // ANJ_WITH_SENML_CBOR
+    (void) timestamp;
+    log(L_DEBUG, "Notification can't be timestamped, not stored");
+#        endif // ANJ_WITH_SENML_CBOR
+}
+
+void _anj_offline_store_notification(anj_t *anj,
+                                     uint8_t *msg,
+                                     size_t msg_len,
+                                     double timestamp) {
+    _anj_coap_msg_t notification;
+    memset(&notification, 0, sizeof(notification));
+    if (!_anj_server_decode_msg(&anj->connection_ctx, msg, msg_len,
+                                &notification)) {
+        store_notification(anj, &notification, timestamp);
+    }
+}
+
+static void notification_completion(void *arg_ptr,
+                                    const _anj_coap_msg_t *response,
+                                    int result) {
+    anj_t *anj = (anj_t *) arg_ptr;
+    _anj_exchange_handlers_t *handlers =
+            &anj->offline_store.notification_handlers;
+    // anj->out_buffer still contains the last transmission of the notification
+    if (result == _ANJ_EXCHANGE_ERROR_TIMEOUT
+            || result == _ANJ_EXCHANGE_ERROR_TERMINATED) {
+#        ifdef ANJ_NET_WITH_SEND_IOV
+        // only the header is there, payload is left in anj->payload_buffer
+        _anj_coap_msg_t notification;
+        memset(&notification, 0, sizeof(notification));
+        if (!_anj_coap_decode_udp(anj->out_buffer, anj->out_header_len,
+                                  &notification)) {
+            notification.payload = (uint8_t *) (uintptr_t) anj->out_payload;
+            notification.payload_size = anj->out_payload_len;
+            store_notification(anj, &notification,
+                               anj->offline_store.notification_time);
+        }
+#        else  // ANJ_NET_WITH_SEND_IOV
+        _anj_offline_store_notification(
+                anj, (uint8_t *) (uintptr_t) _anj_server_out_msg(anj),
+                anj->out_msg_len, anj->offline_store.notification_time);
+#        endif // ANJ_NET_WITH_SEND_IOV
+    }
+    if (handlers->completion) {
+        handlers->completion(anj, response, result);
+    }
+}
+
+void _anj_offline_store_wrap_notification(anj_t *anj,
+                                          _anj_exchange_handlers_t *handlers) {
+    if (!anj->offline_store.store) {
+        return;
+    }
+    // observe module handlers operate on anj, so the argument stays the same
+    assert(handlers->arg == anj);
+    anj->offline_store.notification_handlers = *handlers;
+    // values are read now, even if the notification is stored much later
+    anj->offline_store.notification_time =
+            (double) anj_time_real_now() / 1000.0;
+    handlers->completion = notification_completion;
+}
+#    endif // ANJ_WITH_OBSERVE
+
+#    ifdef ANJ_WITH_SENML_CBOR
+// Checks if the stored SenML CBOR pack can be merged with other ones, returns
+// the length of its array header, or 0 if merging is not possible.
+// @p out_base_name is set if the pack defines a base name, which applies also
+// to the records of packs appended after it.
+static size_t senml_mergeable_prefix(const anj_offline_store_t *store,
+                                     size_t index,
+                                     size_t length,
+                                     size_t *out_items,
+                                     bool *out_base_name) {
+    uint8_t prefix[SENML_FIRST_RECORD_PREFIX_SIZE];
+    size_t prefix_len = ANJ_MIN(length, sizeof(prefix));
+    if (store->read(store->arg, index, 0, prefix, prefix_len)
+            || prefix_len < 2) {
+        return 0;
+    }
+    size_t header_len =
+            senml_array_header_length(prefix, prefix_len, out_items);
+    size_t pos = header_len;
+    if (!header_len || pos >= prefix_len || (prefix[pos] & 0xE0) != 0xA0) {
+        return 0;
+    }
+    size_t map_size = prefix[pos++] & 0x1F;
+    // base name is encoded only in the first record, as its first label
+    *out_base_name = map_size && pos < prefix_len
+                     && prefix[pos] == SENML_BASE_NAME;
+    // records inherit the base time of the previous record, so the first
+    // record of each appended pack has to define its own one
+    if (index == 0) {
+        return header_len;
+    }
+    for (size_t i = 0; i < map_size && pos < prefix_len; i++) {
+        uint8_t label = prefix[pos++];
+        if (label == SENML_BASE_TIME) {
+            return header_len;
+        }
+        if (label != SENML_NAME && label != SENML_BASE_NAME) {
+            return 0;
+        }
+        pos = senml_skip_text(prefix, prefix_len, pos);
+        if (!pos) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static void prepare_merged_entries(anj_t *anj, _anj_coap_msg_t *msg) {
+    _anj_offline_store_ctx_t *ctx = &anj->offline_store;
+    const anj_offline_store_t *store = ctx->store;
+    size_t payload_size;
+    if (_anj_server_calculate_max_payload_size(
+                &anj->connection_ctx, msg, ANJ_OUT_PAYLOAD_BUFFER_SIZE,
+                ANJ_OUT_MSG_BUFFER_SIZE, false, &payload_size)) {
+        return;
+    }
+    payload_size = _anj_determine_block_buffer_size(payload_size);
+
+    size_t items;
+    bool base_name;
+    ctx->entry_skip[0] =
+            (uint8_t) senml_mergeable_prefix(store, 0, ctx->entry_length[0],
+                                             &items, &base_name);
+    if (!ctx->entry_skip[0]) {
+        return;
+    }
+    bool base_name_in_effect = base_name;
+    size_t total_items = items;
+    size_t total_size = sizeof(ctx->header) + ctx->entry_length[0]
+                        - ctx->entry_skip[0];
+    size_t count = 1;
+    while (count < ANJ_OFFLINE_STORE_FLUSH_BATCH_SIZE) {
+        uint16_t format;
+        size_t length;
+        if (store->get_entry(store->arg, count, &format, &length)
+                || format != _ANJ_COAP_FORMAT_SENML_CBOR) {
+            break;
+        }
+        size_t skip = senml_mergeable_prefix(store, count, length, &items,
+                                             &base_name);
+        // e.g. names in a Send pack are absolute paths, they can't follow
+        // a Notify pack that sets the observed path as the base name
+        if (!skip || (base_name_in_effect && !base_name)
+                || total_size + length - skip > payload_size) {
+            break;
+        }
+        base_name_in_effect = base_name_in_effect || base_name;
+        ctx->entry_length[count] = length;
+        ctx->entry_skip[count] = (uint8_t) skip;
+        total_items += items;
+        total_size += length - skip;
+        count++;
+    }
+    if (count == 1) {
+        ctx->entry_skip[0] = 0;
+        return;
+    }
+    ctx->entries_in_msg = count;
+    ctx->header_length =
+            anj_cbor_ll_definite_array_begin(ctx->header, total_items);
+    ctx->entry_offset = ctx->entry_skip[0];
+    log(L_DEBUG, "Delivering %u stored entries in a single message",
+        (unsigned) count);
+}
+#    endif // ANJ_WITH_SENML_CBOR
+
+static uint8_t flush_read_payload(void *arg_ptr,
+                                  uint8_t *buff,
+                                  size_t buff_len,
+                                  _anj_exchange_read_result_t *out_params) {
+    anj_t *anj = (anj_t *) arg_ptr;
+    _anj_offline_store_ctx_t *ctx = &anj->offline_store;
+    out_params->format = ctx->format;
+
+    size_t written = ANJ_MIN(ctx->header_length - ctx->header_offset, buff_len);
+    memcpy(buff, &ctx->header[ctx->header_offset], written);
+    ctx->header_offset += written;
+    while (written < buff_len && ctx->entry_idx < ctx->entries_in_msg) {
+        if (ctx->entry_idx < ctx->dropped_in_flight) {
+            log(L_WARNING, "Stored entry dropped during delivery");
+            return ANJ_COAP_CODE_INTERNAL_SERVER_ERROR;
+        }
+        size_t to_read =
+                ANJ_MIN(ctx->entry_length[ctx->entry_idx] - ctx->entry_offset,
+                        buff_len - written);
+        if (to_read
+                && ctx->store->read(ctx->store->arg,
+                                    ctx->entry_idx - ctx->dropped_in_flight,
+                                    ctx->entry_offset, &buff[written],
+                                    to_read)) {
+            log(L_ERROR, "Could not read stored entry");
+            return ANJ_COAP_CODE_INTERNAL_SERVER_ERROR;
+        }
+        written += to_read;
+        ctx->entry_offset += to_read;
+        if (ctx->entry_offset == ctx->entry_length[ctx->entry_idx]) {
+            ctx->entry_idx++;
+            if (ctx->entry_idx < ctx->entries_in_msg) {
+                ctx->entry_offset = ctx->entry_skip[ctx->entry_idx];
+            }
+        }
+    }
+    out_params->payload_len = written;
+    return ctx->entry_idx == ctx->entries_in_msg
+                   ? 0
+                   : _ANJ_EXCHANGE_BLOCK_TRANSFER_NEEDED;
+}
+
+static void flush_completion(void *arg_ptr,
+                             const _anj_coap_msg_t *response,
+                             int result) {
+    (void) response;
+    anj_t *anj = (anj_t *) arg_ptr;
+    _anj_offline_store_ctx_t *ctx = &anj->offline_store;
+    ctx->flush_in_progress = false;
+    if (result == _ANJ_EXCHANGE_ERROR_TIMEOUT
+            || result == _ANJ_EXCHANGE_ERROR_TERMINATED) {
+        // keep the entries and try again in the next registration session
+        log(L_WARNING, "Delivery of stored entries failed: %d", result);
+        ctx->flush_paused = true;
+        return;
+    }
+    if (ctx->entry_idx < ctx->dropped_in_flight) {
+        // block-wise transfer was cancelled, remaining entries are delivered
+        // with the next message
+        return;
+    }
+    if (result) {
+        // the Server will not accept the same payload later either
+        log(L_ERROR, "Stored entries rejected with %d, dropping", result);
+    } else {
+        log(L_INFO, "Delivered %u stored entries",
+            (unsigned) ctx->entries_in_msg);
+    }
+    if (ctx->store->drop(ctx->store->arg,
+                         ctx->entries_in_msg - ctx->dropped_in_flight)) {
+        ctx->flush_paused = true;
+    }
+}
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+bool _anj_offline_store_pending(anj_t *anj) {
+    assert(anj);
+    _anj_offline_store_ctx_t *ctx = &anj->offline_store;
+    uint16_t format;
+    size_t length;
+    return ctx->store && !ctx->flush_paused && !ctx->flush_in_progress
+           && !anj->server_instance.mute_send
+           && !ctx->store->get_entry(ctx->store->arg, 0, &format, &length);
+}
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
+void _anj_offline_store_process(anj_t *anj,
+                                _anj_exchange_handlers_t *out_handlers,
+                                _anj_coap_msg_t *out_msg) {
+    assert(anj && out_handlers && out_msg);
+    _anj_offline_store_ctx_t *ctx = &anj->offline_store;
+    assert(!ctx->flush_in_progress);
+
+    out_msg->operation = ANJ_OP_NONE;
+    if (!ctx->store || ctx->flush_paused || anj->server_instance.mute_send) {
+        return;
+    }
+    int res = ctx->store->get_entry(ctx->store->arg, 0, &ctx->format,
+                                    &ctx->entry_length[0]);
+    if (res) {
+        if (res != ANJ_OFFLINE_STORE_NO_ENTRY) {
+            log(L_ERROR, "Could not access offline store");
+            ctx->flush_paused = true;
+        }
+        return;
+    }
+
+    out_msg->operation = ANJ_OP_INF_CON_SEND;
+    ctx->entries_in_msg = 1;
+    ctx->dropped_in_flight = 0;
+    ctx->entry_idx = 0;
+    ctx->entry_offset = 0;
+    ctx->entry_skip[0] = 0;
+    ctx->header_length = 0;
+    ctx->header_offset = 0;
+#    ifdef ANJ_WITH_SENML_CBOR
+    if (ctx->format == _ANJ_COAP_FORMAT_SENML_CBOR) {
+        prepare_merged_entries(anj, out_msg);
+    }
+#    endif // ANJ_WITH_SENML_CBOR
+    *out_handlers = (_anj_exchange_handlers_t) {
+        .completion = flush_completion,
+        .read_payload = flush_read_payload,
+        .arg = anj
+    };
+    ctx->flush_in_progress = true;
+}
+
+void _anj_offline_store_session_started(anj_t *anj) {
+    anj->offline_store.flush_paused = false;
+}
+
+#endif // ANJ_WITH_OFFLINE_STORE
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef ANJ_SRC_CORE_OFFLINE_STORE_H
+#define ANJ_SRC_CORE_OFFLINE_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <anj/anj_config.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+
+#include "../coap/coap.h"
+#include "../exchange.h"
+
+#ifdef ANJ_WITH_OFFLINE_STORE
+
+/**
+ * Serializes the payload of the Send request into the offline store.
+ *
+ * Records without timestamp get the current time, because the payload is
+ * delivered later. The request is not used after this function returns.
+ *
+ * @param anj      Anjay object to operate on.
+ * @param request  Send request.
+ *
+ * @return 0 on success, a negative value if the store is not configured or in
+ *         case of an error.
+ */
+int _anj_offline_store_send_request(anj_t *anj,
+                                    const anj_send_request_t *request);
+
+#    ifdef ANJ_WITH_OBSERVE
+/**
+ * Stores the payload of the encoded notification that could not be delivered,
+ * as SenML CBOR pack with base time set to @p timestamp. LwM2M CBOR payload is
+ * re-encoded to SenML CBOR. Nothing is stored if Notification Storing When
+ * Disabled or Offline Resource is not set, the notification was sent with
+ * block-wise transfer or it is in any other format, as it can't be
+ * timestamped.
+ *
+ * @param anj        Anjay object to operate on.
+ * @param msg        Encoded CoAP message.
+ * @param msg_len    Length of the message.
+ * @param timestamp  Real time in seconds at which the notification was
+ *                   prepared.
+ */
+void _anj_offline_store_notification(anj_t *anj,
+                                     uint8_t *msg,
+                                     size_t msg_len,
+                                     double timestamp);
+
+/**
+ * Replaces the completion handler of the notification exchange, so that the
+ * notification is stored if it could not be delivered, timestamped with the
+ * current time. Original handlers are called afterwards.
+ *
+ * @param         anj       Anjay object to operate on.
+ * @param[in,out] handlers  Exchange handlers returned by the observe module.
+ */
+void _anj_offline_store_wrap_notification(anj_t *anj,
+                                          _anj_exchange_handlers_t *handlers);
+#    endif // ANJ_WITH_OBSERVE
+
+/**
+ * Checks if there are stored entries to deliver, and if so, prepares LwM2M Send
+ * message with the oldest of them. If there is nothing to send,
+ * out_msg->operation is set to @ref ANJ_OP_NONE.
+ *
+ * @param      anj           Anjay object to operate on.
+ * @param[out] out_handlers  Exchange handlers.
+ * @param[out] out_msg       Outgoing message structure.
+ */
+void _anj_offline_store_process(anj_t *anj,
+                                _anj_exchange_handlers_t *out_handlers,
+                                _anj_coap_msg_t *out_msg);
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * @param anj  Anjay object to operate on.
+ *
+ * @returns True if there are stored entries that
+ *          @ref _anj_offline_store_process would deliver.
+ */
+bool _anj_offline_store_pending(anj_t *anj);
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
+/**
+ * Should be called when a new registration session starts. Resumes the delivery
+ * of stored entries if it was paused after a failure.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_offline_store_session_started(anj_t *anj);
+
+#endif // ANJ_WITH_OFFLINE_STORE
+
+#endif // ANJ_SRC_CORE_OFFLINE_STORE_H
@@ -31,14 +31,20 @@
 #include "../utils.h"
 #include "core.h"
 #include "core_utils.h"
+#include "in_flight.h"
 #include "reg_session.h"
 #include "register.h"
+#include "response_cache.h"
 #include "server.h"
 
 #ifdef ANJ_WITH_LWM2M_SEND
 #    include "lwm2m_send.h"
 #endif // ANJ_WITH_LWM2M_SEND
 
+#ifdef ANJ_WITH_OFFLINE_STORE
+#    include "offline_store.h"
+#endif // ANJ_WITH_OFFLINE_STORE
+
 #define _ANJ_REG_SESSION_NEW_EXCHANGE 1
 
 static uint64_t calculate_next_update(anj_t *anj) {
@@ -75,6 +81,12 @@ void _anj_reg_session_init(anj_t *anj) {
     anj->server_state.enable_time = 0;
     anj->server_state.enable_time_user_triggered = 0;
     refresh_queue_mode_timeout(anj);
+#ifdef ANJ_WITH_OFFLINE_STORE
+    _anj_offline_store_session_started(anj);
+#endif // ANJ_WITH_OFFLINE_STORE
+#ifdef ANJ_WITH_RESPONSE_CACHE
+    _anj_response_cache_clear(anj);
+#endif // ANJ_WITH_RESPONSE_CACHE
 }
 
 #ifdef ANJ_WITH_OBSERVE
@@ -174,15 +186,32 @@ void _anj_reg_session_refresh_registration_related_resources(anj_t *anj) {
 #endif // ANJ_WITH_OBSERVE
 }
 
-static int handle_incoming_message(anj_t *anj, size_t msg_size) {
+static int
+handle_incoming_message(anj_t *anj, uint8_t *msg_data, size_t msg_size) {
     _anj_coap_msg_t msg;
     memset(&msg, 0, sizeof(msg));
-    int res = _anj_coap_decode_udp(anj->in_buffer, msg_size, &msg);
+    int res = _anj_server_decode_msg(&anj->connection_ctx, msg_data, msg_size,
+                                     &msg);
     if (res) {
         ANJ_CORE_LOG_COAP_ERROR(res);
         // ignore invalid messages
         return 0;
     }
+#ifdef ANJ_COAP_WITH_TCP
+    if (_anj_server_handle_signalling_msg(anj, &msg)) {
+        return 0;
+    }
+#endif // ANJ_COAP_WITH_TCP
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+    if (_anj_in_flight_handle_msg(anj, &msg)) {
+        return 0;
+    }
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+#ifdef ANJ_WITH_RESPONSE_CACHE
+    if (_anj_response_cache_handle_msg(anj, &msg)) {
+        return 0;
+    }
+#endif // ANJ_WITH_RESPONSE_CACHE
 
     _anj_exchange_handlers_t exchange_handlers = { 0 };
     uint8_t response_code = 0;
@@ -273,6 +302,23 @@ static int handle_registration_update(anj_t *anj) {
     return _ANJ_REG_SESSION_NEW_EXCHANGE;
 }
 
+#ifdef ANJ_WITH_OFFLINE_STORE
+static int handle_offline_store(anj_t *anj) {
+    _anj_coap_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    _anj_exchange_handlers_t exchange_handlers = { 0 };
+    _anj_offline_store_process(anj, &exchange_handlers, &msg);
+    if (msg.operation != ANJ_OP_INF_CON_SEND) {
+        return 0;
+    }
+    log(L_DEBUG, "Sending stored data");
+    if (_anj_server_prepare_client_request(anj, &msg, &exchange_handlers)) {
+        return -1;
+    }
+    return _ANJ_REG_SESSION_NEW_EXCHANGE;
+}
+#endif // ANJ_WITH_OFFLINE_STORE
+
 #ifdef ANJ_WITH_LWM2M_SEND
 static int handle_send(anj_t *anj) {
     _anj_coap_msg_t msg;
@@ -302,6 +348,9 @@ static int handle_observe(anj_t *anj) {
         return 0;
     }
     log(L_DEBUG, "Sending notification");
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    _anj_offline_store_wrap_notification(anj, &exchange_handlers);
+#    endif // ANJ_WITH_OFFLINE_STORE
     if (_anj_server_prepare_client_request(anj, &msg, &exchange_handlers)) {
         return -1;
     }
@@ -350,13 +399,23 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
             return _ANJ_CORE_NEXT_ACTION_CONTINUE;
         }
 
-        // check for new requests
-        size_t msg_size;
-        res = _anj_server_receive(&anj->connection_ctx, anj->in_buffer,
-                                  &msg_size, ANJ_IN_MSG_BUFFER_SIZE);
-        if (anj_net_is_ok(res)) {
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+        _anj_in_flight_process(anj);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
+        // check for new requests, all pending messages that don't start a new
+        // exchange (e.g. responses to in-flight requests) are handled now
+        while (true) {
+            uint8_t *msg_data;
+            size_t msg_size;
+            res = _anj_server_receive(&anj->connection_ctx, anj->in_buffer,
+                                      &msg_data, &msg_size,
+                                      ANJ_IN_MSG_BUFFER_SIZE);
+            if (!anj_net_is_ok(res)) {
+                break;
+            }
             // new message received, if decode fails or not recognized - drop
-            res = handle_incoming_message(anj, msg_size);
+            res = handle_incoming_message(anj, msg_data, msg_size);
             if (res) {
                 anj->server_state.details.registered
                         .internal_state = get_new_state_for_new_exchange(
@@ -364,7 +423,8 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
                         res);
                 return _ANJ_CORE_NEXT_ACTION_CONTINUE;
             }
-        } else if (!anj_net_is_again(res)) {
+        }
+        if (!anj_net_is_again(res)) {
             log(L_ERROR, "Error while receiving message: %d", res);
             anj->server_state.details.registered.internal_state =
                     _ANJ_SRV_MAN_STATE_DISCONNECT_IN_PROGRESS;
@@ -393,6 +453,19 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
             return _ANJ_CORE_NEXT_ACTION_CONTINUE;
         }
 
+#ifdef ANJ_WITH_OFFLINE_STORE
+        // still no ongoing exchange, deliver the data stored while offline
+        // before the new Send requests
+        res = handle_offline_store(anj);
+        if (res) {
+            anj->server_state.details.registered.internal_state =
+                    get_new_state_for_new_exchange(
+                            anj->server_state.details.registered.internal_state,
+                            res);
+            return _ANJ_CORE_NEXT_ACTION_CONTINUE;
+        }
+#endif // ANJ_WITH_OFFLINE_STORE
+
 #ifdef ANJ_WITH_LWM2M_SEND
         // still no ongoing exchange, check for Send requests
         res = handle_send(anj);
@@ -422,7 +495,12 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
                 && anj->server_state.details.registered.internal_state
                                != _ANJ_SRV_MAN_STATE_QUEUE_MODE_IN_PROGRESS
                 && anj_time_real_now() > anj->server_state.details.registered
-                                                 .queue_start_time) {
+                                                 .queue_start_time
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+                // wait for the responses to the requests already sent
+                && !_anj_in_flight_pending(anj)
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+        ) {
             anj->server_state.details.registered.internal_state =
                     _ANJ_SRV_MAN_STATE_ENTERING_QUEUE_MODE_IN_PROGRESS;
             *out_status = ANJ_CONN_STATUS_ENTERING_QUEUE_MODE;
@@ -464,6 +542,16 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
     case _ANJ_SRV_MAN_STATE_EXCHANGE_IN_PROGRESS: {
         int res = _anj_server_handle_request(anj);
         if (anj_net_is_again(res)) {
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+            _anj_in_flight_process(anj);
+            // request is sent, the response is awaited in the in-flight slot
+            // and the next exchange can be started
+            if (_anj_in_flight_detach(anj)) {
+                anj->server_state.details.registered.internal_state =
+                        _ANJ_SRV_MAN_STATE_IDLE_IN_PROGRESS;
+                return _ANJ_CORE_NEXT_ACTION_CONTINUE;
+            }
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
             return _ANJ_CORE_NEXT_ACTION_LEAVE;
         }
         // _anj_register_operation_status() value is important only in case of
@@ -488,6 +576,9 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
     case _ANJ_SRV_MAN_STATE_ENTERING_QUEUE_MODE_IN_PROGRESS:
     case _ANJ_SRV_MAN_STATE_DISCONNECT_IN_PROGRESS: {
         _anj_exchange_terminate(&anj->exchange_ctx);
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+        _anj_in_flight_terminate(anj);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
         // bootstrap or restart request is the only case when we want to clean
         // up the connection
         bool with_cleanup = anj->server_state.bootstrap_request_triggered
@@ -528,6 +619,81 @@ _anj_reg_session_process_registered(anj_t *anj, anj_conn_status_t *out_status) {
     return _ANJ_CORE_NEXT_ACTION_LEAVE;
 }
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+// time at which a new client initiated exchange has to be started
+static uint64_t next_client_request_time(anj_t *anj) {
+    if (anj->server_state.details.registered.update_with_lifetime
+            || anj->server_state.details.registered.update_with_payload
+            || anj->server_state.registration_update_triggered) {
+        return 0;
+    }
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    if (_anj_offline_store_pending(anj)) {
+        return 0;
+    }
+#    endif // ANJ_WITH_OFFLINE_STORE
+#    ifdef ANJ_WITH_LWM2M_SEND
+    if (_anj_lwm2m_send_pending(anj)) {
+        return 0;
+    }
+#    endif // ANJ_WITH_LWM2M_SEND
+    uint64_t deadline = anj->server_state.details.registered.next_update_time;
+#    ifdef ANJ_WITH_OBSERVE
+    uint64_t time_to_next_notification;
+    if (!anj_observe_time_to_next_notification(
+                anj, &anj->server_instance.observe_state,
+                &time_to_next_notification)
+            && time_to_next_notification != ANJ_TIME_UNDEFINED) {
+        deadline = ANJ_MIN(deadline,
+                           anj_time_real_now() + time_to_next_notification);
+    }
+#    endif // ANJ_WITH_OBSERVE
+    return deadline;
+}
+
+uint64_t _anj_reg_session_poll_deadline(anj_t *anj, uint8_t *out_events) {
+    switch (anj->server_state.details.registered.internal_state) {
+    case _ANJ_SRV_MAN_STATE_IDLE_IN_PROGRESS: {
+        if (_anj_core_state_transition_forced(anj)) {
+            return 0;
+        }
+        // no ongoing exchange, wait for the LwM2M Server requests
+        uint64_t deadline = _anj_server_poll_deadline(anj, out_events);
+        deadline = ANJ_MIN(deadline, next_client_request_time(anj));
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+        deadline = ANJ_MIN(deadline, _anj_in_flight_deadline(anj));
+        if (_anj_in_flight_pending(anj)) {
+            return deadline;
+        }
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+        if (anj->queue_mode_enabled) {
+            deadline = ANJ_MIN(deadline,
+                               _anj_core_time_after(
+                                       anj->server_state.details.registered
+                                               .queue_start_time));
+        }
+        return deadline;
+    }
+    case _ANJ_SRV_MAN_STATE_QUEUE_MODE_IN_PROGRESS:
+        // connection is closed, only the timers are checked
+        if (_anj_core_state_transition_forced(anj)) {
+            return 0;
+        }
+        return next_client_request_time(anj);
+    case _ANJ_SRV_MAN_STATE_EXCHANGE_IN_PROGRESS: {
+        uint64_t deadline = _anj_server_poll_deadline(anj, out_events);
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+        deadline = ANJ_MIN(deadline, _anj_in_flight_deadline(anj));
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+        return deadline;
+    }
+    default:
+        // connection is being opened or closed
+        return 0;
+    }
+}
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 _anj_core_next_action_t
 _anj_reg_session_process_suspended(anj_t *anj, anj_conn_status_t *out_status) {
     assert(anj->server_state.conn_status == ANJ_CONN_STATUS_SUSPENDED);
@@ -64,4 +64,19 @@ _anj_reg_session_process_suspended(anj_t *anj, anj_conn_status_t *out_status);
  */
 void _anj_reg_session_refresh_registration_related_resources(anj_t *anj);
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * Returns the time at which @ref _anj_reg_session_process_registered has to be
+ * called, even if no socket event occurs, and adds the awaited events to
+ * @p out_events.
+ *
+ * @param         anj         Anjay object to operate on.
+ * @param[in,out] out_events  Bitmask of ANJ_CORE_POLL_* values.
+ *
+ * @returns Time in milliseconds, as returned by @ref anj_time_real_now, or
+ *          @ref ANJ_TIME_UNDEFINED.
+ */
+uint64_t _anj_reg_session_poll_deadline(anj_t *anj, uint8_t *out_events);
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 #endif // ANJ_SRC_CORE_SERVER_MANAGEMENT_H
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/compat/time.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/log/log.h>
+
+#include "../coap/coap.h"
+#include "../exchange.h"
+#include "core_utils.h"
+#include "response_cache.h"
+#include "server.h"
+
+#ifdef ANJ_WITH_RESPONSE_CACHE
+
+// CoAP UDP header: version, type and token length, code, message ID
+#    define HEADER_SIZE 4
+#    define HEADER_TYPE(Msg) (((Msg)[0] >> 4) & 0x03)
+#    define HEADER_TKL(Msg) ((Msg)[0] & 0x0F)
+#    define HEADER_TYPE_ACK 2
+
+// RFC 7252, 4.8.2: MAX_LATENCY
+#    define MAX_LATENCY_MS 100000
+
+// RFC 7252, 4.8.2: EXCHANGE_LIFETIME = MAX_TRANSMIT_SPAN + 2 * MAX_LATENCY +
+// PROCESSING_DELAY, where MAX_TRANSMIT_SPAN = ACK_TIMEOUT *
+// ((2 ** MAX_RETRANSMIT) - 1) * ACK_RANDOM_FACTOR and PROCESSING_DELAY =
+// ACK_TIMEOUT
+static uint64_t exchange_lifetime(const _anj_exchange_udp_tx_params_t *params) {
+    uint64_t max_transmit_span =
+            (uint64_t) ((double) params->ack_timeout_ms
+                        * (double) ((1 << params->max_retransmit) - 1)
+                        * params->ack_random_factor);
+    return max_transmit_span + 2 * MAX_LATENCY_MS + params->ack_timeout_ms;
+}
+
+static bool entry_valid(const _anj_response_cache_entry_t *entry,
+                        uint64_t now) {
+    return entry->msg_len && entry->expiration_time > now;
+}
+
+static bool entry_matches(const _anj_response_cache_entry_t *entry,
+                          uint16_t message_id,
+                          const _anj_coap_token_t *token) {
+    return (uint16_t) ((entry->msg[2] << 8) | entry->msg[3]) == message_id
+           && HEADER_TKL(entry->msg) == token->size
+           && !memcmp(&entry->msg[HEADER_SIZE], token->bytes, token->size);
+}
+
+void _anj_response_cache_store(anj_t *anj) {
+    assert(anj);
+    // requests are not retransmitted over reliable transport
+    if (_anj_server_reliable_transport(&anj->connection_ctx)) {
+        return;
+    }
+    // header and token are always in out_buffer
+    const uint8_t *msg = _anj_server_out_msg(anj);
+    size_t msg_len = anj->out_msg_len;
+    // only piggybacked responses are cached, empty ACKs have no code
+    if (msg_len < HEADER_SIZE || HEADER_TYPE(msg) != HEADER_TYPE_ACK
+            || msg[1] == 0 || HEADER_TKL(msg) > _ANJ_COAP_MAX_TOKEN_LENGTH
+            || msg_len < (size_t) (HEADER_SIZE + HEADER_TKL(msg))) {
+        return;
+    }
+    if (msg_len > ANJ_RESPONSE_CACHE_MAX_MSG_SIZE) {
+        log(L_DEBUG, "Response too long to be cached");
+        return;
+    }
+
+    uint64_t now = anj_time_real_now();
+    _anj_coap_token_t token;
+    token.size = HEADER_TKL(msg);
+    memcpy(token.bytes, &msg[HEADER_SIZE], token.size);
+    uint16_t message_id = (uint16_t) ((msg[2] << 8) | msg[3]);
+
+    // retransmitted response replaces the previous copy, otherwise use a free
+    // or expired entry, or the oldest one
+    _anj_response_cache_entry_t *entry = &anj->response_cache[0];
+    for (size_t i = 0; i < ANJ_RESPONSE_CACHE_SIZE; i++) {
+        _anj_response_cache_entry_t *candidate = &anj->response_cache[i];
+        if (!entry_valid(candidate, now)
+                || entry_matches(candidate, message_id, &token)) {
+            entry = candidate;
+            break;
+        }
+        if (candidate->expiration_time < entry->expiration_time) {
+            entry = candidate;
+        }
+    }
+    _anj_server_copy_out_msg(anj, entry->msg);
+    entry->msg_len = msg_len;
+    entry->expiration_time =
+            now + exchange_lifetime(&anj->exchange_ctx.tx_params);
+}
+
+bool _anj_response_cache_handle_msg(anj_t *anj, const _anj_coap_msg_t *msg) {
+    assert(anj && msg);
+    if (msg->operation >= ANJ_OP_RESPONSE
+            || _anj_server_reliable_transport(&anj->connection_ctx)
+            || msg->coap_binding_data.udp.type
+                           != ANJ_COAP_UDP_TYPE_CONFIRMABLE) {
+        return false;
+    }
+    uint64_t now = anj_time_real_now();
+    for (size_t i = 0; i < ANJ_RESPONSE_CACHE_SIZE; i++) {
+        _anj_response_cache_entry_t *entry = &anj->response_cache[i];
+        if (!entry_valid(entry, now)
+                || !entry_matches(entry, msg->coap_binding_data.udp.message_id,
+                                  &msg->token)) {
+            continue;
+        }
+        log(L_INFO, "Duplicated request, sending cached response");
+        // failed send is treated like a lost response, the LwM2M Server will
+        // retransmit the request again
+        int res = _anj_server_send(&anj->connection_ctx, entry->msg,
+                                   entry->msg_len);
+        if (res) {
+            log(L_WARNING, "Could not send cached response: %d", res);
+            anj->connection_ctx.bytes_sent = 0;
+            anj->connection_ctx.send_in_progress = false;
+        }
+        return true;
+    }
+    return false;
+}
+
+void _anj_response_cache_clear(anj_t *anj) {
+    assert(anj);
+    for (size_t i = 0; i < ANJ_RESPONSE_CACHE_SIZE; i++) {
+        anj->response_cache[i].msg_len = 0;
+    }
+}
+
+#endif // ANJ_WITH_RESPONSE_CACHE
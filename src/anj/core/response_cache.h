@@ -0,0 +1,58 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef ANJ_SRC_CORE_RESPONSE_CACHE_H
+#define ANJ_SRC_CORE_RESPONSE_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <anj/anj_config.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+
+#include "../coap/coap.h"
+
+#ifdef ANJ_WITH_RESPONSE_CACHE
+
+/**
+ * Stores the outgoing message that was just sent if it is a piggybacked
+ * response to the LwM2M Server request. Other messages and responses that don't
+ * fit in the cache entry are ignored. If the cache is full, the oldest entry is
+ * replaced.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_response_cache_store(anj_t *anj);
+
+/**
+ * Checks if the incoming message is a retransmission of the confirmable
+ * request, for which the response is cached, and if so, sends the cached
+ * response again.
+ *
+ * @param anj  Anjay object to operate on.
+ * @param msg  Decoded incoming message.
+ *
+ * @returns True if the message was answered and must not be processed further.
+ */
+bool _anj_response_cache_handle_msg(anj_t *anj, const _anj_coap_msg_t *msg);
+
+/**
+ * Removes all cached responses. Should be called when a new session with the
+ * LwM2M Server starts, message IDs and tokens of the previous one are no longer
+ * relevant.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_response_cache_clear(anj_t *anj);
+
+#endif // ANJ_WITH_RESPONSE_CACHE
+
+#endif // ANJ_SRC_CORE_RESPONSE_CACHE_H
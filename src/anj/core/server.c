@@ -8,6 +8,7 @@
  */
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -23,15 +24,149 @@
 #include "../exchange.h"
 #include "../utils.h"
 #include "core_utils.h"
+#include "in_flight.h"
+#include "response_cache.h"
 #include "server.h"
 
 #define _ANJ_SERVER_MINIMAL_BLOCK_SIZE 16
 #define _ANJ_SERVER_GENERIC_ERROR -1
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+#    define _ANJ_SERVER_MAXIMAL_BLOCK_SIZE 1024
+// number of exchanges without losses after which the block size limit is
+// doubled
+#    define _ANJ_SERVER_BLOCK_SIZE_PROBE_INTERVAL 8
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+#ifdef ANJ_COAP_WITH_TCP
+// RFC 8323 5.3.1: Max-Message-Size assumed until CSM of the peer is received
+#    define _ANJ_SERVER_DEFAULT_PEER_MAX_MSG_SIZE 1152
+#endif // ANJ_COAP_WITH_TCP
 
 static int net_again_is_error(int result) {
     return result == ANJ_NET_EAGAIN ? _ANJ_SERVER_GENERIC_ERROR : result;
 }
 
+bool _anj_server_reliable_transport(const _anj_server_connection_ctx_t *ctx) {
+    assert(ctx);
+#ifdef ANJ_COAP_WITH_TCP
+    return ctx->type == ANJ_NET_BINDING_TCP || ctx->type == ANJ_NET_BINDING_TLS;
+#else  // ANJ_COAP_WITH_TCP
+    (void) ctx;
+    return false;
+#endif // ANJ_COAP_WITH_TCP
+}
+
+#ifdef ANJ_COAP_WITH_TCP
+static void queue_signalling_msg(_anj_server_connection_ctx_t *ctx,
+                                 _anj_coap_msg_t *msg) {
+    size_t msg_len;
+    int res = _anj_coap_encode_tcp(
+            msg, &ctx->signalling_buffer[ctx->signalling_len],
+            sizeof(ctx->signalling_buffer) - ctx->signalling_len, &msg_len);
+    if (res) {
+        log(L_WARNING, "Could not queue signalling message: %d", res);
+        return;
+    }
+    ctx->signalling_len += msg_len;
+}
+
+// Returns ANJ_NET_EAGAIN if some of the signalling messages are not sent yet.
+static int flush_signalling_msgs(_anj_server_connection_ctx_t *ctx) {
+    if (!ctx->signalling_len) {
+        return ANJ_NET_OK;
+    }
+    size_t consumed_bytes;
+    int result = anj_net_send(ctx->type, ctx->net_ctx, &consumed_bytes,
+                              &ctx->signalling_buffer[ctx->signalling_sent],
+                              ctx->signalling_len - ctx->signalling_sent);
+    if (!anj_net_is_ok(result)) {
+        return result;
+    }
+    ctx->signalling_sent += consumed_bytes;
+    if (ctx->signalling_sent < ctx->signalling_len) {
+        return ANJ_NET_EAGAIN;
+    }
+    log(L_TRACE, "Sent %zu bytes of signalling messages", ctx->signalling_len);
+    ctx->signalling_len = 0;
+    ctx->signalling_sent = 0;
+    return ANJ_NET_OK;
+}
+
+static void reset_stream(_anj_server_connection_ctx_t *ctx) {
+    ctx->stream_begin = 0;
+    ctx->stream_end = 0;
+    ctx->stream_skip = 0;
+    ctx->signalling_len = 0;
+    ctx->signalling_sent = 0;
+    ctx->peer_max_msg_size = _ANJ_SERVER_DEFAULT_PEER_MAX_MSG_SIZE;
+    if (!_anj_server_reliable_transport(ctx)) {
+        return;
+    }
+    // RFC 8323 5.3: CSM is the first message sent on the connection
+    _anj_coap_msg_t csm;
+    memset(&csm, 0, sizeof(csm));
+    csm.operation = ANJ_OP_COAP_CSM;
+    csm.signalling_opts.csm.max_msg_size = ANJ_IN_MSG_BUFFER_SIZE;
+    csm.signalling_opts.csm.block_wise_transfer_capable = true;
+    queue_signalling_msg(ctx, &csm);
+}
+
+bool _anj_server_handle_signalling_msg(anj_t *anj, const _anj_coap_msg_t *msg) {
+    assert(anj && msg);
+    _anj_server_connection_ctx_t *ctx = &anj->connection_ctx;
+    if (!_anj_server_reliable_transport(ctx)) {
+        return false;
+    }
+    switch (msg->operation) {
+    case ANJ_OP_COAP_CSM:
+        if (msg->signalling_opts.csm.max_msg_size) {
+            ctx->peer_max_msg_size = msg->signalling_opts.csm.max_msg_size;
+        }
+        log(L_DEBUG, "CSM received, Max-Message-Size: %" PRIu32,
+            ctx->peer_max_msg_size);
+        return true;
+    case ANJ_OP_COAP_PING: {
+        _anj_coap_msg_t pong;
+        memset(&pong, 0, sizeof(pong));
+        pong.operation = ANJ_OP_COAP_PONG;
+        pong.token = msg->token;
+        pong.signalling_opts.ping_pong.custody =
+                msg->signalling_opts.ping_pong.custody;
+        queue_signalling_msg(ctx, &pong);
+        // otherwise Pong is sent right before the next message
+        if (!ctx->send_in_progress) {
+            int result = flush_signalling_msgs(ctx);
+            if (!anj_net_is_ok(result) && !anj_net_is_again(result)) {
+                log(L_WARNING, "Could not send Pong: %d", result);
+            }
+        }
+        return true;
+    }
+    case ANJ_OP_COAP_PONG:
+    // RFC 8323 3.4: Empty messages are always ignored
+    case ANJ_OP_COAP_EMPTY_MSG:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif // ANJ_COAP_WITH_TCP
+
+int _anj_server_decode_msg(const _anj_server_connection_ctx_t *ctx,
+                           uint8_t *buffer,
+                           size_t length,
+                           _anj_coap_msg_t *out_msg) {
+    assert(ctx && buffer && out_msg);
+    (void) ctx;
+#ifdef ANJ_COAP_WITH_TCP
+    if (_anj_server_reliable_transport(ctx)) {
+        // buffer holds exactly one message, see receive_stream()
+        size_t offset;
+        return _anj_coap_decode_tcp(buffer, length, out_msg, &offset);
+    }
+#endif // ANJ_COAP_WITH_TCP
+    return _anj_coap_decode_udp(buffer, length, out_msg);
+}
+
 int _anj_server_connect(_anj_server_connection_ctx_t *ctx,
                         anj_net_binding_type_t type,
                         const anj_net_config_t *net_socket_cfg,
@@ -86,6 +221,14 @@ int _anj_server_connect(_anj_server_connection_ctx_t *ctx,
             log(L_ERROR, "Could not get MTU: %d", result);
             return net_again_is_error(result);
         }
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+        ctx->block_size_limit = _ANJ_SERVER_MAXIMAL_BLOCK_SIZE;
+        ctx->exchanges_without_loss = 0;
+        ctx->loss_in_exchange = false;
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+#ifdef ANJ_COAP_WITH_TCP
+        reset_stream(ctx);
+#endif // ANJ_COAP_WITH_TCP
         log(L_INFO, "Connected to %s:%s", hostname, port);
     } else if (!anj_net_is_again(result)) {
         log(L_ERROR, "Connection failed: %d", result);
@@ -97,6 +240,19 @@ int _anj_server_close(_anj_server_connection_ctx_t *ctx, bool cleanup) {
     assert(ctx);
     ctx->bytes_sent = 0;
     ctx->send_in_progress = false;
+#ifdef ANJ_COAP_WITH_TCP
+    ctx->signalling_len = 0;
+    ctx->signalling_sent = 0;
+    // data from the previous connection is not handled
+    ctx->stream_begin = 0;
+    ctx->stream_end = 0;
+    ctx->stream_skip = 0;
+#endif // ANJ_COAP_WITH_TCP
+#ifdef ANJ_NET_WITH_BATCHED_IO
+    // datagrams from the previous connection are not handled
+    ctx->recv_batch_count = 0;
+    ctx->recv_batch_idx = 0;
+#endif // ANJ_NET_WITH_BATCHED_IO
 
     if (!ctx->net_ctx) {
         // nothing to do, net_ctx was not created or already cleaned up
@@ -139,15 +295,10 @@ int _anj_server_close(_anj_server_connection_ctx_t *ctx, bool cleanup) {
     return result;
 }
 
-int _anj_server_send(_anj_server_connection_ctx_t *ctx,
-                     const uint8_t *buffer,
-                     size_t length) {
-    assert(ctx && ctx->net_ctx);
-    size_t consumed_bytes;
-    ctx->send_in_progress = true;
-    int result =
-            anj_net_send(ctx->type, ctx->net_ctx, &consumed_bytes,
-                         &buffer[ctx->bytes_sent], length - ctx->bytes_sent);
+static int handle_send_result(_anj_server_connection_ctx_t *ctx,
+                              int result,
+                              size_t consumed_bytes,
+                              size_t length) {
     if (anj_net_is_ok(result)) {
         log(L_TRACE, "Sent %zu bytes", consumed_bytes);
         ctx->bytes_sent += consumed_bytes;
@@ -165,15 +316,387 @@ int _anj_server_send(_anj_server_connection_ctx_t *ctx,
     return result;
 }
 
+int _anj_server_send(_anj_server_connection_ctx_t *ctx,
+                     const uint8_t *buffer,
+                     size_t length) {
+    assert(ctx && ctx->net_ctx);
+    size_t consumed_bytes;
+    ctx->send_in_progress = true;
+#ifdef ANJ_COAP_WITH_TCP
+    // signalling messages can't be interleaved with the message in the stream
+    if (!ctx->bytes_sent) {
+        int result = flush_signalling_msgs(ctx);
+        if (!anj_net_is_ok(result)) {
+            if (!anj_net_is_again(result)) {
+                ctx->send_in_progress = false;
+            }
+            return result;
+        }
+    }
+#endif // ANJ_COAP_WITH_TCP
+    int result =
+            anj_net_send(ctx->type, ctx->net_ctx, &consumed_bytes,
+                         &buffer[ctx->bytes_sent], length - ctx->bytes_sent);
+    return handle_send_result(ctx, result, consumed_bytes, length);
+}
+
+#ifdef ANJ_NET_WITH_SEND_IOV
+int _anj_server_send_iov(_anj_server_connection_ctx_t *ctx,
+                         const anj_net_iovec_t *iov,
+                         size_t iov_count) {
+    assert(ctx && ctx->net_ctx && iov_count <= _ANJ_SERVER_MAX_IOV_COUNT);
+    // skip the part of the message sent with the previous calls
+    anj_net_iovec_t remaining[_ANJ_SERVER_MAX_IOV_COUNT];
+    size_t remaining_count = 0;
+    size_t to_skip = ctx->bytes_sent;
+    size_t length = 0;
+    for (size_t i = 0; i < iov_count; i++) {
+        length += iov[i].length;
+        if (to_skip >= iov[i].length) {
+            to_skip -= iov[i].length;
+            continue;
+        }
+        remaining[remaining_count++] = (anj_net_iovec_t) {
+            .buf = &iov[i].buf[to_skip],
+            .length = iov[i].length - to_skip
+        };
+        to_skip = 0;
+    }
+    size_t consumed_bytes;
+    ctx->send_in_progress = true;
+    int result = anj_net_send_iov(ctx->type, ctx->net_ctx, &consumed_bytes,
+                                  remaining, remaining_count);
+    if (result == ANJ_NET_ENOTSUP) {
+        log(L_ERROR, "Scatter/gather send not supported by the binding");
+    }
+    return handle_send_result(ctx, result, consumed_bytes, length);
+}
+#endif // ANJ_NET_WITH_SEND_IOV
+
+#if defined(ANJ_NET_WITH_SEND_IOV) || defined(ANJ_WITH_IN_PLACE_PAYLOAD)
+static const uint8_t g_payload_marker = 0xFF;
+#endif // defined(ANJ_NET_WITH_SEND_IOV) || defined(ANJ_WITH_IN_PLACE_PAYLOAD)
+
+#ifdef ANJ_WITH_IN_PLACE_PAYLOAD
+// header and options are encoded in front of this offset
+#    define OUT_PAYLOAD_OFFSET \
+        (ANJ_OUT_MSG_BUFFER_SIZE - ANJ_OUT_PAYLOAD_BUFFER_SIZE)
+#endif // ANJ_WITH_IN_PLACE_PAYLOAD
+
+uint8_t *_anj_server_payload_buffer(anj_t *anj) {
+    assert(anj);
+#ifdef ANJ_WITH_IN_PLACE_PAYLOAD
+    return &anj->out_buffer[OUT_PAYLOAD_OFFSET];
+#else  // ANJ_WITH_IN_PLACE_PAYLOAD
+    return anj->payload_buffer;
+#endif // ANJ_WITH_IN_PLACE_PAYLOAD
+}
+
+const uint8_t *_anj_server_out_msg(const anj_t *anj) {
+    assert(anj);
+#ifdef ANJ_WITH_IN_PLACE_PAYLOAD
+    return &anj->out_buffer[anj->out_msg_offset];
+#else  // ANJ_WITH_IN_PLACE_PAYLOAD
+    return anj->out_buffer;
+#endif // ANJ_WITH_IN_PLACE_PAYLOAD
+}
+
+void _anj_server_copy_out_msg(const anj_t *anj, uint8_t *out_buffer) {
+    assert(anj && out_buffer);
+#ifdef ANJ_NET_WITH_SEND_IOV
+    memcpy(out_buffer, anj->out_buffer, anj->out_header_len);
+    if (anj->out_payload_len) {
+        out_buffer[anj->out_header_len] = g_payload_marker;
+        memcpy(&out_buffer[anj->out_header_len + 1], anj->out_payload,
+               anj->out_payload_len);
+    }
+#else  // ANJ_NET_WITH_SEND_IOV
+    memcpy(out_buffer, _anj_server_out_msg(anj), anj->out_msg_len);
+#endif // ANJ_NET_WITH_SEND_IOV
+}
+
+// Encodes the outgoing message to anj->out_buffer; if scatter/gather send or
+// in-place payload is enabled, the payload is left where it was prepared.
+static int encode_out_msg(anj_t *anj, _anj_coap_msg_t *msg) {
+#ifdef ANJ_NET_WITH_SEND_IOV
+    int res = _anj_coap_encode_udp_header(msg, anj->out_buffer,
+                                          _ANJ_OUT_BUFFER_SIZE,
+                                          &anj->out_header_len);
+    if (res) {
+        return res;
+    }
+    anj->out_payload = msg->payload;
+    anj->out_payload_len = msg->payload ? msg->payload_size : 0;
+    anj->out_msg_len = anj->out_header_len;
+    if (anj->out_payload_len) {
+        anj->out_msg_len += 1 + anj->out_payload_len;
+    }
+    return anj->out_msg_len > ANJ_OUT_MSG_BUFFER_SIZE ? _ANJ_ERR_BUFF : 0;
+#elif defined(ANJ_WITH_IN_PLACE_PAYLOAD)
+    if (!msg->payload || !msg->payload_size) {
+        anj->out_msg_offset = 0;
+        return _anj_coap_encode_udp(msg, anj->out_buffer,
+                                    ANJ_OUT_MSG_BUFFER_SIZE, &anj->out_msg_len);
+    }
+    // payload is already at OUT_PAYLOAD_OFFSET, header is encoded at the
+    // beginning of out_buffer and moved right in front of the payload marker
+    assert(msg->payload == &anj->out_buffer[OUT_PAYLOAD_OFFSET]);
+    size_t header_len;
+    int res = _anj_coap_encode_udp_header(msg, anj->out_buffer,
+                                          OUT_PAYLOAD_OFFSET - 1, &header_len);
+    if (res) {
+        return res;
+    }
+    anj->out_msg_offset = OUT_PAYLOAD_OFFSET - 1 - header_len;
+    memmove(&anj->out_buffer[anj->out_msg_offset], anj->out_buffer,
+            header_len);
+    anj->out_buffer[OUT_PAYLOAD_OFFSET - 1] = g_payload_marker;
+    anj->out_msg_len = header_len + 1 + msg->payload_size;
+    return 0;
+#else  // ANJ_NET_WITH_SEND_IOV
+#    ifdef ANJ_COAP_WITH_TCP
+    if (_anj_server_reliable_transport(&anj->connection_ctx)) {
+        return _anj_coap_encode_tcp(msg, anj->out_buffer,
+                                    ANJ_OUT_MSG_BUFFER_SIZE, &anj->out_msg_len);
+    }
+#    endif // ANJ_COAP_WITH_TCP
+    return _anj_coap_encode_udp(msg, anj->out_buffer, ANJ_OUT_MSG_BUFFER_SIZE,
+                                &anj->out_msg_len);
+#endif // ANJ_NET_WITH_SEND_IOV
+}
+
+static int send_out_msg(anj_t *anj) {
+#ifdef ANJ_NET_WITH_SEND_IOV
+    anj_net_iovec_t iov[_ANJ_SERVER_MAX_IOV_COUNT] = {
+        {
+            .buf = anj->out_buffer,
+            .length = anj->out_header_len
+        },
+        {
+            .buf = &g_payload_marker,
+            .length = 1
+        },
+        {
+            .buf = anj->out_payload,
+            .length = anj->out_payload_len
+        }
+    };
+    return _anj_server_send_iov(&anj->connection_ctx, iov,
+                                anj->out_payload_len ? 3 : 1);
+#else  // ANJ_NET_WITH_SEND_IOV
+    return _anj_server_send(&anj->connection_ctx, _anj_server_out_msg(anj),
+                            anj->out_msg_len);
+#endif // ANJ_NET_WITH_SEND_IOV
+}
+
+#ifdef ANJ_NET_WITH_BATCHED_IO
+int _anj_server_send_batch(_anj_server_connection_ctx_t *ctx,
+                           const anj_net_datagram_t *datagrams,
+                           size_t count) {
+    assert(ctx && ctx->net_ctx && !ctx->send_in_progress);
+    size_t sent = 0;
+    while (sent < count) {
+        size_t sent_now;
+        int result = anj_net_send_batch(ctx->type, ctx->net_ctx,
+                                        &datagrams[sent], count - sent,
+                                        &sent_now);
+        if (result == ANJ_NET_ENOTSUP) {
+            // send one by one, partial send of a datagram is not possible
+            for (; sent < count; sent++) {
+                result = _anj_server_send(ctx, datagrams[sent].buf,
+                                          datagrams[sent].length);
+                if (result) {
+                    ctx->bytes_sent = 0;
+                    ctx->send_in_progress = false;
+                    return result;
+                }
+            }
+            return ANJ_NET_OK;
+        }
+        if (result) {
+            return result;
+        }
+        log(L_TRACE, "Sent %zu datagrams", sent_now);
+        sent += sent_now;
+    }
+    return ANJ_NET_OK;
+}
+
+static bool pop_received_datagram(_anj_server_connection_ctx_t *ctx,
+                                  uint8_t *buffer,
+                                  size_t *out_length,
+                                  size_t length) {
+    while (ctx->recv_batch_idx < ctx->recv_batch_count) {
+        size_t idx = ctx->recv_batch_idx++;
+        if (ctx->recv_batch_length[idx] <= length) {
+            memcpy(buffer, ctx->recv_batch[idx], ctx->recv_batch_length[idx]);
+            *out_length = ctx->recv_batch_length[idx];
+            return true;
+        }
+        log(L_ERROR, "Message too long, dropping");
+    }
+    return false;
+}
+
+// Returns ANJ_NET_ENOTSUP if the binding doesn't support batched I/O.
+static int receive_batch(_anj_server_connection_ctx_t *ctx,
+                         uint8_t *buffer,
+                         size_t *out_length,
+                         size_t length) {
+    anj_net_datagram_t datagrams[ANJ_NET_RECV_BATCH_SIZE];
+    datagrams[0] = (anj_net_datagram_t) {
+        .buf = buffer,
+        .length = length
+    };
+    for (size_t i = 1; i < ANJ_NET_RECV_BATCH_SIZE; i++) {
+        datagrams[i] = (anj_net_datagram_t) {
+            .buf = ctx->recv_batch[i - 1],
+            .length = ANJ_IN_MSG_BUFFER_SIZE
+        };
+    }
+    size_t count;
+    int result = anj_net_recv_batch(ctx->type, ctx->net_ctx, datagrams,
+                                    ANJ_NET_RECV_BATCH_SIZE, &count);
+    if (!anj_net_is_ok(result)) {
+        return result;
+    }
+    log(L_TRACE, "Received %zu datagrams", count);
+    // remaining datagrams are handled with the next calls, truncated ones are
+    // dropped
+    ctx->recv_batch_idx = 0;
+    ctx->recv_batch_count = 0;
+    for (size_t i = 1; i < count; i++) {
+        ctx->recv_batch_length[ctx->recv_batch_count++] =
+                datagrams[i].truncated ? SIZE_MAX : datagrams[i].bytes_received;
+    }
+    if (!datagrams[0].truncated) {
+        *out_length = datagrams[0].bytes_received;
+        return ANJ_NET_OK;
+    }
+    log(L_ERROR, "Message too long, dropping");
+    return pop_received_datagram(ctx, buffer, out_length, length)
+                   ? ANJ_NET_OK
+                   : ANJ_NET_EAGAIN;
+}
+#endif // ANJ_NET_WITH_BATCHED_IO
+
+#ifdef ANJ_COAP_WITH_TCP
+// Checks if the message that starts at stream_begin is received completely.
+// Returns a negative value if the stream can't be split into messages anymore.
+static int stream_msg_size(_anj_server_connection_ctx_t *ctx,
+                           uint8_t *buffer,
+                           size_t *out_msg_size,
+                           bool *out_complete) {
+    size_t available = ctx->stream_end - ctx->stream_begin;
+    int res = _anj_coap_tcp_frame_size(&buffer[ctx->stream_begin], available,
+                                       out_msg_size);
+    if (res < 0) {
+        return res;
+    }
+    if (res) {
+        // at least one more byte is needed to read the message length
+        *out_msg_size = available + 1;
+    }
+    *out_complete = !res && *out_msg_size <= available;
+    return 0;
+}
+
+// Messages are cut out of the stream in place: the caller gets a pointer to
+// the message inside of the buffer, and the data is moved to the beginning of
+// the buffer only if the incomplete message at its end wouldn't fit otherwise.
+static int receive_stream(_anj_server_connection_ctx_t *ctx,
+                          uint8_t *buffer,
+                          uint8_t **out_msg,
+                          size_t *out_length,
+                          size_t length) {
+    while (true) {
+        if (ctx->stream_begin == ctx->stream_end) {
+            ctx->stream_begin = 0;
+            ctx->stream_end = 0;
+        }
+        size_t msg_size;
+        bool complete;
+        if (stream_msg_size(ctx, buffer, &msg_size, &complete)) {
+            log(L_ERROR, "Invalid message length, stream can't be parsed");
+            return _ANJ_SERVER_GENERIC_ERROR;
+        }
+        if (complete) {
+            *out_msg = &buffer[ctx->stream_begin];
+            *out_length = msg_size;
+            ctx->stream_begin += msg_size;
+            log(L_TRACE, "Received %zu bytes", msg_size);
+            return ANJ_NET_OK;
+        }
+        if (msg_size > length) {
+            log(L_ERROR, "Message too long, dropping");
+            ctx->stream_skip = msg_size - (ctx->stream_end - ctx->stream_begin);
+            ctx->stream_begin = 0;
+            ctx->stream_end = 0;
+        } else if (ctx->stream_begin + msg_size > length) {
+            memmove(buffer, &buffer[ctx->stream_begin],
+                    ctx->stream_end - ctx->stream_begin);
+            ctx->stream_end -= ctx->stream_begin;
+            ctx->stream_begin = 0;
+        }
+
+        size_t bytes_received;
+        int result = anj_net_recv(ctx->type, ctx->net_ctx, &bytes_received,
+                                  &buffer[ctx->stream_end],
+                                  length - ctx->stream_end);
+        if (!anj_net_is_ok(result)) {
+            return result;
+        }
+        // there is always space in the buffer, so nothing received means that
+        // the peer closed the connection
+        if (!bytes_received) {
+            log(L_ERROR, "Connection closed by the peer");
+            return _ANJ_SERVER_GENERIC_ERROR;
+        }
+        ctx->stream_end += bytes_received;
+        size_t skipped = ANJ_MIN(ctx->stream_skip, bytes_received);
+        ctx->stream_skip -= skipped;
+        ctx->stream_begin += skipped;
+    }
+}
+#endif // ANJ_COAP_WITH_TCP
+
 int _anj_server_receive(_anj_server_connection_ctx_t *ctx,
                         uint8_t *buffer,
+                        uint8_t **out_msg,
                         size_t *out_length,
                         size_t length) {
     assert(ctx && ctx->net_ctx && !ctx->send_in_progress);
     size_t bytes_received;
+    *out_msg = buffer;
 
+#ifdef ANJ_COAP_WITH_TCP
+    if (_anj_server_reliable_transport(ctx)) {
+        // e.g. Pong that could not be sent right after the Ping was received
+        int result = flush_signalling_msgs(ctx);
+        if (!anj_net_is_ok(result) && !anj_net_is_again(result)) {
+            return result;
+        }
+        result = receive_stream(ctx, buffer, out_msg, out_length, length);
+        if (!anj_net_is_ok(result)) {
+            *out_length = 0;
+        }
+        return result;
+    }
+#endif // ANJ_COAP_WITH_TCP
+#ifdef ANJ_NET_WITH_BATCHED_IO
+    if (pop_received_datagram(ctx, buffer, out_length, length)) {
+        log(L_TRACE, "Received %zu bytes", *out_length);
+        return ANJ_NET_OK;
+    }
+    int result = receive_batch(ctx, buffer, &bytes_received, length);
+    if (result == ANJ_NET_ENOTSUP) {
+        result = anj_net_recv(ctx->type, ctx->net_ctx, &bytes_received,
+                              buffer, length);
+    }
+#else  // ANJ_NET_WITH_BATCHED_IO
     int result = anj_net_recv(ctx->type, ctx->net_ctx, &bytes_received, buffer,
                               length);
+#endif // ANJ_NET_WITH_BATCHED_IO
     if (anj_net_is_ok(result)) {
         *out_length = bytes_received;
         log(L_TRACE, "Received %zu bytes", bytes_received);
@@ -202,12 +725,22 @@ int _anj_server_calculate_max_payload_size(_anj_server_connection_ctx_t *ctx,
     size_t header_max_size =
             server_request ? _ANJ_COAP_UDP_RESPONSE_MSG_HEADER_MAX_SIZE
                            : _anj_coap_calculate_msg_header_max_size(msg);
+#ifdef ANJ_COAP_WITH_TCP
+    if (_anj_server_reliable_transport(ctx)) {
+        max_msg_size = ANJ_MIN(max_msg_size, (size_t) ctx->peer_max_msg_size);
+        header_max_size += _ANJ_COAP_TCP_HEADER_EXTRA_SIZE;
+    }
+#endif // ANJ_COAP_WITH_TCP
     if (header_max_size > max_msg_size) {
         log(L_ERROR, "Buffer too small for message");
         return _ANJ_SERVER_GENERIC_ERROR;
     }
     size_t max_payload_size =
             ANJ_MIN((max_msg_size - header_max_size), payload_buff_size);
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+    max_payload_size =
+            ANJ_MIN(max_payload_size, (size_t) ctx->block_size_limit);
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
     if (max_payload_size < _ANJ_SERVER_MINIMAL_BLOCK_SIZE) {
         log(L_ERROR, "Buffer too small for payload");
         return _ANJ_SERVER_GENERIC_ERROR;
@@ -216,9 +749,69 @@ int _anj_server_calculate_max_payload_size(_anj_server_connection_ctx_t *ctx,
     return 0;
 }
 
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+static void block_size_handle_loss(anj_t *anj) {
+    _anj_server_connection_ctx_t *ctx = &anj->connection_ctx;
+    const _anj_exchange_ctx_t *exchange_ctx = &anj->exchange_ctx;
+    // in exchanges started by the LwM2M Server, timeout means that the Server
+    // stopped sending requests, not that our message was lost
+    if (exchange_ctx->server_request) {
+        return;
+    }
+
+    // the loss might be caused by ICMP Fragmentation Needed message, which
+    // updates the path MTU known by the network stack
+    int32_t mtu;
+    if (anj_net_is_ok(anj_net_get_inner_mtu(ctx->type, ctx->net_ctx, &mtu))
+            && mtu > 0 && mtu != ctx->mtu) {
+        log(L_INFO, "Inner MTU changed from %" PRId32 " to %" PRId32, ctx->mtu,
+            mtu);
+        ctx->mtu = mtu;
+    }
+
+    // loss of a message that is already smaller than a block, e.g. a short
+    // Notify, doesn't mean that smaller blocks would get through
+    const _anj_coap_msg_t *lost_msg = &exchange_ctx->base_msg;
+    if (lost_msg->block.block_type != ANJ_OPTION_BLOCK_1
+            && lost_msg->payload_size <= ctx->block_size_limit) {
+        return;
+    }
+    ctx->loss_in_exchange = true;
+    ctx->exchanges_without_loss = 0;
+
+    // halve the size of the lost payload; losing the same message again does
+    // not change the limit, so it's lowered once per retransmitted message
+    uint16_t block_size = (uint16_t) (_anj_determine_block_buffer_size(
+                                              lost_msg->payload_size)
+                                      / 2);
+    if (block_size >= _ANJ_SERVER_MINIMAL_BLOCK_SIZE
+            && block_size < ctx->block_size_limit) {
+        ctx->block_size_limit = block_size;
+        log(L_DEBUG, "Block size limit lowered to %" PRIu16, block_size);
+    }
+}
+
+static void block_size_handle_exchange_end(_anj_server_connection_ctx_t *ctx) {
+    if (ctx->loss_in_exchange) {
+        ctx->loss_in_exchange = false;
+        return;
+    }
+    if (ctx->block_size_limit < _ANJ_SERVER_MAXIMAL_BLOCK_SIZE
+            && ++ctx->exchanges_without_loss
+                           >= _ANJ_SERVER_BLOCK_SIZE_PROBE_INTERVAL) {
+        ctx->block_size_limit *= 2;
+        ctx->exchanges_without_loss = 0;
+        log(L_DEBUG, "Block size limit raised to %" PRIu16,
+            ctx->block_size_limit);
+    }
+}
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+
 // For the first _anj_server_handle_request() call, _anj_exchange_get_state()
 // always returns ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION even though
-// message is not sent yet (check exchange.h API documentation).
+// message is not sent yet (check exchange.h API documentation). The only
+// exception is a LwM2M Server request that doesn't need a response, then the
+// exchange is already in ANJ_EXCHANGE_STATE_WAITING_MSG state.
 int _anj_server_handle_request(anj_t *anj) {
     int result = 0;
     _anj_exchange_state_t exchange_state =
@@ -231,16 +824,13 @@ int _anj_server_handle_request(anj_t *anj) {
             // For both cases we need to send a message but for new message we
             // also need to build CoAP message first.
             if (exchange_state == ANJ_EXCHANGE_STATE_MSG_TO_SEND) {
-                result = _anj_coap_encode_udp(&msg, anj->out_buffer,
-                                              ANJ_OUT_MSG_BUFFER_SIZE,
-                                              &anj->out_msg_len);
+                result = encode_out_msg(anj, &msg);
                 if (result) {
                     ANJ_CORE_LOG_COAP_ERROR(result);
                     return result;
                 }
             }
-            result = _anj_server_send(&anj->connection_ctx, anj->out_buffer,
-                                      anj->out_msg_len);
+            result = send_out_msg(anj);
             if (anj_net_is_again(result)) {
                 // check for send ACK timeout, error suggests network issue
                 exchange_state =
@@ -253,6 +843,9 @@ int _anj_server_handle_request(anj_t *anj) {
             } else if (result) {
                 return result;
             }
+#ifdef ANJ_WITH_RESPONSE_CACHE
+            _anj_response_cache_store(anj);
+#endif // ANJ_WITH_RESPONSE_CACHE
             exchange_state =
                     _anj_exchange_process(&anj->exchange_ctx,
                                           ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
@@ -260,9 +853,11 @@ int _anj_server_handle_request(anj_t *anj) {
         }
 
         if (exchange_state == ANJ_EXCHANGE_STATE_WAITING_MSG) {
+            uint8_t *msg_data;
             size_t msg_size;
             result = _anj_server_receive(&anj->connection_ctx, anj->in_buffer,
-                                         &msg_size, ANJ_IN_MSG_BUFFER_SIZE);
+                                         &msg_data, &msg_size,
+                                         ANJ_IN_MSG_BUFFER_SIZE);
             if (anj_net_is_again(result)) {
                 // check for receive timeout
                 exchange_state =
@@ -272,14 +867,36 @@ int _anj_server_handle_request(anj_t *anj) {
                     // we're still waiting for a message
                     return result;
                 }
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+                // retransmission is needed or the exchange timed out
+                block_size_handle_loss(anj);
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
             } else if (result) {
                 return result;
             } else {
-                result = _anj_coap_decode_udp(anj->in_buffer, msg_size, &msg);
+                result = _anj_server_decode_msg(&anj->connection_ctx, msg_data,
+                                                msg_size, &msg);
                 if (result) {
                     ANJ_CORE_LOG_COAP_ERROR(result);
                     // drop message and continue waiting
-                } else {
+                }
+#ifdef ANJ_COAP_WITH_TCP
+                else if (_anj_server_handle_signalling_msg(anj, &msg)) {
+                    // CoAP signalling message, not related to the exchange
+                }
+#endif // ANJ_COAP_WITH_TCP
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+                else if (_anj_in_flight_handle_msg(anj, &msg)) {
+                    // response to one of the requests sent earlier, continue
+                    // waiting
+                }
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+#ifdef ANJ_WITH_RESPONSE_CACHE
+                else if (_anj_response_cache_handle_msg(anj, &msg)) {
+                    // retransmission of the request that was already handled
+                }
+#endif // ANJ_WITH_RESPONSE_CACHE
+                else {
                     exchange_state =
                             _anj_exchange_process(&anj->exchange_ctx,
                                                   ANJ_EXCHANGE_EVENT_NEW_MSG,
@@ -294,14 +911,16 @@ int _anj_server_handle_request(anj_t *anj) {
             // related variables
             anj->connection_ctx.bytes_sent = 0;
             anj->connection_ctx.send_in_progress = false;
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+            block_size_handle_exchange_end(&anj->connection_ctx);
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
             return 0;
         }
     }
 }
 
 static int encode_coap_msg(anj_t *anj, _anj_coap_msg_t *msg) {
-    int res = _anj_coap_encode_udp(msg, anj->out_buffer,
-                                   ANJ_OUT_MSG_BUFFER_SIZE, &anj->out_msg_len);
+    int res = encode_out_msg(anj, msg);
     if (res) {
         _anj_exchange_terminate(&anj->exchange_ctx);
         ANJ_CORE_LOG_COAP_ERROR(res);
@@ -322,7 +941,8 @@ int _anj_server_prepare_client_request(anj_t *anj,
         return -1;
     }
     if (_anj_exchange_new_client_request(&anj->exchange_ctx, new_request,
-                                         handlers, anj->payload_buffer,
+                                         handlers,
+                                         _anj_server_payload_buffer(anj),
                                          payload_size)
             != ANJ_EXCHANGE_STATE_MSG_TO_SEND) {
         return -1;
@@ -348,8 +968,14 @@ int _anj_server_prepare_server_request(anj_t *anj,
                                              response_code,
                                              request,
                                              handlers,
-                                             anj->payload_buffer,
+                                             _anj_server_payload_buffer(anj),
                                              payload_size);
+#ifdef ANJ_COAP_WITH_QBLOCK
+    // Non-confirmable request with Q-Block1 option might not need a response
+    if (state == ANJ_EXCHANGE_STATE_WAITING_MSG) {
+        return 0;
+    }
+#endif // ANJ_COAP_WITH_QBLOCK
     // _anj_exchange_new_server_request can't return different state
     assert(state == ANJ_EXCHANGE_STATE_MSG_TO_SEND);
     return encode_coap_msg(anj, request);
@@ -364,3 +990,34 @@ uint64_t _anj_server_calculate_max_transmit_wait(
                         * (double) ((1 << (params->max_retransmit + 1)) - 1))
                        * params->ack_random_factor);
 }
+
+#ifdef ANJ_WITH_CORE_POLL_INFO
+uint64_t _anj_server_poll_deadline(anj_t *anj, uint8_t *out_events) {
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+    // datagrams received earlier are not reported by the socket
+    if (anj->connection_ctx.recv_batch_idx
+            < anj->connection_ctx.recv_batch_count) {
+        return 0;
+    }
+#    endif // ANJ_NET_WITH_BATCHED_IO
+#    ifdef ANJ_COAP_WITH_TCP
+    // messages received earlier together with the previous one
+    size_t msg_size;
+    bool complete;
+    if (_anj_server_reliable_transport(&anj->connection_ctx)
+            && !stream_msg_size(&anj->connection_ctx, anj->in_buffer,
+                                &msg_size, &complete)
+            && complete) {
+        return 0;
+    }
+#    endif // ANJ_COAP_WITH_TCP
+    if (_anj_exchange_get_state(&anj->exchange_ctx)
+            == ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION) {
+        // previous attempt to send the message returned ANJ_NET_EAGAIN
+        *out_events |= ANJ_CORE_POLL_OUT;
+    } else {
+        *out_events |= ANJ_CORE_POLL_IN;
+    }
+    return _anj_exchange_next_timeout(&anj->exchange_ctx);
+}
+#endif // ANJ_WITH_CORE_POLL_INFO
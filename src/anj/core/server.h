@@ -21,6 +21,11 @@
 #include "../coap/coap.h"
 #include "../exchange.h"
 
+#ifdef ANJ_NET_WITH_SEND_IOV
+// CoAP header with options, payload marker and payload
+#    define _ANJ_SERVER_MAX_IOV_COUNT 3
+#endif // ANJ_NET_WITH_SEND_IOV
+
 /**
  * Establishes a connection to the server. If @ref ANJ_NET_EAGAIN is returned,
  * this function must be called again with the same arguments.
@@ -71,13 +76,94 @@ int _anj_server_send(_anj_server_connection_ctx_t *ctx,
                      const uint8_t *buffer,
                      size_t length);
 
+#ifdef ANJ_NET_WITH_SEND_IOV
+/**
+ * Works like @ref _anj_server_send, but the message is gathered from
+ * @p iov_count buffers and sent with @ref anj_net_send_iov_t. If
+ * @ref ANJ_NET_EAGAIN is returned, this function must be called again with the
+ * same arguments.
+ *
+ * @param ctx        Server connection context.
+ * @param iov        Parts of the message to send, in order.
+ * @param iov_count  Number of elements in @p iov, at most
+ *                   @ref _ANJ_SERVER_MAX_IOV_COUNT.
+ *
+ * @return @ref ANJ_NET_OK or @ref ANJ_NET_EAGAIN on success, a negative value
+ *        in case of an error.
+ */
+int _anj_server_send_iov(_anj_server_connection_ctx_t *ctx,
+                         const anj_net_iovec_t *iov,
+                         size_t iov_count);
+#endif // ANJ_NET_WITH_SEND_IOV
+
+/**
+ * Returns the buffer in which the payload of outgoing messages is prepared:
+ * <c>anj->payload_buffer</c>, or the end of <c>anj->out_buffer</c> if
+ * @ref ANJ_WITH_IN_PLACE_PAYLOAD is enabled. It is
+ * @ref ANJ_OUT_PAYLOAD_BUFFER_SIZE bytes long.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+uint8_t *_anj_server_payload_buffer(anj_t *anj);
+
+/**
+ * Returns the beginning of the outgoing message, last encoded with
+ * @ref _anj_server_prepare_client_request,
+ * @ref _anj_server_prepare_server_request or @ref _anj_server_handle_request.
+ * If @ref ANJ_NET_WITH_SEND_IOV is enabled, only CoAP header and options are
+ * there.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+const uint8_t *_anj_server_out_msg(const anj_t *anj);
+
+/**
+ * Copies the whole outgoing message, last encoded with
+ * @ref _anj_server_prepare_client_request,
+ * @ref _anj_server_prepare_server_request or @ref _anj_server_handle_request,
+ * to @p out_buffer.
+ *
+ * @param      anj         Anjay object to operate on.
+ * @param[out] out_buffer  Buffer of at least <c>anj->out_msg_len</c> bytes.
+ */
+void _anj_server_copy_out_msg(const anj_t *anj, uint8_t *out_buffer);
+
+#ifdef ANJ_NET_WITH_BATCHED_IO
+/**
+ * Sends multiple datagrams to the server, using @ref anj_net_send_batch_t if
+ * the binding supports it. Must not be called while a message sent with
+ * @ref _anj_server_send is in progress. Datagrams that could not be sent
+ * because the operation would block are not retried.
+ *
+ * @param ctx        Server connection context.
+ * @param datagrams  Datagrams to send.
+ * @param count      Number of datagrams.
+ *
+ * @return @ref ANJ_NET_OK if all datagrams were sent, @ref ANJ_NET_EAGAIN if
+ *         some of them weren't, a negative value in case of an error.
+ */
+int _anj_server_send_batch(_anj_server_connection_ctx_t *ctx,
+                           const anj_net_datagram_t *datagrams,
+                           size_t count);
+#endif // ANJ_NET_WITH_BATCHED_IO
+
 /**
  * Receives a message from the server. If this function returns error,
  * connection must be closed. @ref ANJ_NET_OK returned means that new message
  * was received.
  *
+ * If @ref ANJ_NET_WITH_BATCHED_IO is enabled, up to
+ * @ref ANJ_NET_RECV_BATCH_SIZE pending datagrams are received at once, and the
+ * following calls return them without calling the network layer.
+ *
+ * For TCP and TLS bindings @p buffer holds the part of the stream that is not
+ * handled yet, so it must be the same buffer in all calls for the connection.
+ * A message may arrive in several reads, or several messages in one read; each
+ * call returns a single message, placed anywhere in @p buffer.
+ *
  * @param      ctx        Server connection context.
- * @param[out] buffer     Pointer to the buffer to store the received message.
+ * @param      buffer     Buffer to store the received data.
+ * @param[out] out_msg    Beginning of the received message in @p buffer.
  * @param[out] out_length Pointer to the length of the received message.
  * @param      length     Length of the buffer.
  *
@@ -86,9 +172,54 @@ int _anj_server_send(_anj_server_connection_ctx_t *ctx,
  */
 int _anj_server_receive(_anj_server_connection_ctx_t *ctx,
                         uint8_t *buffer,
+                        uint8_t **out_msg,
                         size_t *out_length,
                         size_t length);
 
+/**
+ * Checks if the connection uses CoAP over reliable transport (RFC 8323), i.e.
+ * TCP or TLS binding.
+ *
+ * @param ctx  Server connection context.
+ *
+ * @return true for TCP and TLS bindings, false otherwise.
+ */
+bool _anj_server_reliable_transport(const _anj_server_connection_ctx_t *ctx);
+
+/**
+ * Decodes the message received with @ref _anj_server_receive, using CoAP over
+ * TCP or CoAP over UDP depending on the binding of the connection.
+ *
+ * @param      ctx      Server connection context.
+ * @param      buffer   Received message.
+ * @param      length   Length of the received message.
+ * @param[out] out_msg  Decoded message.
+ *
+ * @return 0 on success, a non-zero value if the message can't be decoded and
+ *         should be dropped.
+ */
+int _anj_server_decode_msg(const _anj_server_connection_ctx_t *ctx,
+                           uint8_t *buffer,
+                           size_t length,
+                           _anj_coap_msg_t *out_msg);
+
+#ifdef ANJ_COAP_WITH_TCP
+/**
+ * Handles CoAP signalling messages of CoAP over TCP (RFC 8323, section 5):
+ * Max-Message-Size from CSM of the LwM2M Server is taken into account when
+ * calculating the payload size, Ping is answered with Pong and Empty messages
+ * are ignored. CSM of the LwM2M Client is sent right after the connection is
+ * established, before any other message.
+ *
+ * @param anj  Anjay object to operate on.
+ * @param msg  Decoded message.
+ *
+ * @return true if @p msg was a signalling or Empty message received over TCP or
+ *         TLS and must not be processed further, false otherwise.
+ */
+bool _anj_server_handle_signalling_msg(anj_t *anj, const _anj_coap_msg_t *msg);
+#endif // ANJ_COAP_WITH_TCP
+
 /**
  * Calculates the maximum payload size that can be sent in a single message.
  * Calculation is based on given arguments and the MTU of the network
@@ -170,4 +301,19 @@ int _anj_server_prepare_server_request(anj_t *anj,
 uint64_t _anj_server_calculate_max_transmit_wait(
         const _anj_exchange_udp_tx_params_t *params);
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * Returns the time at which @ref _anj_server_handle_request has to be called
+ * again, even if no socket event occurs, and adds the awaited events to
+ * @p out_events. If there is no ongoing exchange, incoming messages are
+ * awaited and @ref ANJ_TIME_UNDEFINED is returned.
+ *
+ * @param         anj         Anjay instance.
+ * @param[in,out] out_events  Bitmask of ANJ_CORE_POLL_* values.
+ *
+ * @return Time in milliseconds, as returned by @ref anj_time_real_now.
+ */
+uint64_t _anj_server_poll_deadline(anj_t *anj, uint8_t *out_events);
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 #endif // ANJ_SRC_CORE_SERVER_H
@@ -28,6 +28,7 @@
 #include "bootstrap.h"
 #include "core.h"
 #include "core_utils.h"
+#include "response_cache.h"
 #include "server.h"
 #include "server_bootstrap.h"
 
@@ -81,6 +82,9 @@ int _anj_server_bootstrap_start_bootstrap_operation(anj_t *anj) {
     }
     // if last bootstrap session was aborted, we need to reset the state
     _anj_bootstrap_reset(anj);
+#    ifdef ANJ_WITH_RESPONSE_CACHE
+    _anj_response_cache_clear(anj);
+#    endif // ANJ_WITH_RESPONSE_CACHE
     if (anj->security_instance.client_hold_off_time > 0) {
         anj->server_state.details.bootstrap.bootstrap_timeout =
                 anj_time_real_now()
@@ -96,15 +100,27 @@ int _anj_server_bootstrap_start_bootstrap_operation(anj_t *anj) {
     return 0;
 }
 
-static int handle_incoming_message(anj_t *anj, size_t msg_size) {
+static int
+handle_incoming_message(anj_t *anj, uint8_t *msg_data, size_t msg_size) {
     _anj_coap_msg_t msg;
     memset(&msg, 0, sizeof(msg));
-    int res = _anj_coap_decode_udp(anj->in_buffer, msg_size, &msg);
+    int res = _anj_server_decode_msg(&anj->connection_ctx, msg_data, msg_size,
+                                     &msg);
     if (res) {
         ANJ_CORE_LOG_COAP_ERROR(res);
         // ignore invalid messages
         return 0;
     }
+#    ifdef ANJ_COAP_WITH_TCP
+    if (_anj_server_handle_signalling_msg(anj, &msg)) {
+        return 0;
+    }
+#    endif // ANJ_COAP_WITH_TCP
+#    ifdef ANJ_WITH_RESPONSE_CACHE
+    if (_anj_response_cache_handle_msg(anj, &msg)) {
+        return 0;
+    }
+#    endif // ANJ_WITH_RESPONSE_CACHE
 
     _anj_exchange_handlers_t exchange_handlers = { 0 };
     uint8_t response_code = 0;
@@ -158,13 +174,15 @@ static _anj_core_next_action_t handle_bootstrap_process(anj_t *anj) {
     switch (result) {
     case _ANJ_BOOTSTRAP_IN_PROGRESS: {
         // check for new requests
+        uint8_t *msg_data;
         size_t msg_size;
         result = _anj_server_receive(&anj->connection_ctx, anj->in_buffer,
-                                     &msg_size, ANJ_IN_MSG_BUFFER_SIZE);
+                                     &msg_data, &msg_size,
+                                     ANJ_IN_MSG_BUFFER_SIZE);
         if (anj_net_is_ok(result)) {
             // new message received, if decode fails or not recognized -
             // drop
-            result = handle_incoming_message(anj, msg_size);
+            result = handle_incoming_message(anj, msg_data, msg_size);
             if (result) {
                 anj->server_state.details.bootstrap.bootstrap_state =
                         _ANJ_SRV_BOOTSTRAP_STATE_FINISH_DISCONNECT_AND_RETRY;
@@ -328,4 +346,27 @@ _anj_core_next_action_t _anj_server_bootstrap_process_bootstrap_operation(
     }
 }
 
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+uint64_t _anj_server_bootstrap_poll_deadline(anj_t *anj, uint8_t *out_events) {
+    switch (anj->server_state.details.bootstrap.bootstrap_state) {
+    case _ANJ_SRV_BOOTSTRAP_STATE_BOOTSTRAP_IN_PROGRESS: {
+        uint64_t deadline = _anj_server_poll_deadline(anj, out_events);
+        if (!_anj_exchange_ongoing_exchange(&anj->exchange_ctx)
+                && anj->bootstrap_ctx.in_progress) {
+            // waiting for the Bootstrap Server requests
+            deadline = ANJ_MIN(deadline, _anj_core_time_after(
+                                                 anj->bootstrap_ctx.lifetime));
+        }
+        return deadline;
+    }
+    case _ANJ_SRV_BOOTSTRAP_STATE_WAITING:
+        return _anj_core_time_after(
+                anj->server_state.details.bootstrap.bootstrap_timeout);
+    default:
+        // connection is being opened or closed
+        return 0;
+    }
+}
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
 #endif // ANJ_WITH_BOOTSTRAP
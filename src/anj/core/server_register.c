@@ -39,6 +39,10 @@
 #include "server.h"
 #include "server_register.h"
 
+#ifdef ANJ_WITH_LWM2M_SEND
+#    include "lwm2m_send.h"
+#endif // ANJ_WITH_LWM2M_SEND
+
 #ifndef NDEBUG
 typedef struct {
     uint16_t rid;
@@ -189,6 +193,9 @@ int _anj_server_register_start_register_operation(anj_t *anj) {
     anj->server_state.details.registration.retry_seq_count = 0;
 
 #ifdef ANJ_WITH_LWM2M_SEND
+#    ifdef ANJ_WITH_OFFLINE_STORE
+    _anj_lwm2m_send_store_queued(anj);
+#    endif // ANJ_WITH_OFFLINE_STORE
     anj_send_abort(anj, ANJ_SEND_ID_ALL);
 #endif // ANJ_WITH_LWM2M_SEND
 #ifdef ANJ_WITH_OBSERVE
@@ -354,3 +361,18 @@ _anj_server_register_process_register_operation(anj_t *anj,
     ANJ_UNREACHABLE("Invalid state");
     return _ANJ_CORE_NEXT_ACTION_LEAVE;
 }
+
+#ifdef ANJ_WITH_CORE_POLL_INFO
+uint64_t _anj_server_register_poll_deadline(anj_t *anj, uint8_t *out_events) {
+    switch (anj->server_state.details.registration.registration_state) {
+    case _ANJ_SRV_REG_STATE_REGISTER_IN_PROGRESS:
+        return _anj_server_poll_deadline(anj, out_events);
+    case _ANJ_SRV_REG_STATE_RESTART_IN_PROGRESS:
+        return _anj_core_time_after(
+                anj->server_state.details.registration.retry_timeout);
+    default:
+        // connection is being opened or closed
+        return 0;
+    }
+}
+#endif // ANJ_WITH_CORE_POLL_INFO
@@ -53,4 +53,18 @@ _anj_core_next_action_t
 _anj_server_register_process_register_operation(anj_t *anj,
                                                 anj_conn_status_t *out_status);
 
+#ifdef ANJ_WITH_CORE_POLL_INFO
+/**
+ * Returns the time at which
+ * @ref _anj_server_register_process_register_operation has to be called, even
+ * if no socket event occurs, and adds the awaited events to @p out_events.
+ *
+ * @param         anj         Anjay object to operate on.
+ * @param[in,out] out_events  Bitmask of ANJ_CORE_POLL_* values.
+ *
+ * @returns Time in milliseconds, as returned by @ref anj_time_real_now.
+ */
+uint64_t _anj_server_register_poll_deadline(anj_t *anj, uint8_t *out_events);
+#endif // ANJ_WITH_CORE_POLL_INFO
+
 #endif // ANJ_SRC_CORE_SERVER_REGISTER_H
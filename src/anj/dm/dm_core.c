@@ -59,17 +59,85 @@ uint16_t _anj_dm_count_obj_insts(const anj_dm_obj_t *obj) {
     return count;
 }
 
-const anj_dm_obj_t *_anj_dm_find_obj(_anj_dm_data_model_t *dm, anj_oid_t oid) {
-    for (uint16_t idx = 0; idx < dm->objs_count; idx++) {
-        if (dm->objs[idx]->oid == oid) {
-            return dm->objs[idx];
-        } else if (dm->objs[idx]->oid > oid) {
-            break;
+#ifdef ANJ_DM_WITH_BINARY_SEARCH
+// All ID arrays in the data model are sorted in ascending order and unused
+// slots are packed at the end and set to ANJ_ID_INVALID, which is the highest
+// possible ID value, so every array can be searched as a whole. Each lookup
+// finds the first element that is not less than the searched ID.
+static uint16_t find_obj_idx(_anj_dm_data_model_t *dm, anj_oid_t oid) {
+    uint16_t low = 0;
+    uint16_t high = dm->objs_count;
+    while (low < high) {
+        uint16_t mid = (uint16_t) (low + (high - low) / 2);
+        if (dm->objs[mid]->oid < oid) {
+            low = (uint16_t) (mid + 1);
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static const anj_dm_obj_inst_t *_anj_dm_find_inst(const anj_dm_obj_t *obj,
+                                                  anj_iid_t iid) {
+    uint16_t low = 0;
+    uint16_t high = obj->max_inst_count;
+    while (low < high) {
+        uint16_t mid = (uint16_t) (low + (high - low) / 2);
+        if (obj->insts[mid].iid < iid) {
+            low = (uint16_t) (mid + 1);
+        } else {
+            high = mid;
         }
     }
+    if (low < obj->max_inst_count && obj->insts[low].iid == iid) {
+        return &obj->insts[low];
+    }
     return NULL;
 }
 
+static const anj_dm_res_t *_anj_dm_find_res(const anj_dm_obj_inst_t *inst,
+                                            anj_rid_t rid) {
+    uint16_t low = 0;
+    uint16_t high = inst->res_count;
+    while (low < high) {
+        uint16_t mid = (uint16_t) (low + (high - low) / 2);
+        if (inst->resources[mid].rid < rid) {
+            low = (uint16_t) (mid + 1);
+        } else {
+            high = mid;
+        }
+    }
+    if (low < inst->res_count && inst->resources[low].rid == rid) {
+        return &inst->resources[low];
+    }
+    return NULL;
+}
+
+static bool res_inst_exists(const anj_dm_res_t *res, anj_riid_t riid) {
+    uint16_t low = 0;
+    uint16_t high = res->max_inst_count;
+    while (low < high) {
+        uint16_t mid = (uint16_t) (low + (high - low) / 2);
+        if (res->insts[mid] < riid) {
+            low = (uint16_t) (mid + 1);
+        } else {
+            high = mid;
+        }
+    }
+    return low < res->max_inst_count && res->insts[low] == riid;
+}
+#else  // ANJ_DM_WITH_BINARY_SEARCH
+static uint16_t find_obj_idx(_anj_dm_data_model_t *dm, anj_oid_t oid) {
+    uint16_t idx;
+    for (idx = 0; idx < dm->objs_count; idx++) {
+        if (dm->objs[idx]->oid >= oid) {
+            break;
+        }
+    }
+    return idx;
+}
+
 static const anj_dm_obj_inst_t *_anj_dm_find_inst(const anj_dm_obj_t *obj,
                                                   anj_iid_t iid) {
     for (uint16_t idx = 0; idx < obj->max_inst_count; idx++) {
@@ -104,6 +172,15 @@ static bool res_inst_exists(const anj_dm_res_t *res, anj_riid_t riid) {
     }
     return false;
 }
+#endif // ANJ_DM_WITH_BINARY_SEARCH
+
+const anj_dm_obj_t *_anj_dm_find_obj(_anj_dm_data_model_t *dm, anj_oid_t oid) {
+    uint16_t idx = find_obj_idx(dm, oid);
+    if (idx < dm->objs_count && dm->objs[idx]->oid == oid) {
+        return dm->objs[idx];
+    }
+    return NULL;
+}
 
 static int finish_ongoing_operation(anj_t *anj) {
     _anj_dm_data_model_t *dm = &anj->dm;
@@ -138,17 +215,14 @@ int _anj_dm_get_obj_ptr_call_transaction_begin(anj_t *anj,
                                                anj_oid_t oid,
                                                const anj_dm_obj_t **out_obj) {
     _anj_dm_data_model_t *dm = &anj->dm;
-    for (uint16_t idx = 0; idx < dm->objs_count; idx++) {
-        if (dm->objs[idx]->oid == oid) {
-            *out_obj = dm->objs[idx];
-            if (!dm->in_transaction[idx]) {
-                dm->in_transaction[idx] = true;
-                return _anj_dm_call_transaction_begin(anj, *out_obj);
-            }
-            return 0;
-        } else if (dm->objs[idx]->oid > oid) {
-            break;
+    uint16_t idx = find_obj_idx(dm, oid);
+    if (idx < dm->objs_count && dm->objs[idx]->oid == oid) {
+        *out_obj = dm->objs[idx];
+        if (!dm->in_transaction[idx]) {
+            dm->in_transaction[idx] = true;
+            return _anj_dm_call_transaction_begin(anj, *out_obj);
         }
+        return 0;
     }
     dm_log(L_ERROR, "Object /%" PRIu16 " not found in data model", oid);
     return ANJ_DM_ERR_NOT_FOUND;
@@ -109,6 +109,23 @@ static void uri_log(const anj_uri_path_t *path) {
     }
 }
 
+static int out_ctx_init(anj_t *anj,
+                        _anj_op_t op,
+                        const anj_uri_path_t *path,
+                        size_t res_count,
+                        uint16_t format) {
+    int res = _anj_io_out_ctx_init(&anj->anj_io.out_ctx, op, path, res_count,
+                                   format);
+#ifdef ANJ_WITH_TLV
+    if (!res) {
+        _anj_io_out_ctx_set_tlv_length_cb(&anj->anj_io.out_ctx,
+                                          _anj_dm_get_tlv_aggregate_length,
+                                          anj);
+    }
+#endif // ANJ_WITH_TLV
+    return res;
+}
+
 static int handle_read_payload_result(_anj_dm_data_model_t *ctx,
                                       int anj_io_return_code,
                                       int dm_return_code,
@@ -277,19 +294,20 @@ static int process_read(anj_t *anj,
             }
             dm_log(L_TRACE, "Reading from:");
             resource_uri_trace_log(&ctx->out_record.path);
-            ret_anj = _anj_io_out_ctx_new_entry(&anj->anj_io.out_ctx,
-                                                &ctx->out_record);
-            if (ret_anj) {
-                dm_log(L_ERROR, "anj_io out ctx error %d", ret_anj);
-                return map_anj_io_err_to_coap_code(ret_anj);
+            ret_anj = _anj_io_out_ctx_add_entry(&anj->anj_io.out_ctx,
+                                                &ctx->out_record,
+                                                &buff[*out_payload_len],
+                                                buff_len - *out_payload_len,
+                                                &copied_bytes);
+        } else {
+            if (ctx->op_count == 0) {
+                ret_dm = _ANJ_DM_LAST_RECORD;
             }
-        } else if (ctx->op_count == 0) {
-            ret_dm = _ANJ_DM_LAST_RECORD;
+            ret_anj = _anj_io_out_ctx_get_payload(&anj->anj_io.out_ctx,
+                                                  &buff[*out_payload_len],
+                                                  buff_len - *out_payload_len,
+                                                  &copied_bytes);
         }
-        ret_anj = _anj_io_out_ctx_get_payload(&anj->anj_io.out_ctx,
-                                              &buff[*out_payload_len],
-                                              buff_len - *out_payload_len,
-                                              &copied_bytes);
         *out_payload_len += copied_bytes;
         int ret = handle_read_payload_result(ctx, ret_anj, ret_dm,
                                              *out_payload_len, buff_len);
@@ -595,10 +613,9 @@ static uint8_t _dm_write_payload(void *arg_ptr,
                 break;
             }
 
-            ret_val = _anj_io_out_ctx_init(&anj->anj_io.out_ctx,
-                                           ANJ_OP_DM_READ_COMP,
-                                           &ANJ_MAKE_ROOT_PATH(), res_count,
-                                           ctx->composite_format);
+            ret_val = out_ctx_init(anj, ANJ_OP_DM_READ_COMP,
+                                   &ANJ_MAKE_ROOT_PATH(), res_count,
+                                   ctx->composite_format);
 
             if (res_count == 0) {
                 ctx->composite_path_count = 0;
@@ -719,9 +736,8 @@ void _anj_dm_process_request(anj_t *anj,
             if (!res_count) {
                 dm_log(L_INFO, "No readable resources for given path");
             }
-            ret_val = _anj_io_out_ctx_init(&anj->anj_io.out_ctx, ANJ_OP_DM_READ,
-                                           &request->uri, res_count,
-                                           request->accept);
+            ret_val = out_ctx_init(anj, ANJ_OP_DM_READ, &request->uri,
+                                   res_count, request->accept);
             if (ret_val) {
                 ret_val = ret_val != _ANJ_IO_ERR_UNSUPPORTED_FORMAT
                                   ? map_anj_io_err_to_coap_code(ret_val)
@@ -874,9 +890,9 @@ int _anj_dm_observe_build_msg(anj_t *anj,
             res_count += path_res_count;
         }
 
-        res = _anj_io_out_ctx_init(&anj->anj_io.out_ctx, op,
-                                   composite ? &ANJ_MAKE_ROOT_PATH() : paths[0],
-                                   res_count, *inout_format);
+        res = out_ctx_init(anj, op,
+                           composite ? &ANJ_MAKE_ROOT_PATH() : paths[0],
+                           res_count, *inout_format);
         if (res) {
             res = map_anj_io_err_to_coap_code(res);
             goto finalize;
@@ -936,8 +952,8 @@ int _anj_dm_observe_build_msg(anj_t *anj,
             goto finalize;
         }
 
-        res = _anj_io_out_ctx_init(&anj->anj_io.out_ctx, ANJ_OP_DM_READ,
-                                   paths[0], res_count, *inout_format);
+        res = out_ctx_init(anj, ANJ_OP_DM_READ, paths[0], res_count,
+                           *inout_format);
         if (res) {
             res = map_anj_io_err_to_coap_code(res);
             goto finalize;
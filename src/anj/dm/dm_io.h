@@ -117,6 +117,28 @@ int _anj_dm_operation_end(anj_t *anj);
  */
 int _anj_dm_get_read_entry(anj_t *anj, anj_io_out_entry_t *out_record);
 
+#ifdef ANJ_WITH_TLV
+/**
+ * Calculates the length of TLV encoded Object Instance or Multiple Resource
+ * pointed by @p path, as it will be returned by @ref _anj_dm_get_read_entry.
+ * Matches the @ref _anj_io_tlv_length_cb_t callback type, so that the TLV
+ * encoder can call it before encoding the first record of the aggregate.
+ *
+ * Values of the Resources are read to determine their lengths, so for TLV
+ * format the read handler is called twice for every Resource (Instance) nested
+ * in an aggregate and has to return the same value both times.
+ *
+ * @param      arg        Anjay object to operate on.
+ * @param      path       Object Instance or Resource path.
+ * @param[out] out_length Length of the aggregate value.
+ *
+ * @returns 0 on success, a negative value in case of error.
+ */
+int _anj_dm_get_tlv_aggregate_length(void *arg,
+                                     const anj_uri_path_t *path,
+                                     size_t *out_length);
+#endif // ANJ_WITH_TLV
+
 /**
  * Returns information about the number of Resources and Resource Instances that
  * can be read for the READ operation currently in progress.
@@ -285,6 +285,81 @@ int _anj_dm_get_read_entry(anj_t *anj, anj_io_out_entry_t *out_record) {
     return dm->op_count > 0 ? 0 : _ANJ_DM_LAST_RECORD;
 }
 
+#ifdef ANJ_WITH_TLV
+static int add_tlv_record_length(anj_t *anj,
+                                 _anj_dm_entity_ptrs_t *ptrs,
+                                 uint16_t id,
+                                 size_t *inout_length) {
+    anj_io_out_entry_t entry = {
+        .type = ptrs->res->type
+    };
+    int ret = get_read_value(anj, &entry.value, ptrs);
+    if (ret) {
+        return ret;
+    }
+    size_t value_length;
+    ret = _anj_io_tlv_value_length(&entry, true, &value_length);
+    if (ret) {
+        return ret;
+    }
+    *inout_length += _anj_io_tlv_header_length(id, value_length) + value_length;
+    return 0;
+}
+
+static int get_tlv_multi_res_length(anj_t *anj,
+                                    _anj_dm_entity_ptrs_t *ptrs,
+                                    size_t *out_length) {
+    *out_length = 0;
+    uint16_t inst_count = _anj_dm_count_res_insts(ptrs->res);
+    for (uint16_t idx = 0; idx < inst_count; idx++) {
+        ptrs->riid = ptrs->res->insts[idx];
+        int ret = add_tlv_record_length(anj, ptrs, ptrs->riid, out_length);
+        if (ret) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+int _anj_dm_get_tlv_aggregate_length(void *arg,
+                                     const anj_uri_path_t *path,
+                                     size_t *out_length) {
+    assert(arg && path && out_length);
+    anj_t *anj = (anj_t *) arg;
+    _anj_dm_entity_ptrs_t ptrs;
+    int ret = _anj_dm_get_entity_ptrs(&anj->dm, path, &ptrs);
+    if (ret) {
+        return ret;
+    }
+    if (anj_uri_path_is(path, ANJ_ID_RID)) {
+        return get_tlv_multi_res_length(anj, &ptrs, out_length);
+    }
+    assert(anj_uri_path_is(path, ANJ_ID_IID));
+
+    *out_length = 0;
+    for (uint16_t idx = 0; idx < ptrs.inst->res_count; idx++) {
+        ptrs.res = &ptrs.inst->resources[idx];
+        if (!resource_can_be_read(ptrs.res)) {
+            continue;
+        }
+        if (_anj_dm_is_multi_instance_resource(ptrs.res->operation)) {
+            size_t multi_res_length;
+            ret = get_tlv_multi_res_length(anj, &ptrs, &multi_res_length);
+            *out_length += _anj_io_tlv_header_length(ptrs.res->rid,
+                                                     multi_res_length)
+                           + multi_res_length;
+        } else {
+            ptrs.riid = ANJ_ID_INVALID;
+            ret = add_tlv_record_length(anj, &ptrs, ptrs.res->rid, out_length);
+        }
+        if (ret) {
+            return ret;
+        }
+    }
+    return 0;
+}
+#endif // ANJ_WITH_TLV
+
 void _anj_dm_get_readable_res_count(anj_t *anj, size_t *out_res_count) {
     assert(anj && out_res_count);
     _anj_dm_data_model_t *dm = &anj->dm;
@@ -26,6 +26,13 @@
 
 #define exchange_log(...) anj_log(exchange, __VA_ARGS__)
 
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+#    define _ANJ_EXCHANGE_RTO_MIN_MS 100
+#    define _ANJ_EXCHANGE_RTO_MAX_MS 60000
+// CoCoA: RTO the aged estimate moves towards
+#    define _ANJ_EXCHANGE_RTO_AGING_BASE_MS 1000
+#endif // ANJ_WITH_ADAPTIVE_RTO
+
 static uint8_t
 default_read_payload_handler(void *arg_ptr,
                              uint8_t *buff,
@@ -79,21 +86,131 @@ static _anj_exchange_state_t finalize_exchange(_anj_exchange_ctx_t *ctx,
     return ctx->state;
 }
 
+static bool reliable_transport(const _anj_exchange_ctx_t *ctx) {
+#ifdef ANJ_COAP_WITH_TCP
+    return ctx->reliable_transport;
+#else  // ANJ_COAP_WITH_TCP
+    (void) ctx;
+    return false;
+#endif // ANJ_COAP_WITH_TCP
+}
+
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+// Returns RTO calculated from the updated estimator, RFC 6298 section 2.
+static uint64_t rtt_estimator_update(_anj_exchange_rtt_estimator_t *estimator,
+                                     uint64_t rtt_ms,
+                                     uint64_t k) {
+    if (!estimator->initialized) {
+        estimator->initialized = true;
+        estimator->srtt_ms = rtt_ms;
+        estimator->rttvar_ms = rtt_ms / 2;
+    } else {
+        uint64_t rtt_diff = estimator->srtt_ms > rtt_ms
+                                    ? estimator->srtt_ms - rtt_ms
+                                    : rtt_ms - estimator->srtt_ms;
+        estimator->rttvar_ms = (3 * estimator->rttvar_ms + rtt_diff) / 4;
+        estimator->srtt_ms = (7 * estimator->srtt_ms + rtt_ms) / 8;
+    }
+    return estimator->srtt_ms + k * estimator->rttvar_ms;
+}
+
+static void rto_update(_anj_exchange_rto_t *rto,
+                       uint64_t transmission_timestamp_ms,
+                       uint16_t retry_count) {
+    // CoCoA: it's not known to which of the transmissions the response refers,
+    // with more than 2 retransmissions the measurement is not reliable enough
+    if (retry_count > 2) {
+        return;
+    }
+    uint64_t now = anj_time_real_now();
+    uint64_t rtt_ms = now - transmission_timestamp_ms;
+    if (!retry_count) {
+        uint64_t strong_rto = rtt_estimator_update(&rto->strong, rtt_ms, 4);
+        rto->rto_ms = (strong_rto + rto->rto_ms) / 2;
+    } else {
+        uint64_t weak_rto = rtt_estimator_update(&rto->weak, rtt_ms, 1);
+        rto->rto_ms = (weak_rto + 3 * rto->rto_ms) / 4;
+    }
+    rto->rto_ms = ANJ_MAX(rto->rto_ms, _ANJ_EXCHANGE_RTO_MIN_MS);
+    rto->rto_ms = ANJ_MIN(rto->rto_ms, _ANJ_EXCHANGE_RTO_MAX_MS);
+    rto->last_update_timestamp_ms = now;
+    exchange_log(L_TRACE, "RTT: %" PRIu64 " ms, RTO: %" PRIu64 " ms", rtt_ms,
+                 rto->rto_ms);
+}
+
+// CoCoA: small RTO that isn't updated for 16 * RTO is doubled, large one that
+// isn't updated for 4 * RTO is halved and increased by 1 s
+static void rto_aging(_anj_exchange_rto_t *rto) {
+    uint64_t now = anj_time_real_now();
+    uint64_t unchanged_ms = now - rto->last_update_timestamp_ms;
+    if (rto->rto_ms < 1000 && unchanged_ms > 16 * rto->rto_ms) {
+        rto->rto_ms *= 2;
+    } else if (rto->rto_ms > 3000 && unchanged_ms > 4 * rto->rto_ms) {
+        rto->rto_ms = _ANJ_EXCHANGE_RTO_AGING_BASE_MS + rto->rto_ms / 2;
+    } else {
+        return;
+    }
+    rto->last_update_timestamp_ms = now;
+}
+
+static void measure_rtt(_anj_exchange_ctx_t *ctx) {
+    if (!reliable_transport(ctx) && !ctx->separate_response) {
+        rto_update(&ctx->rto, ctx->transmission_timestamp_ms, ctx->retry_count);
+    }
+}
+#endif // ANJ_WITH_ADAPTIVE_RTO
+
+// Timeout after retry_count retransmissions. CoCoA variable backoff factor
+// makes it grow slower for long initial timeouts and faster for short ones.
+static uint64_t retransmission_timeout(uint64_t initial_timeout_ms,
+                                       uint16_t retry_count) {
+    double backoff_factor = 2.0;
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    if (initial_timeout_ms < 1000) {
+        backoff_factor = 3.0;
+    } else if (initial_timeout_ms > 3000) {
+        backoff_factor = 1.5;
+    }
+#endif // ANJ_WITH_ADAPTIVE_RTO
+    return (uint64_t) (pow(backoff_factor, (double) retry_count)
+                       * (double) initial_timeout_ms);
+}
+
 static void exchange_param_init(_anj_exchange_ctx_t *ctx) {
     ctx->retry_count = 0;
     ctx->block_number = 0;
     // RFC 7252 "The initial timeout is set to a random number between
     // ACK_TIMEOUT and (ACK_TIMEOUT * ACK_RANDOM_FACTOR)"
     double ack_timeout_ms = (double) ctx->tx_params.ack_timeout_ms;
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    // RTO estimate is used instead of ACK_TIMEOUT for requests of the client
+    double rto_ms = ack_timeout_ms;
+    if (!ctx->server_request) {
+        rto_aging(&ctx->rto);
+        rto_ms = (double) ctx->rto.rto_ms;
+    }
+#else  // ANJ_WITH_ADAPTIVE_RTO
+    double rto_ms = ack_timeout_ms;
+#endif // ANJ_WITH_ADAPTIVE_RTO
 
     if (ctx->server_request) {
         ctx->timeout_ms = ctx->server_exchange_timeout;
+    } else if (reliable_transport(ctx)) {
+        // response is awaited as long as the retransmissions of the request
+        // would last over UDP: MAX_TRANSMIT_WAIT = ACK_TIMEOUT *
+        // ((2 ** (MAX_RETRANSMIT + 1)) - 1) * ACK_RANDOM_FACTOR
+        ctx->timeout_ms = (uint64_t) (ack_timeout_ms
+                                      * (double) ((1 << (ctx->tx_params
+                                                                 .max_retransmit
+                                                         + 1))
+                                                  - 1)
+                                      * ctx->tx_params.ack_random_factor);
     } else {
         // calculate timeout for the first message, comply with RFC 7252 4.2
         double random_factor = ((double) _anj_rand32_r(&ctx->timeout_rand_seed)
                                 / (double) UINT32_MAX)
                                * (ctx->tx_params.ack_random_factor - 1.0);
-        ctx->timeout_ms = (uint64_t) (ack_timeout_ms * (random_factor + 1.0));
+        ctx->timeout_ms = (uint64_t) (rto_ms * (random_factor + 1.0));
     }
     ctx->timeout_timestamp_ms = anj_time_real_now() + ctx->timeout_ms;
     ctx->send_ack_timeout_timestamp_ms =
@@ -125,6 +242,11 @@ static void handle_send_ack(_anj_exchange_ctx_t *ctx,
         } else {
             ctx->state = ANJ_EXCHANGE_STATE_WAITING_MSG;
             exchange_log(L_TRACE, "message sent, waiting for response");
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+            if (!ctx->retry_count) {
+                ctx->transmission_timestamp_ms = anj_time_real_now();
+            }
+#endif // ANJ_WITH_ADAPTIVE_RTO
         }
     }
 }
@@ -132,6 +254,9 @@ static void handle_send_ack(_anj_exchange_ctx_t *ctx,
 static void handle_server_response(_anj_exchange_ctx_t *ctx,
                                    _anj_coap_msg_t *in_out_msg) {
     if (in_out_msg->operation == ANJ_OP_COAP_EMPTY_MSG) {
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+        measure_rtt(ctx);
+#endif // ANJ_WITH_ADAPTIVE_RTO
         if (ctx->base_msg.operation == ANJ_OP_INF_CON_NOTIFY) {
             finalize_exchange(ctx, in_out_msg, 0);
             return;
@@ -169,6 +294,9 @@ static void handle_server_response(_anj_exchange_ctx_t *ctx,
         exchange_log(L_WARNING, "block number mismatch, ignoring");
         return;
     }
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    measure_rtt(ctx);
+#endif // ANJ_WITH_ADAPTIVE_RTO
 
     if (in_out_msg->msg_code >= ANJ_COAP_CODE_BAD_REQUEST) {
         exchange_log(L_ERROR, "received error response: %" PRIu8,
@@ -275,6 +403,139 @@ send_service_unavailable:
     return;
 }
 
+#ifdef ANJ_COAP_WITH_QBLOCK
+#    define _ANJ_EXCHANGE_CBOR_UINT_MAX_SIZE 5
+
+// RFC 9177: blocks are sent in sets of MAX_PAYLOADS, only the last block of
+// every set is acknowledged with a response
+static bool q_block_set_end(uint32_t block_number) {
+    return (block_number + 1) % ANJ_COAP_QBLOCK_MAX_PAYLOADS == 0;
+}
+
+// Block of a body transferred with Q-Block1 that is not the last one in a set:
+// Confirmable request is only acknowledged, Non-confirmable one is not answered
+static void q_block1_no_response(_anj_exchange_ctx_t *ctx,
+                                 _anj_coap_msg_t *in_out_msg) {
+    reset_exchange_params(ctx);
+    if (reliable_transport(ctx)
+            || in_out_msg->coap_binding_data.udp.type
+                           != ANJ_COAP_UDP_TYPE_CONFIRMABLE) {
+        ctx->state = ANJ_EXCHANGE_STATE_WAITING_MSG;
+        return;
+    }
+    ctx->state = ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION;
+    in_out_msg->operation = ANJ_OP_COAP_EMPTY_MSG;
+    in_out_msg->payload_size = 0;
+    in_out_msg->block.block_type = ANJ_OPTION_BLOCK_NOT_DEFINED;
+    // store the response in case of retransmission
+    ctx->base_msg = *in_out_msg;
+}
+
+static size_t encode_cbor_uint(uint8_t *buff, uint32_t value) {
+    if (value < 24) {
+        buff[0] = (uint8_t) value;
+        return 1;
+    } else if (value <= UINT8_MAX) {
+        buff[0] = 24;
+        buff[1] = (uint8_t) value;
+        return 2;
+    } else if (value <= UINT16_MAX) {
+        buff[0] = 25;
+        buff[1] = (uint8_t) (value >> 8);
+        buff[2] = (uint8_t) value;
+        return 3;
+    }
+    buff[0] = 26;
+    buff[1] = (uint8_t) (value >> 24);
+    buff[2] = (uint8_t) (value >> 16);
+    buff[3] = (uint8_t) (value >> 8);
+    buff[4] = (uint8_t) value;
+    return 5;
+}
+
+// Blocks are passed to the write_payload handler in order, so a block received
+// after a gap can't be used. At the end of the set, the LwM2M Server is asked
+// for all blocks from the first missing one up to the received one.
+static void q_block1_handle_gap(_anj_exchange_ctx_t *ctx,
+                                _anj_coap_msg_t *in_out_msg,
+                                uint32_t first_missing) {
+    if (in_out_msg->block.more_flag
+            && !q_block_set_end(in_out_msg->block.number)) {
+        exchange_log(L_DEBUG,
+                     "block %" PRIu32 " missing, ignoring block %" PRIu32,
+                     first_missing, in_out_msg->block.number);
+        q_block1_no_response(ctx, in_out_msg);
+        return;
+    }
+    // RFC 9177: payload of 4.08 (Request Entity Incomplete) is a CBOR Sequence
+    // of the missing block numbers
+    size_t payload_size = 0;
+    for (uint32_t number = first_missing;
+         number <= in_out_msg->block.number
+         && payload_size + _ANJ_EXCHANGE_CBOR_UINT_MAX_SIZE <= ctx->block_size;
+         number++) {
+        payload_size +=
+                encode_cbor_uint(&ctx->payload_buff[payload_size], number);
+    }
+    exchange_log(L_WARNING, "blocks %" PRIu32 "-%" PRIu32 " missing",
+                 first_missing, in_out_msg->block.number);
+    reset_exchange_params(ctx);
+    ctx->state = ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION;
+    in_out_msg->operation = ANJ_OP_RESPONSE;
+    in_out_msg->msg_code = ANJ_COAP_CODE_REQUEST_ENTITY_INCOMPLETE;
+    in_out_msg->payload = ctx->payload_buff;
+    in_out_msg->payload_size = payload_size;
+    in_out_msg->content_format = _ANJ_COAP_FORMAT_MISSING_BLOCKS_CBOR_SEQ;
+    in_out_msg->block.block_type = ANJ_OPTION_BLOCK_NOT_DEFINED;
+    ctx->base_msg = *in_out_msg;
+}
+
+static bool q_block2_set_in_progress(const _anj_exchange_ctx_t *ctx) {
+    return ctx->server_request && ctx->q_block && ctx->block_transfer
+           && ctx->base_msg.operation != ANJ_OP_COAP_EMPTY_MSG
+           && ctx->base_msg.block.block_type == ANJ_OPTION_BLOCK_2
+           && !q_block_set_end(ctx->base_msg.block.number);
+}
+
+// Next block of the response with Q-Block2 is sent without waiting for the
+// request of the LwM2M Server, as a Non-confirmable response with the same
+// token
+static void q_block2_next_block(_anj_exchange_ctx_t *ctx,
+                                _anj_coap_msg_t *out_msg) {
+    _anj_exchange_read_result_t read_result = { 0 };
+    uint8_t result =
+            ctx->handlers.read_payload(ctx->handlers.arg, ctx->payload_buff,
+                                       ctx->block_size, &read_result);
+    if (result && result != _ANJ_EXCHANGE_BLOCK_TRANSFER_NEEDED) {
+        // part of the response is already sent, only thing to do is to cancel
+        // the exchange
+        exchange_log(L_ERROR,
+                     "error while reading payload: %" PRIu8
+                     ", cancel exchange",
+                     result);
+        finalize_exchange(ctx, NULL, result);
+        return;
+    }
+    ctx->block_transfer = result == _ANJ_EXCHANGE_BLOCK_TRANSFER_NEEDED;
+    _anj_coap_msg_t *msg = &ctx->base_msg;
+    msg->operation = ANJ_OP_RESPONSE;
+    msg->msg_code = ANJ_COAP_CODE_CONTENT;
+    msg->coap_binding_data.udp.type = ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE;
+    msg->payload = ctx->payload_buff;
+    msg->payload_size = read_result.payload_len;
+    msg->content_format = read_result.format;
+    msg->block.number = ++ctx->block_number;
+    msg->block.more_flag = ctx->block_transfer;
+    exchange_log(L_DEBUG, "sending block %" PRIu32 " without request",
+                 ctx->block_number);
+    *out_msg = *msg;
+    ctx->state = ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION;
+    reset_exchange_params(ctx);
+    ctx->send_ack_timeout_timestamp_ms =
+            anj_time_real_now() + _ANJ_EXCHANGE_COAP_PROCESSING_DELAY_MS;
+}
+#endif // ANJ_COAP_WITH_QBLOCK
+
 static void handle_server_request(_anj_exchange_ctx_t *ctx,
                                   _anj_coap_msg_t *in_out_msg) {
     uint8_t response_code = ANJ_COAP_CODE_EMPTY;
@@ -302,7 +563,8 @@ static void handle_server_request(_anj_exchange_ctx_t *ctx,
 
     // message_id and token are the same, so we are facing retransmission of the
     // same request, we should send the same response as before
-    if (ctx->base_msg.coap_binding_data.udp.message_id
+    if (!reliable_transport(ctx)
+            && ctx->base_msg.coap_binding_data.udp.message_id
                     == in_out_msg->coap_binding_data.udp.message_id
             && _anj_tokens_equal(&ctx->base_msg.token, &in_out_msg->token)) {
         exchange_log(L_INFO,
@@ -313,8 +575,36 @@ static void handle_server_request(_anj_exchange_ctx_t *ctx,
         return;
     }
 
+    // LwM2M Server may ask for smaller blocks in the subsequent Block2
+    // requests (RFC 7959, section 2.4), block number is then scaled by the
+    // ratio of the block sizes
+    if (in_out_msg->block.block_type == ANJ_OPTION_BLOCK_2
+            && ctx->block_transfer
+#ifdef ANJ_COAP_WITH_QBLOCK
+            && !ctx->q_block
+#endif // ANJ_COAP_WITH_QBLOCK
+            && in_out_msg->block.size >= 16
+            && in_out_msg->block.size < ctx->block_size) {
+        uint32_t ratio = ctx->block_size / in_out_msg->block.size;
+        if (in_out_msg->block.number == (ctx->block_number + 1) * ratio) {
+            exchange_log(L_DEBUG, "block size changed to %" PRIu16,
+                         in_out_msg->block.size);
+            ctx->block_number = in_out_msg->block.number - 1;
+            ctx->block_size = in_out_msg->block.size;
+        }
+    }
+
     ctx->block_number++;
     if (ctx->block_number != in_out_msg->block.number) {
+#ifdef ANJ_COAP_WITH_QBLOCK
+        if (ctx->q_block
+                && in_out_msg->block.block_type == ANJ_OPTION_BLOCK_1
+                && in_out_msg->block.number > ctx->block_number) {
+            q_block1_handle_gap(ctx, in_out_msg, ctx->block_number);
+            ctx->block_number--;
+            return;
+        }
+#endif // ANJ_COAP_WITH_QBLOCK
         exchange_log(L_WARNING, "block number mismatch, ignoring");
         ctx->block_number--;
         return;
@@ -340,6 +630,13 @@ static void handle_server_request(_anj_exchange_ctx_t *ctx,
             response_code = ctx->block_transfer ? ANJ_COAP_CODE_CONTINUE
                                                 : ctx->msg_code;
         }
+#ifdef ANJ_COAP_WITH_QBLOCK
+        if (ctx->block_transfer && ctx->q_block
+                && !q_block_set_end(in_out_msg->block.number)) {
+            q_block1_no_response(ctx, in_out_msg);
+            return;
+        }
+#endif // ANJ_COAP_WITH_QBLOCK
     }
 
     size_t payload_size = 0;
@@ -374,6 +671,9 @@ static void handle_server_request(_anj_exchange_ctx_t *ctx,
                     .block_type = ANJ_OPTION_BLOCK_2,
                     .size = ctx->block_size
                 };
+#ifdef ANJ_COAP_WITH_QBLOCK
+                in_out_msg->block.q_block = ctx->q_block;
+#endif // ANJ_COAP_WITH_QBLOCK
             }
         } else if (result) {
             exchange_log(L_ERROR, "error while reading payload: %" PRIu8,
@@ -438,6 +738,10 @@ _anj_exchange_new_server_request(_anj_exchange_ctx_t *ctx,
     set_default_handlers(&ctx->handlers);
     ctx->op = in_out_msg->operation;
     ctx->msg_code = response_msg_code;
+#ifdef ANJ_COAP_WITH_QBLOCK
+    ctx->q_block = in_out_msg->block.block_type != ANJ_OPTION_BLOCK_NOT_DEFINED
+                   && in_out_msg->block.q_block;
+#endif // ANJ_COAP_WITH_QBLOCK
 
     exchange_param_init(ctx);
 
@@ -480,6 +784,16 @@ _anj_exchange_new_server_request(_anj_exchange_ctx_t *ctx,
                                              !ctx->block_transfer);
     }
     in_out_msg->payload_size = 0;
+#ifdef ANJ_COAP_WITH_QBLOCK
+    if (!result && ctx->block_transfer && ctx->q_block
+            && !q_block_set_end(in_out_msg->block.number)) {
+        q_block1_no_response(ctx, in_out_msg);
+        exchange_log(L_TRACE, "first block of Q-Block1 transfer received");
+        return ctx->state == ANJ_EXCHANGE_STATE_WAITING_MSG
+                       ? ANJ_EXCHANGE_STATE_WAITING_MSG
+                       : ANJ_EXCHANGE_STATE_MSG_TO_SEND;
+    }
+#endif // ANJ_COAP_WITH_QBLOCK
 
     // for LwM2M there is possible scenario of block transfer in both directions
     // at the same time, but block2 is always prepared after last block1
@@ -510,6 +824,9 @@ _anj_exchange_new_server_request(_anj_exchange_ctx_t *ctx,
                 .block_type = ANJ_OPTION_BLOCK_2,
                 .size = ctx->block_size
             };
+#ifdef ANJ_COAP_WITH_QBLOCK
+            in_out_msg->block.q_block = ctx->q_block;
+#endif // ANJ_COAP_WITH_QBLOCK
         } else {
             in_out_msg->block.block_type = ANJ_OPTION_BLOCK_NOT_DEFINED;
         }
@@ -545,6 +862,9 @@ _anj_exchange_new_client_request(_anj_exchange_ctx_t *ctx,
     ctx->server_request = false;
     ctx->block_transfer = false;
     ctx->msg_code = 0;
+#ifdef ANJ_COAP_WITH_QBLOCK
+    ctx->q_block = false;
+#endif // ANJ_COAP_WITH_QBLOCK
     ctx->handlers = *handlers;
     set_default_handlers(&ctx->handlers);
 
@@ -553,6 +873,12 @@ _anj_exchange_new_client_request(_anj_exchange_ctx_t *ctx,
             (*op == ANJ_OP_INF_NON_CON_SEND || *op == ANJ_OP_INF_NON_CON_NOTIFY)
                     ? false
                     : true;
+    if (reliable_transport(ctx)) {
+        // notifications are not acknowledged, but every request is answered
+        // with a response (RFC 8323, section 2.2)
+        ctx->confirmable = *op != ANJ_OP_INF_CON_NOTIFY
+                           && *op != ANJ_OP_INF_NON_CON_NOTIFY;
+    }
 
     if (*op == ANJ_OP_INF_CON_NOTIFY || *op == ANJ_OP_INF_NON_CON_NOTIFY) {
         const _anj_coap_token_t *token = &in_out_msg->token;
@@ -633,6 +959,15 @@ _anj_exchange_state_t _anj_exchange_process(_anj_exchange_ctx_t *ctx,
             reset_exchange_params(ctx);
             return ANJ_EXCHANGE_STATE_MSG_TO_SEND;
         }
+#ifdef ANJ_COAP_WITH_QBLOCK
+        if (ctx->state == ANJ_EXCHANGE_STATE_WAITING_MSG
+                && q_block2_set_in_progress(ctx)) {
+            q_block2_next_block(ctx, in_out_msg);
+            if (ctx->state == ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION) {
+                return ANJ_EXCHANGE_STATE_MSG_TO_SEND;
+            }
+        }
+#endif // ANJ_COAP_WITH_QBLOCK
         return ctx->state;
     }
 
@@ -658,13 +993,14 @@ _anj_exchange_state_t _anj_exchange_process(_anj_exchange_ctx_t *ctx,
             exchange_log(L_ERROR, "server request timeout occurred");
             return finalize_exchange(ctx, NULL, _ANJ_EXCHANGE_ERROR_TIMEOUT);
         } else {
-            if (ctx->retry_count < ctx->tx_params.max_retransmit) {
+            if (!reliable_transport(ctx)
+                    && ctx->retry_count < ctx->tx_params.max_retransmit) {
                 ctx->retry_count++;
                 uint64_t time_real_now = anj_time_real_now();
                 ctx->timeout_timestamp_ms =
                         time_real_now
-                        + (uint64_t) pow(2.0, (double) ctx->retry_count)
-                                  * ctx->timeout_ms;
+                        + retransmission_timeout(ctx->timeout_ms,
+                                                 ctx->retry_count);
                 ctx->send_ack_timeout_timestamp_ms =
                         time_real_now + _ANJ_EXCHANGE_COAP_PROCESSING_DELAY_MS;
                 exchange_log(L_WARNING, "timeout occurred, retrying");
@@ -700,6 +1036,18 @@ _anj_exchange_state_t _anj_exchange_get_state(_anj_exchange_ctx_t *ctx) {
     return ctx->state;
 }
 
+uint64_t _anj_exchange_next_timeout(const _anj_exchange_ctx_t *ctx) {
+    assert(ctx);
+    switch (ctx->state) {
+    case ANJ_EXCHANGE_STATE_WAITING_SEND_CONFIRMATION:
+        return ctx->send_ack_timeout_timestamp_ms;
+    case ANJ_EXCHANGE_STATE_WAITING_MSG:
+        return ctx->timeout_timestamp_ms;
+    default:
+        return ANJ_TIME_UNDEFINED;
+    }
+}
+
 int _anj_exchange_set_udp_tx_params(
         _anj_exchange_ctx_t *ctx, const _anj_exchange_udp_tx_params_t *params) {
     assert(ctx && params);
@@ -708,6 +1056,9 @@ int _anj_exchange_set_udp_tx_params(
         return -1;
     }
     ctx->tx_params = *params;
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    _anj_exchange_reset_rto(ctx);
+#endif // ANJ_WITH_ADAPTIVE_RTO
     exchange_log(L_DEBUG,
                  "UDP TX params set: ack_timeout_ms=%" PRIu64
                  ", ack_random_factor=%f, max_retransmit=%" PRIu16,
@@ -726,12 +1077,148 @@ void _anj_exchange_set_server_request_timeout(
     ctx->server_exchange_timeout = server_exchange_timeout;
 }
 
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+void _anj_exchange_reset_rto(_anj_exchange_ctx_t *ctx) {
+    assert(ctx);
+    memset(&ctx->rto, 0, sizeof(ctx->rto));
+    ctx->rto.rto_ms = ctx->tx_params.ack_timeout_ms;
+    ctx->rto.last_update_timestamp_ms = anj_time_real_now();
+}
+#endif // ANJ_WITH_ADAPTIVE_RTO
+
+#ifdef ANJ_COAP_WITH_TCP
+void _anj_exchange_set_reliable_transport(_anj_exchange_ctx_t *ctx,
+                                          bool reliable) {
+    assert(ctx && ctx->state == ANJ_EXCHANGE_STATE_FINISHED);
+    ctx->reliable_transport = reliable;
+}
+#endif // ANJ_COAP_WITH_TCP
+
 void _anj_exchange_init(_anj_exchange_ctx_t *ctx, unsigned int random_seed) {
     assert(ctx);
     memset(ctx, 0, sizeof(*ctx));
     ctx->state = ANJ_EXCHANGE_STATE_FINISHED;
     ctx->tx_params = _ANJ_EXCHANGE_UDP_TX_PARAMS_DEFAULT;
     ctx->server_exchange_timeout = _ANJ_EXCHANGE_SERVER_REQUEST_TIMEOUT_MS;
-    ctx->timeout_rand_seed = random_seed;
+    _anj_rand_seed(&ctx->timeout_rand_seed, random_seed);
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+    _anj_exchange_reset_rto(ctx);
+#endif // ANJ_WITH_ADAPTIVE_RTO
     exchange_log(L_DEBUG, "context initialized");
 }
+
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+bool _anj_exchange_can_detach(const _anj_exchange_ctx_t *ctx) {
+    assert(ctx);
+    return ctx->state == ANJ_EXCHANGE_STATE_WAITING_MSG && !ctx->server_request
+           && ctx->confirmable && !ctx->block_transfer
+           && !ctx->separate_response
+           && (ctx->base_msg.operation == ANJ_OP_INF_CON_NOTIFY
+               || ctx->base_msg.operation == ANJ_OP_INF_CON_SEND);
+}
+
+void _anj_exchange_detach(_anj_exchange_ctx_t *ctx,
+                          uint16_t message_id,
+                          _anj_exchange_in_flight_t *out_in_flight) {
+    assert(ctx && out_in_flight);
+    assert(_anj_exchange_can_detach(ctx));
+    *out_in_flight = (_anj_exchange_in_flight_t) {
+        .message_id = message_id,
+        .token = ctx->base_msg.token,
+        .op = ctx->base_msg.operation,
+        .separate_response = false,
+        .retry_count = ctx->retry_count,
+        .timeout_ms = ctx->timeout_ms,
+        .timeout_timestamp_ms = ctx->timeout_timestamp_ms,
+#    ifdef ANJ_WITH_ADAPTIVE_RTO
+        .transmission_timestamp_ms = ctx->transmission_timestamp_ms
+#    endif // ANJ_WITH_ADAPTIVE_RTO
+    };
+    ctx->state = ANJ_EXCHANGE_STATE_FINISHED;
+    exchange_log(L_DEBUG, "exchange detached, message ID: %" PRIu16,
+                 message_id);
+}
+
+_anj_exchange_in_flight_state_t
+_anj_exchange_in_flight_handle_msg(_anj_exchange_ctx_t *ctx,
+                                   _anj_exchange_in_flight_t *in_flight,
+                                   const _anj_coap_msg_t *msg,
+                                   int *out_result) {
+    assert(ctx && in_flight && msg && out_result);
+#    ifndef ANJ_WITH_ADAPTIVE_RTO
+    (void) ctx;
+#    endif // ANJ_WITH_ADAPTIVE_RTO
+    if (msg->operation == ANJ_OP_COAP_EMPTY_MSG
+            || msg->operation == ANJ_OP_COAP_RESET) {
+        if (msg->coap_binding_data.udp.message_id != in_flight->message_id) {
+            return _ANJ_EXCHANGE_IN_FLIGHT_NOT_MATCHED;
+        }
+        if (msg->operation == ANJ_OP_COAP_RESET) {
+            exchange_log(L_WARNING, "received CoAP RESET message");
+            *out_result = ANJ_COAP_CODE_BAD_REQUEST;
+            return _ANJ_EXCHANGE_IN_FLIGHT_FINISHED;
+        }
+#    ifdef ANJ_WITH_ADAPTIVE_RTO
+        if (!in_flight->separate_response) {
+            rto_update(&ctx->rto, in_flight->transmission_timestamp_ms,
+                       in_flight->retry_count);
+        }
+#    endif // ANJ_WITH_ADAPTIVE_RTO
+        if (in_flight->op == ANJ_OP_INF_CON_NOTIFY) {
+            *out_result = 0;
+            return _ANJ_EXCHANGE_IN_FLIGHT_FINISHED;
+        }
+        // request is acknowledged, so it is not retransmitted anymore, but
+        // the separate response is awaited as long as retransmissions would
+        exchange_log(L_DEBUG,
+                     "empty message received, waiting for separate response");
+        in_flight->separate_response = true;
+        in_flight->retry_count = 0;
+        in_flight->timeout_timestamp_ms =
+                anj_time_real_now() + in_flight->timeout_ms;
+        return _ANJ_EXCHANGE_IN_FLIGHT_WAITING;
+    }
+    if (msg->operation != ANJ_OP_RESPONSE
+            || !_anj_tokens_equal(&msg->token, &in_flight->token)) {
+        return _ANJ_EXCHANGE_IN_FLIGHT_NOT_MATCHED;
+    }
+#    ifdef ANJ_WITH_ADAPTIVE_RTO
+    if (!reliable_transport(ctx) && !in_flight->separate_response) {
+        rto_update(&ctx->rto, in_flight->transmission_timestamp_ms,
+                   in_flight->retry_count);
+    }
+#    endif // ANJ_WITH_ADAPTIVE_RTO
+    if (msg->msg_code >= ANJ_COAP_CODE_BAD_REQUEST) {
+        exchange_log(L_ERROR, "received error response: %" PRIu8,
+                     msg->msg_code);
+        *out_result = msg->msg_code;
+    } else {
+        *out_result = 0;
+    }
+    return _ANJ_EXCHANGE_IN_FLIGHT_FINISHED;
+}
+
+_anj_exchange_in_flight_state_t
+_anj_exchange_in_flight_process(const _anj_exchange_ctx_t *ctx,
+                                _anj_exchange_in_flight_t *in_flight) {
+    assert(ctx && in_flight);
+    if (!timeout_occurred(in_flight->timeout_timestamp_ms)) {
+        return _ANJ_EXCHANGE_IN_FLIGHT_WAITING;
+    }
+    if (reliable_transport(ctx)
+            || in_flight->retry_count >= ctx->tx_params.max_retransmit) {
+        exchange_log(L_ERROR, "client request timeout occurred");
+        return _ANJ_EXCHANGE_IN_FLIGHT_FINISHED;
+    }
+    in_flight->retry_count++;
+    in_flight->timeout_timestamp_ms =
+            anj_time_real_now()
+            + retransmission_timeout(in_flight->timeout_ms,
+                                     in_flight->retry_count);
+    if (in_flight->separate_response) {
+        return _ANJ_EXCHANGE_IN_FLIGHT_WAITING;
+    }
+    exchange_log(L_WARNING, "timeout occurred, retrying");
+    return _ANJ_EXCHANGE_IN_FLIGHT_RETRANSMIT;
+}
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
@@ -110,7 +110,9 @@ typedef enum {
  * @param[inout] buff              Payload buffer used for the response.
  * @param        buff_len          Length of the payload buffer.
  *
- * @returns Initial state of the exchange.
+ * @returns Initial state of the exchange: @ref ANJ_EXCHANGE_STATE_MSG_TO_SEND,
+ *          or @ref ANJ_EXCHANGE_STATE_WAITING_MSG if the request is a block of a
+ *          Q-Block1 transfer that is not answered (RFC 9177).
  */
 _anj_exchange_state_t
 _anj_exchange_new_server_request(_anj_exchange_ctx_t *ctx,
@@ -191,7 +193,9 @@ _anj_exchange_new_client_request(_anj_exchange_ctx_t *ctx,
  *  - block-wise Early negotiation for LwM2M Server requests, except for the
  *    Composite operations with block-wise transfer in both directions,
  *  - NSTART = 1, which means that for additional LwM2M Server request will
- *    respond with the @ref ANJ_COAP_CODE_SERVICE_UNAVAILABLE code,
+ *    respond with the @ref ANJ_COAP_CODE_SERVICE_UNAVAILABLE code; confirmable
+ *    Notify and Send requests can be detached from the context with @ref
+ *    _anj_exchange_detach to keep more of them outstanding,
  *  - block-wise transfer in both directions, but only with the same block size,
  * Late negotiation mechanism for block-wise transfer is not supported. Changing
  * the size of a block during an ongoing exchange will cause an error and abort
@@ -243,6 +247,18 @@ bool _anj_exchange_ongoing_exchange(_anj_exchange_ctx_t *ctx);
  */
 _anj_exchange_state_t _anj_exchange_get_state(_anj_exchange_ctx_t *ctx);
 
+/**
+ * Gets the time at which the exchange has to be processed with
+ * @ref ANJ_EXCHANGE_EVENT_NONE to handle a timeout or a retransmission, even
+ * if no message arrives and the pending message can't be sent.
+ *
+ * @param ctx  Exchange context.
+ *
+ * @returns Time in milliseconds, as returned by @ref anj_time_real_now, or
+ *          @ref ANJ_TIME_UNDEFINED if there is no ongoing exchange.
+ */
+uint64_t _anj_exchange_next_timeout(const _anj_exchange_ctx_t *ctx);
+
 /**
  * Sets the CoAP transmission parameters for given context. If never called, the
  * default values will be used (RFC 7252).
@@ -268,6 +284,33 @@ int _anj_exchange_set_udp_tx_params(
 void _anj_exchange_set_server_request_timeout(_anj_exchange_ctx_t *ctx,
                                               uint64_t server_exchange_timeout);
 
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+/**
+ * Discards round-trip times measured so far, the retransmission timeout starts
+ * again from ACK_TIMEOUT. Should be called when connecting to another LwM2M
+ * Server.
+ *
+ * @param ctx  Exchange context.
+ */
+void _anj_exchange_reset_rto(_anj_exchange_ctx_t *ctx);
+#endif // ANJ_WITH_ADAPTIVE_RTO
+
+#ifdef ANJ_COAP_WITH_TCP
+/**
+ * Configures the exchange for CoAP over reliable transport (RFC 8323), i.e. TCP
+ * or TLS. There are no message types and acknowledgements there: requests are
+ * never retransmitted, notifications are considered delivered once sent, and
+ * every request of the LwM2M Client, including Non-confirmable Send, awaits the
+ * response for MAX_TRANSMIT_WAIT calculated from the transmission parameters.
+ * Must not be called during an ongoing exchange.
+ *
+ * @param ctx       Exchange context,
+ * @param reliable  true for CoAP over TCP or TLS, false for CoAP over UDP.
+ */
+void _anj_exchange_set_reliable_transport(_anj_exchange_ctx_t *ctx,
+                                          bool reliable);
+#endif // ANJ_COAP_WITH_TCP
+
 /**
  * Initializes the exchange module context. Should be called once for each
  * context. Specific exchange context is related with one server connection.
@@ -277,6 +320,88 @@ void _anj_exchange_set_server_request_timeout(_anj_exchange_ctx_t *ctx,
  */
 void _anj_exchange_init(_anj_exchange_ctx_t *ctx, unsigned int random_seed);
 
+#ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+/**
+ * States of a request detached with @ref _anj_exchange_detach.
+ */
+typedef enum {
+    // message is not related to the request
+    _ANJ_EXCHANGE_IN_FLIGHT_NOT_MATCHED,
+    // still waiting for the response
+    _ANJ_EXCHANGE_IN_FLIGHT_WAITING,
+    // the request has to be sent again
+    _ANJ_EXCHANGE_IN_FLIGHT_RETRANSMIT,
+    // request is finished, result is provided
+    _ANJ_EXCHANGE_IN_FLIGHT_FINISHED
+} _anj_exchange_in_flight_state_t;
+
+/**
+ * Checks if the ongoing exchange can be detached from the context with @ref
+ * _anj_exchange_detach. This is only possible for confirmable Notify and Send
+ * requests that fit in a single message, were already sent and are waiting for
+ * the acknowledgement.
+ *
+ * @param ctx  Exchange context.
+ *
+ * @returns True if the exchange can be detached.
+ */
+bool _anj_exchange_can_detach(const _anj_exchange_ctx_t *ctx);
+
+/**
+ * Moves the state of the ongoing exchange to @p out_in_flight and finishes the
+ * exchange without calling @ref _anj_exchange_completion_t, so that the next
+ * exchange can be started. From now on, incoming messages should be passed to
+ * @ref _anj_exchange_in_flight_handle_msg and @ref
+ * _anj_exchange_in_flight_process should be called periodically. Must be
+ * called only if @ref _anj_exchange_can_detach returns true.
+ *
+ * @param      ctx            Exchange context.
+ * @param      message_id     Message ID of the message that was sent.
+ * @param[out] out_in_flight  State of the detached request.
+ */
+void _anj_exchange_detach(_anj_exchange_ctx_t *ctx,
+                          uint16_t message_id,
+                          _anj_exchange_in_flight_t *out_in_flight);
+
+/**
+ * Checks if @p msg is related to the detached request and processes it.
+ *
+ * @param      ctx         Exchange context the request was detached from, its
+ *                         RTO estimate is updated if
+ *                         @ref ANJ_WITH_ADAPTIVE_RTO is enabled.
+ * @param      in_flight   State of the detached request.
+ * @param      msg         Incoming message.
+ * @param[out] out_result  Result of the request if @ref
+ *                         _ANJ_EXCHANGE_IN_FLIGHT_FINISHED is returned, with
+ *                         the same meaning as in @ref
+ *                         _anj_exchange_completion_t.
+ *
+ * @returns @ref _ANJ_EXCHANGE_IN_FLIGHT_NOT_MATCHED if the message should be
+ *          handled elsewhere, @ref _ANJ_EXCHANGE_IN_FLIGHT_WAITING or @ref
+ *          _ANJ_EXCHANGE_IN_FLIGHT_FINISHED otherwise.
+ */
+_anj_exchange_in_flight_state_t
+_anj_exchange_in_flight_handle_msg(_anj_exchange_ctx_t *ctx,
+                                   _anj_exchange_in_flight_t *in_flight,
+                                   const _anj_coap_msg_t *msg,
+                                   int *out_result);
+
+/**
+ * Handles retransmissions and timeout of the detached request, using
+ * transmission parameters of @p ctx.
+ *
+ * @param ctx        Exchange context the request was detached from.
+ * @param in_flight  State of the detached request.
+ *
+ * @returns @ref _ANJ_EXCHANGE_IN_FLIGHT_RETRANSMIT if the message should be
+ *          sent again, @ref _ANJ_EXCHANGE_IN_FLIGHT_FINISHED in case of
+ *          timeout, or @ref _ANJ_EXCHANGE_IN_FLIGHT_WAITING.
+ */
+_anj_exchange_in_flight_state_t
+_anj_exchange_in_flight_process(const _anj_exchange_ctx_t *ctx,
+                                _anj_exchange_in_flight_t *in_flight);
+#endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,9 +35,56 @@
 #    include "internal.h"
 #    include "io.h"
 
+static bool prebuffer_empty(const _anj_cbor_ll_decoder_t *ctx) {
+    return ctx->prebuffer_offset == ctx->prebuffer_size;
+}
+
+/**
+ * Headers and numbers are read directly from the input buffer. The prebuffer
+ * is used only if they are split between payload chunks, and then only until
+ * the bytes of the previous chunk are consumed, see try_rewind_prebuffer().
+ */
+static const uint8_t *next_bytes(const _anj_cbor_ll_decoder_t *ctx) {
+    return prebuffer_empty(ctx) ? ctx->input
+                                : ctx->prebuffer + ctx->prebuffer_offset;
+}
+
+static size_t available_bytes(const _anj_cbor_ll_decoder_t *ctx) {
+    return prebuffer_empty(ctx)
+                   ? (size_t) (ctx->input_end - ctx->input)
+                   : (size_t) (ctx->prebuffer_size - ctx->prebuffer_offset);
+}
+
+// Moves the input pointer back over the unconsumed prebuffered bytes if all of
+// them were copied from the current payload chunk, so that decoding continues
+// directly from the input buffer
+static void try_rewind_prebuffer(_anj_cbor_ll_decoder_t *ctx) {
+    size_t prebuffered_bytes = ctx->prebuffer_size - ctx->prebuffer_offset;
+    assert(ctx->input >= ctx->input_begin);
+    if (prebuffered_bytes
+            && (size_t) (ctx->input - ctx->input_begin) >= prebuffered_bytes) {
+        ctx->input -= prebuffered_bytes;
+        ctx->prebuffer_size = 0;
+        ctx->prebuffer_offset = 0;
+    }
+}
+
+static void consume_bytes(_anj_cbor_ll_decoder_t *ctx, uint8_t count) {
+    assert(available_bytes(ctx) >= count);
+    if (prebuffer_empty(ctx)) {
+        ctx->input += count;
+    } else {
+        ctx->prebuffer_offset += count;
+        try_rewind_prebuffer(ctx);
+    }
+}
+
+// Ensures that at least min_size bytes are available through next_bytes(),
+// unless the payload is finished
 static int fill_prebuffer(_anj_cbor_ll_decoder_t *ctx, uint8_t min_size) {
     assert(min_size <= sizeof(ctx->prebuffer));
-    if (ctx->prebuffer_size - ctx->prebuffer_offset >= min_size) {
+    if (available_bytes(ctx) >= min_size
+            || (prebuffer_empty(ctx) && ctx->input_last)) {
         return 0;
     }
     if (ctx->prebuffer_offset) {
@@ -153,11 +200,11 @@ static void ignore_tag(_anj_cbor_ll_decoder_t *ctx) {
 #    endif // ANJ_WITH_CBOR_DECODE_DECIMAL_FRACTIONS
     uint8_t ext_len_size = parse_ext_length_size(ctx);
     if (ext_len_size) {
-        if (ctx->prebuffer_offset + ext_len_size > ctx->prebuffer_size) {
+        if (available_bytes(ctx) < ext_len_size) {
             assert(ctx->input_last);
             ctx->state = ANJ_CBOR_LL_DECODER_STATE_ERROR;
         } else {
-            ctx->prebuffer_offset += ext_len_size;
+            consume_bytes(ctx, ext_len_size);
         }
     }
 }
@@ -191,7 +238,7 @@ static int preprocess_next_value(_anj_cbor_ll_decoder_t *ctx) {
             return result;
         }
         assert(ctx->prebuffer_offset <= ctx->prebuffer_size);
-        if (ctx->prebuffer_offset == ctx->prebuffer_size) {
+        if (!available_bytes(ctx)) {
             // EOF
             if (ctx->after_tag
 #    if _ANJ_MAX_CBOR_NEST_STACK_SIZE > 0
@@ -207,7 +254,8 @@ static int preprocess_next_value(_anj_cbor_ll_decoder_t *ctx) {
             return 0;
         }
 
-        uint8_t byte = ctx->prebuffer[ctx->prebuffer_offset++];
+        uint8_t byte = *next_bytes(ctx);
+        consume_bytes(ctx, 1);
         if (byte == CBOR_INDEFINITE_STRUCTURE_BREAK) {
             /* end of the indefinite map, array or byte/text string */
 #    if _ANJ_MAX_CBOR_NEST_STACK_SIZE > 0
@@ -363,13 +411,13 @@ static int parse_uint(_anj_cbor_ll_decoder_t *ctx, uint64_t *out_value) {
         uint32_t u32;
         uint64_t u64;
     } value;
-    if (ctx->prebuffer_offset + ext_len_size > ctx->prebuffer_size) {
+    if (available_bytes(ctx) < ext_len_size) {
         assert(ctx->input_last);
         ctx->state = ANJ_CBOR_LL_DECODER_STATE_ERROR;
         return _ANJ_IO_ERR_FORMAT;
     }
-    memcpy(&value, ctx->prebuffer + ctx->prebuffer_offset, ext_len_size);
-    ctx->prebuffer_offset += ext_len_size;
+    memcpy(&value, next_bytes(ctx), ext_len_size);
+    consume_bytes(ctx, ext_len_size);
     switch (ext_len_size) {
     case 1:
         *out_value = value.u8;
@@ -580,13 +628,11 @@ static int decode_float(_anj_cbor_ll_decoder_t *ctx, float *out_value) {
         if ((result = fill_prebuffer(ctx, sizeof(value)))) {
             return result;
         }
-        if (ctx->prebuffer_offset + sizeof(value) > ctx->prebuffer_size) {
+        if (available_bytes(ctx) < sizeof(value)) {
             result = _ANJ_IO_ERR_FORMAT;
         } else {
-            memcpy(&value,
-                   ctx->prebuffer + ctx->prebuffer_offset,
-                   sizeof(value));
-            ctx->prebuffer_offset += sizeof(value);
+            memcpy(&value, next_bytes(ctx), sizeof(value));
+            consume_bytes(ctx, sizeof(value));
             *out_value = decode_half_float(_anj_convert_be16(value));
         }
     } else
@@ -598,13 +644,11 @@ static int decode_float(_anj_cbor_ll_decoder_t *ctx, float *out_value) {
         if ((result = fill_prebuffer(ctx, sizeof(value)))) {
             return result;
         }
-        if (ctx->prebuffer_offset + sizeof(value) > ctx->prebuffer_size) {
+        if (available_bytes(ctx) < sizeof(value)) {
             result = _ANJ_IO_ERR_FORMAT;
         } else {
-            memcpy(&value,
-                   ctx->prebuffer + ctx->prebuffer_offset,
-                   sizeof(value));
-            ctx->prebuffer_offset += sizeof(value);
+            memcpy(&value, next_bytes(ctx), sizeof(value));
+            consume_bytes(ctx, sizeof(value));
             *out_value = _anj_ntohf(value);
         }
     }
@@ -752,14 +796,12 @@ static int decode_double(_anj_cbor_ll_decoder_t *ctx, double *out_value) {
     } else {
         uint64_t value;
         if (!(result = fill_prebuffer(ctx, sizeof(value)))) {
-            if (ctx->prebuffer_offset + sizeof(value) > ctx->prebuffer_size) {
+            if (available_bytes(ctx) < sizeof(value)) {
                 ctx->state = ANJ_CBOR_LL_DECODER_STATE_ERROR;
                 result = _ANJ_IO_ERR_FORMAT;
             } else {
-                memcpy(&value,
-                       ctx->prebuffer + ctx->prebuffer_offset,
-                       sizeof(value));
-                ctx->prebuffer_offset += sizeof(value);
+                memcpy(&value, next_bytes(ctx), sizeof(value));
+                consume_bytes(ctx, sizeof(value));
                 *out_value = _anj_ntohd(value);
             }
         }
@@ -1189,24 +1231,17 @@ static int bytes_get_some_impl(_anj_cbor_ll_decoder_bytes_ctx_t *bytes_ctx,
     } else
 #    endif // ANJ_WITH_CBOR_DECODE_INDEFINITE_BYTES
     {
-        if (ctx->prebuffer_size > ctx->prebuffer_offset) {
+        try_rewind_prebuffer(ctx);
+        if (!prebuffer_empty(ctx)) {
+            // Can't "unbuffer everything" - next payload already provided
+            // return the prebuffer
             size_t prebuffered_bytes =
                     ctx->prebuffer_size - ctx->prebuffer_offset;
-            assert(ctx->input >= ctx->input_begin);
-            size_t can_rewind_by = (size_t) (ctx->input - ctx->input_begin);
-            if (can_rewind_by < prebuffered_bytes) {
-                // Can't "unbuffer everything" - next payload already provided
-                // return the prebuffer
-                *out_buf = ctx->prebuffer + ctx->prebuffer_offset;
-                *out_buf_size =
-                        ANJ_MIN(prebuffered_bytes, bytes_ctx->bytes_available);
-                ctx->prebuffer_offset += (uint8_t) *out_buf_size;
-                goto finish;
-            } else {
-                // Rewind already prebuffered bytes and then continue
-                ctx->prebuffer_size = ctx->prebuffer_offset;
-                ctx->input -= prebuffered_bytes;
-            }
+            *out_buf = ctx->prebuffer + ctx->prebuffer_offset;
+            *out_buf_size =
+                    ANJ_MIN(prebuffered_bytes, bytes_ctx->bytes_available);
+            ctx->prebuffer_offset += (uint8_t) *out_buf_size;
+            goto finish;
         }
         assert(ctx->prebuffer_offset == ctx->prebuffer_size);
         *out_buf = ctx->input;
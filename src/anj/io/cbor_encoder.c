@@ -24,6 +24,7 @@
 // single record never exceeds its size.
 int _anj_cbor_encode_value(_anj_io_buff_t *buff_ctx,
                            const anj_io_out_entry_t *entry) {
+    uint8_t *record = _anj_io_record_buff(buff_ctx);
     size_t buf_pos = buff_ctx->bytes_in_internal_buff;
 
     switch (entry->type) {
@@ -35,8 +36,7 @@ int _anj_cbor_encode_value(_anj_io_buff_t *buff_ctx,
             return _ANJ_IO_ERR_INPUT_ARG;
         }
         buf_pos += anj_cbor_ll_bytes_begin(
-                &buff_ctx->internal_buff[buf_pos],
-                entry->value.bytes_or_string.chunk_length);
+                &record[buf_pos], entry->value.bytes_or_string.chunk_length);
         buff_ctx->is_extended_type = true;
         buff_ctx->remaining_bytes = entry->value.bytes_or_string.chunk_length;
         break;
@@ -54,8 +54,7 @@ int _anj_cbor_encode_value(_anj_io_buff_t *buff_ctx,
             string_length =
                     strlen((const char *) entry->value.bytes_or_string.data);
         }
-        buf_pos += anj_cbor_ll_string_begin(&buff_ctx->internal_buff[buf_pos],
-                                            string_length);
+        buf_pos += anj_cbor_ll_string_begin(&record[buf_pos], string_length);
         buff_ctx->is_extended_type = true;
         buff_ctx->remaining_bytes = string_length;
         break;
@@ -65,8 +64,7 @@ int _anj_cbor_encode_value(_anj_io_buff_t *buff_ctx,
         if (!entry->value.external_data.get_external_data) {
             return _ANJ_IO_ERR_INPUT_ARG;
         }
-        buf_pos += anj_cbor_ll_indefinite_bytes_begin(
-                &buff_ctx->internal_buff[buf_pos]);
+        buf_pos += anj_cbor_ll_indefinite_bytes_begin(&record[buf_pos]);
         buff_ctx->is_extended_type = true;
         // HACK: for ANJ_WITH_EXTERNAL_* types set it to constant value
         // because we don't know the length
@@ -77,32 +75,31 @@ int _anj_cbor_encode_value(_anj_io_buff_t *buff_ctx,
         if (!entry->value.external_data.get_external_data) {
             return _ANJ_IO_ERR_INPUT_ARG;
         }
-        buf_pos += anj_cbor_ll_indefinite_string_begin(
-                &buff_ctx->internal_buff[buf_pos]);
+        buf_pos += anj_cbor_ll_indefinite_string_begin(&record[buf_pos]);
         buff_ctx->is_extended_type = true;
         buff_ctx->remaining_bytes = 1;
         break;
     }
 #    endif // ANJ_WITH_EXTERNAL_DATA
     case ANJ_DATA_TYPE_TIME: {
-        buf_pos += anj_cbor_ll_encode_tag(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_tag(&record[buf_pos],
                                           CBOR_TAG_INTEGER_DATE_TIME);
-        buf_pos += anj_cbor_ll_encode_int(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_int(&record[buf_pos],
                                           entry->value.time_value);
         break;
     }
     case ANJ_DATA_TYPE_INT: {
-        buf_pos += anj_cbor_ll_encode_int(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_int(&record[buf_pos],
                                           entry->value.int_value);
         break;
     }
     case ANJ_DATA_TYPE_DOUBLE: {
-        buf_pos += anj_cbor_ll_encode_double(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_double(&record[buf_pos],
                                              entry->value.double_value);
         break;
     }
     case ANJ_DATA_TYPE_BOOL: {
-        buf_pos += anj_cbor_ll_encode_bool(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_bool(&record[buf_pos],
                                            entry->value.bool_value);
         break;
     }
@@ -113,7 +110,7 @@ int _anj_cbor_encode_value(_anj_io_buff_t *buff_ctx,
         break;
     }
     case ANJ_DATA_TYPE_UINT: {
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            entry->value.uint_value);
         break;
     }
@@ -96,6 +96,15 @@ typedef enum {
 
 void _anj_io_reset_internal_buff(_anj_io_buff_t *ctx);
 
+/**
+ * Returns the buffer into which the record is encoded: payload buffer of the
+ * caller if the record is encoded directly into it, internal buffer otherwise.
+ * In both cases the record starts at the same offset.
+ */
+static inline uint8_t *_anj_io_record_buff(_anj_io_buff_t *ctx) {
+    return ctx->direct_buff ? ctx->direct_buff : ctx->internal_buff;
+}
+
 size_t _anj_io_out_add_objlink(_anj_io_buff_t *buff_ctx,
                                size_t buf_pos,
                                anj_oid_t oid,
@@ -27,6 +27,7 @@
 #include "text_decoder.h"
 #include "text_encoder.h"
 #include "tlv_decoder.h"
+#include "tlv_encoder.h"
 
 ANJ_STATIC_ASSERT(_ANJ_IO_CTX_BUFFER_LENGTH >= ANJ_CBOR_LL_SINGLE_CALL_MAX_LEN,
                   CBOR_buffer_too_small);
@@ -44,6 +45,9 @@ static const uint16_t supported_formats_list[] = {
 #ifdef ANJ_WITH_LWM2M_CBOR
     _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR,
 #endif // ANJ_WITH_LWM2M_CBOR
+#ifdef ANJ_WITH_TLV
+    _ANJ_COAP_FORMAT_OMA_LWM2M_TLV,
+#endif // ANJ_WITH_TLV
 #ifdef ANJ_WITH_SENML_CBOR
     _ANJ_COAP_FORMAT_SENML_CBOR,     _ANJ_COAP_FORMAT_SENML_ETCH_CBOR
 #endif // ANJ_WITH_SENML_CBOR
@@ -82,6 +86,13 @@ check_format(uint16_t given_format, size_t items_count, _anj_op_t op) {
                     && op != ANJ_OP_INF_CANCEL_OBSERVE))) {
         return _ANJ_IO_ERR_FORMAT;
     }
+    // TLV has no representation of full paths, so it is allowed only for
+    // responses related to a single path
+    if (given_format == _ANJ_COAP_FORMAT_OMA_LWM2M_TLV
+            && op != ANJ_OP_DM_READ && op != ANJ_OP_INF_OBSERVE
+            && op != ANJ_OP_INF_CANCEL_OBSERVE) {
+        return _ANJ_IO_ERR_FORMAT;
+    }
     return 0;
 }
 
@@ -96,12 +107,12 @@ static uint16_t choose_format(uint16_t given_format) {
 #endif // ANJ_WITH_LWM2M_CBOR
 }
 
-static int get_cbor_bytes_string_data(_anj_io_buff_t *buff_ctx,
-                                      const anj_io_out_entry_t *entry,
-                                      void *out_buff,
-                                      size_t out_buff_len,
-                                      size_t *copied_bytes,
-                                      size_t bytes_at_the_end_to_ignore) {
+static int get_bytes_or_string_data(_anj_io_buff_t *buff_ctx,
+                                    const anj_io_out_entry_t *entry,
+                                    void *out_buff,
+                                    size_t out_buff_len,
+                                    size_t *copied_bytes,
+                                    size_t bytes_at_the_end_to_ignore) {
     size_t extended_offset =
             buff_ctx->offset - buff_ctx->bytes_in_internal_buff;
     size_t bytes_to_copy =
@@ -215,9 +226,9 @@ static int get_cbor_extended_data(_anj_io_buff_t *buff_ctx,
             || entry->type == ANJ_DATA_TYPE_STRING)
 #endif // ANJ_WITH_EXTERNAL_DATA
     {
-        return get_cbor_bytes_string_data(buff_ctx, entry, out_buff,
-                                          out_buff_len, copied_bytes,
-                                          bytes_at_the_end_to_ignore);
+        return get_bytes_or_string_data(buff_ctx, entry, out_buff,
+                                        out_buff_len, copied_bytes,
+                                        bytes_at_the_end_to_ignore);
     }
 #ifdef ANJ_WITH_EXTERNAL_DATA
     while (1) {
@@ -401,6 +412,10 @@ int _anj_io_out_ctx_init(_anj_io_out_ctx_t *ctx,
     case _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR:
         return _anj_lwm2m_cbor_encoder_init(ctx, &path, items_count);
 #endif // ANJ_WITH_LWM2M_CBOR
+#ifdef ANJ_WITH_TLV
+    case _ANJ_COAP_FORMAT_OMA_LWM2M_TLV:
+        return _anj_tlv_encoder_init(ctx, &path, items_count);
+#endif // ANJ_WITH_TLV
     default:
         // not implemented yet
         return _ANJ_IO_ERR_UNSUPPORTED_FORMAT;
@@ -443,6 +458,11 @@ int _anj_io_out_ctx_new_entry(_anj_io_out_ctx_t *ctx,
         res = _anj_lwm2m_cbor_out_ctx_new_entry(ctx, entry);
         break;
 #endif // ANJ_WITH_LWM2M_CBOR
+#ifdef ANJ_WITH_TLV
+    case _ANJ_COAP_FORMAT_OMA_LWM2M_TLV:
+        res = _anj_tlv_out_ctx_new_entry(ctx, entry);
+        break;
+#endif // ANJ_WITH_TLV
     default:
         break;
     }
@@ -558,6 +578,11 @@ static inline int io_out_ctx_get_payload(_anj_io_out_ctx_t *ctx,
         return ret_val;
     }
 #endif // ANJ_WITH_LWM2M_CBOR
+#ifdef ANJ_WITH_TLV
+    case _ANJ_COAP_FORMAT_OMA_LWM2M_TLV:
+        return get_bytes_or_string_data(&ctx->buff, ctx->entry, out_buff,
+                                        out_buff_len, out_copied_bytes, 0);
+#endif // ANJ_WITH_TLV
     default:
         return _ANJ_IO_ERR_LOGIC;
     }
@@ -579,6 +604,52 @@ int _anj_io_out_ctx_get_payload(_anj_io_out_ctx_t *ctx,
     return ret;
 }
 
+int _anj_io_out_ctx_add_entry(_anj_io_out_ctx_t *ctx,
+                              const anj_io_out_entry_t *entry,
+                              void *out_buff,
+                              size_t out_buff_len,
+                              size_t *out_copied_bytes) {
+    assert(ctx && entry && out_buff && out_buff_len && out_copied_bytes);
+    _anj_io_buff_t *buff_ctx = &ctx->buff;
+
+    // single record never exceeds _ANJ_IO_CTX_BUFFER_LENGTH, so if the payload
+    // buffer is larger, the record is encoded directly into it
+    if (out_buff_len <= _ANJ_IO_CTX_BUFFER_LENGTH) {
+        int res = _anj_io_out_ctx_new_entry(ctx, entry);
+        if (res) {
+            return res;
+        }
+        return _anj_io_out_ctx_get_payload(ctx, out_buff, out_buff_len,
+                                           out_copied_bytes);
+    }
+
+    // bytes already staged by the encoder (LwM2M CBOR map begin) precede the
+    // record
+    assert(!buff_ctx->offset);
+    memcpy(out_buff, buff_ctx->internal_buff, buff_ctx->bytes_in_internal_buff);
+    buff_ctx->direct_buff = (uint8_t *) out_buff;
+    int res = _anj_io_out_ctx_new_entry(ctx, entry);
+    buff_ctx->direct_buff = NULL;
+    if (res) {
+        return res;
+    }
+    size_t record_len = buff_ctx->bytes_in_internal_buff;
+    buff_ctx->offset = record_len;
+    buff_ctx->remaining_bytes -= record_len;
+    *out_copied_bytes = record_len;
+    if (!buff_ctx->remaining_bytes) {
+        _anj_io_reset_internal_buff(buff_ctx);
+        return 0;
+    }
+
+    // extended data and LwM2M CBOR map endings are copied from the source
+    size_t copied_bytes = 0;
+    res = _anj_io_out_ctx_get_payload(ctx, &((uint8_t *) out_buff)[record_len],
+                                      out_buff_len - record_len, &copied_bytes);
+    *out_copied_bytes += copied_bytes;
+    return res;
+}
+
 uint16_t _anj_io_out_ctx_get_format(_anj_io_out_ctx_t *ctx) {
     return ctx->format;
 }
@@ -593,11 +664,9 @@ size_t _anj_io_out_add_objlink(_anj_io_buff_t *buff_ctx,
     buffer[str_size++] = ':';
     str_size += anj_uint16_to_string_value(&buffer[str_size], iid);
 
-    size_t header_size =
-            anj_cbor_ll_string_begin(&buff_ctx->internal_buff[buf_pos],
-                                     str_size);
-    memcpy(&((uint8_t *) buff_ctx->internal_buff)[buf_pos + header_size],
-           buffer, str_size);
+    uint8_t *record = _anj_io_record_buff(buff_ctx);
+    size_t header_size = anj_cbor_ll_string_begin(&record[buf_pos], str_size);
+    memcpy(&record[buf_pos + header_size], buffer, str_size);
     return header_size + str_size;
 }
 
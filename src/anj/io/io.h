@@ -187,6 +187,33 @@ int _anj_io_out_ctx_get_payload(_anj_io_out_ctx_t *ctx,
                                 size_t out_buff_len,
                                 size_t *out_copied_bytes);
 
+/**
+ * Adds new @p entry and copies it to the payload buffer. Equivalent to @ref
+ * _anj_io_out_ctx_new_entry followed by @ref _anj_io_out_ctx_get_payload, but
+ * if @p out_buff_len exceeds the size of the internal buffer, the record is
+ * encoded directly into @p out_buff, without intermediate copy.
+ *
+ * If the function returns @ref ANJ_IO_NEED_NEXT_CALL, the rest of the record
+ * must be copied with @ref _anj_io_out_ctx_get_payload.
+ *
+ * @param      ctx              Context to operate on.
+ * @param      entry            Single record.
+ * @param[out] out_buff         Payload buffer.
+ * @param      out_buff_len     Length of payload buffer.
+ * @param[out] out_copied_bytes Number of bytes that are written into the
+ *                              buffer.
+ *
+ * @return
+ * - 0 on success,
+ * - ANJ_IO_NEED_NEXT_CALL if entry didn't fit in the output buffer,
+ * - a negative value in case of error.
+ */
+int _anj_io_out_ctx_add_entry(_anj_io_out_ctx_t *ctx,
+                              const anj_io_out_entry_t *entry,
+                              void *out_buff,
+                              size_t out_buff_len,
+                              size_t *out_copied_bytes);
+
 /**
  * Returns the value of the currently used format.
  *
@@ -196,6 +223,57 @@ int _anj_io_out_ctx_get_payload(_anj_io_out_ctx_t *ctx,
  */
 uint16_t _anj_io_out_ctx_get_format(_anj_io_out_ctx_t *ctx);
 
+#ifdef ANJ_WITH_TLV
+/**
+ * Sets the callback used by the TLV encoder to get the length of every Object
+ * Instance and Multiple Resource before encoding its first record. TLV header
+ * of such aggregate contains the length of all nested records, so it has to be
+ * known in advance. The callback should calculate it using @ref
+ * _anj_io_tlv_header_length and @ref _anj_io_tlv_value_length for exactly the
+ * same entries that will be passed to @ref _anj_io_out_ctx_new_entry later.
+ *
+ * Has no effect if @p ctx does not use TLV format, so it can be called right
+ * after every successful @ref _anj_io_out_ctx_init.
+ *
+ * @param ctx       Context to operate on.
+ * @param length_cb Callback to call.
+ * @param arg       Opaque argument passed to @p length_cb.
+ */
+void _anj_io_out_ctx_set_tlv_length_cb(_anj_io_out_ctx_t *ctx,
+                                       _anj_io_tlv_length_cb_t *length_cb,
+                                       void *arg);
+
+/**
+ * Returns the size of TLV header of the record with given identifier and value
+ * length.
+ *
+ * @param id           Last ID of the path of the record.
+ * @param value_length Length of the value of the record.
+ *
+ * @return Size of the header.
+ */
+size_t _anj_io_tlv_header_length(uint16_t id, size_t value_length);
+
+/**
+ * Calculates the length of the value of @p entry encoded in TLV format.
+ *
+ * Numeric values nested in an Object Instance or Multiple Resource are always
+ * encoded on 8 bytes, so that the length of the aggregate does not change if
+ * the value read for the length calculation differs from the encoded one.
+ *
+ * @param      entry            Resource or Resource Instance record.
+ * @param      in_aggregate     Whether the record is nested in an Object
+ *                              Instance or Multiple Resource.
+ * @param[out] out_value_length Length of the value.
+ *
+ * @return 0 on success, a negative value if the value can't be encoded in TLV
+ * format.
+ */
+int _anj_io_tlv_value_length(const anj_io_out_entry_t *entry,
+                             bool in_aggregate,
+                             size_t *out_value_length);
+#endif // ANJ_WITH_TLV
+
 #ifdef ANJ_WITH_EXTERNAL_DATA
 /**
  * Invoke @ref anj_close_external_data_t callback for @p entry record.
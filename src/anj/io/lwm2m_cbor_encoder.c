@@ -37,9 +37,10 @@ static size_t uri_path_span(const anj_uri_path_t *a, const anj_uri_path_t *b) {
 
 static void
 end_maps(_anj_io_buff_t *buff_ctx, uint8_t *map_counter, size_t count) {
+    uint8_t *record = _anj_io_record_buff(buff_ctx);
     for (size_t i = 0; i < count; i++) {
         size_t bytes_written = anj_cbor_ll_indefinite_record_end(
-                &buff_ctx->internal_buff[buff_ctx->bytes_in_internal_buff]);
+                &record[buff_ctx->bytes_in_internal_buff]);
         buff_ctx->bytes_in_internal_buff += bytes_written;
         assert(buff_ctx->bytes_in_internal_buff <= _ANJ_IO_CTX_BUFFER_LENGTH);
         (*map_counter)--;
@@ -50,6 +51,7 @@ static void encode_subpath(_anj_io_buff_t *buff_ctx,
                            uint8_t *map_counter,
                            const anj_uri_path_t *path,
                            size_t begin_idx) {
+    uint8_t *record = _anj_io_record_buff(buff_ctx);
     for (size_t idx = begin_idx; idx < anj_uri_path_length(path); idx++) {
         size_t bytes_written = 0;
         // for the first record anj_cbor_ll_indefinite_map_begin() is
@@ -57,12 +59,11 @@ static void encode_subpath(_anj_io_buff_t *buff_ctx,
         // is a continuation of the open map
         if (idx != begin_idx) {
             bytes_written = anj_cbor_ll_indefinite_map_begin(
-                    &buff_ctx->internal_buff[buff_ctx->bytes_in_internal_buff]);
+                    &record[buff_ctx->bytes_in_internal_buff]);
             (*map_counter)++;
         }
         bytes_written += anj_cbor_ll_encode_uint(
-                &buff_ctx->internal_buff[buff_ctx->bytes_in_internal_buff
-                                         + bytes_written],
+                &record[buff_ctx->bytes_in_internal_buff + bytes_written],
                 path->ids[idx]);
         buff_ctx->bytes_in_internal_buff += bytes_written;
         assert(buff_ctx->bytes_in_internal_buff <= _ANJ_IO_CTX_BUFFER_LENGTH);
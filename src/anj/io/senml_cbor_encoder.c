@@ -57,6 +57,7 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
                            _anj_senml_cbor_encoder_t *senml_cbor,
                            _anj_io_buff_t *buff_ctx,
                            bool first_entry) {
+    uint8_t *record = _anj_io_record_buff(buff_ctx);
     size_t buf_pos = 0;
     size_t path_len = anj_uri_path_length(&entry->path);
     if (anj_uri_path_outside_base(&entry->path, &senml_cbor->base_path)
@@ -76,33 +77,30 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
 
     // array
     if (first_entry) {
-        buf_pos += anj_cbor_ll_definite_array_begin(
-                &buff_ctx->internal_buff[buf_pos], senml_cbor->items_count);
+        buf_pos += anj_cbor_ll_definite_array_begin(&record[buf_pos],
+                                                    senml_cbor->items_count);
     }
     // map
     size_t map_size = (size_t) (with_base_name + with_name + with_time + 1);
-    buf_pos += anj_cbor_ll_definite_map_begin(&buff_ctx->internal_buff[buf_pos],
-                                              map_size);
+    buf_pos += anj_cbor_ll_definite_map_begin(&record[buf_pos], map_size);
 
     // basename - only once for READ operation
     if (with_base_name) {
-        buf_pos += add_path(&buff_ctx->internal_buff[buf_pos],
-                            &senml_cbor->base_path, 0,
+        buf_pos += add_path(&record[buf_pos], &senml_cbor->base_path, 0,
                             senml_cbor->base_path_len, SENML_LABEL_BASE_NAME);
     }
     // name
     if (with_name) {
-        buf_pos +=
-                add_path(&buff_ctx->internal_buff[buf_pos], &entry->path,
-                         senml_cbor->base_path_len, path_len, SENML_LABEL_NAME);
+        buf_pos += add_path(&record[buf_pos], &entry->path,
+                            senml_cbor->base_path_len, path_len,
+                            SENML_LABEL_NAME);
     }
     // base time
     if (with_time) {
         senml_cbor->last_timestamp = time_s;
-        buf_pos += anj_cbor_ll_encode_int(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_int(&record[buf_pos],
                                           SENML_LABEL_BASE_TIME);
-        buf_pos += anj_cbor_ll_encode_double(&buff_ctx->internal_buff[buf_pos],
-                                             time_s);
+        buf_pos += anj_cbor_ll_encode_double(&record[buf_pos], time_s);
     }
 
     // value
@@ -114,11 +112,10 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
                                != entry->value.bytes_or_string.chunk_length)) {
             return _ANJ_IO_ERR_INPUT_ARG;
         }
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            SENML_LABEL_VALUE_OPAQUE);
         buf_pos += anj_cbor_ll_bytes_begin(
-                &buff_ctx->internal_buff[buf_pos],
-                entry->value.bytes_or_string.chunk_length);
+                &record[buf_pos], entry->value.bytes_or_string.chunk_length);
         buff_ctx->is_extended_type = true;
         buff_ctx->remaining_bytes = entry->value.bytes_or_string.chunk_length;
         break;
@@ -136,10 +133,9 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
             string_length =
                     strlen((const char *) entry->value.bytes_or_string.data);
         }
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            SENML_LABEL_VALUE_STRING);
-        buf_pos += anj_cbor_ll_string_begin(&buff_ctx->internal_buff[buf_pos],
-                                            string_length);
+        buf_pos += anj_cbor_ll_string_begin(&record[buf_pos], string_length);
         buff_ctx->is_extended_type = true;
         buff_ctx->remaining_bytes = string_length;
         break;
@@ -149,10 +145,9 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
         if (!entry->value.external_data.get_external_data) {
             return _ANJ_IO_ERR_INPUT_ARG;
         }
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            SENML_LABEL_VALUE_OPAQUE);
-        buf_pos += anj_cbor_ll_indefinite_bytes_begin(
-                &buff_ctx->internal_buff[buf_pos]);
+        buf_pos += anj_cbor_ll_indefinite_bytes_begin(&record[buf_pos]);
         buff_ctx->is_extended_type = true;
         // HACK: for ANJ_WITH_EXTERNAL_* types set it to constant value
         // because we don't know the length
@@ -163,51 +158,45 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
         if (!entry->value.external_data.get_external_data) {
             return _ANJ_IO_ERR_INPUT_ARG;
         }
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            SENML_LABEL_VALUE_STRING);
-        buf_pos += anj_cbor_ll_indefinite_string_begin(
-                &buff_ctx->internal_buff[buf_pos]);
+        buf_pos += anj_cbor_ll_indefinite_string_begin(&record[buf_pos]);
         buff_ctx->is_extended_type = true;
         buff_ctx->remaining_bytes = 1;
         break;
     }
 #    endif // ANJ_WITH_EXTERNAL_DATA
     case ANJ_DATA_TYPE_TIME: {
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
-                                           SENML_LABEL_VALUE);
-        buf_pos += anj_cbor_ll_encode_tag(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos], SENML_LABEL_VALUE);
+        buf_pos += anj_cbor_ll_encode_tag(&record[buf_pos],
                                           CBOR_TAG_INTEGER_DATE_TIME);
-        buf_pos += anj_cbor_ll_encode_int(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_int(&record[buf_pos],
                                           entry->value.time_value);
         break;
     }
     case ANJ_DATA_TYPE_INT: {
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
-                                           SENML_LABEL_VALUE);
-        buf_pos += anj_cbor_ll_encode_int(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos], SENML_LABEL_VALUE);
+        buf_pos += anj_cbor_ll_encode_int(&record[buf_pos],
                                           entry->value.int_value);
         break;
     }
     case ANJ_DATA_TYPE_DOUBLE: {
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
-                                           SENML_LABEL_VALUE);
-        buf_pos += anj_cbor_ll_encode_double(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos], SENML_LABEL_VALUE);
+        buf_pos += anj_cbor_ll_encode_double(&record[buf_pos],
                                              entry->value.double_value);
         break;
     }
     case ANJ_DATA_TYPE_BOOL: {
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            SENML_LABEL_VALUE_BOOL);
-        buf_pos += anj_cbor_ll_encode_bool(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_bool(&record[buf_pos],
                                            entry->value.bool_value);
         break;
     }
     case ANJ_DATA_TYPE_OBJLNK: {
         size_t objlink_repr_len = sizeof(SENML_EXT_OBJLNK_REPR) - 1;
-        buf_pos += anj_cbor_ll_string_begin(&buff_ctx->internal_buff[buf_pos],
-                                            objlink_repr_len);
-        memcpy(&buff_ctx->internal_buff[buf_pos], SENML_EXT_OBJLNK_REPR,
-               objlink_repr_len);
+        buf_pos += anj_cbor_ll_string_begin(&record[buf_pos], objlink_repr_len);
+        memcpy(&record[buf_pos], SENML_EXT_OBJLNK_REPR, objlink_repr_len);
         buf_pos += objlink_repr_len;
         buf_pos += _anj_io_out_add_objlink(buff_ctx, buf_pos,
                                            entry->value.objlnk.oid,
@@ -215,9 +204,8 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
         break;
     }
     case ANJ_DATA_TYPE_UINT: {
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
-                                           SENML_LABEL_VALUE);
-        buf_pos += anj_cbor_ll_encode_uint(&buff_ctx->internal_buff[buf_pos],
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos], SENML_LABEL_VALUE);
+        buf_pos += anj_cbor_ll_encode_uint(&record[buf_pos],
                                            entry->value.uint_value);
         break;
     }
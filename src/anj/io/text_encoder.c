@@ -36,6 +36,7 @@
 // single record never exceeds its size.
 static int prepare_payload(const anj_io_out_entry_t *entry,
                            _anj_io_buff_t *buff_ctx) {
+    char *record = (char *) _anj_io_record_buff(buff_ctx);
     switch (entry->type) {
     case ANJ_DATA_TYPE_BYTES: {
         if (entry->value.bytes_or_string.offset != 0
@@ -90,47 +91,41 @@ static int prepare_payload(const anj_io_out_entry_t *entry,
     }
     case ANJ_DATA_TYPE_INT: {
         buff_ctx->bytes_in_internal_buff =
-                anj_int64_to_string_value((char *) buff_ctx->internal_buff,
-                                          entry->value.int_value);
+                anj_int64_to_string_value(record, entry->value.int_value);
         buff_ctx->remaining_bytes = buff_ctx->bytes_in_internal_buff;
         break;
     }
     case ANJ_DATA_TYPE_DOUBLE: {
         buff_ctx->bytes_in_internal_buff =
-                anj_double_to_string_value((char *) buff_ctx->internal_buff,
-                                           entry->value.double_value);
+                anj_double_to_string_value(record, entry->value.double_value);
         buff_ctx->remaining_bytes = buff_ctx->bytes_in_internal_buff;
         break;
     }
     case ANJ_DATA_TYPE_BOOL: {
         buff_ctx->bytes_in_internal_buff = 1;
-        buff_ctx->internal_buff[0] = entry->value.bool_value ? '1' : '0';
+        record[0] = entry->value.bool_value ? '1' : '0';
         buff_ctx->remaining_bytes = buff_ctx->bytes_in_internal_buff;
         break;
     }
     case ANJ_DATA_TYPE_OBJLNK: {
         buff_ctx->bytes_in_internal_buff =
-                anj_uint16_to_string_value((char *) buff_ctx->internal_buff,
-                                           entry->value.objlnk.oid);
-        buff_ctx->internal_buff[buff_ctx->bytes_in_internal_buff++] = ':';
+                anj_uint16_to_string_value(record, entry->value.objlnk.oid);
+        record[buff_ctx->bytes_in_internal_buff++] = ':';
         buff_ctx->bytes_in_internal_buff += anj_uint16_to_string_value(
-                (char *) buff_ctx->internal_buff
-                        + buff_ctx->bytes_in_internal_buff,
+                record + buff_ctx->bytes_in_internal_buff,
                 entry->value.objlnk.iid);
         buff_ctx->remaining_bytes = buff_ctx->bytes_in_internal_buff;
         break;
     }
     case ANJ_DATA_TYPE_UINT: {
         buff_ctx->bytes_in_internal_buff =
-                anj_uint64_to_string_value((char *) buff_ctx->internal_buff,
-                                           entry->value.uint_value);
+                anj_uint64_to_string_value(record, entry->value.uint_value);
         buff_ctx->remaining_bytes = buff_ctx->bytes_in_internal_buff;
         break;
     }
     case ANJ_DATA_TYPE_TIME: {
         buff_ctx->bytes_in_internal_buff =
-                anj_int64_to_string_value((char *) buff_ctx->internal_buff,
-                                          entry->value.time_value);
+                anj_int64_to_string_value(record, entry->value.time_value);
         buff_ctx->remaining_bytes = buff_ctx->bytes_in_internal_buff;
         break;
     }
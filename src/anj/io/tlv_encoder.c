@@ -0,0 +1,356 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <assert.h>
+#include <float.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+#include <anj/utils.h>
+
+#include "../utils.h"
+#include "internal.h"
+#include "io.h"
+#include "tlv_encoder.h"
+
+#ifdef ANJ_WITH_TLV
+
+typedef enum {
+    TLV_ID_IID = 0,
+    TLV_ID_RIID = 1,
+    TLV_ID_RID_ARRAY = 2,
+    TLV_ID_RID = 3
+} tlv_id_type_t;
+
+#    define TLV_ID_16BIT_FLAG 0x20
+#    define TLV_LENGTH_TYPE_SHIFT 3
+// length is stored on at most 24 bits
+#    define TLV_MAX_LENGTH 0xFFFFFFU
+
+static size_t tlv_length_size(size_t length) {
+    if (length < 8) {
+        // stored in the type field
+        return 0;
+    } else if (length <= UINT8_MAX) {
+        return 1;
+    } else if (length <= UINT16_MAX) {
+        return 2;
+    }
+    return 3;
+}
+
+static size_t
+encode_header(uint8_t *out, tlv_id_type_t type, uint16_t id, size_t length) {
+    assert(length <= TLV_MAX_LENGTH);
+    size_t pos = 1;
+    out[0] = (uint8_t) (type << 6);
+    if (id > UINT8_MAX) {
+        out[0] |= TLV_ID_16BIT_FLAG;
+        out[pos++] = (uint8_t) (id >> 8);
+    }
+    out[pos++] = (uint8_t) id;
+
+    size_t length_size = tlv_length_size(length);
+    if (!length_size) {
+        out[0] |= (uint8_t) length;
+    } else {
+        out[0] |= (uint8_t) (length_size << TLV_LENGTH_TYPE_SHIFT);
+        for (size_t i = length_size; i > 0; i--) {
+            out[pos++] = (uint8_t) (length >> (8 * (i - 1)));
+        }
+    }
+    return pos;
+}
+
+static size_t int_length(int64_t value) {
+    if (value == (int8_t) value) {
+        return 1;
+    } else if (value == (int16_t) value) {
+        return 2;
+    } else if (value == (int32_t) value) {
+        return 4;
+    }
+    return 8;
+}
+
+static bool double_is_float(double value) {
+    // NaN and values out of float range are always encoded on 8 bytes
+    return value >= -FLT_MAX && value <= FLT_MAX
+           && (double) (float) value == value;
+}
+
+static int get_bytes_or_string_length(const anj_io_out_entry_t *entry,
+                                      size_t *out_length) {
+    const anj_bytes_or_string_value_t *value = &entry->value.bytes_or_string;
+    if (value->offset != 0
+            || (value->full_length_hint
+                && value->full_length_hint != value->chunk_length)) {
+        return _ANJ_IO_ERR_INPUT_ARG;
+    }
+    *out_length = value->chunk_length;
+    if (entry->type == ANJ_DATA_TYPE_STRING && !*out_length && value->data) {
+        *out_length = strlen((const char *) value->data);
+    }
+    return 0;
+}
+
+size_t _anj_io_tlv_header_length(uint16_t id, size_t value_length) {
+    // type field and 8 or 16-bit identifier
+    size_t type_and_id_size = id > UINT8_MAX ? 3 : 2;
+    return type_and_id_size + tlv_length_size(value_length);
+}
+
+int _anj_io_tlv_value_length(const anj_io_out_entry_t *entry,
+                             bool in_aggregate,
+                             size_t *out_value_length) {
+    assert(entry && out_value_length);
+    switch (entry->type) {
+    case ANJ_DATA_TYPE_BYTES:
+    case ANJ_DATA_TYPE_STRING: {
+        int res = get_bytes_or_string_length(entry, out_value_length);
+        if (res) {
+            return res;
+        }
+        if (*out_value_length > TLV_MAX_LENGTH) {
+            return _ANJ_IO_ERR_INPUT_ARG;
+        }
+        return 0;
+    }
+    // nested values are read separately to calculate lengths of aggregates, so
+    // their width must not depend on the value itself
+    case ANJ_DATA_TYPE_INT:
+        *out_value_length =
+                in_aggregate ? 8 : int_length(entry->value.int_value);
+        return 0;
+    case ANJ_DATA_TYPE_TIME:
+        *out_value_length =
+                in_aggregate ? 8 : int_length(entry->value.time_value);
+        return 0;
+    case ANJ_DATA_TYPE_UINT: {
+        // values that fit in int64_t are encoded in the same way as integers,
+        // so they are also understood by LwM2M 1.0 servers
+        uint64_t value = entry->value.uint_value;
+        *out_value_length = in_aggregate || value > INT64_MAX
+                                    ? 8
+                                    : int_length((int64_t) value);
+        return 0;
+    }
+    case ANJ_DATA_TYPE_DOUBLE:
+        *out_value_length =
+                !in_aggregate && double_is_float(entry->value.double_value)
+                        ? 4
+                        : 8;
+        return 0;
+    case ANJ_DATA_TYPE_BOOL:
+        *out_value_length = 1;
+        return 0;
+    case ANJ_DATA_TYPE_OBJLNK:
+        *out_value_length = 4;
+        return 0;
+    default:
+        // external data can't be used, its length is not known in advance
+        return _ANJ_IO_ERR_IO_TYPE;
+    }
+}
+
+static void encode_uint(uint8_t *out, uint64_t value, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (uint8_t) (value >> (8 * (length - 1 - i)));
+    }
+}
+
+static void encode_value(uint8_t *out,
+                         const anj_io_out_entry_t *entry,
+                         size_t value_length) {
+    switch (entry->type) {
+    case ANJ_DATA_TYPE_INT:
+        encode_uint(out, (uint64_t) entry->value.int_value, value_length);
+        break;
+    case ANJ_DATA_TYPE_TIME:
+        encode_uint(out, (uint64_t) entry->value.time_value, value_length);
+        break;
+    case ANJ_DATA_TYPE_UINT:
+        encode_uint(out, entry->value.uint_value, value_length);
+        break;
+    case ANJ_DATA_TYPE_DOUBLE:
+        if (value_length == 4) {
+            uint32_t value = _anj_htonf((float) entry->value.double_value);
+            memcpy(out, &value, sizeof(value));
+        } else {
+            uint64_t value = _anj_htond(entry->value.double_value);
+            memcpy(out, &value, sizeof(value));
+        }
+        break;
+    case ANJ_DATA_TYPE_BOOL:
+        out[0] = entry->value.bool_value ? 1 : 0;
+        break;
+    case ANJ_DATA_TYPE_OBJLNK:
+        encode_uint(out, entry->value.objlnk.oid, 2);
+        encode_uint(&out[2], entry->value.objlnk.iid, 2);
+        break;
+    default:
+        // bytes and strings are copied directly from the entry
+        break;
+    }
+}
+
+static int get_aggregate_length(_anj_tlv_encoder_t *tlv,
+                                const anj_uri_path_t *path,
+                                size_t *out_length) {
+    if (!tlv->length_cb || tlv->length_cb(tlv->length_cb_arg, path, out_length)
+            // aggregate contains at least the entry that opens it
+            || !*out_length || *out_length > TLV_MAX_LENGTH) {
+        return _ANJ_IO_ERR_LOGIC;
+    }
+    return 0;
+}
+
+int _anj_tlv_out_ctx_new_entry(_anj_io_out_ctx_t *ctx,
+                               const anj_io_out_entry_t *entry) {
+    assert(ctx->format == _ANJ_COAP_FORMAT_OMA_LWM2M_TLV);
+    _anj_tlv_encoder_t *tlv = &ctx->encoder.tlv;
+    const anj_uri_path_t *path = &entry->path;
+
+    if (ctx->buff.remaining_bytes || !tlv->items_count) {
+        return _ANJ_IO_ERR_LOGIC;
+    }
+    if (anj_uri_path_outside_base(path, &tlv->base_path)
+            || !anj_uri_path_has(path, ANJ_ID_RID)) {
+        return _ANJ_IO_ERR_INPUT_ARG;
+    }
+    // Object Instances are encoded only for Read on Object, Multiple Resources
+    // for Read on Object, Object Instance or Resource
+    bool in_instance = !anj_uri_path_has(&tlv->base_path, ANJ_ID_IID);
+    bool in_multi_res = anj_uri_path_has(path, ANJ_ID_RIID)
+                        && !anj_uri_path_has(&tlv->base_path, ANJ_ID_RIID);
+    size_t value_length;
+    int res = _anj_io_tlv_value_length(entry, in_instance || in_multi_res,
+                                       &value_length);
+    if (res) {
+        return res;
+    }
+
+    _anj_io_buff_t *buff_ctx = &ctx->buff;
+    uint8_t *record = _anj_io_record_buff(buff_ctx);
+    size_t buf_pos = buff_ctx->bytes_in_internal_buff;
+
+    if (in_instance && !tlv->instance_remaining) {
+        res = get_aggregate_length(
+                tlv,
+                &ANJ_MAKE_INSTANCE_PATH(path->ids[ANJ_ID_OID],
+                                        path->ids[ANJ_ID_IID]),
+                &tlv->instance_remaining);
+        if (res) {
+            return res;
+        }
+        buf_pos += encode_header(&record[buf_pos], TLV_ID_IID,
+                                 path->ids[ANJ_ID_IID],
+                                 tlv->instance_remaining);
+    } else if (in_instance
+               && path->ids[ANJ_ID_IID] != tlv->last_path.ids[ANJ_ID_IID]) {
+        return _ANJ_IO_ERR_LOGIC;
+    }
+    size_t instance_part_begin = buf_pos;
+
+    if (in_multi_res && !tlv->multi_res_remaining) {
+        res = get_aggregate_length(
+                tlv,
+                &ANJ_MAKE_RESOURCE_PATH(path->ids[ANJ_ID_OID],
+                                        path->ids[ANJ_ID_IID],
+                                        path->ids[ANJ_ID_RID]),
+                &tlv->multi_res_remaining);
+        if (res) {
+            return res;
+        }
+        buf_pos += encode_header(&record[buf_pos], TLV_ID_RID_ARRAY,
+                                 path->ids[ANJ_ID_RID],
+                                 tlv->multi_res_remaining);
+    } else if (in_multi_res
+               && path->ids[ANJ_ID_RID] != tlv->last_path.ids[ANJ_ID_RID]) {
+        return _ANJ_IO_ERR_LOGIC;
+    } else if (!in_multi_res && tlv->multi_res_remaining) {
+        return _ANJ_IO_ERR_LOGIC;
+    }
+    size_t record_begin = buf_pos;
+
+    if (anj_uri_path_has(path, ANJ_ID_RIID)) {
+        buf_pos += encode_header(&record[buf_pos], TLV_ID_RIID,
+                                 path->ids[ANJ_ID_RIID], value_length);
+    } else {
+        buf_pos += encode_header(&record[buf_pos], TLV_ID_RID,
+                                 path->ids[ANJ_ID_RID], value_length);
+    }
+
+    // lengths of the aggregates must match the ones calculated before
+    if (in_multi_res) {
+        size_t record_length = buf_pos - record_begin + value_length;
+        if (record_length > tlv->multi_res_remaining) {
+            return _ANJ_IO_ERR_LOGIC;
+        }
+        tlv->multi_res_remaining -= record_length;
+    }
+    if (in_instance) {
+        size_t instance_part_length =
+                buf_pos - instance_part_begin + value_length;
+        if (instance_part_length > tlv->instance_remaining) {
+            return _ANJ_IO_ERR_LOGIC;
+        }
+        tlv->instance_remaining -= instance_part_length;
+    }
+
+    if (entry->type == ANJ_DATA_TYPE_BYTES
+            || entry->type == ANJ_DATA_TYPE_STRING) {
+        buff_ctx->is_extended_type = true;
+        buff_ctx->remaining_bytes = value_length;
+    } else {
+        encode_value(&record[buf_pos], entry, value_length);
+        buf_pos += value_length;
+    }
+    assert(buf_pos <= _ANJ_IO_CTX_BUFFER_LENGTH);
+    buff_ctx->bytes_in_internal_buff = buf_pos;
+    buff_ctx->remaining_bytes += buff_ctx->bytes_in_internal_buff;
+
+    tlv->last_path = *path;
+    tlv->items_count--;
+    if (!tlv->items_count
+            && (tlv->instance_remaining || tlv->multi_res_remaining)) {
+        return _ANJ_IO_ERR_LOGIC;
+    }
+    return 0;
+}
+
+int _anj_tlv_encoder_init(_anj_io_out_ctx_t *ctx,
+                          const anj_uri_path_t *base_path,
+                          size_t items_count) {
+    assert(base_path);
+    if (!anj_uri_path_has(base_path, ANJ_ID_OID)) {
+        return _ANJ_IO_ERR_FORMAT;
+    }
+    _anj_tlv_encoder_t *tlv = &ctx->encoder.tlv;
+    tlv->base_path = *base_path;
+    tlv->last_path = ANJ_MAKE_ROOT_PATH();
+    tlv->items_count = items_count;
+    return 0;
+}
+
+void _anj_io_out_ctx_set_tlv_length_cb(_anj_io_out_ctx_t *ctx,
+                                       _anj_io_tlv_length_cb_t *length_cb,
+                                       void *arg) {
+    assert(ctx);
+    if (ctx->format != _ANJ_COAP_FORMAT_OMA_LWM2M_TLV) {
+        return;
+    }
+    ctx->encoder.tlv.length_cb = length_cb;
+    ctx->encoder.tlv.length_cb_arg = arg;
+}
+
+#endif // ANJ_WITH_TLV
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef SRC_ANJ_IO_TLV_ENCODER_H
+#define SRC_ANJ_IO_TLV_ENCODER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+
+#include "io.h"
+
+#ifdef ANJ_WITH_TLV
+
+int _anj_tlv_encoder_init(_anj_io_out_ctx_t *ctx,
+                          const anj_uri_path_t *base_path,
+                          size_t items_count);
+
+int _anj_tlv_out_ctx_new_entry(_anj_io_out_ctx_t *ctx,
+                               const anj_io_out_entry_t *entry);
+#endif // ANJ_WITH_TLV
+
+#endif // SRC_ANJ_IO_TLV_ENCODER_H
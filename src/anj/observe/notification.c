@@ -31,10 +31,11 @@
 #    define SUB_ABS(a, b) (((a) > (b)) ? (a) - (b) : (b) - (a))
 #    define MAX_OBSERVE_NUMBER 0xFFFFFF
 
-static void get_min_max_period(_anj_attr_notification_t *effective_attr,
-                               const _anj_observe_server_state_t *server_state,
-                               uint32_t *max_period,
-                               uint32_t *min_period) {
+static void
+get_min_max_period(const _anj_attr_notification_t *effective_attr,
+                   const _anj_observe_server_state_t *server_state,
+                   uint32_t *max_period,
+                   uint32_t *min_period) {
     *min_period = effective_attr->has_min_period
                           ? effective_attr->min_period
                           : server_state->default_min_period;
@@ -172,9 +173,17 @@ static void anj_exchange_completion(void *arg_ptr,
         }
 
         set_notification_flag(ctx, false);
+        _anj_observe_schedule_invalidate(ctx);
     }
 }
 
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+void _anj_observe_notification_detached(anj_t *anj) {
+    assert(anj);
+    anj_exchange_completion(anj, NULL, 0);
+}
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
 static int create_notification(anj_t *anj,
                                _anj_exchange_handlers_t *out_handlers,
                                const _anj_observe_server_state_t *server_state,
@@ -235,103 +244,110 @@ static int create_notification(anj_t *anj,
     return 0;
 }
 
-static uint64_t
-calculate_next_notify_check_timestamp(_anj_observe_observation_t *observation,
-                                      uint32_t max_period) {
-    if (max_period == 0) {
-        return ANJ_TIME_UNDEFINED;
+/* Returns the time at which the observation will require sending a
+ * notification, assuming that nothing changes in the meantime: either when
+ * pmax expires, or, if there is a pending value change, when pmin expires. */
+static uint64_t calculate_next_notify_check_timestamp(
+        const _anj_observe_observation_t *observation,
+        const _anj_observe_server_state_t *server_state) {
+    uint32_t min_period;
+    uint32_t max_period;
+    uint64_t next_notify_check_timestamp = ANJ_TIME_UNDEFINED;
+
+    get_min_max_period(&observation->effective_attr, server_state, &max_period,
+                       &min_period);
+    if (max_period) {
+        next_notify_check_timestamp = observation->last_notify_timestamp
+                                      + (uint64_t) max_period * 1000;
+    }
+    if (observation->notification_to_send) {
+        uint64_t min_period_timestamp = observation->last_notify_timestamp
+                                        + (uint64_t) min_period * 1000;
+        if (min_period_timestamp < next_notify_check_timestamp) {
+            next_notify_check_timestamp = min_period_timestamp;
+        }
     }
+    return next_notify_check_timestamp;
+}
 
-    return observation->last_notify_timestamp + max_period * 1000;
+void _anj_observe_schedule_invalidate(_anj_observe_ctx_t *ctx) {
+    ctx->schedule.valid = false;
 }
 
-static int
-observe_process_or_get_time(anj_t *anj,
-                            _anj_exchange_handlers_t *out_handlers,
-                            const _anj_observe_server_state_t *server_state,
-                            _anj_coap_msg_t *out_msg,
-                            uint64_t *time_to_next_notif,
-                            bool get_time) {
-    uint32_t min_period;
-    uint32_t max_period;
-    uint64_t elapsed_time;
-    uint64_t current_time = anj_time_real_now();
-    uint64_t tmp_time_to_next_notif;
-    uint64_t next_notify_check_timestamp;
-    int ret_val = 0;
+static bool
+schedule_is_valid(_anj_observe_ctx_t *ctx,
+                  const _anj_observe_server_state_t *server_state,
+                  uint64_t current_time) {
+    /* If the system time has been modified, the schedule is outdated. */
+    return ctx->schedule.valid && current_time >= ctx->schedule.calculated_at
+           && ctx->schedule.server_state.ssid == server_state->ssid
+           && ctx->schedule.server_state.default_min_period
+                      == server_state->default_min_period
+           && ctx->schedule.server_state.default_max_period
+                      == server_state->default_max_period;
+}
 
-    if (get_time) {
-        *time_to_next_notif = ANJ_TIME_UNDEFINED;
+/* Called when observation gets a pending value change. Such change can only
+ * make its notification happen earlier, so the schedule doesn't need to be
+ * recalculated from scratch. */
+static void schedule_pending_notification(
+        _anj_observe_ctx_t *ctx, _anj_observe_observation_t *observation) {
+    observation->notification_to_send = true;
+    if (ctx->schedule.valid
+            && ctx->schedule.server_state.ssid == observation->ssid) {
+        uint64_t next_notify_check_timestamp =
+                calculate_next_notify_check_timestamp(
+                        observation, &ctx->schedule.server_state);
+        if (next_notify_check_timestamp
+                < ctx->schedule.next_check_timestamp) {
+            ctx->schedule.next_check_timestamp = next_notify_check_timestamp;
+        }
     }
-    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+}
+
+/* Finds the first observation that requires sending a notification. If there
+ * is no such observation, recalculates the schedule. */
+static _anj_observe_observation_t *
+find_observation_to_notify(_anj_observe_ctx_t *ctx,
+                           const _anj_observe_server_state_t *server_state,
+                           uint64_t current_time) {
+    if (schedule_is_valid(ctx, server_state, current_time)
+            && current_time < ctx->schedule.next_check_timestamp) {
+        return NULL;
+    }
+
+    uint64_t next_check_timestamp = ANJ_TIME_UNDEFINED;
+    ctx->schedule.valid = false;
     for (size_t i = 0; i < ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER; i++) {
-        ctx->processing_observation = &ctx->observations[i];
-        if (!ctx->processing_observation->observe_active
-                || (ctx->processing_observation->ssid != server_state->ssid)) {
+        _anj_observe_observation_t *observation = &ctx->observations[i];
+        if (!observation->observe_active
+                || (observation->ssid != server_state->ssid)) {
             continue;
         }
 
         /* If this condition is met, it means that the system time has been
          * modified, and for this reason, we send a notification regardless of
          * the attributes */
-        if (current_time < ctx->processing_observation->last_notify_timestamp) {
-            if (get_time) {
-                *time_to_next_notif = 0;
-            } else {
-                ret_val = create_notification(anj, out_handlers, server_state,
-                                              out_msg);
-            }
-            break;
-        }
-
-        get_min_max_period(&ctx->processing_observation->effective_attr,
-                           server_state, &max_period, &min_period);
-
-        next_notify_check_timestamp = calculate_next_notify_check_timestamp(
-                ctx->processing_observation, max_period);
-
-        if (get_time && next_notify_check_timestamp != ANJ_TIME_UNDEFINED) {
-            if (current_time > next_notify_check_timestamp) {
-                tmp_time_to_next_notif = 0;
-            } else {
-                tmp_time_to_next_notif =
-                        next_notify_check_timestamp - current_time;
-            }
-
-            if (*time_to_next_notif > tmp_time_to_next_notif) {
-                *time_to_next_notif = tmp_time_to_next_notif;
-            }
+        if (current_time < observation->last_notify_timestamp) {
+            return observation;
         }
 
-        elapsed_time = (current_time
-                        - ctx->processing_observation->last_notify_timestamp)
-                       / 1000;
-
-        if (min_period > elapsed_time) {
-            if (get_time && ctx->processing_observation->notification_to_send) {
-                tmp_time_to_next_notif = min_period * 1000
-                                         - (current_time
-                                            - ctx->processing_observation
-                                                      ->last_notify_timestamp);
-                if (*time_to_next_notif > tmp_time_to_next_notif) {
-                    *time_to_next_notif = tmp_time_to_next_notif;
-                }
-            }
-            continue;
+        uint64_t next_notify_check_timestamp =
+                calculate_next_notify_check_timestamp(observation,
+                                                      server_state);
+        if (next_notify_check_timestamp <= current_time) {
+            return observation;
         }
-
-        if ((max_period && max_period <= elapsed_time)
-                || ctx->processing_observation->notification_to_send) {
-            if (get_time) {
-                *time_to_next_notif = 0;
-            } else {
-                ret_val = create_notification(anj, out_handlers, server_state,
-                                              out_msg);
-            }
-            break;
+        if (next_notify_check_timestamp < next_check_timestamp) {
+            next_check_timestamp = next_notify_check_timestamp;
         }
     }
-    return ret_val;
+
+    ctx->schedule.valid = true;
+    ctx->schedule.next_check_timestamp = next_check_timestamp;
+    ctx->schedule.calculated_at = current_time;
+    ctx->schedule.server_state = *server_state;
+    return NULL;
 }
 
 int _anj_observe_process(anj_t *anj,
@@ -341,8 +357,14 @@ int _anj_observe_process(anj_t *anj,
     assert(anj && server_state && out_msg && out_handlers);
     assert(server_state->ssid > 0 && server_state->ssid < UINT16_MAX);
 
-    return observe_process_or_get_time(anj, out_handlers, server_state, out_msg,
-                                       NULL, false);
+    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    _anj_observe_observation_t *observation =
+            find_observation_to_notify(ctx, server_state, anj_time_real_now());
+    if (!observation) {
+        return 0;
+    }
+    ctx->processing_observation = observation;
+    return create_notification(anj, out_handlers, server_state, out_msg);
 }
 
 int anj_observe_time_to_next_notification(
@@ -352,8 +374,17 @@ int anj_observe_time_to_next_notification(
     assert(anj && server_state && time_to_next_notification);
     assert(server_state->ssid > 0 && server_state->ssid < UINT16_MAX);
 
-    return observe_process_or_get_time(anj, NULL, server_state, NULL,
-                                       time_to_next_notification, true);
+    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    uint64_t current_time = anj_time_real_now();
+    if (find_observation_to_notify(ctx, server_state, current_time)) {
+        *time_to_next_notification = 0;
+    } else if (ctx->schedule.next_check_timestamp == ANJ_TIME_UNDEFINED) {
+        *time_to_next_notification = ANJ_TIME_UNDEFINED;
+    } else {
+        *time_to_next_notification =
+                ctx->schedule.next_check_timestamp - current_time;
+    }
+    return 0;
 }
 
 // a > b
@@ -472,106 +503,266 @@ static int check_attributes(anj_t *anj,
     return 0;
 }
 
-int anj_observe_data_model_changed(anj_t *anj,
-                                   const anj_uri_path_t *path,
-                                   anj_observe_change_type_t change_type,
-                                   uint16_t ssid) {
-    assert(anj && path);
-    assert(ssid < UINT16_MAX);
+void _anj_observe_path_index_invalidate(_anj_observe_ctx_t *ctx) {
+    ctx->path_index_valid = false;
+}
+
+static const anj_uri_path_t *
+path_index_path(const _anj_observe_ctx_t *ctx, uint16_t index_pos) {
+    return &ctx->observations[ctx->path_index[index_pos]].path;
+}
+
+/* Observations are kept in lexicographical order of their paths, with
+ * shorter paths placed before longer ones - so observations of all paths
+ * lying under a given base path are next to each other. Index is rebuilt only
+ * after the set of observations has changed, which happens much less often
+ * than data model changes. */
+static void path_index_update(_anj_observe_ctx_t *ctx) {
+    if (ctx->path_index_valid) {
+        return;
+    }
+    uint16_t size = 0;
+    for (uint16_t i = 0; i < ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER; i++) {
+        if (!ctx->observations[i].ssid) {
+            continue;
+        }
+        uint16_t pos = size;
+        while (pos > 0
+               && anj_uri_path_increasing(&ctx->observations[i].path,
+                                          path_index_path(ctx, pos - 1))) {
+            ctx->path_index[pos] = ctx->path_index[pos - 1];
+            pos--;
+        }
+        ctx->path_index[pos] = i;
+        size++;
+    }
+    ctx->path_index_size = size;
+    ctx->path_index_valid = true;
+}
+
+/* Returns position of the first observation with path not less than @p path,
+ * assumes that the index is up to date. */
+static uint16_t path_index_lower_bound(const _anj_observe_ctx_t *ctx,
+                                       const anj_uri_path_t *path) {
+    uint16_t low = 0;
+    uint16_t high = ctx->path_index_size;
+    while (low < high) {
+        uint16_t mid = (uint16_t) (low + (high - low) / 2);
+        if (anj_uri_path_increasing(path_index_path(ctx, mid), path)) {
+            low = (uint16_t) (mid + 1);
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+typedef struct {
+    bool already_read;
+    _anj_observation_res_val_t value;
+    anj_data_type_t type;
+} changed_value_t;
+
+static int observation_changed(anj_t *anj,
+                               _anj_observe_observation_t *observation,
+                               anj_observe_change_type_t change_type,
+                               uint16_t ssid,
+                               changed_value_t *changed_value) {
+    if (observation->notification_to_send || !observation->observe_active
+            || (ssid == 0 ? !observation->ssid : observation->ssid == ssid)) {
+        return 0;
+    }
+    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    ctx->processing_observation = observation;
+    if (change_type == ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED) {
+        int result = check_attributes(anj, &changed_value->value,
+                                      &changed_value->type,
+                                      &changed_value->already_read);
+        if (result == ATTRIBUTES_NOT_MET) {
+            return 0;
+        } else if (result) {
+            return result;
+        }
+    }
+    schedule_pending_notification(ctx, observation);
+    return 0;
+}
+
+static void assert_change_valid(const anj_uri_path_t *path,
+                                anj_observe_change_type_t change_type) {
+    assert(path);
     assert((change_type == ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED
             && anj_uri_path_has(path, ANJ_ID_RID))
            || ((change_type == ANJ_OBSERVE_CHANGE_TYPE_ADDED
                 || change_type == ANJ_OBSERVE_CHANGE_TYPE_DELETED)
                && !anj_uri_path_is(path, ANJ_ID_RID)));
+    (void) path;
+    (void) change_type;
+}
+
+static void delete_observations(_anj_observe_ctx_t *ctx,
+                                const anj_uri_path_t *path) {
+    for (size_t i = 0; i < ANJ_OBSERVE_MAX_WRITE_ATTRIBUTES_NUMBER; i++) {
+        if (ctx->attributes_storage[i].ssid
+                && !anj_uri_path_outside_base(&ctx->attributes_storage[i].path,
+                                              path)) {
+            ctx->attributes_storage[i].ssid = 0;
+        }
+    }
+    for (uint16_t pos = path_index_lower_bound(ctx, path);
+         pos < ctx->path_index_size
+         && !anj_uri_path_outside_base(path_index_path(ctx, pos), path);
+         pos++) {
+        _anj_observe_observation_t *observation =
+                &ctx->observations[ctx->path_index[pos]];
+        if (observation->ssid
+#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
+                && !observation->prev
+#    endif // ANJ_WITH_OBSERVE_COMPOSITE
+        ) {
+            ctx->processing_observation = observation;
+            _anj_observe_remove_observation(ctx);
+        }
+    }
+}
+
+#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
+static int verify_composite_observations(anj_t *anj,
+                                         const anj_uri_path_t *path) {
+    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    int ret_val = 0;
+    int result;
+    for (uint16_t pos = path_index_lower_bound(ctx, path);
+         pos < ctx->path_index_size
+         && !anj_uri_path_outside_base(path_index_path(ctx, pos), path);
+         pos++) {
+        _anj_observe_observation_t *observation =
+                &ctx->observations[ctx->path_index[pos]];
+        if (observation->ssid && observation->prev) {
+            ctx->processing_observation = observation;
+            /* At the time of adding the observation, the path may not have
+             * existed in the data model, so we need to check this now */
+            if ((result =
+                         _anj_observe_check_if_value_condition_attributes_should_be_disabled(
+                                 anj, ctx->processing_observation))) {
+                _anj_observe_remove_observation(ctx);
+                ret_val = result;
+            }
+            _anj_observe_verify_effective_attributes(
+                    ctx->processing_observation);
+            _anj_observe_schedule_invalidate(ctx);
+        }
+    }
+    return ret_val;
+}
+#    endif // ANJ_WITH_OBSERVE_COMPOSITE
+
+/* Marks positions in the path index of all observations that may be affected
+ * by the change of @p path. */
+static void mark_affected_observations(anj_t *anj,
+                                       const anj_uri_path_t *path,
+                                       anj_observe_change_type_t change_type,
+                                       bool *affected) {
+    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    /* Observations of the changed path or any of its parents, each of them
+     * can be found with a single lookup */
+    for (uint16_t len = 1; len <= path->uri_len; len++) {
+        anj_uri_path_t prefix = *path;
+        prefix.uri_len = len;
+        for (uint16_t pos = path_index_lower_bound(ctx, &prefix);
+             pos < ctx->path_index_size
+             && path_index_path(ctx, pos)->uri_len == len
+             && !anj_uri_path_outside_base(path_index_path(ctx, pos), &prefix);
+             pos++) {
+            affected[pos] = true;
+        }
+    }
+#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
+    if (change_type == ANJ_OBSERVE_CHANGE_TYPE_ADDED) {
+        /* If it is a composite observation, it is also necessary to check the
+         * paths that may not have existed in the data model before. */
+        for (uint16_t pos = path_index_lower_bound(ctx, path);
+             pos < ctx->path_index_size
+             && !anj_uri_path_outside_base(path_index_path(ctx, pos), path);
+             pos++) {
+            _anj_observe_observation_t *observation =
+                    &ctx->observations[ctx->path_index[pos]];
+            /* If this function returns an error different than
+               ANJ_COAP_CODE_NOT_FOUND then the observation should be removed
+               in the _anj_observe_attribute_has_value_change_condition
+               function. */
+            if (!affected[pos] && observation->prev
+                    && !_anj_dm_observe_is_any_resource_readable(
+                               anj, &observation->path)) {
+                affected[pos] = true;
+            }
+        }
+    }
+#    else  // ANJ_WITH_OBSERVE_COMPOSITE
+    (void) change_type;
+#    endif // ANJ_WITH_OBSERVE_COMPOSITE
+}
+
+int anj_observe_data_model_changed_batch(anj_t *anj,
+                                         const anj_uri_path_t *paths,
+                                         size_t paths_count,
+                                         anj_observe_change_type_t change_type,
+                                         uint16_t ssid) {
+    assert(anj && (paths || !paths_count));
+    assert(ssid < UINT16_MAX);
+    for (size_t i = 0; i < paths_count; i++) {
+        assert_change_valid(&paths[i], change_type);
+    }
 
     int ret_val = 0;
     int result = 0;
     _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    /* Observations might get removed while iterating over the index, but this
+     * only clears their ssid, so the index stays usable until the loop ends */
+    path_index_update(ctx);
     switch (change_type) {
     case ANJ_OBSERVE_CHANGE_TYPE_ADDED:
 #    ifdef ANJ_WITH_OBSERVE_COMPOSITE
-        for (size_t i = 0; i < ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER; i++) {
-            if (ctx->observations[i].ssid && ctx->observations[i].prev
-                    && !anj_uri_path_outside_base(&ctx->observations[i].path,
-                                                  path)) {
-                ctx->processing_observation = &ctx->observations[i];
-                /* At the time of adding the observation, the path may not have
-                 * existed in the data model, so we need to check this now */
-                if ((result =
-                             _anj_observe_check_if_value_condition_attributes_should_be_disabled(
-                                     anj, ctx->processing_observation))) {
-                    _anj_observe_remove_observation(ctx);
-                    ret_val = result;
-                }
-                _anj_observe_verify_effective_attributes(
-                        ctx->processing_observation);
+        for (size_t i = 0; i < paths_count; i++) {
+            if ((result = verify_composite_observations(anj, &paths[i]))) {
+                ret_val = result;
             }
         }
+        path_index_update(ctx);
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
     /* fall through */
     case ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED: {
-        bool already_read = false;
-        _anj_observation_res_val_t observe_value;
-        anj_data_type_t res_type;
-        for (size_t i = 0; i < ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER; i++) {
-            if (!ctx->observations[i].notification_to_send
-                    && ctx->observations[i].observe_active
-                    && (ssid == 0 ? ctx->observations[i].ssid
-                                  : ctx->observations[i].ssid != ssid)
-                    && (!anj_uri_path_outside_base(path,
-                                                   &ctx->observations[i].path)
-#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
-                        /* If it is a composite observation, it is also
-                           necessary to check the paths that may not have
-                           existed in the data model before. */
-                        || (change_type == ANJ_OBSERVE_CHANGE_TYPE_ADDED
-                            && ctx->observations[i].prev
-                            && !anj_uri_path_outside_base(
-                                       &ctx->observations[i].path, path)
-                            /* If this function returns an error different than
-                               ANJ_COAP_CODE_NOT_FOUND then the observation
-                               should be removed in the
-                               _anj_observe_attribute_has_value_change_condition
-                               function. */
-                            && !_anj_dm_observe_is_any_resource_readable(
-                                       anj, &ctx->observations[i].path))
-#    endif // ANJ_WITH_OBSERVE_COMPOSITE
-                                )) {
-                ctx->processing_observation = &ctx->observations[i];
-                if (change_type == ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED) {
-                    result = check_attributes(anj, &observe_value, &res_type,
-                                              &already_read);
-                    if (result == ATTRIBUTES_NOT_MET) {
-                        continue;
-                    } else if (result) {
-                        ret_val = result;
-                        continue;
-                    }
-                }
-                ctx->processing_observation->notification_to_send = true;
+        bool affected[ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER] = { false };
+        for (size_t i = 0; i < paths_count; i++) {
+            mark_affected_observations(anj, &paths[i], change_type, affected);
+        }
+        /* Observations of the same path are next to each other in the index,
+         * so the value of each Resource is read at most once */
+        changed_value_t changed_value = {
+            .already_read = false
+        };
+        const anj_uri_path_t *read_path = NULL;
+        for (uint16_t pos = 0; pos < ctx->path_index_size; pos++) {
+            if (!affected[pos]) {
+                continue;
+            }
+            if (!read_path
+                    || !anj_uri_path_equal(read_path,
+                                           path_index_path(ctx, pos))) {
+                read_path = path_index_path(ctx, pos);
+                changed_value.already_read = false;
+            }
+            if ((result = observation_changed(
+                         anj, &ctx->observations[ctx->path_index[pos]],
+                         change_type, ssid, &changed_value))) {
+                ret_val = result;
             }
         }
         break;
     }
     case ANJ_OBSERVE_CHANGE_TYPE_DELETED: {
-        for (size_t i = 0; i < ANJ_OBSERVE_MAX_WRITE_ATTRIBUTES_NUMBER; i++) {
-            if (ctx->attributes_storage[i].ssid
-                    && !anj_uri_path_outside_base(
-                               &ctx->attributes_storage[i].path, path)) {
-                ctx->attributes_storage[i].ssid = 0;
-            }
-        }
-        for (size_t i = 0; i < ANJ_OBSERVE_MAX_OBSERVATIONS_NUMBER; i++) {
-            if (ctx->observations[i].ssid
-                    && !anj_uri_path_outside_base(&ctx->observations[i].path,
-                                                  path)
-#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
-                    && !ctx->observations[i].prev
-#    endif // ANJ_WITH_OBSERVE_COMPOSITE
-            ) {
-                ctx->processing_observation = &ctx->observations[i];
-                _anj_observe_remove_observation(ctx);
-            }
+        for (size_t i = 0; i < paths_count; i++) {
+            delete_observations(ctx, &paths[i]);
         }
         break;
     }
@@ -582,4 +773,13 @@ int anj_observe_data_model_changed(anj_t *anj,
     return ret_val;
 }
 
+int anj_observe_data_model_changed(anj_t *anj,
+                                   const anj_uri_path_t *path,
+                                   anj_observe_change_type_t change_type,
+                                   uint16_t ssid) {
+    assert(anj && path);
+    return anj_observe_data_model_changed_batch(anj, path, 1, change_type,
+                                                ssid);
+}
+
 #endif // ANJ_WITH_OBSERVE
@@ -96,6 +96,7 @@ void _anj_observe_composite_refresh_timestamp(_anj_observe_ctx_t *ctx) {
         ctx->processing_observation->last_notify_timestamp =
                 anj_time_real_now();
     } while ((ctx->processing_observation != first_observation));
+    _anj_observe_schedule_invalidate(ctx);
 }
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
 
@@ -252,9 +253,32 @@ void _anj_observe_remove_observation(_anj_observe_ctx_t *ctx) {
         }
     }
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
+    _anj_observe_path_index_invalidate(ctx);
+    _anj_observe_schedule_invalidate(ctx);
     observe_log(L_INFO, "Observation removed");
 }
 
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+void _anj_observe_detached_notification_failed(anj_t *anj,
+                                               uint16_t ssid,
+                                               const _anj_coap_token_t *token) {
+    assert(anj && token);
+    _anj_observe_ctx_t *ctx = &anj->observe_ctx;
+    _anj_observe_observation_t *observation =
+            find_observation(ctx, ssid, token);
+    if (!observation) {
+        // observation was canceled in the meantime
+        return;
+    }
+    observe_log(L_ERROR, "Failed to send notification");
+    _anj_observe_observation_t *processing_observation =
+            ctx->processing_observation;
+    ctx->processing_observation = observation;
+    _anj_observe_remove_observation(ctx);
+    ctx->processing_observation = processing_observation;
+}
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
 void _anj_observe_set_uri_paths_and_format(anj_t *anj) {
     _anj_observe_ctx_t *ctx = &anj->observe_ctx;
 #    ifdef ANJ_WITH_OBSERVE_COMPOSITE
@@ -271,7 +295,7 @@ void _anj_observe_set_uri_paths_and_format(anj_t *anj) {
     } else
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
     {
-        ctx->format = _ANJ_COAP_FORMAT_NOT_DEFINED;
+        ctx->format = ctx->processing_observation->accept_opt;
         ctx->uri_count = 1;
 #    ifdef ANJ_WITH_OBSERVE_COMPOSITE
         ctx->uri_paths[0] = &ctx->processing_observation->path;
@@ -321,7 +345,6 @@ static int add_observation(anj_t *anj,
                            uint16_t accept_opt,
                            uint16_t ssid) {
     (void) content_format;
-    (void) accept_opt;
     if (!anj_uri_path_has(uri_path, ANJ_ID_OID)) {
         return ANJ_COAP_CODE_METHOD_NOT_ALLOWED;
     }
@@ -345,9 +368,10 @@ static int add_observation(anj_t *anj,
     }
     observation->path = *uri_path;
     observation->ssid = ssid;
+    _anj_observe_path_index_invalidate(ctx);
     observation->token = *ctx->token;
-#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
     observation->accept_opt = accept_opt;
+#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
     observation->content_format_opt = content_format;
     observation->prev = ctx->processing_observation;
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
@@ -360,6 +384,7 @@ static int add_observation(anj_t *anj,
         return res;
     }
     ctx->processing_observation->last_notify_timestamp = anj_time_real_now();
+    _anj_observe_schedule_invalidate(ctx);
     return 0;
 }
 
@@ -477,6 +502,7 @@ static void anj_exchange_completion(void *arg_ptr,
     _anj_observe_ctx_t *ctx = &anj->observe_ctx;
     assert(ctx->in_progress_type == MSG_TYPE_OBSERVE_RESPONSE
            || ctx->in_progress_type == MSG_TYPE_CANCEL_OBSERVE_RESPONSE);
+    ctx->already_processed = 0;
     if (result) {
         _anj_dm_observe_terminate_operation(anj);
         if (ctx->in_progress_type == MSG_TYPE_OBSERVE_RESPONSE) {
@@ -509,6 +535,7 @@ static void refresh_after_write_attr(anj_t *anj,
                                                      ssid);
         }
     }
+    _anj_observe_schedule_invalidate(ctx);
 }
 
 static bool composite_are_not_enabled(void) {
@@ -622,11 +649,13 @@ static int parse_request(anj_t *anj,
             if (ctx->observation_exists) {
                 ctx->processing_observation->last_notify_timestamp =
                         anj_time_real_now();
+                ctx->processing_observation->accept_opt = request->accept;
+                _anj_observe_schedule_invalidate(ctx);
             } else {
                 result = add_observation(anj, &request->attr.notification_attr,
                                          &request->uri,
                                          _ANJ_COAP_FORMAT_NOT_DEFINED,
-                                         _ANJ_COAP_FORMAT_NOT_DEFINED, ssid);
+                                         request->accept, ssid);
             }
 #    ifdef ANJ_WITH_OBSERVE_COMPOSITE
         }
@@ -705,6 +734,8 @@ void _anj_observe_remove_all_observations(anj_t *anj, uint16_t ssid) {
             ctx->observations[i].ssid = 0;
         }
     }
+    _anj_observe_path_index_invalidate(ctx);
+    _anj_observe_schedule_invalidate(ctx);
 }
 
 #endif // ANJ_WITH_OBSERVE
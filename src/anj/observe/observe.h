@@ -222,6 +222,33 @@ int _anj_observe_process(anj_t *anj,
  */
 void _anj_observe_remove_all_observations(anj_t *anj, uint16_t ssid);
 
+#    ifdef _ANJ_WITH_IN_FLIGHT_REQUESTS
+/**
+ * Should be called instead of the exchange completion handler when the
+ * exchange of a confirmable notification is detached after sending (see @ref
+ * _anj_exchange_detach). The notification is treated as sent, so that the
+ * next one can be scheduled.
+ *
+ * @param anj  Anjay object to operate on.
+ */
+void _anj_observe_notification_detached(anj_t *anj);
+
+/**
+ * Should be called when a confirmable notification, whose exchange was detached
+ * after sending (see @ref _anj_exchange_detach), finally fails. The exchange
+ * completion handler has already reported success at the time of detaching, so
+ * the observation related to the notification is removed here. If it does not
+ * exist anymore, nothing happens.
+ *
+ * @param     anj    Anjay object to operate on.
+ * @param     ssid   Short Server ID of the observation.
+ * @param[in] token  Token of the notification.
+ */
+void _anj_observe_detached_notification_failed(anj_t *anj,
+                                               uint16_t ssid,
+                                               const _anj_coap_token_t *token);
+#    endif // _ANJ_WITH_IN_FLIGHT_REQUESTS
+
 /**
  * Removes all attribute storage records for given server. Might be called when
  * the connection to a specific LwM2M server is finished. Specification allows
@@ -322,6 +349,30 @@ int anj_observe_data_model_changed(anj_t *anj,
                                    anj_observe_change_type_t change_type,
                                    uint16_t ssid);
 
+/**
+ * Batched version of @ref anj_observe_data_model_changed. Informs the observe
+ * module about the same type of change of all @p paths at once. The
+ * observations are evaluated in a single pass, and the value of each observed
+ * Resource is read at most once, no matter how many of the @p paths affect it.
+ *
+ * @param     anj          Anjay object to operate on.
+ * @param[in] paths        Array of changed paths, each of them must meet the
+ *                         requirements of @ref anj_observe_data_model_changed
+ *                         for given @p change_type.
+ * @param     paths_count  Number of elements in @p paths.
+ * @param     change_type  Type of change; @ref anj_observe_change_type_t.
+ * @param     ssid         SSID of the server that caused the change. If the
+ *                         change is not associated with any server, it should
+ *                         be set to 0.
+ *
+ * @returns 0 on success, a ANJ_COAP_CODE_* value in case of error.
+ */
+int anj_observe_data_model_changed_batch(anj_t *anj,
+                                         const anj_uri_path_t *paths,
+                                         size_t paths_count,
+                                         anj_observe_change_type_t change_type,
+                                         uint16_t ssid);
+
 #    define ANJ_INTERNAL_INCLUDE_OBSERVE
 #    include <anj_internal/observe.h>
 #    undef ANJ_INTERNAL_INCLUDE_OBSERVE
@@ -78,6 +78,17 @@ void _anj_observe_verify_effective_attributes(
 void _anj_observe_composite_refresh_timestamp(_anj_observe_ctx_t *ctx);
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
 
+/* Notifications scheduling */
+
+/* Must be called whenever timing parameters of any observation change, e.g.
+ * its attributes, last notification timestamp or the observation itself is
+ * added or removed. */
+void _anj_observe_schedule_invalidate(_anj_observe_ctx_t *ctx);
+
+/* Must be called whenever an observation is added or removed, so that the
+ * index of observation paths gets rebuilt before its next use. */
+void _anj_observe_path_index_invalidate(_anj_observe_ctx_t *ctx);
+
 #endif // ANJ_WITH_OBSERVE
 
 #endif // SRC_ANJ_OBSERVE_OBSERVE_CORE_H
@@ -16,13 +16,33 @@
 
 #include <anj/anj_config.h>
 #include <anj/defs.h>
+#include <anj/utils.h>
 
 #include "coap/coap.h"
 
+/**
+ * Initializes PRNG state from a 32-bit seed value.
+ */
+void _anj_rand_seed(_anj_rand_seed_t *seed, uint32_t value);
+
 /**
  * Returns a pseudo-random integer from range [0, UINT32_MAX].
+ *
+ * The generator is fast, but not cryptographically secure.
  */
-uint32_t _anj_rand32_r(_anj_rand_seed_t *seed);
+static inline uint32_t _anj_rand32_r(_anj_rand_seed_t *seed) {
+    // xoshiro128** 1.1 by David Blackman and Sebastiano Vigna, public domain
+    uint32_t *s = seed->s;
+    const uint32_t result = ((s[1] * 5u) << 7 | (s[1] * 5u) >> 25) * 9u;
+    const uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = s[3] << 11 | s[3] >> 21;
+    return result;
+}
 
 /**
  * Returns a pseudo-random integer from range [0, UINT64_MAX].
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#ifndef ANJ_BENCH_H
+#define ANJ_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <time.h>
+
+/**
+ * Monotonic clock with nanosecond resolution, used to measure execution time of
+ * benchmarked code.
+ */
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * Prints a single benchmark result line: average time of one iteration.
+ */
+static inline void bench_report(const char *suite,
+                                const char *name,
+                                uint64_t elapsed_ns,
+                                uint64_t iterations) {
+    printf("%-16s %-40s %10.2f ns/op\n", suite, name,
+           (double) elapsed_ns / (double) iterations);
+}
+
+/**
+ * Used to keep the results of benchmarked calls alive, so that they are not
+ * optimized out by the compiler.
+ */
+extern volatile uint64_t bench_sink;
+
+void bench_dm_lookup(void);
+
+void bench_coap_encode(void);
+
+void bench_rand(void);
+
+void bench_double_to_string(void);
+
+void bench_string_to_number(void);
+
+void bench_cbor_decode(void);
+
+#endif // ANJ_BENCH_H
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+#include <anj/utils.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/io/io.h"
+
+#include "bench.h"
+
+#ifdef ANJ_WITH_SENML_CBOR
+
+#    define RECORDS_COUNT 300
+#    define DECODES_PER_CHUNK_SIZE 5000
+
+// Write-Composite with a mix of doubles, integers and strings, similar to
+// a configuration pushed to many instances of the same Object
+static uint8_t payload[RECORDS_COUNT * 48];
+static size_t payload_len;
+
+static void put_header(uint8_t major_type, uint64_t value) {
+    uint8_t *out = &payload[payload_len];
+    if (value < 24) {
+        out[0] = (uint8_t) ((major_type << 5) | value);
+        payload_len += 1;
+    } else if (value <= UINT8_MAX) {
+        out[0] = (uint8_t) ((major_type << 5) | 24);
+        out[1] = (uint8_t) value;
+        payload_len += 2;
+    } else if (value <= UINT16_MAX) {
+        out[0] = (uint8_t) ((major_type << 5) | 25);
+        out[1] = (uint8_t) (value >> 8);
+        out[2] = (uint8_t) value;
+        payload_len += 3;
+    } else {
+        out[0] = (uint8_t) ((major_type << 5) | 26);
+        for (int i = 0; i < 4; i++) {
+            out[1 + i] = (uint8_t) (value >> (8 * (3 - i)));
+        }
+        payload_len += 5;
+    }
+}
+
+static void put_text(const char *text) {
+    size_t len = strlen(text);
+    put_header(3, len);
+    memcpy(&payload[payload_len], text, len);
+    payload_len += len;
+}
+
+static void put_double(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    payload[payload_len++] = 0xFB;
+    for (int i = 0; i < 8; i++) {
+        payload[payload_len++] = (uint8_t) (bits >> (8 * (7 - i)));
+    }
+}
+
+static void prepare_payload(void) {
+    char name[32];
+    payload_len = 0;
+    put_header(4, RECORDS_COUNT);
+    for (uint32_t i = 0; i < RECORDS_COUNT; i++) {
+        put_header(5, 2);
+        put_header(0, 0); // SenML Name
+        switch (i % 3) {
+        case 0:
+            snprintf(name, sizeof(name), "/3303/%u/5700", (unsigned) i);
+            put_text(name);
+            put_header(0, 2); // SenML Value
+            put_double(20.0 + (double) i / 7.0);
+            break;
+        case 1:
+            snprintf(name, sizeof(name), "/1/%u/1", (unsigned) i);
+            put_text(name);
+            put_header(0, 2); // SenML Value
+            put_header(0, 86400 + i);
+            break;
+        default:
+            snprintf(name, sizeof(name), "/3341/%u/5527", (unsigned) i);
+            put_text(name);
+            put_header(0, 3); // SenML String Value
+            put_text("display text 0123456789");
+            break;
+        }
+    }
+}
+
+static void bench_chunk_size(const char *name, size_t chunk_size) {
+    uint64_t sink = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < DECODES_PER_CHUNK_SIZE; i++) {
+        _anj_io_in_ctx_t ctx;
+        if (_anj_io_in_ctx_init(&ctx, ANJ_OP_DM_WRITE_COMP,
+                                &ANJ_MAKE_ROOT_PATH(),
+                                _ANJ_COAP_FORMAT_SENML_CBOR)) {
+            printf("cbor_decode: init failed\n");
+            return;
+        }
+        size_t offset = 0;
+        int result = _ANJ_IO_WANT_NEXT_PAYLOAD;
+        while (true) {
+            if (result == _ANJ_IO_WANT_NEXT_PAYLOAD) {
+                size_t len = ANJ_MIN(chunk_size, payload_len - offset);
+                _anj_io_in_ctx_feed_payload(&ctx, &payload[offset], len,
+                                            offset + len == payload_len);
+                offset += len;
+            }
+            anj_data_type_t type = ANJ_DATA_TYPE_ANY;
+            const anj_res_value_t *value;
+            const anj_uri_path_t *path;
+            result = _anj_io_in_ctx_get_entry(&ctx, &type, &value, &path);
+            if (result == _ANJ_IO_WANT_TYPE_DISAMBIGUATION) {
+                // numbers may be decoded as one of several types
+                type = (type & ANJ_DATA_TYPE_DOUBLE) ? ANJ_DATA_TYPE_DOUBLE
+                                                     : ANJ_DATA_TYPE_INT;
+                result = _anj_io_in_ctx_get_entry(&ctx, &type, &value, &path);
+            }
+            if (result == _ANJ_IO_EOF) {
+                break;
+            } else if (result < 0) {
+                printf("cbor_decode: decoding failed: %d\n", result);
+                return;
+            } else if (!result) {
+                sink += path->ids[ANJ_ID_IID] + type;
+            }
+        }
+    }
+    bench_report("cbor_decode", name, bench_now_ns() - start,
+                 (uint64_t) DECODES_PER_CHUNK_SIZE * RECORDS_COUNT);
+    bench_sink += sink;
+}
+
+void bench_cbor_decode(void) {
+    prepare_payload();
+    bench_chunk_size("senml write-composite, contiguous",
+                     sizeof(payload));
+    bench_chunk_size("senml write-composite, 1024 B blocks", 1024);
+    bench_chunk_size("senml write-composite, 64 B blocks", 64);
+}
+
+#else // ANJ_WITH_SENML_CBOR
+
+void bench_cbor_decode(void) {}
+
+#endif // ANJ_WITH_SENML_CBOR
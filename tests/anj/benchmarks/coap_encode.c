@@ -0,0 +1,71 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+
+#include "../../../src/anj/coap/coap.h"
+
+#include "bench.h"
+
+#define ENCODES_PER_MSG 2000000
+
+static uint8_t payload[64];
+
+static void bench_msg(const char *name, const _anj_coap_msg_t *template_msg) {
+    uint8_t buff[256];
+    uint64_t sink = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < ENCODES_PER_MSG; i++) {
+        _anj_coap_msg_t msg = *template_msg;
+        msg.observe_number = i;
+        size_t out_msg_size = 0;
+        sink += (uint64_t) _anj_coap_encode_udp(&msg, buff, sizeof(buff),
+                                                &out_msg_size);
+        sink += out_msg_size + buff[out_msg_size / 2];
+    }
+    bench_report("coap_encode", name, bench_now_ns() - start,
+                 ENCODES_PER_MSG);
+    bench_sink += sink;
+}
+
+void bench_coap_encode(void) {
+    memset(payload, 0xA5, sizeof(payload));
+
+    _anj_coap_msg_t notify;
+    memset(&notify, 0, sizeof(notify));
+    notify.operation = ANJ_OP_INF_NON_CON_NOTIFY;
+    notify.token.size = 8;
+    notify.content_format = _ANJ_COAP_FORMAT_SENML_CBOR;
+    notify.payload = payload;
+    notify.payload_size = sizeof(payload);
+    bench_msg("notify", &notify);
+
+    _anj_coap_msg_t update;
+    memset(&update, 0, sizeof(update));
+    update.operation = ANJ_OP_UPDATE;
+    update.location_path.location[0] = "rd";
+    update.location_path.location_len[0] = 2;
+    update.location_path.location[1] = "5a3f";
+    update.location_path.location_len[1] = 4;
+    update.location_path.location_count = 2;
+    bench_msg("update", &update);
+
+    _anj_coap_msg_t send;
+    memset(&send, 0, sizeof(send));
+    send.operation = ANJ_OP_INF_CON_SEND;
+    send.content_format = _ANJ_COAP_FORMAT_SENML_CBOR;
+    send.payload = payload;
+    send.payload_size = sizeof(payload);
+    bench_msg("send", &send);
+}
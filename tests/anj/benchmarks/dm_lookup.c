@@ -0,0 +1,130 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <anj/anj_config.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/core.h>
+
+#include "../../../src/anj/dm/dm_core.h"
+#include "../../../src/anj/dm/dm_io.h"
+
+#include "bench.h"
+
+#define MAX_INST_COUNT 2048
+#define RES_COUNT 32
+#define RES_INST_COUNT 64
+#define LOOKUPS_PER_SIZE 1000000
+
+static anj_riid_t res_insts[RES_INST_COUNT];
+static anj_dm_res_t resources[RES_COUNT];
+static anj_dm_obj_inst_t insts[MAX_INST_COUNT];
+
+static int res_read(anj_t *anj,
+                    const anj_dm_obj_t *obj,
+                    anj_iid_t iid,
+                    anj_rid_t rid,
+                    anj_riid_t riid,
+                    anj_res_value_t *out_value) {
+    (void) anj;
+    (void) obj;
+    (void) iid;
+    (void) rid;
+    (void) riid;
+    out_value->int_value = 0;
+    return 0;
+}
+
+static const anj_dm_handlers_t handlers = {
+    .res_read = res_read
+};
+
+static void init_obj(anj_dm_obj_t *obj, uint16_t inst_count) {
+    for (uint16_t i = 0; i < RES_INST_COUNT; i++) {
+        res_insts[i] = i;
+    }
+    for (uint16_t i = 0; i < RES_COUNT; i++) {
+        resources[i] = (anj_dm_res_t) {
+            .rid = i,
+            .operation = ANJ_DM_RES_R,
+            .type = ANJ_DATA_TYPE_INT
+        };
+    }
+    resources[RES_COUNT - 1].operation = ANJ_DM_RES_RM;
+    resources[RES_COUNT - 1].insts = res_insts;
+    resources[RES_COUNT - 1].max_inst_count = RES_INST_COUNT;
+    for (uint16_t i = 0; i < MAX_INST_COUNT; i++) {
+        insts[i] = (anj_dm_obj_inst_t) {
+            .iid = i < inst_count ? i : ANJ_ID_INVALID,
+            .resources = resources,
+            .res_count = RES_COUNT
+        };
+    }
+    *obj = (anj_dm_obj_t) {
+        .oid = 3303,
+        .insts = insts,
+        .max_inst_count = inst_count,
+        .handlers = &handlers
+    };
+}
+
+static void bench_table_size(uint16_t inst_count) {
+    static anj_t anj;
+    _anj_dm_initialize(&anj);
+    anj_dm_obj_t obj;
+    init_obj(&obj, inst_count);
+    if (anj_dm_add_obj(&anj, &obj)) {
+        printf("failed to add object\n");
+        return;
+    }
+
+    char name[64];
+    _anj_dm_entity_ptrs_t ptrs;
+    uint64_t sink = 0;
+
+    // Resource Instance paths, spread over the whole object, so that the
+    // average cost of resolving each of the path levels is measured
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < LOOKUPS_PER_SIZE; i++) {
+        anj_uri_path_t path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(
+                3303, (anj_iid_t) (i % inst_count), RES_COUNT - 1,
+                (anj_riid_t) (i % RES_INST_COUNT));
+        sink += (uint64_t) _anj_dm_get_entity_ptrs(&anj.dm, &path, &ptrs);
+        sink += ptrs.riid;
+    }
+    snprintf(name, sizeof(name), "res_inst_path/%u_insts", inst_count);
+    bench_report("dm_lookup", name, bench_now_ns() - start, LOOKUPS_PER_SIZE);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < LOOKUPS_PER_SIZE; i++) {
+        anj_uri_path_t path = ANJ_MAKE_RESOURCE_PATH(
+                3303, (anj_iid_t) (i % inst_count), (anj_rid_t) (i % RES_COUNT));
+        sink += (uint64_t) _anj_dm_get_entity_ptrs(&anj.dm, &path, &ptrs);
+        sink += ptrs.res->rid;
+    }
+    snprintf(name, sizeof(name), "res_path/%u_insts", inst_count);
+    bench_report("dm_lookup", name, bench_now_ns() - start, LOOKUPS_PER_SIZE);
+
+    bench_sink += sink;
+}
+
+void bench_dm_lookup(void) {
+#ifdef ANJ_DM_WITH_BINARY_SEARCH
+    printf("dm_lookup: binary search (ANJ_DM_WITH_BINARY_SEARCH=ON)\n");
+#else  // ANJ_DM_WITH_BINARY_SEARCH
+    printf("dm_lookup: linear search (ANJ_DM_WITH_BINARY_SEARCH=OFF)\n");
+#endif // ANJ_DM_WITH_BINARY_SEARCH
+    static const uint16_t sizes[] = { 8, 32, 128, 512, MAX_INST_COUNT };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_table_size(sizes[i]);
+    }
+}
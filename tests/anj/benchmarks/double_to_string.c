@@ -0,0 +1,106 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+#include <anj/utils.h>
+
+#include "bench.h"
+
+#define VALUES_COUNT 1024
+#define ITERATIONS 2000
+
+static double sensor_values[VALUES_COUNT];
+static double random_values[VALUES_COUNT];
+
+static uint64_t next_bits(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void prepare_values(void) {
+    uint64_t state = 0x9E3779B97F4A7C15;
+    for (size_t i = 0; i < VALUES_COUNT; i++) {
+        // typical readings: temperature, voltage, coordinates
+        uint64_t bits = next_bits(&state);
+        double divider = pow(10.0, (double) (bits % 7));
+        sensor_values[i] =
+                (double) ((int64_t) (bits >> 16) % 1000000) / divider;
+    }
+    for (size_t i = 0; i < VALUES_COUNT;) {
+        uint64_t bits = next_bits(&state);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (isfinite(value)) {
+            random_values[i++] = value;
+        }
+    }
+}
+
+static size_t anj_to_string(char *buff, double value) {
+    return anj_double_to_string_value(buff, value);
+}
+
+static size_t snprintf_17g(char *buff, double value) {
+    return (size_t) snprintf(buff, ANJ_DOUBLE_STR_MAX_LEN + 1, "%.17g",
+                             value);
+}
+
+// shortest representation with the standard library: increases precision
+// until the value converts back
+static size_t snprintf_shortest(char *buff, double value) {
+    int len = 0;
+    for (int precision = 1; precision <= 17; precision++) {
+        len = snprintf(buff, ANJ_DOUBLE_STR_MAX_LEN + 1, "%.*g", precision,
+                       value);
+        if (strtod(buff, NULL) == value) {
+            break;
+        }
+    }
+    return (size_t) len;
+}
+
+static void bench_values(const char *name,
+                         const double *values,
+                         size_t (*to_string)(char *buff, double value)) {
+    char buff[ANJ_DOUBLE_STR_MAX_LEN + 1];
+    uint64_t sink = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        for (size_t j = 0; j < VALUES_COUNT; j++) {
+            size_t len = to_string(buff, values[j]);
+            sink += len + (uint8_t) buff[len - 1];
+        }
+    }
+    bench_report("double_to_str", name, bench_now_ns() - start,
+                 (uint64_t) ITERATIONS * VALUES_COUNT);
+    bench_sink += sink;
+}
+
+void bench_double_to_string(void) {
+    prepare_values();
+    bench_values("sensor: anj_double_to_string_value", sensor_values,
+                 anj_to_string);
+    bench_values("sensor: snprintf %.17g", sensor_values, snprintf_17g);
+    bench_values("sensor: snprintf shortest", sensor_values,
+                 snprintf_shortest);
+    bench_values("random: anj_double_to_string_value", random_values,
+                 anj_to_string);
+    bench_values("random: snprintf %.17g", random_values, snprintf_17g);
+    bench_values("random: snprintf shortest", random_values,
+                 snprintf_shortest);
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include "bench.h"
+
+volatile uint64_t bench_sink;
+
+int main(void) {
+    bench_dm_lookup();
+    bench_coap_encode();
+    bench_rand();
+    bench_double_to_string();
+    bench_string_to_number();
+    bench_cbor_decode();
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/compat/rng.h>
+#include <anj/defs.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/utils.h"
+
+#include "bench.h"
+
+#define RAND_ITERATIONS 20000000
+#define ENCODE_ITERATIONS 2000000
+#define SECURE_RNG_ITERATIONS 100000
+
+static uint8_t payload[64];
+
+// Generator used before xoshiro128**: three steps of ANSI C LCG, 15 bits each,
+// kept here as the baseline.
+static uint32_t lcg_rand32(unsigned int *seed) {
+    uint32_t result = 0;
+    for (int i = 0; i < 3; ++i) {
+        *seed = *seed * 1103515245u + 12345u;
+        result *= 0x8000u;
+        result += (uint32_t) (*seed % 0x8000u);
+    }
+    return result;
+}
+
+static void bench_generators(void) {
+    uint64_t sink = 0;
+    unsigned int lcg_seed = 1;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < RAND_ITERATIONS; i++) {
+        sink += lcg_rand32(&lcg_seed);
+    }
+    bench_report("rand", "lcg_rand32 (baseline)", bench_now_ns() - start,
+                 RAND_ITERATIONS);
+
+    _anj_rand_seed_t seed;
+    _anj_rand_seed(&seed, 1);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < RAND_ITERATIONS; i++) {
+        sink += _anj_rand32_r(&seed);
+    }
+    bench_report("rand", "xoshiro128** rand32", bench_now_ns() - start,
+                 RAND_ITERATIONS);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < RAND_ITERATIONS; i++) {
+        sink += _anj_rand64_r(&seed);
+    }
+    bench_report("rand", "xoshiro128** rand64 (token)", bench_now_ns() - start,
+                 RAND_ITERATIONS);
+
+#ifdef ANJ_COAP_WITH_SECURE_RNG
+    uint8_t token[8];
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < SECURE_RNG_ITERATIONS; i++) {
+        sink += (uint64_t) anj_rng_generate(token, sizeof(token)) + token[0];
+    }
+    bench_report("rand", "anj_rng_generate (token)", bench_now_ns() - start,
+                 SECURE_RNG_ITERATIONS);
+#endif // ANJ_COAP_WITH_SECURE_RNG
+    bench_sink += sink;
+}
+
+static void bench_encode(const char *name,
+                         const _anj_coap_msg_t *template_msg,
+                         bool fresh_token) {
+    uint8_t buff[256];
+    uint64_t sink = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < ENCODE_ITERATIONS; i++) {
+        _anj_coap_msg_t msg = *template_msg;
+        if (fresh_token) {
+            _anj_coap_init_coap_udp_credentials(&msg);
+        }
+        size_t out_msg_size = 0;
+        sink += (uint64_t) _anj_coap_encode_udp(&msg, buff, sizeof(buff),
+                                                &out_msg_size);
+        sink += out_msg_size + buff[out_msg_size / 2];
+    }
+    bench_report("rand", name, bench_now_ns() - start, ENCODE_ITERATIONS);
+    bench_sink += sink;
+}
+
+void bench_rand(void) {
+    _anj_coap_init(1);
+    bench_generators();
+
+    memset(payload, 0xA5, sizeof(payload));
+    _anj_coap_msg_t send;
+    memset(&send, 0, sizeof(send));
+    send.operation = ANJ_OP_INF_CON_SEND;
+    send.content_format = _ANJ_COAP_FORMAT_SENML_CBOR;
+    send.payload = payload;
+    send.payload_size = sizeof(payload);
+    bench_encode("send with fresh token", &send, true);
+
+    // Notifications reuse the observation token, message ID is a counter
+    _anj_coap_msg_t notify;
+    memset(&notify, 0, sizeof(notify));
+    notify.operation = ANJ_OP_INF_NON_CON_NOTIFY;
+    notify.token.size = 8;
+    notify.content_format = _ANJ_COAP_FORMAT_SENML_CBOR;
+    notify.payload = payload;
+    notify.payload_size = sizeof(payload);
+    bench_encode("notify", &notify, false);
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+#include <anj/utils.h>
+
+#include "bench.h"
+
+#define VALUES_COUNT 1024
+#define ITERATIONS 2000
+
+typedef struct {
+    char str[ANJ_DOUBLE_STR_MAX_LEN + 1];
+    size_t len;
+} value_str_t;
+
+static value_str_t uint_values[VALUES_COUNT];
+static value_str_t double_values[VALUES_COUNT];
+
+static uint64_t next_bits(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void prepare_values(void) {
+    uint64_t state = 0x9E3779B97F4A7C15;
+    for (size_t i = 0; i < VALUES_COUNT; i++) {
+        // timestamps, counters and identifiers of various lengths
+        uint64_t bits = next_bits(&state);
+        uint64_t value = bits >> (bits % 64);
+        uint_values[i].len = anj_uint64_to_string_value(uint_values[i].str,
+                                                        value);
+    }
+    for (size_t i = 0; i < VALUES_COUNT; i++) {
+        // mostly short sensor readings, every fourth one printed with full
+        // precision
+        uint64_t bits = next_bits(&state);
+        double value = (double) ((int64_t) (bits >> 16) % 1000000)
+                       / pow(10.0, (double) (bits % 7));
+        if (i % 4 == 3) {
+            value = (double) (bits >> 11) / (double) (UINT64_C(1) << 40);
+        }
+        double_values[i].len =
+                anj_double_to_string_value(double_values[i].str, value);
+    }
+}
+
+// Implementations used before SWAR digit parsing and Eisel-Lemire algorithm,
+// kept here as the baseline.
+static int baseline_string_to_uint64(uint64_t *out_val,
+                                     const char *buff,
+                                     size_t buff_len) {
+    uint64_t value;
+    size_t i = 0;
+
+    if (buff_len == 0 || buff_len > ANJ_U64_STR_MAX_LEN) {
+        return -1;
+    }
+    for (value = 0; i < buff_len && (buff[i] - '0' >= 0 && buff[i] - '0' <= 9);
+         i++) {
+        uint64_t prev_value = value;
+        value = 10 * value + ((uint64_t) (buff[i] - '0'));
+        if (value < prev_value) {
+            return -1;
+        }
+    }
+    if (i < buff_len) {
+        return -1;
+    }
+    *out_val = value;
+    return 0;
+}
+
+static int baseline_string_to_int64(int64_t *out_val,
+                                    const char *buff,
+                                    size_t buff_len) {
+    uint64_t value;
+    int64_t sign;
+    size_t i = 0;
+
+    if (buff_len == 0) {
+        return -1;
+    }
+    sign = (buff[i] == '-') ? -1 : 1;
+    if (buff[i] == '+' || buff[i] == '-') {
+        i++;
+    }
+    if (baseline_string_to_uint64(&value, &buff[i], buff_len - i)) {
+        return -1;
+    }
+    if (value > INT64_MAX) {
+        if (value - 1 == INT64_MAX && sign == -1) {
+            *out_val = INT64_MIN;
+            return 0;
+        }
+        return -1;
+    }
+    *out_val = sign * (int64_t) value;
+    return 0;
+}
+
+static int baseline_string_to_double(double *out_val,
+                                     const char *buff,
+                                     size_t buff_len) {
+    for (size_t i = 0; i < buff_len; i++) {
+        if (buff[i] == 'e' || buff[i] == 'E') {
+            if (buff_len > ANJ_DOUBLE_STR_MAX_LEN) {
+                return -1;
+            }
+            double mantissa;
+            if (baseline_string_to_double(&mantissa, buff, i)) {
+                return -1;
+            }
+            int64_t exponent;
+            if (baseline_string_to_int64(&exponent, &buff[i + 1],
+                                         buff_len - i - 1)) {
+                return -1;
+            }
+            if (exponent > DBL_MAX_10_EXP || exponent < DBL_MIN_10_EXP) {
+                return -1;
+            }
+            *out_val = mantissa * pow(10, (double) exponent);
+            return 0;
+        }
+    }
+
+    bool is_negative = false;
+    if (!buff_len) {
+        return -1;
+    }
+    if (buff[0] == '-') {
+        is_negative = true;
+        buff++;
+        buff_len--;
+    }
+    if (!buff_len) {
+        return -1;
+    }
+
+    bool is_fractional_part = false;
+    for (size_t i = buff_len; i > 0; i--) {
+        if (buff[i - 1] == '.') {
+            is_fractional_part = true;
+            break;
+        }
+    }
+
+    uint8_t single_value;
+    double fractional_value = 0;
+    double fractional_divider = 1.0;
+    double integer_value = 0;
+    double multiplicator = 1.0;
+    for (size_t i = buff_len; i > 0; i--) {
+        if (buff[i - 1] == '.') {
+            is_fractional_part = false;
+            multiplicator = 1;
+        } else {
+            single_value = (uint8_t) buff[i - 1] - '0';
+            if (single_value > 9) {
+                return -1;
+            }
+            if (is_fractional_part) {
+                fractional_value += single_value * multiplicator;
+                fractional_divider *= 10;
+            } else {
+                integer_value += single_value * multiplicator;
+            }
+            multiplicator = multiplicator * 10;
+        }
+    }
+
+    *out_val = integer_value;
+    if (fractional_value > 0.0) {
+        *out_val += fractional_value / fractional_divider;
+    }
+    if (is_negative) {
+        *out_val = -(*out_val);
+    }
+    return 0;
+}
+
+static uint64_t parse_uint_anj(const value_str_t *value) {
+    uint64_t result = 0;
+    anj_string_to_uint64_value(&result, value->str, value->len);
+    return result;
+}
+
+static uint64_t parse_uint_baseline(const value_str_t *value) {
+    uint64_t result = 0;
+    baseline_string_to_uint64(&result, value->str, value->len);
+    return result;
+}
+
+static uint64_t parse_uint_strtoull(const value_str_t *value) {
+    return strtoull(value->str, NULL, 10);
+}
+
+static uint64_t parse_double_anj(const value_str_t *value) {
+    double result = 0;
+    anj_string_to_double_value(&result, value->str, value->len);
+    return (uint64_t) result;
+}
+
+static uint64_t parse_double_baseline(const value_str_t *value) {
+    double result = 0;
+    baseline_string_to_double(&result, value->str, value->len);
+    return (uint64_t) result;
+}
+
+static uint64_t parse_double_strtod(const value_str_t *value) {
+    return (uint64_t) strtod(value->str, NULL);
+}
+
+static void bench_values(const char *name,
+                         const value_str_t *values,
+                         uint64_t (*parse)(const value_str_t *value)) {
+    uint64_t sink = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        for (size_t j = 0; j < VALUES_COUNT; j++) {
+            sink += parse(&values[j]);
+        }
+    }
+    bench_report("str_to_num", name, bench_now_ns() - start,
+                 (uint64_t) ITERATIONS * VALUES_COUNT);
+    bench_sink += sink;
+}
+
+static void check_double_results(void) {
+    size_t baseline_mismatches = 0;
+    for (size_t i = 0; i < VALUES_COUNT; i++) {
+        double expected = strtod(double_values[i].str, NULL);
+        double value;
+        anj_string_to_double_value(&value, double_values[i].str,
+                                   double_values[i].len);
+        if (value != expected) {
+            printf("anj_string_to_double_value() mismatch for %s\n",
+                   double_values[i].str);
+        }
+        baseline_string_to_double(&value, double_values[i].str,
+                                  double_values[i].len);
+        if (value != expected) {
+            baseline_mismatches++;
+        }
+    }
+    printf("baseline results different than strtod(): %zu/%d\n",
+           baseline_mismatches, VALUES_COUNT);
+}
+
+void bench_string_to_number(void) {
+    prepare_values();
+    bench_values("uint64: anj_string_to_uint64_value", uint_values,
+                 parse_uint_anj);
+    bench_values("uint64: char by char (baseline)", uint_values,
+                 parse_uint_baseline);
+    bench_values("uint64: strtoull", uint_values, parse_uint_strtoull);
+    bench_values("double: anj_string_to_double_value", double_values,
+                 parse_double_anj);
+    bench_values("double: char by char (baseline)", double_values,
+                 parse_double_baseline);
+    bench_values("double: strtod", double_values, parse_double_strtod);
+    check_double_results();
+}
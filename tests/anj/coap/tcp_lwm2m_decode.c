@@ -945,4 +945,25 @@ ANJ_UNIT_TEST(anj_decode_tcp, decode_payload_extended_length_4bytes) {
     ANJ_UNIT_ASSERT_EQUAL((intptr_t) out_data.payload, (intptr_t) &MSG[23]);
 }
 
+ANJ_UNIT_TEST(anj_decode_tcp, frame_size) {
+    uint8_t MSG[] = "\xE8"                             // msg_len 14, tkl 8
+                    "\x01\x02"                         // extended length 527
+                    "\x45"                             // CONTENT
+                    "\x12\x34\x56\x78\x11\x11\x11\x11" // token
+            ;
+    size_t frame_size = 0;
+
+    for (size_t i = 0; i < 3; i++) {
+        ANJ_UNIT_ASSERT_EQUAL(_anj_coap_tcp_frame_size(MSG, i, &frame_size),
+                              _ANJ_INF_COAP_TCP_INCOMPLETE_MESSAGE);
+    }
+    // the rest of the message is not needed
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_coap_tcp_frame_size(MSG, 3, &frame_size));
+    ANJ_UNIT_ASSERT_EQUAL(frame_size, 1 + 2 + 1 + 8 + 527);
+
+    // token longer than 8 bytes
+    MSG[0] = 0xE9;
+    ANJ_UNIT_ASSERT_TRUE(_anj_coap_tcp_frame_size(MSG, 3, &frame_size) < 0);
+}
+
 #pragma GCC diagnostic pop
@@ -663,3 +663,93 @@ ANJ_UNIT_TEST(anj_prepare_udp, prepare_response_with_double_block) {
     ANJ_UNIT_ASSERT_EQUAL(out_msg_size, 19);
 }
 #endif // ANJ_WITH_COMPOSITE_OPERATIONS
+
+ANJ_UNIT_TEST(anj_prepare_udp, prepare_update_with_payload) {
+    _anj_coap_msg_t data = { 0 };
+    uint8_t buff[100];
+    size_t out_msg_size;
+
+    data.operation = ANJ_OP_UPDATE;
+    data.location_path.location[0] = "rd";
+    data.location_path.location_len[0] = 2;
+    data.location_path.location[1] = "0123456789abcdef";
+    data.location_path.location_len[1] = 16;
+    data.location_path.location_count = 2;
+    data.content_format = _ANJ_COAP_FORMAT_LINK_FORMAT;
+    data.payload = (uint8_t *) "<1/1>";
+    data.payload_size = 5;
+
+    ANJ_UNIT_ASSERT_SUCCESS(
+            _anj_coap_encode_udp(&data, buff, sizeof(buff), &out_msg_size));
+
+    uint8_t EXPECTED[] =
+            "\x48"                             // Confirmable, tkl 8
+            "\x02\x00\x00"                     // POST 0x02, msg id
+            "\x00\x00\x00\x00\x00\x00\x00\x00" // token
+            "\xb2\x72\x64"                     // uri path /rd
+            "\x0d\x03"                         // uri path, extended length 16
+            "0123456789abcdef"                 //   /0123456789abcdef
+            "\x11\x28" // content_format: application/link-format
+            "\xFF"
+            "\x3c\x31\x2f\x31\x3e";
+    EXPECTED[2] = (uint8_t) (data.coap_binding_data.udp.message_id >> 8);
+    EXPECTED[3] = (uint8_t) data.coap_binding_data.udp.message_id;
+    memcpy(&EXPECTED[4], data.token.bytes, 8);
+
+    ANJ_UNIT_ASSERT_EQUAL(out_msg_size, sizeof(EXPECTED) - 1);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(buff, EXPECTED, sizeof(EXPECTED) - 1);
+
+    // every buffer shorter than the message is rejected
+    for (size_t i = _ANJ_COAP_UDP_HEADER_LENGTH + 1; i < sizeof(EXPECTED) - 1;
+         i++) {
+        ANJ_UNIT_ASSERT_EQUAL(
+                _anj_coap_encode_udp(&data, buff, i, &out_msg_size),
+                _ANJ_ERR_BUFF);
+    }
+}
+
+ANJ_UNIT_TEST(anj_prepare_udp, prepare_notify_observe_number) {
+    _anj_coap_msg_t data = { 0 };
+    uint8_t buff[100];
+    size_t out_msg_size;
+
+    data.operation = ANJ_OP_INF_NON_CON_NOTIFY;
+    data.token.size = 1;
+    data.token.bytes[0] = 0x44;
+    data.content_format = _ANJ_COAP_FORMAT_SENML_CBOR;
+    data.payload_size = 1;
+    data.payload = (uint8_t *) "\x80";
+
+    // observe 0 is encoded as an empty option
+    ANJ_UNIT_ASSERT_SUCCESS(
+            _anj_coap_encode_udp(&data, buff, sizeof(buff), &out_msg_size));
+    uint8_t EXPECTED_0[] = "\x51"         // NonConfirmable, tkl 1
+                           "\x45\x00\x00" // CONTENT 2.5, msg id
+                           "\x44"         // token
+                           "\x60"         // observe 0
+                           "\x61\x70"     // content-format 112
+                           "\xFF"
+                           "\x80";
+    ANJ_UNIT_ASSERT_EQUAL(out_msg_size, sizeof(EXPECTED_0) - 1);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&buff[4], &EXPECTED_0[4],
+                                      out_msg_size - 4);
+
+    data.observe_number = 0x123456;
+    ANJ_UNIT_ASSERT_SUCCESS(
+            _anj_coap_encode_udp(&data, buff, sizeof(buff), &out_msg_size));
+    uint8_t EXPECTED_1[] = "\x51"             // NonConfirmable, tkl 1
+                           "\x45\x00\x00"     // CONTENT 2.5, msg id
+                           "\x44"             // token
+                           "\x63\x12\x34\x56" // observe 0x123456
+                           "\x61\x70"         // content-format 112
+                           "\xFF"
+                           "\x80";
+    ANJ_UNIT_ASSERT_EQUAL(out_msg_size, sizeof(EXPECTED_1) - 1);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&buff[4], &EXPECTED_1[4],
+                                      out_msg_size - 4);
+
+    data.content_format = _ANJ_COAP_FORMAT_NOT_DEFINED;
+    ANJ_UNIT_ASSERT_EQUAL(
+            _anj_coap_encode_udp(&data, buff, sizeof(buff), &out_msg_size),
+            _ANJ_ERR_INPUT_ARG);
+}
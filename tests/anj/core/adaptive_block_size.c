@@ -0,0 +1,306 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/core.h>
+#include <anj/dm/security_object.h>
+#include <anj/dm/server_object.h>
+#include <anj/utils.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/core/server.h"
+#include "net_api_mock.h"
+#include "time_api_mock.h"
+
+#include <anj_unit_test.h>
+
+#ifdef ANJ_WITH_ADAPTIVE_BLOCK_SIZE
+
+static int res_execute(anj_t *anj,
+                       const anj_dm_obj_t *obj,
+                       anj_iid_t iid,
+                       anj_rid_t rid,
+                       const char *execute_arg,
+                       size_t execute_arg_len) {
+    (void) anj;
+    (void) obj;
+    (void) iid;
+    (void) rid;
+    (void) execute_arg;
+    (void) execute_arg_len;
+    return 0;
+}
+
+// long enough to not fit in a single message with inner MTU of 110 bytes
+static char long_string[] =
+        "0123456789012345678901234567890123456789012345678901234567890123"
+        "0123456789012345678901234567890123456789012345678901234567890123";
+
+static int res_read(anj_t *anj,
+                    const anj_dm_obj_t *obj,
+                    anj_iid_t iid,
+                    anj_rid_t rid,
+                    anj_riid_t riid,
+                    anj_res_value_t *out_value) {
+    (void) anj;
+    (void) obj;
+    (void) iid;
+    (void) rid;
+    (void) riid;
+    out_value->bytes_or_string.data = long_string;
+    return 0;
+}
+
+static anj_dm_handlers_t handlers = {
+    .res_execute = res_execute,
+    .res_read = res_read
+};
+
+static anj_dm_res_t res[] = {
+    {
+        .rid = 0,
+        .operation = ANJ_DM_RES_E
+    },
+    {
+        .rid = 1,
+        .type = ANJ_DATA_TYPE_STRING,
+        .operation = ANJ_DM_RES_R
+    }
+};
+
+static anj_dm_obj_inst_t obj_insts[] = {
+    {
+        .iid = 0,
+        .res_count = 2,
+        .resources = res
+    }
+};
+
+static anj_dm_obj_t obj = {
+    .oid = 10,
+    .insts = obj_insts,
+    .handlers = &handlers,
+    .max_inst_count = 1
+};
+
+// lifetime is long enough to not trigger Update during the tests
+#    define TEST_INIT()                                                 \
+        set_mock_time(0);                                               \
+        net_api_mock_t mock = { 0 };                                    \
+        net_api_mock_ctx_init(&mock);                                   \
+        mock.bytes_to_send = 500;                                       \
+        mock.inner_mtu_value = 1000;                                    \
+        anj_t anj;                                                      \
+        anj_configuration_t config = {                                  \
+            .endpoint_name = "name"                                     \
+        };                                                              \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_core_init(&anj, &config));          \
+        anj_dm_security_obj_t sec_obj;                                  \
+        anj_dm_security_obj_init(&sec_obj);                             \
+        anj_dm_server_obj_t ser_obj;                                    \
+        anj_dm_server_obj_init(&ser_obj);                               \
+        const anj_iid_t iid = 1;                                        \
+        anj_dm_security_instance_init_t sec_inst = {                    \
+            .server_uri = "coap://server.com:5683",                     \
+            .ssid = 2,                                                  \
+            .iid = &iid                                                 \
+        };                                                              \
+        anj_dm_server_instance_init_t ser_inst = {                      \
+            .ssid = 2,                                                  \
+            .lifetime = 10000,                                          \
+            .binding = "U",                                             \
+            .iid = &iid                                                 \
+        };                                                              \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_security_obj_add_instance(&sec_obj, &sec_inst)); \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_security_obj_install(&anj, &sec_obj));           \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_server_obj_add_instance(&ser_obj, &ser_inst));   \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_server_obj_install(&anj, &ser_obj));             \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_add_obj(&anj, &obj))
+
+// token and message id are copied from request stored in anj.exchange_ctx
+#    define ADD_RESPONSE(Response)                                        \
+        memcpy(&Response[4], anj.exchange_ctx.base_msg.token.bytes, 8);   \
+        Response[2] = (char) (anj.exchange_ctx.base_msg.coap_binding_data \
+                                      .udp.message_id                     \
+                              >> 8);                                      \
+        Response[3] = (char) (anj.exchange_ctx.base_msg.coap_binding_data \
+                                      .udp.message_id                     \
+                              & 0xFF);                                    \
+        mock.bytes_to_recv = sizeof(Response) - 1;                        \
+        mock.data_to_recv = (uint8_t *) Response
+
+#    define ADD_REQUEST(Request)                  \
+        mock.bytes_to_recv = sizeof(Request) - 1; \
+        mock.data_to_recv = (uint8_t *) Request
+
+static char execute_request[] = "\x42"         // header v 0x01, Confirmable
+                                "\x02\x11\x55" // POST code 0.2
+                                "\x12\x77"     // token
+                                "\xB2\x31\x30" // URI_PATH 11 /10
+                                "\x01\x30"     //            /0
+                                "\x01\x30";    //            /0
+
+static size_t max_payload_size(anj_t *anj) {
+    _anj_coap_msg_t msg = { 0 };
+    size_t payload_size;
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_server_calculate_max_payload_size(
+            &anj->connection_ctx, &msg, ANJ_OUT_PAYLOAD_BUFFER_SIZE,
+            ANJ_OUT_MSG_BUFFER_SIZE, true, &payload_size));
+    return payload_size;
+}
+
+// with inner MTU of 110 bytes Register payload is sent in two 32-byte blocks
+static char register_continue_response[] =
+        "\x68"                             // header v 0x01, Ack, tkl 8
+        "\x5F\x00\x00"                     // CONTINUE code 2.31
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" // token
+        "\xD1\x0E\x09";                    // block1 0, size 32, more
+
+static char register_last_block_response[] =
+        "\x68"                             // header v 0x01, Ack, tkl 8
+        "\x41\x00\x00"                     // CREATED code 2.1
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" // token
+        "\x82\x72\x64"                     // location-path /rd
+        "\x04\x35\x61\x33\x66"             // location-path 8 /5a3f
+        "\xD1\x06\x11";                    // block1 1, size 32
+
+#    define REGISTER_WITH_BLOCK1()                                         \
+        ADD_RESPONSE(register_continue_response);                          \
+        anj_core_step(&anj);                                               \
+        ADD_RESPONSE(register_last_block_response);                        \
+        anj_core_step(&anj);                                               \
+        ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,                \
+                              ANJ_CONN_STATUS_REGISTERED);                 \
+        anj_core_step(&anj)
+
+ANJ_UNIT_TEST(adaptive_block_size, lowered_after_loss_and_raised_back) {
+    TEST_INIT();
+    mock.inner_mtu_value = 110;
+
+    anj_core_step(&anj);
+    size_t first_block_size = mock.bytes_sent;
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_GET_INNER_MTU], 1);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 1024);
+    ANJ_UNIT_ASSERT_EQUAL(anj.exchange_ctx.base_msg.block.block_type,
+                          ANJ_OPTION_BLOCK_1);
+    ANJ_UNIT_ASSERT_EQUAL(anj.exchange_ctx.base_msg.payload_size, 32);
+
+    // first block is lost, e.g. because of ICMP Fragmentation Needed
+    mock.inner_mtu_value = 100;
+    mock.bytes_sent = 0;
+    set_mock_time(10);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, first_block_size);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_GET_INNER_MTU], 2);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.mtu, 100);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 16);
+
+    // retransmission is lost as well, limit is lowered once per message
+    set_mock_time(30);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_GET_INNER_MTU], 3);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 16);
+
+    // size of the ongoing transfer is not changed
+    REGISTER_WITH_BLOCK1();
+    // new exchanges use the lowered limit
+    ANJ_UNIT_ASSERT_EQUAL(max_payload_size(&anj), 16);
+
+    // after a series of exchanges without losses the limit is raised again
+    for (int i = 0; i < 8; i++) {
+        ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 16);
+        execute_request[3] = (char) i;
+        ADD_REQUEST(execute_request);
+        anj_core_step(&anj);
+    }
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 32);
+    ANJ_UNIT_ASSERT_EQUAL(max_payload_size(&anj), 32);
+}
+
+ANJ_UNIT_TEST(adaptive_block_size, not_lowered_after_loss_of_small_message) {
+    TEST_INIT();
+
+    anj_core_step(&anj);
+    size_t register_size = mock.bytes_sent;
+    ANJ_UNIT_ASSERT_EQUAL(anj.exchange_ctx.base_msg.block.block_type,
+                          ANJ_OPTION_BLOCK_NOT_DEFINED);
+
+    // Register request is lost, but it is not larger than the limit
+    mock.inner_mtu_value = 600;
+    mock.bytes_sent = 0;
+    set_mock_time(10);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, register_size);
+    // path MTU is checked after every loss
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_GET_INNER_MTU], 2);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.mtu, 600);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 1024);
+    ANJ_UNIT_ASSERT_FALSE(anj.connection_ctx.loss_in_exchange);
+}
+
+static char read_request[] = "\x42"         // header v 0x01, Confirmable
+                             "\x01\x21\x55" // GET code 0.1
+                             "\x12\x78"     // token
+                             "\xB2\x31\x30" // URI_PATH 11 /10
+                             "\x01\x30"     //            /0
+                             "\x01\x31";    //            /1
+
+ANJ_UNIT_TEST(adaptive_block_size, not_lowered_by_server_exchange_timeout) {
+    TEST_INIT();
+    mock.inner_mtu_value = 110;
+    anj_core_step(&anj);
+    REGISTER_WITH_BLOCK1();
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 1024);
+
+    // the Server reads the first block of the response and stops
+    ADD_REQUEST(read_request);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.exchange_ctx.base_msg.block.block_type,
+                          ANJ_OPTION_BLOCK_2);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_get_state(&anj.exchange_ctx),
+                          ANJ_EXCHANGE_STATE_WAITING_MSG);
+    size_t mtu_calls = mock.call_count[ANJ_NET_FUN_GET_INNER_MTU];
+
+    set_mock_time(100);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_get_state(&anj.exchange_ctx),
+                          ANJ_EXCHANGE_STATE_FINISHED);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_GET_INNER_MTU],
+                          mtu_calls);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 1024);
+    ANJ_UNIT_ASSERT_FALSE(anj.connection_ctx.loss_in_exchange);
+}
+
+ANJ_UNIT_TEST(adaptive_block_size, reset_on_new_connection) {
+    TEST_INIT();
+
+    mock.inner_mtu_value = 110;
+    anj_core_step(&anj);
+    set_mock_time(10);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 16);
+
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_server_close(&anj.connection_ctx, false));
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_server_connect(&anj.connection_ctx,
+                                                ANJ_NET_BINDING_UDP, NULL,
+                                                "server.com", "5683", true));
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.block_size_limit, 1024);
+}
+
+#endif // ANJ_WITH_ADAPTIVE_BLOCK_SIZE
@@ -0,0 +1,441 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/core.h>
+#include <anj/dm/security_object.h>
+#include <anj/dm/server_object.h>
+#include <anj/lwm2m_send.h>
+#include <anj/utils.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/core/server.h"
+#include "../../../src/anj/exchange.h"
+#include "net_api_mock.h"
+#include "time_api_mock.h"
+
+#include <anj_unit_test.h>
+
+#ifdef ANJ_COAP_WITH_TCP
+
+// lifetime is long enough to not trigger Update during the tests
+#    define TEST_INIT()                                                   \
+        set_mock_time(0);                                                 \
+        net_api_mock_t mock = { 0 };                                      \
+        net_api_mock_ctx_init(&mock);                                     \
+        mock.bytes_to_send = 500;                                         \
+        mock.inner_mtu_value = 1000;                                      \
+        anj_t anj;                                                        \
+        anj_configuration_t config = {                                    \
+            .endpoint_name = "name"                                       \
+        };                                                                \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_core_init(&anj, &config));            \
+        anj_dm_security_obj_t sec_obj;                                    \
+        anj_dm_security_obj_init(&sec_obj);                               \
+        anj_dm_server_obj_t ser_obj;                                      \
+        anj_dm_server_obj_init(&ser_obj);                                 \
+        const anj_iid_t iid = 1;                                          \
+        anj_dm_security_instance_init_t sec_inst = {                      \
+            .server_uri = "coap+tcp://server.com:5683",                   \
+            .ssid = 2,                                                    \
+            .iid = &iid                                                   \
+        };                                                                \
+        anj_dm_server_instance_init_t ser_inst = {                        \
+            .ssid = 2,                                                    \
+            .lifetime = 10000,                                            \
+            .binding = "T",                                               \
+            .iid = &iid                                                   \
+        };                                                                \
+        ANJ_UNIT_ASSERT_SUCCESS(                                          \
+                anj_dm_security_obj_add_instance(&sec_obj, &sec_inst));   \
+        ANJ_UNIT_ASSERT_SUCCESS(                                          \
+                anj_dm_security_obj_install(&anj, &sec_obj));             \
+        ANJ_UNIT_ASSERT_SUCCESS(                                          \
+                anj_dm_server_obj_add_instance(&ser_obj, &ser_inst));     \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_server_obj_install(&anj, &ser_obj))
+
+// CoAP over TCP header: Len 8 (options), TKL 8
+static char register_response[] =
+        "\x88"                             // Len 8, TKL 8
+        "\x41"                             // CREATED code 2.1
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" // token
+        "\x82\x72\x64"                     // location-path /rd
+        "\x04\x35\x61\x33\x66";            // location-path 8 /5a3f
+
+static char send_response[] = "\x08"                              // TKL 8
+                              "\x44"                              // Changed
+                              "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"; // token
+
+#    define ADD_RESPONSE(Response, Token)          \
+        memcpy(&Response[2], (Token)->bytes, 8);   \
+        mock.bytes_to_recv = sizeof(Response) - 1; \
+        mock.data_to_recv = (uint8_t *) Response
+
+#    define ADD_REQUEST(Request)                  \
+        mock.bytes_to_recv = sizeof(Request) - 1; \
+        mock.data_to_recv = (uint8_t *) Request
+
+#    define CHECK_SENT(Msg)                                           \
+        ANJ_UNIT_ASSERT_EQUAL(sizeof(Msg) - 1, mock.bytes_sent);      \
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, Msg, \
+                                          mock.bytes_sent);           \
+        mock.bytes_sent = 0
+
+#    define PROCESS_REGISTRATION()                                          \
+        anj_core_step(&anj);                                                \
+        ADD_RESPONSE(register_response, &anj.exchange_ctx.base_msg.token); \
+        anj_core_step(&anj);                                                \
+        ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,                 \
+                              ANJ_CONN_STATUS_REGISTERED);                  \
+        anj_core_step(&anj);                                                \
+        mock.bytes_sent = 0
+
+ANJ_UNIT_TEST(coap_tcp, csm_sent_before_register) {
+    TEST_INIT();
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_TRUE(mock.bytes_sent > 14);
+    // CSM with Max-Message-Size and Block-Wise-Transfer options
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[0], 0x48);
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[1], 0xE1);
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[10], 0x22);
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[11],
+                          (uint8_t) (ANJ_IN_MSG_BUFFER_SIZE >> 8));
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[12],
+                          (uint8_t) (ANJ_IN_MSG_BUFFER_SIZE & 0xFF));
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[13], 0x20);
+    // Register request follows in the same stream, its length is encoded in
+    // one extended length byte
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[14], 0xD8);
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[16], ANJ_COAP_CODE_POST);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&mock.send_data_buffer[17],
+                                      anj.exchange_ctx.base_msg.token.bytes,
+                                      8);
+
+    ADD_RESPONSE(register_response, &anj.exchange_ctx.base_msg.token);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_REGISTERED);
+}
+
+static char server_csm[] = "\x20"      // Len 2, TKL 0
+                           "\xE1"      // CSM
+                           "\x21\x80"; // Max-Message-Size 128
+
+ANJ_UNIT_TEST(coap_tcp, server_max_message_size) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    ADD_REQUEST(server_csm);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.connection_ctx.peer_max_msg_size, 128);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0);
+
+    _anj_coap_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.operation = ANJ_OP_INF_CON_SEND;
+    size_t payload_size;
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_server_calculate_max_payload_size(
+            &anj.connection_ctx, &msg, ANJ_OUT_PAYLOAD_BUFFER_SIZE,
+            ANJ_OUT_MSG_BUFFER_SIZE, false, &payload_size));
+    ANJ_UNIT_ASSERT_TRUE(payload_size < 128);
+}
+
+static char ping[] = "\x11"  // Len 1, TKL 1
+                     "\xE2"  // Ping
+                     "\xAB"  // token
+                     "\x20"; // Custody
+static char pong[] = "\x11"  // Len 1, TKL 1
+                     "\xE3"  // Pong
+                     "\xAB"  // token
+                     "\x20"; // Custody
+
+static char empty_msg[] = "\x00"  // Len 0, TKL 0
+                          "\x00"; // Empty
+
+ANJ_UNIT_TEST(coap_tcp, ping_and_empty_msg) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    ADD_REQUEST(ping);
+    anj_core_step(&anj);
+    CHECK_SENT(pong);
+    ANJ_UNIT_ASSERT_FALSE(anj_core_ongoing_operation(&anj));
+
+    ADD_REQUEST(empty_msg);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0);
+    ANJ_UNIT_ASSERT_FALSE(anj_core_ongoing_operation(&anj));
+}
+
+ANJ_UNIT_TEST(coap_tcp, peer_close) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    // connection is closed and opened again instead of polling the closed
+    // socket forever
+    mock.peer_closed = true;
+    int close_calls = mock.call_count[ANJ_NET_FUN_CLOSE];
+    int connect_calls = mock.call_count[ANJ_NET_FUN_CONNECT];
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_TRUE(mock.call_count[ANJ_NET_FUN_CLOSE] > close_calls);
+    ANJ_UNIT_ASSERT_TRUE(mock.call_count[ANJ_NET_FUN_CONNECT]
+                         > connect_calls);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_REGISTERING);
+}
+
+ANJ_UNIT_TEST(coap_tcp, message_split_across_reads) {
+    TEST_INIT();
+    mock.recv_chunk_size = 3;
+    PROCESS_REGISTRATION();
+
+    // header of the Ping is received in one read, the rest in the next step
+    mock.recv_chunk_size = 1;
+    ADD_REQUEST(ping);
+    mock.bytes_to_recv = 1;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0);
+    mock.bytes_to_recv = sizeof(ping) - 2;
+    anj_core_step(&anj);
+    CHECK_SENT(pong);
+}
+
+ANJ_UNIT_TEST(coap_tcp, several_messages_in_one_read) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    char stream[3 * sizeof(ping)];
+    memcpy(stream, ping, sizeof(ping) - 1);
+    memcpy(&stream[sizeof(ping) - 1], empty_msg, sizeof(empty_msg) - 1);
+    memcpy(&stream[sizeof(ping) + sizeof(empty_msg) - 2], ping,
+           sizeof(ping) - 1);
+    mock.bytes_to_recv = 2 * (sizeof(ping) - 1) + sizeof(empty_msg) - 1;
+    mock.data_to_recv = (uint8_t *) stream;
+    mock.call_count[ANJ_NET_FUN_RECV] = 0;
+    anj_core_step(&anj);
+    // the second call returns ANJ_NET_EAGAIN
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_RECV], 2);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 2 * (sizeof(pong) - 1));
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, pong,
+                                      sizeof(pong) - 1);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&mock.send_data_buffer[sizeof(pong) - 1],
+                                      pong, sizeof(pong) - 1);
+}
+
+ANJ_UNIT_TEST(coap_tcp, partial_message_at_end_of_buffer) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    // Empty message shifts the Pings, so that the first read ends in the
+    // middle of one of them and it has to be moved to the buffer beginning
+    static uint8_t stream[ANJ_IN_MSG_BUFFER_SIZE + sizeof(ping)];
+    memcpy(stream, empty_msg, sizeof(empty_msg) - 1);
+    size_t pings = (sizeof(stream) - sizeof(empty_msg)) / (sizeof(ping) - 1);
+    for (size_t i = 0; i < pings; i++) {
+        memcpy(&stream[sizeof(empty_msg) - 1 + i * (sizeof(ping) - 1)], ping,
+               sizeof(ping) - 1);
+    }
+    mock.bytes_to_recv = sizeof(empty_msg) - 1 + pings * (sizeof(ping) - 1);
+    mock.data_to_recv = stream;
+    mock.bytes_to_send = 1500;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_to_recv, 0);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, pings * (sizeof(pong) - 1));
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(
+            &mock.send_data_buffer[(pings - 1) * (sizeof(pong) - 1)], pong,
+            sizeof(pong) - 1);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_REGISTERED);
+}
+
+ANJ_UNIT_TEST(coap_tcp, message_too_long_dropped) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    // 2 bytes of Extended Length, options and payload of the Ping are
+    // followed by padding that makes it longer than the receive buffer
+    static uint8_t stream[ANJ_IN_MSG_BUFFER_SIZE + 64];
+    size_t long_msg_size = ANJ_IN_MSG_BUFFER_SIZE + 32;
+    size_t ext_len = long_msg_size - 4 - 269;
+    stream[0] = 0xE0;
+    stream[1] = (uint8_t) (ext_len >> 8);
+    stream[2] = (uint8_t) ext_len;
+    stream[3] = 0xE2;
+    memcpy(&stream[long_msg_size], ping, sizeof(ping) - 1);
+    mock.bytes_to_recv = long_msg_size + sizeof(ping) - 1;
+    mock.data_to_recv = stream;
+    mock.recv_chunk_size = 500;
+    anj_core_step(&anj);
+    CHECK_SENT(pong);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_REGISTERED);
+}
+
+ANJ_UNIT_TEST(coap_tcp, pong_sent_after_message_in_progress) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    // Pong received while sending the previous message is sent after it
+    anj.connection_ctx.send_in_progress = true;
+    _anj_coap_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.operation = ANJ_OP_COAP_PING;
+    msg.token.size = 1;
+    msg.token.bytes[0] = (char) 0xAB;
+    msg.signalling_opts.ping_pong.custody = true;
+    ANJ_UNIT_ASSERT_TRUE(_anj_server_handle_signalling_msg(&anj, &msg));
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0);
+    anj.connection_ctx.send_in_progress = false;
+
+    anj_core_step(&anj);
+    CHECK_SENT(pong);
+}
+
+static char observe_request[] = "\x72"      // Len 7, TKL 2
+                                "\x01"      // GET code 0.1
+                                "\x56\x78"  // token
+                                "\x60"      // observe 6 = 0
+                                "\x51\x31"  // uri-path_1 URI_PATH 11 /1
+                                "\x01\x31"  // uri-path_2 /1
+                                "\x01\x35"; // uri-path_3 /5
+
+static char observe_response[] =
+        "\xD2\x04"     // Len 13 + 4, TKL 2
+        "\x45"         // CONTENT 2.5
+        "\x56\x78"     // token
+        "\x60"         // observe 6 = 0
+        "\x62\x2D\x18" // content-format 11544 lwm2mcobr
+        "\xFF"
+        "\xBF\x01\xBF\x01\xBF\x05\x19\x03\x20\xFF\xFF\xFF"; // 800
+
+static char notification[] =
+        "\xD2\x04"     // Len 13 + 4, TKL 2
+        "\x45"         // CONTENT 2.5
+        "\x56\x78"     // token
+        "\x61\x01"     // observe 0x01
+        "\x62\x2D\x18" // content-format 11544 lwm2mcobr
+        "\xFF"
+        "\xBF\x01\xBF\x01\xBF\x05\x18\xC8\xFF\xFF\xFF"; // 200
+
+ANJ_UNIT_TEST(coap_tcp, notifications_not_acknowledged) {
+    TEST_INIT();
+    ser_obj.server_instance.disable_timeout = 800;
+    PROCESS_REGISTRATION();
+
+    ADD_REQUEST(observe_request);
+    anj_core_step(&anj);
+    CHECK_SENT(observe_response);
+
+    // every notification finishes right after it is sent, the next one is not
+    // held back by the previous one
+    ser_obj.server_instance.disable_timeout = 200;
+    for (uint8_t i = 1; i <= 3; i++) {
+        anj_core_data_model_changed(&anj,
+                                    &ANJ_MAKE_RESOURCE_PATH(1, 1, 5),
+                                    ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED);
+        anj_core_step(&anj);
+        notification[6] = (char) i;
+        CHECK_SENT(notification);
+        ANJ_UNIT_ASSERT_FALSE(anj_core_ongoing_operation(&anj));
+    }
+    notification[6] = 1;
+}
+
+static uint16_t g_send_ids[4];
+static int g_results[4];
+static size_t g_finished_count;
+
+static void
+send_finished_handler(anj_t *anjay, uint16_t send_id, int result, void *data) {
+    (void) anjay;
+    (void) data;
+    g_send_ids[g_finished_count] = send_id;
+    g_results[g_finished_count] = result;
+    g_finished_count++;
+}
+
+static anj_io_out_entry_t record = {
+    .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 9),
+    .type = ANJ_DATA_TYPE_INT,
+    .value.int_value = 42
+};
+
+static anj_send_request_t send_req = {
+    .finished_handler = send_finished_handler,
+    .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+    .records_cnt = 1,
+    .records = &record
+};
+
+static void reset_results(void) {
+    g_finished_count = 0;
+    memset(g_send_ids, 0, sizeof(g_send_ids));
+    memset(g_results, 0, sizeof(g_results));
+}
+
+ANJ_UNIT_TEST(coap_tcp, pipelined_sends) {
+    reset_results();
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    uint16_t send_id_1;
+    uint16_t send_id_2;
+    uint16_t send_id_3;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_1));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_2));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_3));
+
+    // all requests are written to the stream without waiting for responses
+    int send_calls = mock.call_count[ANJ_NET_FUN_SEND];
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND], send_calls + 3);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_TRUE(_anj_exchange_ongoing_exchange(&anj.exchange_ctx));
+    mock.bytes_sent = 0;
+
+    // Ping is answered while the requests are pending
+    ADD_REQUEST(ping);
+    anj_core_step(&anj);
+    CHECK_SENT(pong);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 0);
+
+    // no retransmissions over TCP
+    set_mock_time(60);
+    send_calls = mock.call_count[ANJ_NET_FUN_SEND];
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND], send_calls);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 0);
+
+    ADD_RESPONSE(send_response, &anj.exchange_ctx.base_msg.token);
+    anj_core_step(&anj);
+    ADD_RESPONSE(send_response, &anj.in_flight[0].exchange.token);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 2);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[0], send_id_3);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[0], ANJ_SEND_SUCCESS);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[1], send_id_1);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[1], ANJ_SEND_SUCCESS);
+
+    // MAX_TRANSMIT_WAIT for default transmission parameters is 93 s
+    set_mock_time(94);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 3);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[2], send_id_2);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[2], ANJ_SEND_ERR_TIMEOUT);
+    ANJ_UNIT_ASSERT_FALSE(anj_core_ongoing_operation(&anj));
+}
+
+#endif // ANJ_COAP_WITH_TCP
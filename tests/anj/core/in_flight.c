@@ -0,0 +1,514 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/core.h>
+#include <anj/dm/security_object.h>
+#include <anj/dm/server_object.h>
+#include <anj/lwm2m_send.h>
+#include <anj/utils.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/exchange.h"
+#include "../../../src/anj/utils.h"
+#include "net_api_mock.h"
+#include "time_api_mock.h"
+
+#include <anj_unit_test.h>
+
+#if defined(_ANJ_WITH_IN_FLIGHT_REQUESTS) && defined(ANJ_WITH_LWM2M_SEND)
+
+#    define TEST_INIT()                                                   \
+        set_mock_time(0);                                                 \
+        net_api_mock_t mock = { 0 };                                      \
+        net_api_mock_ctx_init(&mock);                                     \
+        mock.inner_mtu_value = 1000;                                      \
+        anj_t anj;                                                        \
+        anj_configuration_t config = {                                    \
+            .endpoint_name = "name"                                       \
+        };                                                                \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_core_init(&anj, &config));            \
+        anj_dm_security_obj_t sec_obj;                                    \
+        anj_dm_security_obj_init(&sec_obj);                               \
+        anj_dm_server_obj_t ser_obj;                                      \
+        anj_dm_server_obj_init(&ser_obj);                                 \
+        const anj_iid_t iid = 1;                                          \
+        anj_dm_security_instance_init_t sec_inst = {                      \
+            .server_uri = "coap://server.com:5683",                       \
+            .ssid = 2,                                                    \
+            .iid = &iid                                                   \
+        };                                                                \
+        anj_dm_server_instance_init_t ser_inst = {                        \
+            .ssid = 2,                                                    \
+            .lifetime = 150,                                              \
+            .binding = "U",                                               \
+            .iid = &iid                                                   \
+        };                                                                \
+        ANJ_UNIT_ASSERT_SUCCESS(                                          \
+                anj_dm_security_obj_add_instance(&sec_obj, &sec_inst));   \
+        ANJ_UNIT_ASSERT_SUCCESS(                                          \
+                anj_dm_security_obj_install(&anj, &sec_obj));             \
+        ANJ_UNIT_ASSERT_SUCCESS(                                          \
+                anj_dm_server_obj_add_instance(&ser_obj, &ser_inst));     \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_server_obj_install(&anj, &ser_obj))
+
+#    define ADD_RESPONSE(Response, Token, Msg_id)        \
+        memcpy(&Response[4], (Token)->bytes, 8);         \
+        Response[2] = (char) ((Msg_id) >> 8);            \
+        Response[3] = (char) ((Msg_id) &0xFF);           \
+        mock.bytes_to_recv = sizeof(Response) - 1;       \
+        mock.data_to_recv = (uint8_t *) Response
+
+static char register_response[] =
+        "\x68"                             // header v 0x01, Ack, tkl 8
+        "\x41\x00\x00"                     // CREATED code 2.1
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" // token
+        "\x82\x72\x64"                     // location-path /rd
+        "\x04\x35\x61\x33\x66";            // location-path 8 /5a3f
+
+#    define PROCESS_REGISTRATION()                                         \
+        mock.bytes_to_send = 500;                                          \
+        anj_core_step(&anj);                                               \
+        ADD_RESPONSE(register_response, &anj.exchange_ctx.base_msg.token,  \
+                     anj.exchange_ctx.base_msg.coap_binding_data.udp       \
+                             .message_id);                                 \
+        anj_core_step(&anj);                                               \
+        ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,                \
+                              ANJ_CONN_STATUS_REGISTERED);                 \
+        anj_core_step(&anj);                                               \
+        mock.bytes_sent = 0
+
+static char send_response[] = "\x68"         // header v 0x01, Ack, tkl 8
+                              "\x44\x00\x00" // Changed code 2.04
+                              "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"; // token
+
+static char send_separate_response[] =
+        "\x48"                             // header v 0x01, Confirmable, tkl 8
+        "\x44\x00\x00"                     // Changed code 2.04
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"; // token
+
+static char empty_ack[] = "\x60"      // header v 0x01, Ack, tkl 0
+                          "\x00\x00\x00"; // empty msg
+
+static uint16_t g_send_ids[4];
+static int g_results[4];
+static size_t g_finished_count;
+
+static void
+send_finished_handler(anj_t *anjay, uint16_t send_id, int result, void *data) {
+    (void) anjay;
+    (void) data;
+    g_send_ids[g_finished_count] = send_id;
+    g_results[g_finished_count] = result;
+    g_finished_count++;
+}
+
+static anj_io_out_entry_t record = {
+    .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 9),
+    .type = ANJ_DATA_TYPE_INT,
+    .value.int_value = 42
+};
+
+static anj_send_request_t send_req = {
+    .finished_handler = send_finished_handler,
+    .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+    .records_cnt = 1,
+    .records = &record
+};
+
+static void reset_results(void) {
+    g_finished_count = 0;
+    memset(g_send_ids, 0, sizeof(g_send_ids));
+    memset(g_results, 0, sizeof(g_results));
+}
+
+ANJ_UNIT_TEST(in_flight, sends_not_serialized) {
+    reset_results();
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    uint16_t send_id_1;
+    uint16_t send_id_2;
+    uint16_t send_id_3;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_1));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_2));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_3));
+
+    // two requests are moved to the in-flight slots, the third one waits in
+    // the main exchange context
+    int send_calls = mock.call_count[ANJ_NET_FUN_SEND];
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND], send_calls + 3);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].send_ids[0], send_id_1);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].send_ids[0], send_id_2);
+    ANJ_UNIT_ASSERT_TRUE(_anj_exchange_ongoing_exchange(&anj.exchange_ctx));
+    ANJ_UNIT_ASSERT_EQUAL(anj.send_ctx.ids[0], send_id_3);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 0);
+
+    // responses can come in any order, response for the second request is
+    // handled while main exchange waits for its own
+    ADD_RESPONSE(send_response, &anj.in_flight[1].exchange.token,
+                 anj.in_flight[1].exchange.message_id);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[0], send_id_2);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[0], ANJ_SEND_SUCCESS);
+    // slot is reused by the third request
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].send_ids[0], send_id_3);
+    ANJ_UNIT_ASSERT_FALSE(_anj_exchange_ongoing_exchange(&anj.exchange_ctx));
+
+    ADD_RESPONSE(send_response, &anj.in_flight[0].exchange.token,
+                 anj.in_flight[0].exchange.message_id);
+    anj_core_step(&anj);
+    ADD_RESPONSE(send_response, &anj.in_flight[1].exchange.token,
+                 anj.in_flight[1].exchange.message_id);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 3);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[1], send_id_1);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[1], ANJ_SEND_SUCCESS);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[2], send_id_3);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[2], ANJ_SEND_SUCCESS);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_NONE);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_NONE);
+}
+
+ANJ_UNIT_TEST(in_flight, separate_response) {
+    reset_results();
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    uint16_t send_id;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+
+    empty_ack[2] = (char) (anj.in_flight[0].exchange.message_id >> 8);
+    empty_ack[3] = (char) (anj.in_flight[0].exchange.message_id & 0xFF);
+    mock.bytes_to_recv = sizeof(empty_ack) - 1;
+    mock.data_to_recv = (uint8_t *) empty_ack;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_TRUE(anj.in_flight[0].exchange.separate_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 0);
+
+    // no retransmissions after empty ACK
+    int send_calls = mock.call_count[ANJ_NET_FUN_SEND];
+    set_mock_time(10);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND], send_calls);
+
+    uint16_t response_msg_id = 0x2137;
+    ADD_RESPONSE(send_separate_response, &anj.in_flight[0].exchange.token,
+                 response_msg_id);
+    mock.bytes_sent = 0;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[0], send_id);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[0], ANJ_SEND_SUCCESS);
+    // confirmable response is acknowledged
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 4);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, "\x60\x00\x21\x37",
+                                      4);
+}
+
+ANJ_UNIT_TEST(in_flight, retransmissions_and_timeout) {
+    reset_results();
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    uint16_t send_id;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+    uint8_t request[100];
+    size_t request_len = mock.bytes_sent;
+    memcpy(request, mock.send_data_buffer, request_len);
+
+    int send_calls = mock.call_count[ANJ_NET_FUN_SEND];
+    _anj_exchange_udp_tx_params_t tx_params =
+            _ANJ_EXCHANGE_UDP_TX_PARAMS_DEFAULT;
+    uint64_t actual_time = 0;
+    while (!g_finished_count && actual_time < 200) {
+        mock.bytes_sent = 0;
+        set_mock_time_advance(&actual_time, 1);
+        anj_core_step(&anj);
+        if (mock.bytes_sent) {
+            // the same message, with the same message ID, is sent again
+            ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, request_len);
+            ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, request,
+                                              request_len);
+        }
+    }
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND],
+                          send_calls + tx_params.max_retransmit);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[0], send_id);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[0], ANJ_SEND_ERR_TIMEOUT);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_NONE);
+}
+
+static char ping[] = "\x40"          // header v 0x01, Confirmable, tkl 0
+                     "\x00\x11\x11"; // empty msg
+
+ANJ_UNIT_TEST(in_flight, server_request_and_abort) {
+    reset_results();
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    uint16_t send_id;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+
+    // server request is handled while the client request is outstanding
+    mock.bytes_sent = 0;
+    mock.bytes_to_recv = sizeof(ping) - 1;
+    mock.data_to_recv = (uint8_t *) ping;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 4);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, "\x70\x00\x11\x11",
+                                      4);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 0);
+
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_abort(&anj, send_id));
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[0], send_id);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[0], ANJ_SEND_ERR_ABORT);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_NONE);
+
+    // late response is ignored
+    ADD_RESPONSE(send_response, &anj.in_flight[0].exchange.token,
+                 anj.in_flight[0].exchange.message_id);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 1);
+}
+
+#    ifdef ANJ_NET_WITH_BATCHED_IO
+ANJ_UNIT_TEST(in_flight, batched_responses) {
+    reset_results();
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    uint16_t send_id_1;
+    uint16_t send_id_2;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_1));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, &send_id_2));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_INF_CON_SEND);
+
+    // both responses are received with a single call and handled in the same
+    // step
+    char second_response[sizeof(send_response)];
+    memcpy(second_response, send_response, sizeof(send_response));
+    ADD_RESPONSE(second_response, &anj.in_flight[1].exchange.token,
+                 anj.in_flight[1].exchange.message_id);
+    mock.extra_bytes_to_recv = mock.bytes_to_recv;
+    mock.extra_data_to_recv = mock.data_to_recv;
+    ADD_RESPONSE(send_response, &anj.in_flight[0].exchange.token,
+                 anj.in_flight[0].exchange.message_id);
+    int recv_calls = mock.call_count[ANJ_NET_FUN_RECV_BATCH];
+    anj_core_step(&anj);
+    // the second call returns ANJ_NET_EAGAIN
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_RECV_BATCH],
+                          recv_calls + 2);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 2);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[0], send_id_1);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[0], ANJ_SEND_SUCCESS);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_ids[1], send_id_2);
+    ANJ_UNIT_ASSERT_EQUAL(g_results[1], ANJ_SEND_SUCCESS);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_NONE);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_NONE);
+}
+
+ANJ_UNIT_TEST(in_flight, batched_retransmissions) {
+    reset_results();
+    TEST_INIT();
+    // without randomization both requests time out at the same moment
+    _anj_exchange_udp_tx_params_t tx_params =
+            _ANJ_EXCHANGE_UDP_TX_PARAMS_DEFAULT;
+    tx_params.ack_random_factor = 1.0;
+    _anj_exchange_set_udp_tx_params(&anj.exchange_ctx, &tx_params);
+    PROCESS_REGISTRATION();
+
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, NULL));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, NULL));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_INF_CON_SEND);
+
+    int batch_calls = mock.call_count[ANJ_NET_FUN_SEND_BATCH];
+    uint64_t actual_time = 0;
+    while (mock.call_count[ANJ_NET_FUN_SEND_BATCH] == batch_calls
+           && actual_time < 10) {
+        set_mock_time_advance(&actual_time, 1);
+        anj_core_step(&anj);
+    }
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND_BATCH],
+                          batch_calls + 1);
+    ANJ_UNIT_ASSERT_EQUAL(mock.datagrams_in_last_batch, 2);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 0);
+}
+#    endif // ANJ_NET_WITH_BATCHED_IO
+
+#    ifdef ANJ_WITH_CORE_POLL_INFO
+ANJ_UNIT_TEST(in_flight, poll_info) {
+    reset_results();
+    TEST_INIT();
+    _anj_exchange_udp_tx_params_t tx_params =
+            _ANJ_EXCHANGE_UDP_TX_PARAMS_DEFAULT;
+    tx_params.ack_random_factor = 1.0;
+    _anj_exchange_set_udp_tx_params(&anj.exchange_ctx, &tx_params);
+    PROCESS_REGISTRATION();
+
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, NULL));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+
+    // the response to the in-flight request and its retransmission are awaited
+    anj_core_poll_info_t info;
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_TRUE(info.system_socket == &mock);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, ANJ_CORE_POLL_IN);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, 2000);
+
+    uint64_t actual_time = 0;
+    set_mock_time_advance(&actual_time, 2);
+    anj_core_step(&anj);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, 4000);
+
+    ADD_RESPONSE(send_response, &anj.in_flight[0].exchange.token,
+                 anj.in_flight[0].exchange.message_id);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_finished_count, 1);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_TRUE(info.timeout_ms > 4000);
+}
+#    endif // ANJ_WITH_CORE_POLL_INFO
+
+#    ifdef ANJ_NET_WITH_SEND_IOV
+ANJ_UNIT_TEST(in_flight, send_iov) {
+    reset_results();
+    TEST_INIT();
+    _anj_exchange_udp_tx_params_t tx_params =
+            _ANJ_EXCHANGE_UDP_TX_PARAMS_DEFAULT;
+    tx_params.ack_random_factor = 1.0;
+    _anj_exchange_set_udp_tx_params(&anj.exchange_ctx, &tx_params);
+    PROCESS_REGISTRATION();
+
+    // header, payload marker and payload are passed as separate buffers
+    int iov_calls = mock.call_count[ANJ_NET_FUN_SEND_IOV];
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, NULL));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(mock.call_count[ANJ_NET_FUN_SEND_IOV],
+                          iov_calls + 1);
+    ANJ_UNIT_ASSERT_EQUAL(mock.iov_count_in_last_send, 3);
+    uint8_t request[100];
+    size_t request_len = mock.bytes_sent;
+    memcpy(request, mock.send_data_buffer, request_len);
+
+    // retransmission is sent from the copy kept in the in-flight slot
+    mock.bytes_sent = 0;
+    uint64_t actual_time = 0;
+    set_mock_time_advance(&actual_time, 2);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, request_len);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, request,
+                                      request_len);
+}
+#    endif // ANJ_NET_WITH_SEND_IOV
+
+#    if defined(ANJ_WITH_OBSERVE) && defined(ANJ_WITH_LWM2M12)
+static char observe_request[] = "\x42"         // Confirmable, tkl 2
+                                "\x01\x11\x21" // GET code 0.1
+                                "\x56\x78"     // token
+                                "\x60"         // observe 6 = 0
+                                "\x51\x31"     // URI_PATH 11 /1
+                                "\x01\x31"     //            /1
+                                "\x01\x35";    //            /5
+
+ANJ_UNIT_TEST(in_flight, newer_notification_replaces_older) {
+    reset_results();
+    TEST_INIT();
+    ser_obj.server_instance.default_notification_mode = 1;
+    PROCESS_REGISTRATION();
+    mock.bytes_to_recv = sizeof(observe_request) - 1;
+    mock.data_to_recv = (uint8_t *) observe_request;
+    anj_core_step(&anj);
+
+    uint64_t actual_time = 0;
+    set_mock_time_advance(&actual_time, 1);
+    ser_obj.server_instance.disable_timeout = 200;
+    anj_core_data_model_changed(&anj, &ANJ_MAKE_RESOURCE_PATH(1, 1, 5),
+                                ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_NOTIFY);
+    _anj_exchange_in_flight_t older = anj.in_flight[0].exchange;
+
+    // value changes again before the first notification is acknowledged
+    ser_obj.server_instance.disable_timeout = 300;
+    anj_core_data_model_changed(&anj, &ANJ_MAKE_RESOURCE_PATH(1, 1, 5),
+                                ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED);
+    mock.bytes_sent = 0;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_TRUE(mock.bytes_sent > 0);
+    uint8_t newer[100];
+    size_t newer_len = mock.bytes_sent;
+    memcpy(newer, mock.send_data_buffer, newer_len);
+
+    // the newer notification takes the slot and retransmission state of the
+    // older one, which is not retransmitted anymore
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_INF_CON_NOTIFY);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[1].exchange.op, ANJ_OP_NONE);
+    ANJ_UNIT_ASSERT_TRUE(_anj_tokens_equal(&anj.in_flight[0].exchange.token,
+                                           &older.token));
+    ANJ_UNIT_ASSERT_NOT_EQUAL(anj.in_flight[0].exchange.message_id,
+                              older.message_id);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.retry_count,
+                          older.retry_count);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.timeout_timestamp_ms,
+                          older.timeout_timestamp_ms);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.timeout_ms,
+                          older.timeout_ms);
+
+    size_t retransmissions = 0;
+    while (!retransmissions && actual_time < 10) {
+        mock.bytes_sent = 0;
+        set_mock_time_advance(&actual_time, 1);
+        anj_core_step(&anj);
+        if (mock.bytes_sent) {
+            ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, newer_len);
+            ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, newer,
+                                              newer_len);
+            retransmissions++;
+        }
+    }
+    ANJ_UNIT_ASSERT_EQUAL(retransmissions, 1);
+
+    // ACK of the newer notification finishes the exchange
+    empty_ack[2] = (char) (anj.in_flight[0].exchange.message_id >> 8);
+    empty_ack[3] = (char) (anj.in_flight[0].exchange.message_id & 0xFF);
+    mock.bytes_to_recv = sizeof(empty_ack) - 1;
+    mock.data_to_recv = (uint8_t *) empty_ack;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.in_flight[0].exchange.op, ANJ_OP_NONE);
+}
+#    endif // defined(ANJ_WITH_OBSERVE) && defined(ANJ_WITH_LWM2M12)
+
+#endif // defined(_ANJ_WITH_IN_FLIGHT_REQUESTS) && defined(ANJ_WITH_LWM2M_SEND)
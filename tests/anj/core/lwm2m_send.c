@@ -23,6 +23,7 @@
 
 #include "../../../src/anj/coap/coap.h"
 #include "../../../src/anj/core/lwm2m_send.h"
+#include "../../../src/anj/core/server.h"
 #include "../../../src/anj/exchange.h"
 #include "../../../src/anj/io/io.h"
 #include "net_api_mock.h"
@@ -582,6 +583,100 @@ ANJ_UNIT_TEST(lwm2m_send, send_with_lwm2m_cbor_same_path) {
                           ANJ_SEND_ERR_DATA_NOT_VALID);
 }
 
+#ifdef ANJ_LWM2M_SEND_WITH_COALESCING
+static char coalesced_second_send[] =
+        "\x48"                             // Confirmable, tkl 8
+        "\x02\x00\x00"                     // POST 0x02, msg id
+        "\x00\x00\x00\x00\x00\x00\x00\x00" // token
+        "\xb2\x64\x70"                     // uri path /dp
+        "\x11\x70"                         // content_format: senml-cbor
+        "\xFF"
+        "\x81\xa3"                                 // map(3)
+        "\x00\x67/3/0/17"                          // path
+        "\x22\xfb\x41\xd9\x6a\x56\x4a\x00\x00\x00" // base time
+        "\x03\x6b"
+        "demo_device"; // string value
+
+ANJ_UNIT_TEST(lwm2m_send, coalesced_sends) {
+    EXTENDED_INIT();
+    mock.inner_mtu_value = 1000;
+    PROCESS_REGISTRATION();
+    anj_send_request_t send_req_1 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &default_record_1
+    };
+    anj_send_request_t send_req_2 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &default_record_2
+    };
+    static anj_io_out_entry_t lwm2m_cbor_record = {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 3),
+        .type = ANJ_DATA_TYPE_UINT,
+        .value.uint_value = 25,
+    };
+    anj_send_request_t send_req_3 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_LWM2M_CBOR,
+        .records_cnt = 1,
+        .records = &lwm2m_cbor_record
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req_1, NULL));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req_2, NULL));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req_3, NULL));
+    // records of both SenML CBOR requests are sent in a single message
+    HANDLE_SEND(basic_send, send_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_result, 0);
+    ANJ_UNIT_ASSERT_EQUAL(g_send_id, 2);
+    ANJ_UNIT_ASSERT_EQUAL(anj.send_ctx.ids[0], 3);
+    // request with different content format is sent separately
+    HANDLE_SEND(lwm2m_cbor_send, send_response);
+    FINAL_CHECK(3, 0);
+}
+
+ANJ_UNIT_TEST(lwm2m_send, abort_coalesced_send) {
+    EXTENDED_INIT();
+    mock.inner_mtu_value = 1000;
+    PROCESS_REGISTRATION();
+    anj_send_request_t send_req_1 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &default_record_1
+    };
+    anj_send_request_t send_req_2 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &default_record_2
+    };
+    uint16_t send_id_1;
+    ANJ_UNIT_ASSERT_SUCCESS(
+            anj_send_new_request(&anj, &send_req_1, &send_id_1));
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req_2, NULL));
+
+    mock.bytes_to_send = 500;
+    anj_core_step(&anj);
+    COPY_TOKEN_AND_MSG_ID(basic_send, 8);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, basic_send,
+                                      sizeof(basic_send) - 1);
+    ANJ_UNIT_ASSERT_TRUE(anj_core_ongoing_operation(&anj));
+    // the other request from the aborted message stays in the queue
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_abort(&anj, send_id_1));
+    ANJ_UNIT_ASSERT_EQUAL(g_send_id, send_id_1);
+    ANJ_UNIT_ASSERT_EQUAL(g_result, ANJ_SEND_ERR_ABORT);
+    ANJ_UNIT_ASSERT_EQUAL(anj.send_ctx.ids[0], 2);
+    ANJ_UNIT_ASSERT_FALSE(anj.send_ctx.active_exchange);
+
+    mock.bytes_sent = 0;
+    HANDLE_SEND(coalesced_second_send, send_response);
+    FINAL_CHECK(2, 0);
+}
+#endif // ANJ_LWM2M_SEND_WITH_COALESCING
+
 ANJ_UNIT_TEST(lwm2m_send, abort_ongoing_send) {
     EXTENDED_INIT();
     PROCESS_REGISTRATION();
@@ -944,7 +1039,8 @@ ANJ_UNIT_TEST(lwm2m_send, send_external_opaque) {
         // preapare first block
         ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_new_client_request(
                                       &anj.exchange_ctx, &msg, &handlers,
-                                      anj.payload_buffer, buff_len),
+                                      _anj_server_payload_buffer(&anj),
+                                      buff_len),
                               ANJ_EXCHANGE_STATE_MSG_TO_SEND);
 
         char expected[] = "\x48"         // Confirmable, tkl 8
@@ -1030,7 +1126,8 @@ ANJ_UNIT_TEST(lwm2m_send, send_external_opaque) {
         // preapare first block
         ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_new_client_request(
                                       &anj.exchange_ctx, &msg, &handlers,
-                                      anj.payload_buffer, buff_len),
+                                      _anj_server_payload_buffer(&anj),
+                                      buff_len),
                               ANJ_EXCHANGE_STATE_MSG_TO_SEND);
 
         char expected[] = "\x48"         // Confirmable, tkl 8
@@ -1113,7 +1210,8 @@ ANJ_UNIT_TEST(lwm2m_send, send_external_opaque) {
         // preapare first block
         ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_new_client_request(
                                       &anj.exchange_ctx, &msg, &handlers,
-                                      anj.payload_buffer, buff_len),
+                                      _anj_server_payload_buffer(&anj),
+                                      buff_len),
                               ANJ_EXCHANGE_STATE_MSG_TO_SEND);
 
         char expected[] = "\x48"         // Confirmable, tkl 8
@@ -1152,7 +1250,8 @@ ANJ_UNIT_TEST(lwm2m_send, send_external_opaque) {
         // preapare first block
         ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_new_client_request(
                                       &anj.exchange_ctx, &msg, &handlers,
-                                      anj.payload_buffer, buff_len),
+                                      _anj_server_payload_buffer(&anj),
+                                      buff_len),
                               ANJ_EXCHANGE_STATE_MSG_TO_SEND);
 
         char expected[] = "\x48"         // Confirmable, tkl 8
@@ -1208,7 +1307,8 @@ ANJ_UNIT_TEST(lwm2m_send, send_external_opaque) {
         // preapare first block
         ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_new_client_request(
                                       &anj.exchange_ctx, &msg, &handlers,
-                                      anj.payload_buffer, buff_len),
+                                      _anj_server_payload_buffer(&anj),
+                                      buff_len),
                               ANJ_EXCHANGE_STATE_FINISHED);
 
         ANJ_UNIT_ASSERT_TRUE(closed);
@@ -1230,7 +1330,8 @@ ANJ_UNIT_TEST(lwm2m_send, send_external_opaque) {
         // preapare first block
         ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_new_client_request(
                                       &anj.exchange_ctx, &msg, &handlers,
-                                      anj.payload_buffer, buff_len),
+                                      _anj_server_payload_buffer(&anj),
+                                      buff_len),
                               ANJ_EXCHANGE_STATE_MSG_TO_SEND);
         char expected[] = "\x48"         // Confirmable, tkl 8
                           "\x02\x00\x00" // POST 0x02, msg id
@@ -7,10 +7,12 @@
  * See the attached LICENSE file for details.
  */
 
+#include <assert.h>
 #include <stddef.h>
 #include <string.h>
 
 #include <anj/compat/net/anj_net_api.h>
+#include <anj/compat/net/anj_tcp.h>
 #include <anj/compat/net/anj_udp.h>
 #include <anj/utils.h>
 
@@ -95,6 +97,75 @@ int anj_udp_recv(anj_net_ctx_t *ctx,
     return ANJ_NET_EAGAIN;
 }
 
+#ifdef ANJ_NET_WITH_BATCHED_IO
+int anj_udp_recv_batch(anj_net_ctx_t *ctx,
+                       anj_net_datagram_t *datagrams,
+                       size_t count,
+                       size_t *out_count) {
+    net_api_mock_t *mock = (net_api_mock_t *) ctx;
+    mock->call_count[ANJ_NET_FUN_RECV_BATCH]++;
+    *out_count = 0;
+    int res = anj_udp_recv(ctx, &datagrams[0].bytes_received, datagrams[0].buf,
+                           datagrams[0].length);
+    if (res) {
+        return res;
+    }
+    datagrams[0].truncated = false;
+    *out_count = 1;
+    if (count > 1 && mock->extra_bytes_to_recv > 0) {
+        datagrams[1].bytes_received =
+                ANJ_MIN(mock->extra_bytes_to_recv, datagrams[1].length);
+        memcpy(datagrams[1].buf, mock->extra_data_to_recv,
+               datagrams[1].bytes_received);
+        datagrams[1].truncated = false;
+        mock->extra_bytes_to_recv = 0;
+        *out_count = 2;
+    }
+    return ANJ_NET_OK;
+}
+
+int anj_udp_send_batch(anj_net_ctx_t *ctx,
+                       const anj_net_datagram_t *datagrams,
+                       size_t count,
+                       size_t *out_count) {
+    net_api_mock_t *mock = (net_api_mock_t *) ctx;
+    mock->call_count[ANJ_NET_FUN_SEND_BATCH]++;
+    mock->datagrams_in_last_batch = 0;
+    *out_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t bytes_sent;
+        int res = anj_udp_send(ctx, &bytes_sent, datagrams[i].buf,
+                               datagrams[i].length);
+        if (res) {
+            return *out_count ? ANJ_NET_OK : res;
+        }
+        (*out_count)++;
+        mock->datagrams_in_last_batch++;
+    }
+    return ANJ_NET_OK;
+}
+#endif // ANJ_NET_WITH_BATCHED_IO
+
+#ifdef ANJ_NET_WITH_SEND_IOV
+// gathers all buffers, so that the tests can check the message as a whole
+int anj_udp_send_iov(anj_net_ctx_t *ctx,
+                     size_t *bytes_sent,
+                     const anj_net_iovec_t *iov,
+                     size_t iov_count) {
+    net_api_mock_t *mock = (net_api_mock_t *) ctx;
+    mock->call_count[ANJ_NET_FUN_SEND_IOV]++;
+    mock->iov_count_in_last_send = iov_count;
+    uint8_t buf[sizeof(mock->send_data_buffer)];
+    size_t length = 0;
+    for (size_t i = 0; i < iov_count; i++) {
+        assert(length + iov[i].length <= sizeof(buf));
+        memcpy(&buf[length], iov[i].buf, iov[i].length);
+        length += iov[i].length;
+    }
+    return anj_udp_send(ctx, bytes_sent, buf, length);
+}
+#endif // ANJ_NET_WITH_SEND_IOV
+
 int anj_udp_create_ctx(anj_net_ctx_t **ctx, const anj_net_config_t *config) {
     (void) config;
     *ctx = (anj_net_ctx_t *) net_api_mock;
@@ -171,6 +242,11 @@ int anj_udp_get_inner_mtu(anj_net_ctx_t *ctx, int32_t *out_value) {
     HANLDE_RETURN_AND_COUNT(mock, ANJ_NET_FUN_GET_INNER_MTU);
 }
 
+const void *anj_udp_get_system_socket(anj_net_ctx_t *ctx) {
+    // mock context is used as the socket
+    return ctx;
+}
+
 int anj_udp_reuse_last_port(anj_net_ctx_t *ctx) {
     net_api_mock_t *mock = (net_api_mock_t *) ctx;
     if (mock->net_eagain_calls == 0) {
@@ -178,3 +254,96 @@ int anj_udp_reuse_last_port(anj_net_ctx_t *ctx) {
     }
     HANLDE_RETURN_WITH_AGAIN_AND_COUNT(mock, ANJ_NET_FUN_REUSE_LAST_PORT);
 }
+
+#ifdef ANJ_NET_WITH_TCP
+// stream socket: data of consecutive calls is appended to send_data_buffer
+// until the test clears bytes_sent, bytes_to_send limits every call
+int anj_tcp_send(anj_net_ctx_t *ctx,
+                 size_t *bytes_sent,
+                 const uint8_t *buf,
+                 size_t length) {
+    net_api_mock_t *mock = (net_api_mock_t *) ctx;
+    if (g_force_send_failure) {
+        g_force_send_failure = false;
+        return FORCED_ERROR;
+    }
+    *bytes_sent = 0;
+    mock->call_count[ANJ_NET_FUN_SEND]++;
+    if (mock->bytes_to_send > 0) {
+        size_t to_send = ANJ_MIN(mock->bytes_to_send, length);
+        assert(mock->bytes_sent + to_send <= sizeof(mock->send_data_buffer));
+        memcpy(&mock->send_data_buffer[mock->bytes_sent], buf, to_send);
+        mock->bytes_sent += to_send;
+        *bytes_sent = to_send;
+        return ANJ_NET_OK;
+    }
+    return mock->call_result[ANJ_NET_FUN_SEND];
+}
+
+// data_to_recv is consumed, so that the stream can be received in parts
+int anj_tcp_recv(anj_net_ctx_t *ctx,
+                 size_t *bytes_received,
+                 uint8_t *buf,
+                 size_t length) {
+    net_api_mock_t *mock = (net_api_mock_t *) ctx;
+    if (mock->peer_closed) {
+        mock->call_count[ANJ_NET_FUN_RECV]++;
+        *bytes_received = 0;
+        return ANJ_NET_OK;
+    }
+    if (mock->recv_chunk_size) {
+        length = ANJ_MIN(length, mock->recv_chunk_size);
+    }
+    int res = anj_udp_recv(ctx, bytes_received, buf, length);
+    if (!res) {
+        mock->data_to_recv += *bytes_received;
+    }
+    return res;
+}
+
+int anj_tcp_create_ctx(anj_net_ctx_t **ctx, const anj_net_config_t *config) {
+    return anj_udp_create_ctx(ctx, config);
+}
+
+int anj_tcp_connect(anj_net_ctx_t *ctx,
+                    const char *hostname,
+                    const char *port) {
+    return anj_udp_connect(ctx, hostname, port);
+}
+
+int anj_tcp_shutdown(anj_net_ctx_t *ctx) {
+    return anj_udp_shutdown(ctx);
+}
+
+int anj_tcp_close(anj_net_ctx_t *ctx) {
+    return anj_udp_close(ctx);
+}
+
+int anj_tcp_cleanup_ctx(anj_net_ctx_t **ctx) {
+    return anj_udp_cleanup_ctx(ctx);
+}
+
+int anj_tcp_get_bytes_received(anj_net_ctx_t *ctx, uint64_t *out_value) {
+    return anj_udp_get_bytes_received(ctx, out_value);
+}
+
+int anj_tcp_get_bytes_sent(anj_net_ctx_t *ctx, uint64_t *out_value) {
+    return anj_udp_get_bytes_sent(ctx, out_value);
+}
+
+int anj_tcp_get_state(anj_net_ctx_t *ctx, anj_net_socket_state_t *out_value) {
+    return anj_udp_get_state(ctx, out_value);
+}
+
+int anj_tcp_get_inner_mtu(anj_net_ctx_t *ctx, int32_t *out_value) {
+    return anj_udp_get_inner_mtu(ctx, out_value);
+}
+
+const void *anj_tcp_get_system_socket(anj_net_ctx_t *ctx) {
+    return anj_udp_get_system_socket(ctx);
+}
+
+int anj_tcp_reuse_last_port(anj_net_ctx_t *ctx) {
+    return anj_udp_reuse_last_port(ctx);
+}
+#endif // ANJ_NET_WITH_TCP
@@ -29,6 +29,9 @@ typedef enum {
     ANJ_NET_FUN_GET_BYTES_RECEIVED,
     ANJ_NET_FUN_GET_BYTES_SENT,
     ANJ_NET_FUN_GET_STATE,
+    ANJ_NET_FUN_RECV_BATCH,
+    ANJ_NET_FUN_SEND_BATCH,
+    ANJ_NET_FUN_SEND_IOV,
     ANJ_NET_FUN_LAST
 } anj_net_fun_t;
 
@@ -43,6 +46,23 @@ typedef struct {
 
     size_t bytes_to_recv;
     uint8_t *data_to_recv;
+#ifdef ANJ_NET_WITH_TCP
+    // limit of bytes returned by a single anj_tcp_recv call, 0 means no limit
+    size_t recv_chunk_size;
+    // anj_tcp_recv reports end of the stream, i.e. succeeds with 0 bytes
+    bool peer_closed;
+#endif // ANJ_NET_WITH_TCP
+#ifdef ANJ_NET_WITH_BATCHED_IO
+    // returned by anj_udp_recv_batch together with data_to_recv
+    size_t extra_bytes_to_recv;
+    uint8_t *extra_data_to_recv;
+    // number of datagrams sent with the last anj_udp_send_batch call
+    size_t datagrams_in_last_batch;
+#endif // ANJ_NET_WITH_BATCHED_IO
+#ifdef ANJ_NET_WITH_SEND_IOV
+    // number of buffers passed to the last anj_udp_send_iov call
+    size_t iov_count_in_last_send;
+#endif // ANJ_NET_WITH_SEND_IOV
 
     size_t inner_mtu_value;
     const char *hostname;
@@ -0,0 +1,598 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/compat/offline_store.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/core.h>
+#include <anj/dm/security_object.h>
+#include <anj/dm/server_object.h>
+#include <anj/lwm2m_send.h>
+#include <anj/utils.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/core/offline_store.h"
+#include "../../../src/anj/exchange.h"
+#include "net_api_mock.h"
+#include "time_api_mock.h"
+
+#include <anj_unit_test.h>
+
+#if defined(ANJ_WITH_OFFLINE_STORE) \
+        && defined(ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT)
+
+#    define STORE_PATH "offline_store_test.bin"
+#    define STORE_CAPACITY 1024
+
+#    define TEST_INIT()                                                     \
+        set_mock_time(0);                                                   \
+        net_api_mock_t mock = { 0 };                                        \
+        net_api_mock_ctx_init(&mock);                                       \
+        mock.inner_mtu_value = 110;                                         \
+        remove(STORE_PATH);                                                 \
+        anj_offline_store_file_t store_ctx;                                 \
+        anj_offline_store_t store;                                          \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_offline_store_file_open(                \
+                &store_ctx, STORE_PATH, STORE_CAPACITY, &store));           \
+        anj_t anj;                                                          \
+        anj_configuration_t config = {                                      \
+            .endpoint_name = "name",                                        \
+            .offline_store = &store                                         \
+        };                                                                  \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_core_init(&anj, &config));              \
+        anj_dm_security_obj_t sec_obj;                                      \
+        anj_dm_security_obj_init(&sec_obj);                                 \
+        anj_dm_server_obj_t ser_obj;                                        \
+        anj_dm_server_obj_init(&ser_obj);                                   \
+        const anj_iid_t iid = 1;                                            \
+        anj_dm_security_instance_init_t sec_inst = {                        \
+            .server_uri = "coap://server.com:5683",                         \
+            .ssid = 2,                                                      \
+            .iid = &iid                                                     \
+        };                                                                  \
+        anj_dm_server_instance_init_t ser_inst = {                          \
+            .ssid = 2,                                                      \
+            .lifetime = 150,                                                \
+            .binding = "U",                                                 \
+            .iid = &iid                                                     \
+        };                                                                  \
+        ANJ_UNIT_ASSERT_SUCCESS(                                            \
+                anj_dm_security_obj_add_instance(&sec_obj, &sec_inst));     \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_security_obj_install(&anj, &sec_obj)); \
+        ANJ_UNIT_ASSERT_SUCCESS(                                            \
+                anj_dm_server_obj_add_instance(&ser_obj, &ser_inst));       \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_server_obj_install(&anj, &ser_obj))
+
+#    define COPY_TOKEN_AND_MSG_ID(Msg, Token_size)                          \
+        memcpy(&Msg[4], anj.exchange_ctx.base_msg.token.bytes, Token_size); \
+        Msg[2] = anj.exchange_ctx.base_msg.coap_binding_data.udp.message_id \
+                 >> 8;                                                      \
+        Msg[3] = anj.exchange_ctx.base_msg.coap_binding_data.udp.message_id \
+                 & 0xFF
+
+#    define ADD_RESPONSE(Response)                 \
+        COPY_TOKEN_AND_MSG_ID(Response, 8);        \
+        mock.bytes_to_recv = sizeof(Response) - 1; \
+        mock.data_to_recv = (uint8_t *) Response
+
+static char register_response[] =
+        "\x68"                             // header v 0x01, Ack, tkl 8
+        "\x41\x00\x00"                     // CREATED code 2.1
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" // token
+        "\x82\x72\x64"                     // location-path /rd
+        "\x04\x35\x61\x33\x66";            // location-path 8 /5a3f
+
+static char send_response[] = "\x68"         // header v 0x01, Ack, tkl 8
+                              "\x44\x00\x00" // Changed code 2.04
+                              "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"; // token
+
+// stored data is sent in the same anj_core_step in which the registration is
+// finished
+#    define PROCESS_REGISTRATION()                          \
+        mock.bytes_to_send = 500;                           \
+        anj_core_step(&anj);                                \
+        ADD_RESPONSE(register_response);                    \
+        mock.bytes_sent = 0;                                \
+        anj_core_step(&anj);                                \
+        ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status, \
+                              ANJ_CONN_STATUS_REGISTERED)
+
+#    define HANDLE_SEND(Send_request, Response)                            \
+        COPY_TOKEN_AND_MSG_ID(Send_request, 8);                            \
+        ANJ_UNIT_ASSERT_EQUAL(sizeof(Send_request) - 1, mock.bytes_sent);  \
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer,           \
+                                          Send_request, mock.bytes_sent);  \
+        ADD_RESPONSE(Response);                                            \
+        mock.bytes_sent = 0;                                               \
+        anj_core_step(&anj);                                               \
+        ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,                \
+                              ANJ_CONN_STATUS_REGISTERED);                 \
+        ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0)
+
+static int g_result = 0;
+static size_t g_handler_calls = 0;
+
+static void
+send_finished_handler(anj_t *anjay, uint16_t send_id, int result, void *data) {
+    (void) anjay;
+    (void) send_id;
+    (void) data;
+    g_result = result;
+    g_handler_calls++;
+}
+
+static anj_io_out_entry_t record_1 = {
+    .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 9),
+    .type = ANJ_DATA_TYPE_INT,
+    .value.int_value = 42,
+    .timestamp = 1705597224.0
+};
+
+static anj_io_out_entry_t record_2 = {
+    .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 17),
+    .type = ANJ_DATA_TYPE_STRING,
+    .value.bytes_or_string.data = "demo_device",
+    .timestamp = 1705597224.0
+};
+
+// each stored entry keeps its own base time
+static char merged_send[] =
+        "\x48"                             // Confirmable, tkl 8
+        "\x02\x00\x00"                     // POST 0x02, msg id
+        "\x00\x00\x00\x00\x00\x00\x00\x00" // token
+        "\xb2\x64\x70"                     // uri path /dp
+        "\x11\x70"                         // content_format: senml-cbor
+        "\xFF"
+        "\x82\xa3"                                 // map(3)
+        "\x00\x66/3/0/9"                           // path
+        "\x22\xfb\x41\xd9\x6a\x56\x4a\x00\x00\x00" // base time
+        "\x02\x18\x2a"                             // value 42
+        "\xa3"                                     // map(3)
+        "\x00\x67/3/0/17"                          // path
+        "\x22\xfb\x41\xd9\x6a\x56\x4a\x00\x00\x00" // base time
+        "\x03\x6b"
+        "demo_device"; // string value
+
+ANJ_UNIT_TEST(offline_store, store_while_not_registered) {
+    TEST_INIT();
+    g_handler_calls = 0;
+    anj_send_request_t send_req_1 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &record_1
+    };
+    anj_send_request_t send_req_2 = send_req_1;
+    send_req_2.records = &record_2;
+    ANJ_UNIT_ASSERT_EQUAL(anj_send_new_request(&anj, &send_req_1, NULL),
+                          ANJ_SEND_STORED);
+    ANJ_UNIT_ASSERT_EQUAL(anj_send_new_request(&anj, &send_req_2, NULL),
+                          ANJ_SEND_STORED);
+    // requests are not queued, so there is nothing to report
+    ANJ_UNIT_ASSERT_EQUAL(g_handler_calls, 0);
+    ANJ_UNIT_ASSERT_EQUAL(anj.send_ctx.ids[0], 0);
+
+    PROCESS_REGISTRATION();
+    HANDLE_SEND(merged_send, send_response);
+
+    uint16_t format;
+    size_t length;
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 0, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+// notification of /3/0/9 sets the observed path as the base name
+static const uint8_t stored_notification[] = "\x81\xa2"       // map(2)
+                                             "\x21\x66/3/0/9" // base name
+                                             "\x02\x18\x2a";  // value 42
+
+static char notification_send[] =
+        "\x48"                             // Confirmable, tkl 8
+        "\x02\x00\x00"                     // POST 0x02, msg id
+        "\x00\x00\x00\x00\x00\x00\x00\x00" // token
+        "\xb2\x64\x70"                     // uri path /dp
+        "\x11\x70"                         // content_format: senml-cbor
+        "\xFF"
+        "\x81\xa2"       // map(2)
+        "\x21\x66/3/0/9" // base name
+        "\x02\x18\x2a";  // value 42
+
+static char record_1_send[] =
+        "\x48"                             // Confirmable, tkl 8
+        "\x02\x00\x00"                     // POST 0x02, msg id
+        "\x00\x00\x00\x00\x00\x00\x00\x00" // token
+        "\xb2\x64\x70"                     // uri path /dp
+        "\x11\x70"                         // content_format: senml-cbor
+        "\xFF"
+        "\x81\xa3"                                 // map(3)
+        "\x00\x66/3/0/9"                           // path
+        "\x22\xfb\x41\xd9\x6a\x56\x4a\x00\x00\x00" // base time
+        "\x02\x18\x2a";                           // value 42
+
+ANJ_UNIT_TEST(offline_store, not_merged_after_base_name) {
+    TEST_INIT();
+    ANJ_UNIT_ASSERT_SUCCESS(
+            store.begin(store.arg, _ANJ_COAP_FORMAT_SENML_CBOR));
+    ANJ_UNIT_ASSERT_SUCCESS(store.append(store.arg, stored_notification,
+                                         sizeof(stored_notification) - 1));
+    ANJ_UNIT_ASSERT_SUCCESS(store.end(store.arg, true));
+    anj_send_request_t send_req = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &record_1
+    };
+    ANJ_UNIT_ASSERT_EQUAL(anj_send_new_request(&anj, &send_req, NULL),
+                          ANJ_SEND_STORED);
+
+    // record names of the Send request would be relative to /3/0/9
+    PROCESS_REGISTRATION();
+    COPY_TOKEN_AND_MSG_ID(notification_send, 8);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, sizeof(notification_send) - 1);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, notification_send,
+                                      mock.bytes_sent);
+    ADD_RESPONSE(send_response);
+    mock.bytes_sent = 0;
+    anj_core_step(&anj);
+    HANDLE_SEND(record_1_send, send_response);
+
+    uint16_t format;
+    size_t length;
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 0, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+static char long_string[401];
+
+static anj_io_out_entry_t long_record = {
+    .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 17),
+    .type = ANJ_DATA_TYPE_STRING,
+    .value.bytes_or_string.data = long_string,
+    .timestamp = 1705597224.0
+};
+
+static char block_continue_response[] = "\x68"         // Ack, tkl 8
+                                        "\x5F\x00\x00" // Continue code 2.31
+                                        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"
+                                        "\xD1\x0E\x00"; // block1
+
+ANJ_UNIT_TEST(offline_store, entry_dropped_during_delivery) {
+    TEST_INIT();
+    memset(long_string, 'a', sizeof(long_string) - 1);
+    anj_send_request_t send_req = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &long_record
+    };
+    for (int i = 0; i < 2; i++) {
+        ANJ_UNIT_ASSERT_EQUAL(anj_send_new_request(&anj, &send_req, NULL),
+                              ANJ_SEND_STORED);
+    }
+    uint16_t format;
+    size_t length;
+    ANJ_UNIT_ASSERT_SUCCESS(store.get_entry(store.arg, 0, &format, &length));
+    size_t entry_length = length;
+
+    // the first entry is delivered with block-wise transfer
+    PROCESS_REGISTRATION();
+    ANJ_UNIT_ASSERT_EQUAL(anj.exchange_ctx.base_msg.block.block_type,
+                          ANJ_OPTION_BLOCK_1);
+    ANJ_UNIT_ASSERT_EQUAL(anj.offline_store.entries_in_msg, 1);
+
+    // there is no room for the third entry, the first one is dropped
+    long_string[0] = 'b';
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_offline_store_send_request(&anj, &send_req));
+    ANJ_UNIT_ASSERT_EQUAL(anj.offline_store.dropped_in_flight, 1);
+
+    // rest of the dropped entry can't be sent, so the transfer is cancelled
+    block_continue_response[sizeof(block_continue_response) - 2] =
+            (char) (0x08
+                    | (anj.exchange_ctx.base_msg.block.size == 64 ? 2 : 1));
+    ADD_RESPONSE(block_continue_response);
+    mock.bytes_sent = 0;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_REGISTERED);
+    // delivery starts again from the second entry
+    ANJ_UNIT_ASSERT_EQUAL(anj.exchange_ctx.base_msg.block.number, 0);
+    ANJ_UNIT_ASSERT_EQUAL(anj.offline_store.dropped_in_flight, 0);
+
+    // second and third entries are kept
+    for (size_t i = 0; i < 2; i++) {
+        uint8_t value_start;
+        ANJ_UNIT_ASSERT_SUCCESS(
+                store.get_entry(store.arg, i, &format, &length));
+        ANJ_UNIT_ASSERT_EQUAL(length, entry_length);
+        ANJ_UNIT_ASSERT_SUCCESS(store.read(store.arg, i, length - 400,
+                                           &value_start, 1));
+        ANJ_UNIT_ASSERT_EQUAL(value_start, i ? 'b' : 'a');
+    }
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 2, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+static char block_changed_response[] = "\x68"         // Ack, tkl 8
+                                       "\x44\x00\x00" // Changed code 2.04
+                                       "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"
+                                       "\xD1\x0E\x00"; // block1
+
+ANJ_UNIT_TEST(offline_store, block_wise_delivery) {
+    TEST_INIT();
+    memset(long_string, 'a', sizeof(long_string) - 1);
+    anj_send_request_t send_req = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &long_record
+    };
+    ANJ_UNIT_ASSERT_EQUAL(anj_send_new_request(&anj, &send_req, NULL),
+                          ANJ_SEND_STORED);
+    uint16_t format;
+    size_t length;
+    ANJ_UNIT_ASSERT_SUCCESS(store.get_entry(store.arg, 0, &format, &length));
+    uint8_t entry[sizeof(long_string) + 32];
+    ANJ_UNIT_ASSERT_SUCCESS(store.read(store.arg, 0, 0, entry, length));
+
+    PROCESS_REGISTRATION();
+    size_t delivered = 0;
+    uint8_t szx = anj.exchange_ctx.base_msg.block.size == 64 ? 2 : 1;
+    while (true) {
+        _anj_coap_msg_t *msg = &anj.exchange_ctx.base_msg;
+        ANJ_UNIT_ASSERT_EQUAL(msg->block.block_type, ANJ_OPTION_BLOCK_1);
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(msg->payload, &entry[delivered],
+                                          msg->payload_size);
+        delivered += msg->payload_size;
+        bool last = !msg->block.more_flag;
+        // both responses have the same length
+        char *response =
+                last ? block_changed_response : block_continue_response;
+        COPY_TOKEN_AND_MSG_ID(response, 8);
+        response[14] = (char) ((msg->block.number << 4)
+                               | (msg->block.more_flag << 3) | szx);
+        mock.bytes_to_recv = sizeof(block_continue_response) - 1;
+        mock.data_to_recv = (uint8_t *) response;
+        mock.bytes_sent = 0;
+        anj_core_step(&anj);
+        if (last) {
+            break;
+        }
+    }
+    ANJ_UNIT_ASSERT_EQUAL(delivered, length);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0);
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 0, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+ANJ_UNIT_TEST(offline_store, send_stored_after_timeout) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+    g_handler_calls = 0;
+    g_result = 0;
+    anj_send_request_t send_req = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &record_1
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req, NULL));
+    anj_core_step(&anj);
+    COPY_TOKEN_AND_MSG_ID(record_1_send, 8);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, sizeof(record_1_send) - 1);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(mock.send_data_buffer, record_1_send,
+                                      mock.bytes_sent);
+
+    // no response to any of the retransmissions
+    uint64_t actual_time = 0;
+    while (!g_handler_calls && actual_time < 500) {
+        set_mock_time_advance(&actual_time, 10);
+        anj_core_step(&anj);
+    }
+    ANJ_UNIT_ASSERT_EQUAL(g_handler_calls, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_result, ANJ_SEND_STORED);
+    uint16_t format;
+    size_t length;
+    ANJ_UNIT_ASSERT_SUCCESS(store.get_entry(store.arg, 0, &format, &length));
+    ANJ_UNIT_ASSERT_EQUAL(format, _ANJ_COAP_FORMAT_SENML_CBOR);
+    ANJ_UNIT_ASSERT_EQUAL(length, sizeof(record_1_send) - 1 - 18);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+ANJ_UNIT_TEST(offline_store, queued_requests_stored_on_shutdown) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+    g_handler_calls = 0;
+    anj_send_request_t send_req_1 = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &record_1
+    };
+    anj_send_request_t send_req_2 = send_req_1;
+    send_req_2.records = &record_2;
+    // the first request is being sent, the second one waits in the queue
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req_1, NULL));
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_SUCCESS(anj_send_new_request(&anj, &send_req_2, NULL));
+    ANJ_UNIT_ASSERT_EQUAL(anj.send_ctx.ids[1] != 0, true);
+
+    anj_core_shutdown(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(g_handler_calls, 2);
+    ANJ_UNIT_ASSERT_EQUAL(g_result, ANJ_SEND_STORED);
+    uint16_t format;
+    size_t length;
+    for (size_t i = 0; i < 2; i++) {
+        ANJ_UNIT_ASSERT_SUCCESS(
+                store.get_entry(store.arg, i, &format, &length));
+    }
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 2, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+#    if defined(ANJ_WITH_OBSERVE) && defined(ANJ_WITH_LWM2M12) \
+            && defined(ANJ_WITH_SENML_CBOR) && defined(ANJ_WITH_LWM2M_CBOR)
+static char observe_request[] = "\x42"         // Confirmable, tkl 2
+                                "\x01\x11\x21" // GET code 0.1
+                                "\x56\x78"     // token
+                                "\x60"         // observe 6 = 0
+                                "\x51\x31"     // URI_PATH 11 /1
+                                "\x01\x31"     //            /1
+                                "\x01\x35";    //            /5
+
+// LwM2M CBOR notification {1: {1: {5: 200}}} is stored as SenML CBOR pack,
+// [{0: "/1/1/5", -3: 1.0, 2: 200}], timestamped when it was prepared
+static const uint8_t notification_payload[] =
+        "\x81\xA3\x00\x66/1/1/5\x22\xFA\x3F\x80\x00\x00\x02\x18\xC8";
+
+ANJ_UNIT_TEST(offline_store, notification_stored_after_timeout) {
+    TEST_INIT();
+    ser_obj.server_instance.notification_storing = true;
+    ser_obj.server_instance.default_notification_mode = 1;
+    PROCESS_REGISTRATION();
+    mock.bytes_to_recv = sizeof(observe_request) - 1;
+    mock.data_to_recv = (uint8_t *) observe_request;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.observe_ctx.observations[0].ssid, 2);
+
+    // confirmable notification is not acknowledged
+    uint64_t actual_time = 0;
+    set_mock_time_advance(&actual_time, 1);
+    ser_obj.server_instance.disable_timeout = 200;
+    anj_core_data_model_changed(&anj, &ANJ_MAKE_RESOURCE_PATH(1, 1, 5),
+                                ANJ_CORE_CHANGE_TYPE_VALUE_CHANGED);
+    mock.bytes_sent = 0;
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.send_data_buffer[0] & 0x30, 0x00);
+    uint16_t format;
+    size_t length;
+    while (store.get_entry(store.arg, 0, &format, &length)
+           && actual_time < 500) {
+        set_mock_time_advance(&actual_time, 10);
+        anj_core_step(&anj);
+    }
+    ANJ_UNIT_ASSERT_SUCCESS(store.get_entry(store.arg, 0, &format, &length));
+    ANJ_UNIT_ASSERT_EQUAL(format, _ANJ_COAP_FORMAT_SENML_CBOR);
+    ANJ_UNIT_ASSERT_EQUAL(length, sizeof(notification_payload) - 1);
+    uint8_t buff[sizeof(notification_payload)];
+    ANJ_UNIT_ASSERT_SUCCESS(store.read(store.arg, 0, 0, buff, length));
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(buff, notification_payload, length);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+#    endif // defined(ANJ_WITH_OBSERVE) && defined(ANJ_WITH_LWM2M12) &&
+           // defined(ANJ_WITH_SENML_CBOR) && defined(ANJ_WITH_LWM2M_CBOR)
+
+ANJ_UNIT_TEST(offline_store, not_stored_without_store) {
+    set_mock_time(0);
+    anj_t anj;
+    anj_configuration_t config = {
+        .endpoint_name = "name"
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(anj_core_init(&anj, &config));
+    anj_send_request_t send_req = {
+        .finished_handler = send_finished_handler,
+        .content_format = ANJ_SEND_CONTENT_FORMAT_SENML_CBOR,
+        .records_cnt = 1,
+        .records = &record_1
+    };
+    ANJ_UNIT_ASSERT_EQUAL(anj_send_new_request(&anj, &send_req, NULL),
+                          ANJ_SEND_ERR_NOT_ALLOWED);
+}
+
+ANJ_UNIT_TEST(offline_store, invalid_store) {
+    set_mock_time(0);
+    anj_t anj;
+    anj_offline_store_t store = { 0 };
+    anj_configuration_t config = {
+        .endpoint_name = "name",
+        .offline_store = &store
+    };
+    ANJ_UNIT_ASSERT_FAILED(anj_core_init(&anj, &config));
+}
+
+ANJ_UNIT_TEST(offline_store, file_persistence) {
+    remove(STORE_PATH);
+    anj_offline_store_file_t store_ctx;
+    anj_offline_store_t store;
+    ANJ_UNIT_ASSERT_SUCCESS(
+            anj_offline_store_file_open(&store_ctx, STORE_PATH, 64, &store));
+    const uint8_t data[] = "0123456789abcdef";
+    for (uint16_t i = 0; i < 2; i++) {
+        ANJ_UNIT_ASSERT_SUCCESS(store.begin(store.arg, i));
+        ANJ_UNIT_ASSERT_SUCCESS(store.append(store.arg, data, 8));
+        ANJ_UNIT_ASSERT_SUCCESS(store.append(store.arg, &data[8], 8));
+        ANJ_UNIT_ASSERT_SUCCESS(store.end(store.arg, true));
+    }
+    // discarded entry is not visible
+    ANJ_UNIT_ASSERT_SUCCESS(store.begin(store.arg, 5));
+    ANJ_UNIT_ASSERT_SUCCESS(store.append(store.arg, data, 4));
+    ANJ_UNIT_ASSERT_SUCCESS(store.end(store.arg, false));
+    anj_offline_store_file_close(&store_ctx);
+
+    ANJ_UNIT_ASSERT_SUCCESS(
+            anj_offline_store_file_open(&store_ctx, STORE_PATH, 64, &store));
+    uint16_t format;
+    size_t length;
+    uint8_t buff[16];
+    for (uint16_t i = 0; i < 2; i++) {
+        ANJ_UNIT_ASSERT_SUCCESS(
+                store.get_entry(store.arg, i, &format, &length));
+        ANJ_UNIT_ASSERT_EQUAL(format, i);
+        ANJ_UNIT_ASSERT_EQUAL(length, 16);
+        ANJ_UNIT_ASSERT_SUCCESS(store.read(store.arg, i, 4, buff, 12));
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(buff, &data[4], 12);
+    }
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 2, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+
+    // third entry doesn't fit, so the oldest one is dropped, the entry
+    // wraps around the end of the ring buffer, number of dropped entries is
+    // reported
+    ANJ_UNIT_ASSERT_SUCCESS(store.begin(store.arg, 2));
+    ANJ_UNIT_ASSERT_EQUAL(store.append(store.arg, data, 16), 1);
+    ANJ_UNIT_ASSERT_SUCCESS(store.end(store.arg, true));
+    ANJ_UNIT_ASSERT_SUCCESS(store.get_entry(store.arg, 0, &format, &length));
+    ANJ_UNIT_ASSERT_EQUAL(format, 1);
+    ANJ_UNIT_ASSERT_SUCCESS(store.get_entry(store.arg, 1, &format, &length));
+    ANJ_UNIT_ASSERT_EQUAL(format, 2);
+    ANJ_UNIT_ASSERT_SUCCESS(store.read(store.arg, 1, 0, buff, 16));
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(buff, data, 16);
+
+    // entry larger than the whole store is rejected
+    ANJ_UNIT_ASSERT_SUCCESS(store.begin(store.arg, 3));
+    uint8_t big[64] = { 0 };
+    ANJ_UNIT_ASSERT_FAILED(store.append(store.arg, big, sizeof(big)));
+    ANJ_UNIT_ASSERT_SUCCESS(store.end(store.arg, false));
+
+    ANJ_UNIT_ASSERT_SUCCESS(store.drop(store.arg, 2));
+    ANJ_UNIT_ASSERT_EQUAL(store.get_entry(store.arg, 0, &format, &length),
+                          ANJ_OFFLINE_STORE_NO_ENTRY);
+    anj_offline_store_file_close(&store_ctx);
+    remove(STORE_PATH);
+}
+
+#endif // defined(ANJ_WITH_OFFLINE_STORE) &&
+       // defined(ANJ_WITH_OFFLINE_STORE_POSIX_COMPAT)
@@ -265,6 +265,22 @@ ANJ_UNIT_TEST(registration_session, update_with_data_model) {
     HANDLE_UPDATE(update_with_data_model);
 }
 
+ANJ_UNIT_TEST(registration_session, update_with_data_model_batch) {
+    EXTENDED_INIT();
+    PROCESS_REGISTRATION();
+    uint64_t actual_time = 76;
+    set_mock_time(actual_time);
+    HANDLE_UPDATE(update);
+
+    anj_uri_path_t paths[] = { ANJ_MAKE_INSTANCE_PATH(1, 3),
+                               ANJ_MAKE_INSTANCE_PATH(1, 4) };
+    anj_core_data_model_changed_batch(&anj, paths, ANJ_ARRAY_SIZE(paths),
+                                      ANJ_CORE_CHANGE_TYPE_ADDED);
+    HANDLE_UPDATE(update_with_data_model);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(mock.bytes_sent, 0);
+}
+
 static char update_with_data_model_block_1[] =
         "\x48"                             // Confirmable, tkl 8
         "\x02\x00\x00"                     // POST, msg_id
@@ -979,6 +995,87 @@ ANJ_UNIT_TEST(registration_session, queue_mode_notifications) {
     HANDLE_UPDATE(update);
 }
 
+ANJ_UNIT_TEST(registration_session, poll_info) {
+    EXTENDED_INIT();
+    anj_core_poll_info_t info;
+
+    // Register message sent, waiting for the response or retransmission
+    anj_core_step(&anj);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_TRUE(info.system_socket == &mock);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, ANJ_CORE_POLL_IN);
+    ANJ_UNIT_ASSERT_TRUE(info.timeout_ms >= 2000 && info.timeout_ms <= 3000);
+    ADD_RESPONSE(register_response);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_REGISTERED);
+
+    // lifetime is 150 so next update should be sent after 75 seconds
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_TRUE(info.system_socket == &mock);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, ANJ_CORE_POLL_IN);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, 75 * 1000);
+    // anj_core_next_step_time() doesn't cover the registered state
+    ANJ_UNIT_ASSERT_EQUAL(anj_core_next_step_time(&anj), 0);
+
+    uint64_t actual_time_s = 10;
+    set_mock_time(actual_time_s);
+    anj_core_step(&anj);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, (75 - 10) * 1000);
+
+    anj_core_request_update(&anj);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, 0);
+
+    // Update can't be sent, wait until it is possible
+    mock.bytes_to_send = 0;
+    mock.call_result[ANJ_NET_FUN_SEND] = ANJ_NET_EAGAIN;
+    anj_core_step(&anj);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_TRUE(info.system_socket == &mock);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, ANJ_CORE_POLL_OUT);
+    ANJ_UNIT_ASSERT_TRUE(info.timeout_ms > 0);
+    mock.bytes_to_send = 100;
+    mock.call_result[ANJ_NET_FUN_SEND] = 0;
+    anj_core_step(&anj);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, ANJ_CORE_POLL_IN);
+    ANJ_UNIT_ASSERT_TRUE(info.timeout_ms >= 2000 && info.timeout_ms <= 3000);
+}
+
+ANJ_UNIT_TEST(registration_session, poll_info_queue_mode) {
+    // lifetime is set to 150 so next update should be sent after 75 seconds
+    // queue mode timeout is 50 seconds
+    EXTENDED_INIT_WITH_QUEUE_MODE((50 * 1000));
+    PROCESS_REGISTRATION();
+    anj_core_poll_info_t info;
+
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, ANJ_CORE_POLL_IN);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, 50 * 1000 + 1);
+
+    // connection is closed in queue mode, only the Update is awaited
+    uint64_t actual_time_s = 55;
+    set_mock_time(actual_time_s);
+    anj_core_step(&anj);
+    ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status,
+                          ANJ_CONN_STATUS_QUEUE_MODE);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_NULL(info.system_socket);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, 0);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, (75 - 55) * 1000);
+    ANJ_UNIT_ASSERT_EQUAL(anj_core_next_step_time(&anj), info.timeout_ms);
+
+    // client suspended, nothing to do until the server is enabled again
+    anj_core_disable_server(&anj, 30 * 1000);
+    HANDLE_DEREGISTER(deregistrer_response);
+    anj_core_poll_info(&anj, &info);
+    ANJ_UNIT_ASSERT_NULL(info.system_socket);
+    ANJ_UNIT_ASSERT_EQUAL(info.events, 0);
+    ANJ_UNIT_ASSERT_EQUAL(info.timeout_ms, 30 * 1000);
+}
+
 static char observe_request_no_attributes[] =
         "\x42"         // header v 0x01, Confirmable, tkl 8
         "\x01\x11\x21" // GET code 0.1
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/compat/net/anj_net_api.h>
+#include <anj/core.h>
+#include <anj/defs.h>
+#include <anj/dm/core.h>
+#include <anj/dm/security_object.h>
+#include <anj/dm/server_object.h>
+#include <anj/utils.h>
+
+#include "net_api_mock.h"
+#include "time_api_mock.h"
+
+#include <anj_unit_test.h>
+
+#ifdef ANJ_WITH_RESPONSE_CACHE
+
+static int g_execute_counter;
+
+static int res_execute(anj_t *anj,
+                       const anj_dm_obj_t *obj,
+                       anj_iid_t iid,
+                       anj_rid_t rid,
+                       const char *execute_arg,
+                       size_t execute_arg_len) {
+    (void) anj;
+    (void) obj;
+    (void) iid;
+    (void) rid;
+    (void) execute_arg;
+    (void) execute_arg_len;
+    g_execute_counter++;
+    return 0;
+}
+
+static anj_dm_handlers_t handlers = {
+    .res_execute = res_execute
+};
+
+static anj_dm_res_t res[] = {
+    {
+        .rid = 0,
+        .operation = ANJ_DM_RES_E
+    }
+};
+
+static anj_dm_obj_inst_t obj_insts[] = {
+    {
+        .iid = 0,
+        .res_count = 1,
+        .resources = res
+    }
+};
+
+static anj_dm_obj_t obj = {
+    .oid = 10,
+    .insts = obj_insts,
+    .handlers = &handlers,
+    .max_inst_count = 1
+};
+
+// lifetime is long enough to not trigger Update during the tests
+#    define TEST_INIT()                                                 \
+        g_execute_counter = 0;                                          \
+        set_mock_time(0);                                               \
+        net_api_mock_t mock = { 0 };                                    \
+        net_api_mock_ctx_init(&mock);                                   \
+        mock.bytes_to_send = 500;                                       \
+        mock.inner_mtu_value = 1000;                                    \
+        anj_t anj;                                                      \
+        anj_configuration_t config = {                                  \
+            .endpoint_name = "name"                                     \
+        };                                                              \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_core_init(&anj, &config));          \
+        anj_dm_security_obj_t sec_obj;                                  \
+        anj_dm_security_obj_init(&sec_obj);                             \
+        anj_dm_server_obj_t ser_obj;                                    \
+        anj_dm_server_obj_init(&ser_obj);                               \
+        const anj_iid_t iid = 1;                                        \
+        anj_dm_security_instance_init_t sec_inst = {                    \
+            .server_uri = "coap://server.com:5683",                     \
+            .ssid = 2,                                                  \
+            .iid = &iid                                                 \
+        };                                                              \
+        anj_dm_server_instance_init_t ser_inst = {                      \
+            .ssid = 2,                                                  \
+            .lifetime = 10000,                                          \
+            .binding = "U",                                             \
+            .iid = &iid                                                 \
+        };                                                              \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_security_obj_add_instance(&sec_obj, &sec_inst)); \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_security_obj_install(&anj, &sec_obj));           \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_server_obj_add_instance(&ser_obj, &ser_inst));   \
+        ANJ_UNIT_ASSERT_SUCCESS(                                        \
+                anj_dm_server_obj_install(&anj, &ser_obj));             \
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_add_obj(&anj, &obj))
+
+static char register_response[] =
+        "\x68"                             // header v 0x01, Ack, tkl 8
+        "\x41\x00\x00"                     // CREATED code 2.1
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" // token
+        "\x82\x72\x64"                     // location-path /rd
+        "\x04\x35\x61\x33\x66";            // location-path 8 /5a3f
+
+static char deregister_response[] =
+        "\x68"                              // header v 0x01, Ack, tkl 8
+        "\x42\x00\x00"                      // DELETED code 2.2
+        "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF"; // token
+
+// token and message id are copied from request stored in anj.exchange_ctx
+#    define ADD_RESPONSE(Response)                                        \
+        memcpy(&Response[4], anj.exchange_ctx.base_msg.token.bytes, 8);   \
+        Response[2] = (char) (anj.exchange_ctx.base_msg.coap_binding_data \
+                                      .udp.message_id                     \
+                              >> 8);                                      \
+        Response[3] = (char) (anj.exchange_ctx.base_msg.coap_binding_data \
+                                      .udp.message_id                     \
+                              & 0xFF);                                    \
+        mock.bytes_to_recv = sizeof(Response) - 1;                        \
+        mock.data_to_recv = (uint8_t *) Response
+
+#    define PROCESS_REGISTRATION()                          \
+        anj_core_step(&anj);                                \
+        ADD_RESPONSE(register_response);                    \
+        anj_core_step(&anj);                                \
+        ANJ_UNIT_ASSERT_EQUAL(anj.server_state.conn_status, \
+                              ANJ_CONN_STATUS_REGISTERED);  \
+        anj_core_step(&anj);                                \
+        mock.bytes_sent = 0
+
+#    define ADD_REQUEST(Request)                  \
+        mock.bytes_to_recv = sizeof(Request) - 1; \
+        mock.data_to_recv = (uint8_t *) Request
+
+#    define CHECK_RESPONSE(Response)                                  \
+        ANJ_UNIT_ASSERT_EQUAL(sizeof(Response) - 1, mock.bytes_sent); \
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(                            \
+                mock.send_data_buffer, Response, mock.bytes_sent);    \
+        mock.bytes_sent = 0
+
+static char execute_request[] = "\x42"         // header v 0x01, Confirmable
+                                "\x02\x11\x55" // POST code 0.2
+                                "\x12\x77"     // token
+                                "\xB2\x31\x30" // URI_PATH 11 /10
+                                "\x01\x30"     //            /0
+                                "\x01\x30";    //            /0
+static char execute_response[] = "\x62"         // ACK, tkl 3
+                                 "\x44\x11\x55" // Changed code 2.04
+                                 "\x12\x77";    // token
+
+ANJ_UNIT_TEST(response_cache, duplicated_request) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 1);
+    ANJ_UNIT_ASSERT_FALSE(anj_core_ongoing_operation(&anj));
+
+    // response got lost, LwM2M Server retransmits the request
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 1);
+    ANJ_UNIT_ASSERT_FALSE(anj_core_ongoing_operation(&anj));
+
+    // the same message ID with different token is a new request
+    execute_request[5] = 0x78;
+    execute_response[5] = 0x78;
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 2);
+    execute_request[5] = 0x77;
+    execute_response[5] = 0x77;
+}
+
+ANJ_UNIT_TEST(response_cache, entry_expired) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 1);
+
+    // EXCHANGE_LIFETIME for default transmission parameters is 247 s
+    set_mock_time(246);
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 1);
+
+    // message ID can be reused by the LwM2M Server, request is processed again
+    set_mock_time(248);
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 2);
+}
+
+ANJ_UNIT_TEST(response_cache, cleared_on_new_registration) {
+    TEST_INIT();
+    PROCESS_REGISTRATION();
+
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 1);
+
+    // De-register is sent before the new registration
+    anj_core_restart(&anj);
+    anj_core_step(&anj);
+    ADD_RESPONSE(deregister_response);
+    anj_core_step(&anj);
+    PROCESS_REGISTRATION();
+    ADD_REQUEST(execute_request);
+    anj_core_step(&anj);
+    CHECK_RESPONSE(execute_response);
+    ANJ_UNIT_ASSERT_EQUAL(g_execute_counter, 2);
+}
+
+#endif // ANJ_WITH_RESPONSE_CACHE
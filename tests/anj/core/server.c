@@ -273,29 +273,35 @@ ANJ_UNIT_TEST(server, recv) {
                                                 "localhost", "9998", true));
 
     uint8_t buffer[20] = { 0 };
+    uint8_t *out_msg;
     size_t out_length;
 
     mock.bytes_to_recv = 10;
     mock.data_to_recv = (uint8_t *) "1234567890";
 
     mock.call_result[ANJ_NET_FUN_RECV] = ANJ_NET_EAGAIN;
-    ANJ_UNIT_ASSERT_EQUAL(_anj_server_receive(&ctx, buffer, &out_length, 20),
-                          ANJ_NET_EAGAIN);
+    ANJ_UNIT_ASSERT_EQUAL(
+            _anj_server_receive(&ctx, buffer, &out_msg, &out_length, 20),
+            ANJ_NET_EAGAIN);
     ANJ_UNIT_ASSERT_EQUAL(out_length, 0);
 
     mock.call_result[ANJ_NET_FUN_RECV] = ANJ_NET_EMSGSIZE;
-    ANJ_UNIT_ASSERT_EQUAL(_anj_server_receive(&ctx, buffer, &out_length, 20),
-                          ANJ_NET_EAGAIN);
+    ANJ_UNIT_ASSERT_EQUAL(
+            _anj_server_receive(&ctx, buffer, &out_msg, &out_length, 20),
+            ANJ_NET_EAGAIN);
     ANJ_UNIT_ASSERT_EQUAL(out_length, 0);
 
     mock.call_result[ANJ_NET_FUN_RECV] = -88;
-    ANJ_UNIT_ASSERT_EQUAL(_anj_server_receive(&ctx, buffer, &out_length, 20),
-                          -88);
+    ANJ_UNIT_ASSERT_EQUAL(
+            _anj_server_receive(&ctx, buffer, &out_msg, &out_length, 20),
+            -88);
     ANJ_UNIT_ASSERT_EQUAL(out_length, 0);
 
     mock.call_result[ANJ_NET_FUN_RECV] = ANJ_NET_OK;
-    ANJ_UNIT_ASSERT_SUCCESS(_anj_server_receive(&ctx, buffer, &out_length, 20));
+    ANJ_UNIT_ASSERT_SUCCESS(
+            _anj_server_receive(&ctx, buffer, &out_msg, &out_length, 20));
     ANJ_UNIT_ASSERT_EQUAL(out_length, 10);
+    ANJ_UNIT_ASSERT_TRUE(out_msg == buffer);
     ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(buffer, "1234567890", 10);
 }
 
@@ -275,3 +275,104 @@ ANJ_UNIT_TEST(dm, add_obj_check_error_max_allowed_res_insts_number) {
     inst_2_res[2].insts = res_insts;
     ANJ_UNIT_ASSERT_SUCCESS(_anj_dm_check_obj(&obj));
 }
+
+#define LOOKUP_TEST_INST_SLOTS 64
+#define LOOKUP_TEST_INST_COUNT 50
+#define LOOKUP_TEST_RES_COUNT 30
+#define LOOKUP_TEST_RES_INST_SLOTS 16
+#define LOOKUP_TEST_RES_INST_COUNT 11
+
+static anj_riid_t lookup_res_insts[LOOKUP_TEST_RES_INST_SLOTS];
+static anj_dm_res_t lookup_res[LOOKUP_TEST_RES_COUNT];
+static anj_dm_obj_inst_t lookup_insts[LOOKUP_TEST_INST_SLOTS];
+
+static void init_lookup_obj(anj_dm_obj_t *lookup_obj) {
+    // RIIDs: 1, 3, 5, ..., unused slots set to ANJ_ID_INVALID
+    for (uint16_t i = 0; i < LOOKUP_TEST_RES_INST_SLOTS; i++) {
+        lookup_res_insts[i] = i < LOOKUP_TEST_RES_INST_COUNT
+                                      ? (anj_riid_t) (2 * i + 1)
+                                      : ANJ_ID_INVALID;
+    }
+    // RIDs: 0, 3, 6, ..., last one is multi-instance
+    for (uint16_t i = 0; i < LOOKUP_TEST_RES_COUNT; i++) {
+        lookup_res[i] = (anj_dm_res_t) {
+            .rid = (anj_rid_t) (3 * i),
+            .operation = ANJ_DM_RES_R,
+            .type = ANJ_DATA_TYPE_INT
+        };
+    }
+    lookup_res[LOOKUP_TEST_RES_COUNT - 1].operation = ANJ_DM_RES_RM;
+    lookup_res[LOOKUP_TEST_RES_COUNT - 1].insts = lookup_res_insts;
+    lookup_res[LOOKUP_TEST_RES_COUNT - 1].max_inst_count =
+            LOOKUP_TEST_RES_INST_SLOTS;
+    // IIDs: 0, 2, 4, ..., unused slots set to ANJ_ID_INVALID
+    for (uint16_t i = 0; i < LOOKUP_TEST_INST_SLOTS; i++) {
+        lookup_insts[i] = (anj_dm_obj_inst_t) {
+            .iid = i < LOOKUP_TEST_INST_COUNT ? (anj_iid_t) (2 * i)
+                                              : ANJ_ID_INVALID,
+            .resources = lookup_res,
+            .res_count = LOOKUP_TEST_RES_COUNT
+        };
+    }
+    *lookup_obj = (anj_dm_obj_t) {
+        .oid = 3303,
+        .insts = lookup_insts,
+        .max_inst_count = LOOKUP_TEST_INST_SLOTS,
+        .handlers = &handlers
+    };
+}
+
+ANJ_UNIT_TEST(dm, entity_lookup_large_tables) {
+    anj_t anj = { 0 };
+    _anj_dm_initialize(&anj);
+
+    anj_dm_obj_t lookup_obj;
+    init_lookup_obj(&lookup_obj);
+    anj_dm_obj_t other_objs[] = { { .oid = 1 }, { .oid = 3 }, { .oid = 5 } };
+    for (size_t i = 0; i < ANJ_ARRAY_SIZE(other_objs); i++) {
+        ANJ_UNIT_ASSERT_SUCCESS(anj_dm_add_obj(&anj, &other_objs[i]));
+    }
+    ANJ_UNIT_ASSERT_SUCCESS(anj_dm_add_obj(&anj, &lookup_obj));
+
+    ANJ_UNIT_ASSERT_TRUE(_anj_dm_find_obj(&anj.dm, 1) == &other_objs[0]);
+    ANJ_UNIT_ASSERT_TRUE(_anj_dm_find_obj(&anj.dm, 5) == &other_objs[2]);
+    ANJ_UNIT_ASSERT_TRUE(_anj_dm_find_obj(&anj.dm, 3303) == &lookup_obj);
+    ANJ_UNIT_ASSERT_NULL(_anj_dm_find_obj(&anj.dm, 0));
+    ANJ_UNIT_ASSERT_NULL(_anj_dm_find_obj(&anj.dm, 4));
+    ANJ_UNIT_ASSERT_NULL(_anj_dm_find_obj(&anj.dm, 3304));
+
+    _anj_dm_entity_ptrs_t ptrs;
+    for (uint16_t iid = 0; iid < 2 * LOOKUP_TEST_INST_SLOTS; iid++) {
+        int res = _anj_dm_get_entity_ptrs(
+                &anj.dm, &ANJ_MAKE_INSTANCE_PATH(3303, iid), &ptrs);
+        if (iid % 2 == 0 && iid / 2 < LOOKUP_TEST_INST_COUNT) {
+            ANJ_UNIT_ASSERT_SUCCESS(res);
+            ANJ_UNIT_ASSERT_TRUE(ptrs.inst == &lookup_insts[iid / 2]);
+        } else {
+            ANJ_UNIT_ASSERT_EQUAL(res, ANJ_DM_ERR_NOT_FOUND);
+        }
+    }
+    for (uint16_t rid = 0; rid < 3 * LOOKUP_TEST_RES_COUNT + 3; rid++) {
+        int res = _anj_dm_get_entity_ptrs(
+                &anj.dm, &ANJ_MAKE_RESOURCE_PATH(3303, 98, rid), &ptrs);
+        if (rid % 3 == 0 && rid / 3 < LOOKUP_TEST_RES_COUNT) {
+            ANJ_UNIT_ASSERT_SUCCESS(res);
+            ANJ_UNIT_ASSERT_TRUE(ptrs.res == &lookup_res[rid / 3]);
+        } else {
+            ANJ_UNIT_ASSERT_EQUAL(res, ANJ_DM_ERR_NOT_FOUND);
+        }
+    }
+    anj_rid_t multi_rid = 3 * (LOOKUP_TEST_RES_COUNT - 1);
+    for (uint16_t riid = 0; riid < 2 * LOOKUP_TEST_RES_INST_SLOTS; riid++) {
+        int res = _anj_dm_get_entity_ptrs(
+                &anj.dm,
+                &ANJ_MAKE_RESOURCE_INSTANCE_PATH(3303, 0, multi_rid, riid),
+                &ptrs);
+        if (riid % 2 == 1 && riid / 2 < LOOKUP_TEST_RES_INST_COUNT) {
+            ANJ_UNIT_ASSERT_SUCCESS(res);
+            ANJ_UNIT_ASSERT_EQUAL(ptrs.riid, riid);
+        } else {
+            ANJ_UNIT_ASSERT_EQUAL(res, ANJ_DM_ERR_NOT_FOUND);
+        }
+    }
+}
@@ -68,6 +68,12 @@ static int inst_delete(anj_t *anj, const anj_dm_obj_t *obj, anj_iid_t iid) {
 }
 
 static char res_4_buff[100] = { 0 };
+// if set, every read of Resource 0 returns a longer value than the previous one
+static bool res_0_volatile;
+static int64_t res_0_volatile_value;
+// if set, Resource 4 is a string that gets longer with every read
+static bool res_4_volatile;
+static size_t res_4_volatile_length;
 static int res_read(anj_t *anj,
                     const anj_dm_obj_t *obj,
                     anj_iid_t iid,
@@ -78,12 +84,21 @@ static int res_read(anj_t *anj,
     (void) iid;
     (void) riid;
     (void) out_value;
-    if (rid == 4) {
+    if (rid == 4 && res_4_volatile) {
+        static const char volatile_value[] = "abcdefgh";
+        res_4_volatile_length++;
+        out_value->bytes_or_string.data =
+                &volatile_value[sizeof(volatile_value) - 1
+                                - res_4_volatile_length];
+    } else if (rid == 4) {
         out_value->bytes_or_string.data = res_4_buff;
     } else if (riid == 1 && obj->oid != 222) {
         out_value->int_value = 6;
     } else if (riid == 2) {
         out_value->int_value = 7;
+    } else if (rid == 0 && res_0_volatile) {
+        res_0_volatile_value = res_0_volatile_value * 1000 + 1;
+        out_value->int_value = res_0_volatile_value;
     } else if (rid == 0) {
         out_value->int_value = (iid == 1) ? 1 : 3;
     } else if (rid == 1) {
@@ -841,6 +856,112 @@ ANJ_UNIT_TEST(dm_integration, empty_read_lwm2m_cbor) {
     obj_1_insts[0].res_count = 2;
 }
 
+#ifdef ANJ_WITH_TLV
+ANJ_UNIT_TEST(dm_integration, read_operation_tlv) {
+    SET_UP();
+    msg.operation = ANJ_OP_DM_READ;
+    msg.accept = _ANJ_COAP_FORMAT_OMA_LWM2M_TLV;
+    msg.uri = ANJ_MAKE_OBJECT_PATH(111);
+    PROCESS_REQUEST(false)
+    char expected[] = "\x61"             // ACK, tkl 1
+                      "\x45\x11\x11\x01" // content, msg_id token
+                      "\xC2\x2D\x16"     // content_format: tlv
+                      "\xFF"
+                      "\x08\x01\x0B"                                 // /1
+                      "\xC8\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01" // /1/0: 1
+                      "\x08\x02\x26"                                 // /2
+                      "\xC8\x00\x08\x00\x00\x00\x00\x00\x00\x00\x03" // /2/0: 3
+                      "\x88\x02\x16"                                 // /2/2
+                      "\x48\x01\x08\x00\x00\x00\x00\x00\x00\x00\x06" // /2/2/1
+                      "\x48\x02\x08\x00\x00\x00\x00\x00\x00\x00\x07" // /2/2/2
+                      "\xC0\x04";                                    // /2/4: ""
+    verify_payload(expected, sizeof(expected) - 1, &msg);
+}
+
+ANJ_UNIT_TEST(dm_integration, read_operation_tlv_block) {
+    SET_UP();
+    msg.operation = ANJ_OP_DM_READ;
+    msg.accept = _ANJ_COAP_FORMAT_OMA_LWM2M_TLV;
+    msg.uri = ANJ_MAKE_OBJECT_PATH(111);
+    payload_len = 32;
+    PROCESS_REQUEST_BLOCK();
+    char expected[] = "\x61"             // ACK, tkl 1
+                      "\x45\x11\x11\x01" // content, msg_id token
+                      "\xC2\x2D\x16"     // content_format: tlv
+                      "\xB1\x09"         // block2 0, size 32, more
+                      "\xFF"
+                      "\x08\x01\x0B\xC8\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01"
+                      "\x08\x02\x26\xC8\x00\x08\x00\x00\x00\x00\x00\x00\x00\x03"
+                      "\x88\x02\x16\x48";
+    verify_payload(expected, sizeof(expected) - 1, &msg);
+
+    msg.operation = ANJ_OP_DM_READ;
+    msg.payload_size = 0;
+    msg.block.number++;
+    msg.coap_binding_data.udp.message_id++;
+    ANJ_UNIT_ASSERT_EQUAL(_anj_exchange_process(&exchange_ctx,
+                                                ANJ_EXCHANGE_EVENT_NEW_MSG,
+                                                &msg),
+                          ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ANJ_UNIT_ASSERT_EQUAL(
+            _anj_exchange_process(&exchange_ctx,
+                                  ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION, &msg),
+            ANJ_EXCHANGE_STATE_FINISHED);
+    char expected2[] = "\x61"             // ACK, tkl 1
+                       "\x45\x11\x12\x01" // content, msg_id token
+                       "\xC2\x2D\x16"     // content_format: tlv
+                       "\xB1\x11"         // block2 1, size 32
+                       "\xFF"
+                       "\x01\x08\x00\x00\x00\x00\x00\x00\x00\x06"
+                       "\x48\x02\x08\x00\x00\x00\x00\x00\x00\x00\x07\xC0\x04";
+    verify_payload(expected2, sizeof(expected2) - 1, &msg);
+}
+
+// lengths of nested TLV records are calculated with an additional read, numeric
+// values are encoded on 8 bytes so that it doesn't matter if they change
+ANJ_UNIT_TEST(dm_integration, read_operation_tlv_value_changed) {
+    SET_UP();
+    res_0_volatile = true;
+    res_0_volatile_value = 0;
+    msg.operation = ANJ_OP_DM_READ;
+    msg.accept = _ANJ_COAP_FORMAT_OMA_LWM2M_TLV;
+    msg.uri = ANJ_MAKE_OBJECT_PATH(111);
+    PROCESS_REQUEST(false);
+    res_0_volatile = false;
+    char expected[] = "\x61"             // ACK, tkl 1
+                      "\x45\x11\x11\x01" // content, msg_id token
+                      "\xC2\x2D\x16"     // content_format: tlv
+                      "\xFF"
+                      "\x08\x01\x0B"                                 // /1
+                      "\xC8\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01" // /1/0
+                      "\x08\x02\x26"                                 // /2
+                      "\xC8\x00\x08\x00\x00\x00\x00\x00\x0F\x46\x29" // /2/0
+                      "\x88\x02\x16"                                 // /2/2
+                      "\x48\x01\x08\x00\x00\x00\x00\x00\x00\x00\x06" // /2/2/1
+                      "\x48\x02\x08\x00\x00\x00\x00\x00\x00\x00\x07" // /2/2/2
+                      "\xC0\x04";                                    // /2/4: ""
+    verify_payload(expected, sizeof(expected) - 1, &msg);
+}
+
+// strings can't be padded, so a changed length is still an error
+ANJ_UNIT_TEST(dm_integration, read_operation_tlv_length_changed) {
+    SET_UP();
+    res_4_volatile = true;
+    res_4_volatile_length = 0;
+    msg.operation = ANJ_OP_DM_READ;
+    msg.accept = _ANJ_COAP_FORMAT_OMA_LWM2M_TLV;
+    msg.uri = ANJ_MAKE_OBJECT_PATH(111);
+    PROCESS_REQUEST_WITH_ERROR(ANJ_COAP_CODE_INTERNAL_SERVER_ERROR);
+    res_4_volatile = false;
+    // mismatch is detected while building the payload, after 2.05 Content was
+    // already chosen as the response code
+    char expected[] = "\x61"              // ACK, tkl 1
+                      "\xA0\x11\x11\x01"; // internal server error, msg_id token
+    verify_payload(expected, sizeof(expected) - 1, &msg);
+    ANJ_UNIT_ASSERT_EQUAL(anj.dm.op_in_progress, false);
+}
+#endif // ANJ_WITH_TLV
+
 #ifdef ANJ_WITH_COMPOSITE_OPERATIONS
 ANJ_UNIT_TEST(dm_integration, read_composite) {
     SET_UP();
@@ -2133,6 +2254,7 @@ ANJ_UNIT_TEST(dm_integration, delete_operation_with_observation_removed) {
     anj.observe_ctx.observations[4].path = ANJ_MAKE_INSTANCE_PATH(222, 0);
     anj.observe_ctx.observations[4].observe_active = true;
     anj.observe_ctx.observations[4].prev = &anj.observe_ctx.observations[4];
+    anj.observe_ctx.path_index_valid = false;
 
     obj_2_insts[1].iid = 1;
     obj_2_insts[0].iid = 0;
@@ -2171,6 +2293,7 @@ ANJ_UNIT_TEST(dm_integration, create_with_write_with_observation_set_to_send) {
     anj.observe_ctx.observations[3].ssid = 2;
     anj.observe_ctx.observations[3].path = ANJ_MAKE_OBJECT_PATH(222);
     anj.observe_ctx.observations[3].observe_active = true;
+    anj.observe_ctx.path_index_valid = false;
     obj_2_insts[1].res_count++;
 
     msg.content_format = _ANJ_COAP_FORMAT_NOT_DEFINED;
@@ -2219,6 +2342,7 @@ ANJ_UNIT_TEST(dm_integration, write_replace_operation_with_observation_update) {
     anj.observe_ctx.observations[4].ssid = 1;
     anj.observe_ctx.observations[4].path = ANJ_MAKE_RESOURCE_PATH(111, 1, 1);
     anj.observe_ctx.observations[4].observe_active = true;
+    anj.observe_ctx.path_index_valid = false;
 
     msg.content_format = _ANJ_COAP_FORMAT_OMA_LWM2M_TLV;
     msg.operation = ANJ_OP_DM_WRITE_REPLACE;
@@ -2274,6 +2398,7 @@ ANJ_UNIT_TEST(
     anj.observe_ctx.observations[4].path =
             ANJ_MAKE_RESOURCE_INSTANCE_PATH(111, 2, 2, 2);
     anj.observe_ctx.observations[4].prev = &anj.observe_ctx.observations[1];
+    anj.observe_ctx.path_index_valid = false;
 
     msg.content_format = _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
     msg.operation = ANJ_OP_DM_WRITE_REPLACE;
@@ -2326,6 +2451,7 @@ ANJ_UNIT_TEST(
     anj.observe_ctx.observations[3].path = ANJ_MAKE_INSTANCE_PATH(111, 1);
     anj.observe_ctx.observations[4].path =
             ANJ_MAKE_RESOURCE_INSTANCE_PATH(111, 2, 2, 2);
+    anj.observe_ctx.path_index_valid = false;
 
     msg.content_format = _ANJ_COAP_FORMAT_OMA_LWM2M_CBOR;
     msg.operation = ANJ_OP_DM_WRITE_PARTIAL_UPDATE;
@@ -2372,6 +2498,7 @@ ANJ_UNIT_TEST(dm_integration, delete_object_observation_update) {
     anj.observe_ctx.observations[3].ssid = 1;
     anj.observe_ctx.observations[3].path = ANJ_MAKE_INSTANCE_PATH(222, 1);
     anj.observe_ctx.observations[3].observe_active = true;
+    anj.observe_ctx.path_index_valid = false;
 
     ANJ_UNIT_ASSERT_SUCCESS(anj_dm_remove_obj(&anj, 111));
     ANJ_UNIT_ASSERT_EQUAL(anj.observe_ctx.observations[0].ssid, 0);
@@ -0,0 +1,267 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ANJ_UNIT_ENABLE_SHORT_ASSERTS
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+
+#include "../../src/anj/coap/coap.h"
+#include "../../src/anj/exchange.h"
+#include "exchange_internal.h"
+
+#include <anj_unit_test.h>
+
+#ifdef ANJ_WITH_ADAPTIVE_RTO
+
+// Link with constant RTT, every loss_interval-th request is lost (0 means that
+// there are no losses). Responses are never lost, so a retransmission sent
+// while the response to one of the previous transmissions is on its way is
+// spurious.
+typedef struct {
+    uint64_t rtt_ms;
+    size_t loss_interval;
+    // emulates static ACK_TIMEOUT, by discarding the estimate before each
+    // exchange
+    bool static_rto;
+} link_t;
+
+typedef struct {
+    uint64_t now;
+    size_t transmissions;
+    size_t completed;
+    size_t timeouts;
+    size_t retransmissions;
+    size_t spurious_retransmissions;
+} link_stats_t;
+
+static void run_exchange(_anj_exchange_ctx_t *ctx,
+                         const link_t *link,
+                         link_stats_t *stats) {
+    uint8_t payload[16];
+    _anj_coap_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.operation = ANJ_OP_INF_CON_SEND;
+    _anj_exchange_handlers_t handlers = { 0 };
+    if (link->static_rto) {
+        _anj_exchange_reset_rto(ctx);
+    }
+    set_mock_time(stats->now);
+    ASSERT_EQ(_anj_exchange_new_client_request(ctx, &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint64_t response_time = UINT64_MAX;
+    while (true) {
+        ASSERT_EQ(_anj_exchange_process(ctx,
+                                        ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                        &msg),
+                  ANJ_EXCHANGE_STATE_WAITING_MSG);
+        if (response_time != UINT64_MAX) {
+            stats->spurious_retransmissions++;
+        }
+        stats->transmissions++;
+        if (!link->loss_interval
+                || stats->transmissions % link->loss_interval) {
+            response_time =
+                    ANJ_MIN(response_time, stats->now + link->rtt_ms);
+        }
+
+        uint64_t timeout = _anj_exchange_next_timeout(ctx);
+        if (response_time <= timeout) {
+            stats->now = response_time;
+            set_mock_time(stats->now);
+            _anj_coap_msg_t response = msg;
+            response.operation = ANJ_OP_RESPONSE;
+            response.msg_code = ANJ_COAP_CODE_CHANGED;
+            response.payload_size = 0;
+            ASSERT_EQ(_anj_exchange_process(ctx, ANJ_EXCHANGE_EVENT_NEW_MSG,
+                                            &response),
+                      ANJ_EXCHANGE_STATE_FINISHED);
+            stats->completed++;
+            return;
+        }
+        stats->now = timeout;
+        set_mock_time(stats->now);
+        if (_anj_exchange_process(ctx, ANJ_EXCHANGE_EVENT_NONE, &msg)
+                == ANJ_EXCHANGE_STATE_FINISHED) {
+            stats->timeouts++;
+            return;
+        }
+        stats->retransmissions++;
+    }
+}
+
+// Sends confirmable requests back to back for the given time.
+static void run_link(_anj_exchange_ctx_t *ctx,
+                     const link_t *link,
+                     uint64_t duration_ms,
+                     link_stats_t *stats) {
+    uint64_t end = stats->now + duration_ms;
+    while (stats->now < end) {
+        run_exchange(ctx, link, stats);
+    }
+}
+
+ANJ_UNIT_TEST(adaptive_rto, long_rtt_no_spurious_retransmissions) {
+    set_mock_time(0);
+    // RTT longer than the initial timeout of RFC 7252 (2 to 3 seconds)
+    link_t link = {
+        .rtt_ms = 4000
+    };
+    _anj_exchange_ctx_t ctx;
+
+    link.static_rto = true;
+    link_stats_t static_stats = { 0 };
+    _anj_exchange_init(&ctx, 0);
+    run_link(&ctx, &link, 600000, &static_stats);
+    // every request is sent twice
+    ASSERT_EQ(static_stats.spurious_retransmissions, static_stats.completed);
+
+    // weak estimates, coming from the retransmitted requests, converge
+    // within a few exchanges
+    link.static_rto = false;
+    link_stats_t stats = { 0 };
+    _anj_exchange_init(&ctx, 0);
+    run_link(&ctx, &link, 60000, &stats);
+    ASSERT_TRUE(stats.spurious_retransmissions > 0);
+    ASSERT_TRUE(stats.spurious_retransmissions < 5);
+    ASSERT_TRUE(ctx.rto.rto_ms > link.rtt_ms);
+
+    link_stats_t steady_stats = {
+        .now = stats.now
+    };
+    run_link(&ctx, &link, 600000, &steady_stats);
+    ASSERT_EQ(steady_stats.spurious_retransmissions, 0);
+    ASSERT_EQ(steady_stats.timeouts, 0);
+    ASSERT_TRUE(steady_stats.completed >= static_stats.completed);
+}
+
+ANJ_UNIT_TEST(adaptive_rto, short_rtt_fast_loss_recovery) {
+    set_mock_time(0);
+    link_t link = {
+        .rtt_ms = 80,
+        .loss_interval = 5
+    };
+    _anj_exchange_ctx_t ctx;
+
+    link.static_rto = true;
+    link_stats_t static_stats = { 0 };
+    _anj_exchange_init(&ctx, 0);
+    run_link(&ctx, &link, 600000, &static_stats);
+
+    link.static_rto = false;
+    link_stats_t stats = { 0 };
+    _anj_exchange_init(&ctx, 0);
+    run_link(&ctx, &link, 600000, &stats);
+
+    // losses are detected within hundreds of milliseconds instead of seconds
+    ASSERT_TRUE(ctx.rto.rto_ms < 1000);
+    ASSERT_TRUE(stats.completed > 3 * static_stats.completed);
+    ASSERT_EQ(stats.timeouts, 0);
+    ASSERT_EQ(stats.spurious_retransmissions, 0);
+}
+
+ANJ_UNIT_TEST(adaptive_rto, rtt_increase) {
+    set_mock_time(0);
+    link_t link = {
+        .rtt_ms = 100
+    };
+    _anj_exchange_ctx_t ctx;
+    _anj_exchange_init(&ctx, 0);
+    link_stats_t stats = { 0 };
+    run_link(&ctx, &link, 60000, &stats);
+    ASSERT_TRUE(ctx.rto.rto_ms < 1000);
+
+    // responses to requests retransmitted more than twice don't update the
+    // estimate, RTO aging makes it grow until they do
+    link.rtt_ms = 6000;
+    run_link(&ctx, &link, 600000, &stats);
+    ASSERT_EQ(stats.timeouts, 0);
+    size_t spurious_retransmissions = stats.spurious_retransmissions;
+    run_link(&ctx, &link, 600000, &stats);
+    ASSERT_EQ(stats.spurious_retransmissions, spurious_retransmissions);
+}
+
+ANJ_UNIT_TEST(adaptive_rto, aging) {
+    set_mock_time(0);
+    link_t link = {
+        .rtt_ms = 100
+    };
+    _anj_exchange_ctx_t ctx;
+    _anj_exchange_init(&ctx, 0);
+    link_stats_t stats = { 0 };
+    run_link(&ctx, &link, 60000, &stats);
+    uint64_t rto_ms = ctx.rto.rto_ms;
+    ASSERT_TRUE(rto_ms < 1000);
+
+    // estimate that is not updated for 16 * RTO is doubled
+    stats.now += 16 * rto_ms + 1;
+    uint8_t payload[16];
+    _anj_coap_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.operation = ANJ_OP_INF_CON_SEND;
+    _anj_exchange_handlers_t handlers = { 0 };
+    set_mock_time(stats.now);
+    ASSERT_EQ(_anj_exchange_new_client_request(&ctx, &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ASSERT_EQ(ctx.rto.rto_ms, 2 * rto_ms);
+    _anj_exchange_terminate(&ctx);
+
+    // large estimate is moved back towards 1 s
+    ctx.rto.rto_ms = 10000;
+    ctx.rto.last_update_timestamp_ms = stats.now;
+    stats.now += 40001;
+    set_mock_time(stats.now);
+    memset(&msg, 0, sizeof(msg));
+    msg.operation = ANJ_OP_INF_CON_SEND;
+    ASSERT_EQ(_anj_exchange_new_client_request(&ctx, &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ASSERT_EQ(ctx.rto.rto_ms, 6000);
+    _anj_exchange_terminate(&ctx);
+}
+
+ANJ_UNIT_TEST(adaptive_rto, variable_backoff) {
+    set_mock_time(0);
+    _anj_exchange_ctx_t ctx;
+    _anj_exchange_init(&ctx, 0);
+    uint8_t payload[16];
+    _anj_coap_msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.operation = ANJ_OP_INF_CON_SEND;
+    _anj_exchange_handlers_t handlers = { 0 };
+
+    // initial timeout below 1 s is tripled with each retransmission
+    ctx.rto.rto_ms = 400;
+    set_mock_time(0);
+    ASSERT_EQ(_anj_exchange_new_client_request(&ctx, &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+    uint64_t initial_timeout = ctx.timeout_ms;
+    ASSERT_TRUE(initial_timeout >= 400 && initial_timeout <= 600);
+    set_mock_time(initial_timeout);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NONE, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+    ASSERT_EQ(_anj_exchange_next_timeout(&ctx),
+              initial_timeout + 3 * initial_timeout);
+    _anj_exchange_terminate(&ctx);
+}
+
+#endif // ANJ_WITH_ADAPTIVE_RTO
@@ -14,6 +14,7 @@
 
 #define ANJ_UNIT_ENABLE_SHORT_ASSERTS
 #include <anj/anj_config.h>
+#include <anj/compat/time.h>
 #include <anj/defs.h>
 
 #include "../../src/anj/coap/coap.h"
@@ -1072,6 +1073,28 @@ ANJ_UNIT_TEST(client_requests, update_operation_with_termination) {
     ASSERT_EQ(handlers_arg.result, _ANJ_EXCHANGE_ERROR_TERMINATED);
 }
 
+// Test: Time of the next timeout check follows the state of the exchange.
+ANJ_UNIT_TEST(client_requests, update_operation_next_timeout) {
+    TEST_INIT();
+    _anj_exchange_handlers_t handlers = {
+        .arg = &handlers_arg
+    };
+    msg.operation = ANJ_OP_UPDATE;
+
+    ASSERT_EQ(_anj_exchange_next_timeout(&ctx), ANJ_TIME_UNDEFINED);
+    ASSERT_EQ(_anj_exchange_new_client_request(&ctx, &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ASSERT_EQ(_anj_exchange_next_timeout(&ctx),
+              ctx.send_ack_timeout_timestamp_ms);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+    ASSERT_EQ(_anj_exchange_next_timeout(&ctx), ctx.timeout_timestamp_ms);
+    _anj_exchange_terminate(&ctx);
+    ASSERT_EQ(_anj_exchange_next_timeout(&ctx), ANJ_TIME_UNDEFINED);
+}
+
 // Test: Update operation with retransmision.
 ANJ_UNIT_TEST(client_requests, update_operation_with_2_retransmision) {
     TEST_INIT();
@@ -0,0 +1,401 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ANJ_UNIT_ENABLE_SHORT_ASSERTS
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+
+#include "../../src/anj/coap/coap.h"
+#include "../../src/anj/exchange.h"
+
+#include <anj_unit_test.h>
+
+#ifdef ANJ_COAP_WITH_QBLOCK
+
+// tests are built with ANJ_COAP_QBLOCK_MAX_PAYLOADS set to 2
+
+typedef struct {
+    size_t out_payload_len;
+    char *out_payload;
+    uint16_t out_format;
+    int read_counter;
+    uint8_t read_ret_val;
+    uint8_t buff[100];
+    size_t buff_offset;
+    bool last_block;
+    int write_counter;
+    int complete_counter;
+    int result;
+} q_block_arg_t;
+
+static uint8_t read_payload(void *arg_ptr,
+                            uint8_t *buff,
+                            size_t buff_len,
+                            _anj_exchange_read_result_t *out_params) {
+    (void) buff_len;
+    q_block_arg_t *arg = (q_block_arg_t *) arg_ptr;
+    out_params->payload_len = arg->out_payload_len;
+    out_params->format = arg->out_format;
+    memcpy(buff, arg->out_payload, arg->out_payload_len);
+    arg->read_counter++;
+    return arg->read_ret_val;
+}
+
+static uint8_t write_payload(void *arg_ptr,
+                             uint8_t *buff,
+                             size_t buff_len,
+                             bool last_block) {
+    q_block_arg_t *arg = (q_block_arg_t *) arg_ptr;
+    memcpy(arg->buff + arg->buff_offset, buff, buff_len);
+    arg->buff_offset += buff_len;
+    arg->last_block = last_block;
+    arg->write_counter++;
+    return 0;
+}
+
+static void completion(void *arg_ptr,
+                       const _anj_coap_msg_t *response,
+                       int result) {
+    (void) response;
+    q_block_arg_t *arg = (q_block_arg_t *) arg_ptr;
+    arg->result = result;
+    arg->complete_counter++;
+}
+
+#    define HANDLERS_INIT()                     \
+        q_block_arg_t arg = { 0 };              \
+        _anj_exchange_handlers_t handlers = {   \
+            .arg = &arg,                        \
+            .write_payload = write_payload,     \
+            .read_payload = read_payload,       \
+            .completion = completion            \
+        };                                      \
+        uint8_t payload[20];                    \
+        _anj_exchange_ctx_t ctx;                \
+        _anj_exchange_init(&ctx, 0)
+
+// message ID of Non-confirmable response is generated, so it's not compared
+static void verify_msg(const uint8_t *expected,
+                       size_t expected_len,
+                       _anj_coap_msg_t *msg) {
+    uint8_t out_buff[120];
+    size_t out_msg_size = 0;
+
+    ASSERT_OK(_anj_coap_encode_udp(msg, out_buff, sizeof(out_buff),
+                                   &out_msg_size));
+    ASSERT_EQ(out_msg_size, expected_len);
+    if (msg->coap_binding_data.udp.type == ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE) {
+        ASSERT_EQ_BYTES_SIZED(out_buff, expected, 2);
+        ASSERT_EQ_BYTES_SIZED(&out_buff[4], &expected[4], expected_len - 4);
+    } else {
+        ASSERT_EQ_BYTES_SIZED(out_buff, expected, expected_len);
+    }
+}
+
+static _anj_coap_msg_t write_block(uint8_t type,
+                                   uint16_t msg_id,
+                                   uint32_t block_num,
+                                   bool more) {
+    return (_anj_coap_msg_t) {
+        .operation = ANJ_OP_DM_WRITE_REPLACE,
+        .token = {
+            .size = 1,
+            .bytes = { 1 }
+        },
+        .coap_binding_data = {
+            .udp = {
+                .type = type,
+                .message_id = msg_id
+            }
+        },
+        .block = {
+            .block_type = ANJ_OPTION_BLOCK_1,
+            .number = block_num,
+            .size = 16,
+            .more_flag = more,
+            .q_block = true
+        },
+        .content_format = _ANJ_COAP_FORMAT_CBOR,
+        .uri = {
+            .uri_len = 1,
+            .ids = { 1 }
+        },
+        .payload = (uint8_t *) "1111111122222222",
+        .payload_size = 16
+    };
+}
+
+static _anj_coap_msg_t read_block(uint16_t msg_id, uint32_t block_num) {
+    return (_anj_coap_msg_t) {
+        .operation = ANJ_OP_DM_READ,
+        .token = {
+            .size = 1,
+            .bytes = { 2 }
+        },
+        .coap_binding_data = {
+            .udp = {
+                .type = ANJ_COAP_UDP_TYPE_CONFIRMABLE,
+                .message_id = msg_id
+            }
+        },
+        .block = {
+            .block_type = ANJ_OPTION_BLOCK_2,
+            .number = block_num,
+            .size = 16,
+            .q_block = true
+        },
+        .uri = {
+            .uri_len = 1,
+            .ids = { 1 }
+        }
+    };
+}
+
+// Test: Write with Non-confirmable Q-Block1 transfer, only the last block of
+// every set is answered.
+// Server LwM2M                 |                      Client LwM2M
+// ----------------------------------------------------------------
+// NON WRITE q-block1 0 more ---->
+// NON WRITE q-block1 1 more ---->
+//                              <---- NON 2.31 Continue q-block1 1 more
+// NON WRITE q-block1 2 more ---->
+// NON WRITE q-block1 3      ---->
+//                              <---- NON 2.04 Changed q-block1 3
+ANJ_UNIT_TEST(q_block, q_block1_non_confirmable) {
+    HANDLERS_INIT();
+    _anj_coap_msg_t msg =
+            write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1000, 0, true);
+    ASSERT_EQ(_anj_exchange_new_server_request(&ctx, ANJ_COAP_CODE_CHANGED,
+                                               &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1001, 1, true);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected[] = "\x51"          // NON, tkl 1
+                         "\x5F"          // Continue
+                         "\x00\x00\x01"  // msg id, token
+                         "\xd1\x06\x18"; // q-block1 1 more
+    verify_msg(expected, sizeof(expected) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1002, 2, true);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1003, 3, false);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected2[] = "\x51"          // NON, tkl 1
+                          "\x44"          // Changed
+                          "\x00\x00\x01"  // msg id, token
+                          "\xd1\x06\x30"; // q-block1 3
+    verify_msg(expected2, sizeof(expected2) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_FINISHED);
+
+    ASSERT_EQ(arg.write_counter, 4);
+    ASSERT_EQ(arg.buff_offset, 64);
+    ASSERT_TRUE(arg.last_block);
+    ASSERT_EQ(arg.complete_counter, 1);
+    ASSERT_EQ(arg.result, 0);
+}
+
+// Test: Confirmable block that is not the last one in a set is only
+// acknowledged.
+// Server LwM2M                 |                      Client LwM2M
+// ----------------------------------------------------------------
+// CON WRITE q-block1 0 more ---->
+//                              <---- Empty ACK
+// CON WRITE q-block1 1      ---->
+//                              <---- ACK 2.04 Changed q-block1 1
+ANJ_UNIT_TEST(q_block, q_block1_confirmable) {
+    HANDLERS_INIT();
+    _anj_coap_msg_t msg =
+            write_block(ANJ_COAP_UDP_TYPE_CONFIRMABLE, 0x3333, 0, true);
+    ASSERT_EQ(_anj_exchange_new_server_request(&ctx, ANJ_COAP_CODE_CHANGED,
+                                               &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected[] = "\x60"      // ACK, tkl 0
+                         "\x00"      // Empty
+                         "\x33\x33"; // msg id
+    verify_msg(expected, sizeof(expected) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_CONFIRMABLE, 0x2222, 1, false);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected2[] = "\x61"          // ACK, tkl 1
+                          "\x44"          // Changed
+                          "\x22\x22\x01"  // msg id, token
+                          "\xd1\x06\x10"; // q-block1 1
+    verify_msg(expected2, sizeof(expected2) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_FINISHED);
+
+    ASSERT_EQ(arg.write_counter, 2);
+    ASSERT_EQ(arg.complete_counter, 1);
+    ASSERT_EQ(arg.result, 0);
+}
+
+// Test: Block lost in the middle of a set, the LwM2M Server is asked for
+// missing blocks at the end of the set.
+// Server LwM2M                 |                      Client LwM2M
+// ----------------------------------------------------------------
+// NON WRITE q-block1 0 more ---->
+// NON WRITE q-block1 1 more -X
+// NON WRITE q-block1 2 more ---->
+// NON WRITE q-block1 3 more ---->
+//                              <---- NON 4.08 Request Entity Incomplete
+//                                    [1, 2, 3]
+// NON WRITE q-block1 1 more ---->
+//                              <---- NON 2.31 Continue q-block1 1 more
+// NON WRITE q-block1 2      ---->
+//                              <---- NON 2.04 Changed q-block1 2
+ANJ_UNIT_TEST(q_block, q_block1_missing_block) {
+    HANDLERS_INIT();
+    _anj_coap_msg_t msg =
+            write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1000, 0, true);
+    ASSERT_EQ(_anj_exchange_new_server_request(&ctx, ANJ_COAP_CODE_CHANGED,
+                                               &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1002, 2, true);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1003, 3, true);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected[] = "\x51"         // NON, tkl 1
+                         "\x88"         // Request Entity Incomplete
+                         "\x00\x00\x01" // msg id, token
+                         "\xC2\x01\x10" // content_format: missing blocks
+                         "\xFF"
+                         "\x01\x02\x03"; // CBOR Sequence
+    verify_msg(expected, sizeof(expected) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+    ASSERT_EQ(arg.write_counter, 1);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1004, 1, true);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected2[] = "\x51"          // NON, tkl 1
+                          "\x5F"          // Continue
+                          "\x00\x00\x01"  // msg id, token
+                          "\xd1\x06\x18"; // q-block1 1 more
+    verify_msg(expected2, sizeof(expected2) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+
+    msg = write_block(ANJ_COAP_UDP_TYPE_NON_CONFIRMABLE, 0x1005, 2, false);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected3[] = "\x51"          // NON, tkl 1
+                          "\x44"          // Changed
+                          "\x00\x00\x01"  // msg id, token
+                          "\xd1\x06\x20"; // q-block1 2
+    verify_msg(expected3, sizeof(expected3) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_FINISHED);
+
+    ASSERT_EQ(arg.write_counter, 3);
+    ASSERT_EQ(arg.buff_offset, 48);
+    ASSERT_EQ(arg.complete_counter, 1);
+    ASSERT_EQ(arg.result, 0);
+}
+
+// Test: Read with Q-Block2, the whole set of blocks is sent without waiting
+// for the requests of the LwM2M Server.
+// Server LwM2M            |                           Client LwM2M
+// ----------------------------------------------------------------
+// CON READ q-block2 0 ---->
+//                         <---- ACK 2.05 Content q-block2 0 more
+//                         <---- NON 2.05 Content q-block2 1 more
+// CON READ q-block2 2 ---->
+//                         <---- ACK 2.05 Content q-block2 2
+ANJ_UNIT_TEST(q_block, q_block2) {
+    HANDLERS_INIT();
+    arg.out_payload_len = 16;
+    arg.out_payload = "1234567812345678";
+    arg.out_format = _ANJ_COAP_FORMAT_CBOR;
+    arg.read_ret_val = _ANJ_EXCHANGE_BLOCK_TRANSFER_NEEDED;
+    _anj_coap_msg_t msg = read_block(0x3333, 0);
+    ASSERT_EQ(_anj_exchange_new_server_request(&ctx, ANJ_COAP_CODE_CONTENT,
+                                               &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected[] =
+            "\x61"         // ACK, tkl 1
+            "\x45"         // Content
+            "\x33\x33\x02" // msg id, token
+            "\xC1\x3C"     // content_format: cbor
+            "\xD1\x06\x08" // q-block2 0, size 16, more
+            "\xFF"
+            "\x31\x32\x33\x34\x35\x36\x37\x38\x31\x32\x33\x34\x35\x36\x37\x38";
+    verify_msg(expected, sizeof(expected) - 1, &msg);
+
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected2[] =
+            "\x51"         // NON, tkl 1
+            "\x45"         // Content
+            "\x00\x00\x02" // msg id, token
+            "\xC1\x3C"     // content_format: cbor
+            "\xD1\x06\x18" // q-block2 1, size 16, more
+            "\xFF"
+            "\x31\x32\x33\x34\x35\x36\x37\x38\x31\x32\x33\x34\x35\x36\x37\x38";
+    verify_msg(expected2, sizeof(expected2) - 1, &msg);
+    // end of the set, wait for the request of the next block
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_WAITING_MSG);
+    ASSERT_EQ(arg.read_counter, 2);
+
+    arg.read_ret_val = 0;
+    msg = read_block(0x2222, 2);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_NEW_MSG, &msg),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected3[] =
+            "\x61"         // ACK, tkl 1
+            "\x45"         // Content
+            "\x22\x22\x02" // msg id, token
+            "\xC1\x3C"     // content_format: cbor
+            "\xD1\x06\x20" // q-block2 2, size 16
+            "\xFF"
+            "\x31\x32\x33\x34\x35\x36\x37\x38\x31\x32\x33\x34\x35\x36\x37\x38";
+    verify_msg(expected3, sizeof(expected3) - 1, &msg);
+    ASSERT_EQ(_anj_exchange_process(&ctx, ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &msg),
+              ANJ_EXCHANGE_STATE_FINISHED);
+
+    ASSERT_EQ(arg.read_counter, 3);
+    ASSERT_EQ(arg.complete_counter, 1);
+    ASSERT_EQ(arg.result, 0);
+}
+
+#endif // ANJ_COAP_WITH_QBLOCK
@@ -1070,6 +1070,76 @@ ANJ_UNIT_TEST(server_requests, read_operation_with_block_size_set) {
     verify_payload(expected, sizeof(expected) - 1, &msg);
 }
 
+// Test: Read operation with block response, LwM2M Server asks for smaller
+// blocks in the middle of the transfer (RFC 7959, section 2.4).
+// Server LwM2M         |                    Client LwM2M
+// ------------------------------------------------------
+// READ                 ---->
+//                       <---- 2.05 Content block2 0 size 32 more
+// READ block2 2 size 16 ---->
+//                       <---- 2.05 Content block2 2 size 16
+ANJ_UNIT_TEST(server_requests, read_operation_with_block_size_changed) {
+    handlers_arg_t handlers_arg = { 0 };
+    _anj_exchange_handlers_t handlers = {
+        .arg = &handlers_arg,
+        .write_payload = write_payload_handler,
+        .read_payload = read_payload_handler,
+        .completion = exchange_completion_handler
+    };
+    uint8_t payload[40];
+    handlers_arg.out_payload_len = 32;
+    handlers_arg.out_payload = "12345678123456781234567812345678";
+    handlers_arg.out_format = _ANJ_COAP_FORMAT_CBOR;
+    handlers_arg.ret_val = _ANJ_EXCHANGE_BLOCK_TRANSFER_NEEDED;
+
+    _anj_coap_msg_t msg = {
+        .operation = ANJ_OP_DM_READ,
+        .token = {
+            .size = 1,
+            .bytes = { 1 }
+        },
+        .coap_binding_data = {
+            .udp = {
+                .message_id = 0x3333,
+            }
+        }
+    };
+    _anj_exchange_ctx_t ctx;
+    _anj_exchange_init(&ctx, 0);
+    ASSERT_EQ(_anj_exchange_new_server_request(&ctx, ANJ_COAP_CODE_CONTENT,
+                                               &msg, &handlers, payload,
+                                               sizeof(payload)),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    uint8_t expected[] =
+            "\x61"         // ACK, tkl 1
+            "\x45"         // Content
+            "\x33\x33\x01" // msg id, token
+            "\xC1\x3C"     // content_format: cbor
+            "\xB1\x09"     // block2 0, size 32, more
+            "\xFF"
+            "\x31\x32\x33\x34\x35\x36\x37\x38\x31\x32\x33\x34\x35\x36\x37\x38"
+            "\x31\x32\x33\x34\x35\x36\x37\x38\x31\x32\x33\x34\x35\x36\x37\x38";
+    verify_payload(expected, sizeof(expected) - 1, &msg);
+
+    // the first 32 bytes are already sent, so the next 16-byte block is 2
+    handlers_arg.out_payload_len = 16;
+    handlers_arg.ret_val = 0;
+    msg = process_block_read(&ctx, ANJ_OP_DM_READ, false, 2, 0x2222);
+    uint8_t expected2[] =
+            "\x61"         // ACK, tkl 1
+            "\x45"         // Content
+            "\x22\x22\x02" // msg id, token
+            "\xC1\x3C"     // content_format: cbor
+            "\xB1\x20"     // block2 2, size 16
+            "\xFF"
+            "\x31\x32\x33\x34\x35\x36\x37\x38\x31\x32\x33\x34\x35\x36\x37\x38";
+    verify_payload(expected2, sizeof(expected2) - 1, &msg);
+
+    ASSERT_EQ(handlers_arg.read_counter, 2);
+    ASSERT_EQ(handlers_arg.complete_counter, 1);
+    ASSERT_EQ(handlers_arg.result, 0);
+}
+
 // Test: Read operation, server by block option force the
 // payload size, but client response in single message.
 // Server LwM2M         |                    Client LwM2M
@@ -1433,6 +1433,81 @@ ANJ_UNIT_TEST(cbor_decoder_ll, double_premature_eof) {
                           _ANJ_IO_ERR_FORMAT);
 }
 
+ANJ_UNIT_TEST(cbor_decoder_ll, numbers_split_payload) {
+    static const char data[] = "\xFB\x40\x40\x00\x00\x00\x00\x00\x00"
+                               "\xFA\x42\x00\x00\x00"
+                               "\x19\x01\x02"
+                               "\xF9\x50\x00"
+                               "\x3A\x00\x01\x00\x00";
+    for (size_t split = 0; split < sizeof(data) - 1; ++split) {
+        _anj_cbor_ll_decoder_t ctx;
+        anj_cbor_ll_decoder_init(&ctx);
+        ANJ_UNIT_ASSERT_SUCCESS(
+                anj_cbor_ll_decoder_feed_payload(&ctx, data, split, false));
+
+        _anj_cbor_ll_number_t values[5];
+        size_t decoded = 0;
+        bool fed_rest = false;
+        while (decoded < ANJ_ARRAY_SIZE(values)) {
+            int result = anj_cbor_ll_decoder_number(&ctx, &values[decoded]);
+            if (result == _ANJ_IO_WANT_NEXT_PAYLOAD) {
+                ANJ_UNIT_ASSERT_FALSE(fed_rest);
+                ANJ_UNIT_ASSERT_SUCCESS(anj_cbor_ll_decoder_feed_payload(
+                        &ctx, data + split, sizeof(data) - 1 - split, true));
+                fed_rest = true;
+            } else {
+                ANJ_UNIT_ASSERT_SUCCESS(result);
+                ++decoded;
+            }
+        }
+        ANJ_UNIT_ASSERT_EQUAL(values[0].type, ANJ_CBOR_LL_VALUE_DOUBLE);
+        ANJ_UNIT_ASSERT_EQUAL(values[0].value.f64, 32.0);
+        ANJ_UNIT_ASSERT_EQUAL(values[1].type, ANJ_CBOR_LL_VALUE_FLOAT);
+        ANJ_UNIT_ASSERT_EQUAL(values[1].value.f32, 32.0f);
+        ANJ_UNIT_ASSERT_EQUAL(values[2].type, ANJ_CBOR_LL_VALUE_UINT);
+        ANJ_UNIT_ASSERT_EQUAL(values[2].value.u64, 258);
+        ANJ_UNIT_ASSERT_EQUAL(values[3].type, ANJ_CBOR_LL_VALUE_FLOAT);
+        ANJ_UNIT_ASSERT_EQUAL(values[3].value.f32, 32.0f);
+        ANJ_UNIT_ASSERT_EQUAL(values[4].type, ANJ_CBOR_LL_VALUE_NEGATIVE_INT);
+        ANJ_UNIT_ASSERT_EQUAL(values[4].value.i64, -65537);
+
+        if (!fed_rest) {
+            ANJ_UNIT_ASSERT_EQUAL(anj_cbor_ll_decoder_errno(&ctx),
+                                  _ANJ_IO_WANT_NEXT_PAYLOAD);
+            ANJ_UNIT_ASSERT_SUCCESS(anj_cbor_ll_decoder_feed_payload(
+                    &ctx, data + split, sizeof(data) - 1 - split, true));
+        }
+        ANJ_UNIT_ASSERT_EQUAL(anj_cbor_ll_decoder_errno(&ctx), _ANJ_IO_EOF);
+    }
+}
+
+ANJ_UNIT_TEST(cbor_decoder_ll, prebuffer_used_only_at_chunk_boundary) {
+    static const char data[] = "\x19\x01\x02"
+                               "\x19\x03\x04"
+                               "\x19\x05\x06"
+                               "\x19\x07\x08";
+    _anj_cbor_ll_decoder_t ctx;
+    anj_cbor_ll_decoder_init(&ctx);
+    ANJ_UNIT_ASSERT_SUCCESS(anj_cbor_ll_decoder_feed_payload(&ctx, data, 2,
+                                                             false));
+    _anj_cbor_ll_number_t value;
+    ANJ_UNIT_ASSERT_EQUAL(anj_cbor_ll_decoder_number(&ctx, &value),
+                          _ANJ_IO_WANT_NEXT_PAYLOAD);
+    ANJ_UNIT_ASSERT_SUCCESS(anj_cbor_ll_decoder_feed_payload(
+            &ctx, data + 2, sizeof(data) - 1 - 2, true));
+
+    ANJ_UNIT_ASSERT_SUCCESS(anj_cbor_ll_decoder_number(&ctx, &value));
+    ANJ_UNIT_ASSERT_EQUAL(value.value.u64, 0x0102);
+    // the following items are decoded directly from the second chunk
+    for (uint64_t expected = 0x0304; expected <= 0x0708; expected += 0x0202) {
+        ANJ_UNIT_ASSERT_EQUAL(ctx.prebuffer_offset, ctx.prebuffer_size);
+        ANJ_UNIT_ASSERT_SUCCESS(anj_cbor_ll_decoder_number(&ctx, &value));
+        ANJ_UNIT_ASSERT_EQUAL(value.value.u64, expected);
+    }
+    ANJ_UNIT_ASSERT_EQUAL(ctx.prebuffer_offset, ctx.prebuffer_size);
+    ANJ_UNIT_ASSERT_EQUAL(anj_cbor_ll_decoder_errno(&ctx), _ANJ_IO_EOF);
+}
+
 ANJ_UNIT_TEST(cbor_decoder_ll, boolean_true_and_false) {
     {
         _anj_cbor_ll_decoder_t ctx;
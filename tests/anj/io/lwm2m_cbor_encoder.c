@@ -748,7 +748,9 @@ static anj_io_out_entry_t entries[] = {
     }
 };
 
+#    ifdef ANJ_WITH_EXTERNAL_DATA
 static char ext_data[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+#    endif // ANJ_WITH_EXTERNAL_DATA
 
 // {8: {8: {
 // 0: 25,
@@ -877,6 +879,73 @@ ANJ_UNIT_TEST(lwm2m_cbor_encoder, all_data_types_chunk_read) {
     ANJ_UNIT_ASSERT_TRUE(closed);
 #    endif // ANJ_WITH_EXTERNAL_DATA
 }
+
+// encodes entries into blocks of block_len bytes, with
+// _anj_io_out_ctx_add_entry() if direct is set
+static void encode_entries_in_blocks(lwm2m_cbor_test_env_t *env,
+                                     size_t block_len,
+                                     bool direct) {
+    lwm2m_cbor_test_setup(env, &ANJ_MAKE_INSTANCE_PATH(8, 8),
+                          ANJ_ARRAY_SIZE(entries), ANJ_OP_DM_READ);
+#    ifdef ANJ_WITH_EXTERNAL_DATA
+    ext_data_size = sizeof(ext_data) - 1;
+    ptr_for_callback = ext_data;
+    opened = false;
+    closed = false;
+#    endif // ANJ_WITH_EXTERNAL_DATA
+    size_t block_end = block_len;
+    for (size_t i = 0; i < ANJ_ARRAY_SIZE(entries); i++) {
+        int res;
+        size_t out_len = 0;
+        if (env->out_length == block_end) {
+            block_end += block_len;
+        }
+        if (direct) {
+            res = _anj_io_out_ctx_add_entry(
+                    &env->ctx, &entries[i], &env->buf[env->out_length],
+                    block_end - env->out_length, &out_len);
+        } else {
+            ANJ_UNIT_ASSERT_SUCCESS(
+                    _anj_io_out_ctx_new_entry(&env->ctx, &entries[i]));
+            res = _anj_io_out_ctx_get_payload(
+                    &env->ctx, &env->buf[env->out_length],
+                    block_end - env->out_length, &out_len);
+        }
+        env->out_length += out_len;
+        while (res) {
+            ANJ_UNIT_ASSERT_EQUAL(res, ANJ_IO_NEED_NEXT_CALL);
+            ANJ_UNIT_ASSERT_EQUAL(env->out_length, block_end);
+            block_end += block_len;
+            res = _anj_io_out_ctx_get_payload(
+                    &env->ctx, &env->buf[env->out_length],
+                    block_end - env->out_length, &out_len);
+            env->out_length += out_len;
+        }
+    }
+#    ifdef ANJ_WITH_EXTERNAL_DATA
+    ANJ_UNIT_ASSERT_TRUE(closed);
+#    endif // ANJ_WITH_EXTERNAL_DATA
+}
+
+ANJ_UNIT_TEST(lwm2m_cbor_encoder, direct_encoding) {
+    lwm2m_cbor_test_env_t env = { 0 };
+    encode_entries_in_blocks(&env, sizeof(env.buf), true);
+    VERIFY_BYTES(env, encoded_entries);
+
+    // records that cross the block boundary are finished from the internal
+    // buffer, payload must be the same as with the intermediate copy
+    for (size_t block_len = _ANJ_IO_CTX_BUFFER_LENGTH + 1;
+         block_len < sizeof(encoded_entries) + 2;
+         block_len++) {
+        lwm2m_cbor_test_env_t staged_env = { 0 };
+        encode_entries_in_blocks(&staged_env, block_len, false);
+        lwm2m_cbor_test_env_t direct_env = { 0 };
+        encode_entries_in_blocks(&direct_env, block_len, true);
+        ANJ_UNIT_ASSERT_EQUAL(direct_env.out_length, staged_env.out_length);
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(direct_env.buf, staged_env.buf,
+                                          staged_env.out_length);
+    }
+}
 #    ifdef ANJ_WITH_EXTERNAL_DATA
 static bool opened2;
 static int external_data_open2(void *user_args) {
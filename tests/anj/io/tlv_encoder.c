@@ -0,0 +1,412 @@
+/*
+ * Copyright 2023-2025 AVSystem <avsystem@avsystem.com>
+ * AVSystem Anjay Lite LwM2M SDK
+ * All rights reserved.
+ *
+ * Licensed under AVSystem Anjay Lite LwM2M Client SDK - Non-Commercial License.
+ * See the attached LICENSE file for details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <anj/anj_config.h>
+#include <anj/defs.h>
+#include <anj/utils.h>
+
+#include "../../../src/anj/coap/coap.h"
+#include "../../../src/anj/io/io.h"
+
+#include <anj_unit_test.h>
+
+#ifdef ANJ_WITH_TLV
+
+typedef struct {
+    anj_uri_path_t path;
+    size_t length;
+} aggregate_length_t;
+
+// array of lengths terminated with root path
+static int get_length(void *arg,
+                      const anj_uri_path_t *path,
+                      size_t *out_length) {
+    const aggregate_length_t *lengths = (const aggregate_length_t *) arg;
+    for (; anj_uri_path_length(&lengths->path); lengths++) {
+        if (anj_uri_path_equal(&lengths->path, path)) {
+            *out_length = lengths->length;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+typedef struct {
+    _anj_io_out_ctx_t ctx;
+    uint8_t buf[500];
+    size_t out_length;
+} tlv_test_env_t;
+
+static void tlv_test_setup(tlv_test_env_t *env,
+                           const anj_uri_path_t *base_path,
+                           size_t items_count,
+                           const aggregate_length_t *lengths) {
+    env->out_length = 0;
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_io_out_ctx_init(
+            &env->ctx, ANJ_OP_DM_READ, base_path, items_count,
+            _ANJ_COAP_FORMAT_OMA_LWM2M_TLV));
+    if (lengths) {
+        _anj_io_out_ctx_set_tlv_length_cb(
+                &env->ctx, get_length,
+                (void *) (intptr_t) (const void *) lengths);
+    }
+}
+
+// copies the payload in chunks of at most chunk_size bytes, like block-wise
+// transfer does
+static int encode_entry(tlv_test_env_t *env,
+                        const anj_io_out_entry_t *entry,
+                        size_t chunk_size) {
+    int res = _anj_io_out_ctx_new_entry(&env->ctx, entry);
+    if (res) {
+        return res;
+    }
+    do {
+        size_t copied_bytes = 0;
+        res = _anj_io_out_ctx_get_payload(
+                &env->ctx, &env->buf[env->out_length],
+                ANJ_MIN(chunk_size, sizeof(env->buf) - env->out_length),
+                &copied_bytes);
+        env->out_length += copied_bytes;
+    } while (res == ANJ_IO_NEED_NEXT_CALL);
+    return res;
+}
+
+#    define VERIFY_BYTES(Env, Data)                                  \
+        do {                                                         \
+            ANJ_UNIT_ASSERT_EQUAL(Env.out_length, sizeof(Data) - 1); \
+            ANJ_UNIT_ASSERT_EQUAL_BYTES(Env.buf, Data);              \
+        } while (0)
+
+#    define TEST_SINGLE_RESOURCE(Name, Type, Field, Value, Data)               \
+        ANJ_UNIT_TEST(tlv_encoder, Name) {                                     \
+            tlv_test_env_t env;                                                \
+            tlv_test_setup(&env, &ANJ_MAKE_RESOURCE_PATH(3, 0, 1), 1, NULL);   \
+            anj_io_out_entry_t entry = {                                       \
+                .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 1),                       \
+                .type = Type,                                                  \
+                .value.Field = Value                                           \
+            };                                                                 \
+            ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &entry, 500));          \
+            VERIFY_BYTES(env, Data);                                           \
+        }
+
+TEST_SINGLE_RESOURCE(int_zero, ANJ_DATA_TYPE_INT, int_value, 0,
+                     "\xC1\x01\x00")
+TEST_SINGLE_RESOURCE(int_negative, ANJ_DATA_TYPE_INT, int_value, -1,
+                     "\xC1\x01\xFF")
+TEST_SINGLE_RESOURCE(int_2_bytes, ANJ_DATA_TYPE_INT, int_value, 300,
+                     "\xC2\x01\x01\x2C")
+TEST_SINGLE_RESOURCE(int_4_bytes, ANJ_DATA_TYPE_INT, int_value, -40000,
+                     "\xC4\x01\xFF\xFF\x63\xC0")
+TEST_SINGLE_RESOURCE(int_8_bytes, ANJ_DATA_TYPE_INT, int_value, INT64_MIN,
+                     "\xC8\x01\x08\x80\x00\x00\x00\x00\x00\x00\x00")
+TEST_SINGLE_RESOURCE(uint_small, ANJ_DATA_TYPE_UINT, uint_value, 200,
+                     "\xC2\x01\x00\xC8")
+TEST_SINGLE_RESOURCE(uint_max, ANJ_DATA_TYPE_UINT, uint_value, UINT64_MAX,
+                     "\xC8\x01\x08\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF")
+TEST_SINGLE_RESOURCE(time, ANJ_DATA_TYPE_TIME, time_value, 1700000000,
+                     "\xC4\x01\x65\x53\xF1\x00")
+TEST_SINGLE_RESOURCE(double_as_float, ANJ_DATA_TYPE_DOUBLE, double_value, 1.5,
+                     "\xC4\x01\x3F\xC0\x00\x00")
+TEST_SINGLE_RESOURCE(double, ANJ_DATA_TYPE_DOUBLE, double_value, 0.1,
+                     "\xC8\x01\x08\x3F\xB9\x99\x99\x99\x99\x99\x9A")
+TEST_SINGLE_RESOURCE(bool, ANJ_DATA_TYPE_BOOL, bool_value, true,
+                     "\xC1\x01\x01")
+TEST_SINGLE_RESOURCE(objlnk,
+                     ANJ_DATA_TYPE_OBJLNK,
+                     objlnk,
+                     ((anj_objlnk_value_t) { 3, 0x1234 }),
+                     "\xC4\x01\x00\x03\x12\x34")
+TEST_SINGLE_RESOURCE(string,
+                     ANJ_DATA_TYPE_STRING,
+                     bytes_or_string.data,
+                     "hello",
+                     "\xC5\x01hello")
+TEST_SINGLE_RESOURCE(string_empty,
+                     ANJ_DATA_TYPE_STRING,
+                     bytes_or_string.data,
+                     "",
+                     "\xC0\x01")
+
+ANJ_UNIT_TEST(tlv_encoder, bytes) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_INSTANCE_PATH(3, 0), 1, NULL);
+    anj_io_out_entry_t entry = {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 300),
+        .type = ANJ_DATA_TYPE_BYTES,
+        .value.bytes_or_string.data = "\x00\x01\x02\x03\x04\x05\x06\x07\x08",
+        .value.bytes_or_string.chunk_length = 9
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &entry, 500));
+    // 16-bit ID and 8-bit length
+    VERIFY_BYTES(env, "\xE8\x01\x2C\x09"
+                      "\x00\x01\x02\x03\x04\x05\x06\x07\x08");
+}
+
+ANJ_UNIT_TEST(tlv_encoder, long_string_in_blocks) {
+    char value[301];
+    for (size_t i = 0; i < sizeof(value) - 1; i++) {
+        value[i] = (char) ('a' + i % 26);
+    }
+    value[sizeof(value) - 1] = '\0';
+
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_RESOURCE_PATH(3, 0, 1), 1, NULL);
+    anj_io_out_entry_t entry = {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+        .type = ANJ_DATA_TYPE_STRING,
+        .value.bytes_or_string.data = value
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &entry, 16));
+    ANJ_UNIT_ASSERT_EQUAL(env.out_length, 4 + 300);
+    // 16-bit length
+    ANJ_UNIT_ASSERT_EQUAL_BYTES(env.buf, "\xD0\x01\x01\x2C");
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&env.buf[4], value, 300);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, resource_instance) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 1), 1,
+                   NULL);
+    anj_io_out_entry_t entry = {
+        .path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 1),
+        .type = ANJ_DATA_TYPE_INT,
+        .value.int_value = 2
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &entry, 500));
+    VERIFY_BYTES(env, "\x41\x01\x02");
+}
+
+ANJ_UNIT_TEST(tlv_encoder, multiple_resource) {
+    static const aggregate_length_t lengths[] = {
+        { ANJ_MAKE_RESOURCE_PATH(3, 0, 7), 22 },
+        { ANJ_MAKE_ROOT_PATH(), 0 }
+    };
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_RESOURCE_PATH(3, 0, 7), 2, lengths);
+    anj_io_out_entry_t entries[] = {
+        {
+            .path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 0),
+            .type = ANJ_DATA_TYPE_INT,
+            .value.int_value = 1
+        },
+        {
+            .path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 1),
+            .type = ANJ_DATA_TYPE_INT,
+            .value.int_value = 2
+        }
+    };
+    for (size_t i = 0; i < ANJ_ARRAY_SIZE(entries); i++) {
+        ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &entries[i], 500));
+    }
+    // nested numeric values are always encoded on 8 bytes
+    VERIFY_BYTES(env, "\x88\x07\x16"
+                      "\x48\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01"
+                      "\x48\x01\x08\x00\x00\x00\x00\x00\x00\x00\x02");
+}
+
+ANJ_UNIT_TEST(tlv_encoder, multiple_resource_double) {
+    static const aggregate_length_t lengths[] = {
+        { ANJ_MAKE_RESOURCE_PATH(3, 0, 7), 11 },
+        { ANJ_MAKE_ROOT_PATH(), 0 }
+    };
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_RESOURCE_PATH(3, 0, 7), 1, lengths);
+    anj_io_out_entry_t entry = {
+        .path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 0),
+        .type = ANJ_DATA_TYPE_DOUBLE,
+        .value.double_value = 1.5
+    };
+    ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &entry, 500));
+    VERIFY_BYTES(env, "\x88\x07\x0B"
+                      "\x48\x00\x08\x3F\xF8\x00\x00\x00\x00\x00\x00");
+}
+
+static const anj_io_out_entry_t object_entries[] = {
+    {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 0),
+        .type = ANJ_DATA_TYPE_INT,
+        .value.int_value = 5
+    },
+    {
+        .path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 0),
+        .type = ANJ_DATA_TYPE_INT,
+        .value.int_value = 1
+    },
+    {
+        .path = ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 7, 1),
+        .type = ANJ_DATA_TYPE_INT,
+        .value.int_value = 2
+    },
+    {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 14),
+        .type = ANJ_DATA_TYPE_STRING,
+        .value.bytes_or_string.data = "UTC"
+    },
+    {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 1, 0),
+        .type = ANJ_DATA_TYPE_BOOL,
+        .value.bool_value = true
+    }
+};
+
+static const char object_payload[] =
+        "\x08\x00\x29"
+        "\xC8\x00\x08\x00\x00\x00\x00\x00\x00\x00\x05"
+        "\x88\x07\x16"
+        "\x48\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01"
+        "\x48\x01\x08\x00\x00\x00\x00\x00\x00\x00\x02"
+        "\xC3\x0E"
+        "UTC"
+        "\x03\x01"
+        "\xC1\x00\x01";
+
+static const aggregate_length_t object_lengths[] = {
+    { ANJ_MAKE_INSTANCE_PATH(3, 0), 41 },
+    { ANJ_MAKE_RESOURCE_PATH(3, 0, 7), 22 },
+    { ANJ_MAKE_INSTANCE_PATH(3, 1), 3 },
+    { ANJ_MAKE_ROOT_PATH(), 0 }
+};
+
+ANJ_UNIT_TEST(tlv_encoder, object) {
+    for (size_t chunk_size = 1; chunk_size <= sizeof(object_payload);
+         chunk_size++) {
+        tlv_test_env_t env;
+        tlv_test_setup(&env, &ANJ_MAKE_OBJECT_PATH(3),
+                       ANJ_ARRAY_SIZE(object_entries), object_lengths);
+        for (size_t i = 0; i < ANJ_ARRAY_SIZE(object_entries); i++) {
+            ANJ_UNIT_ASSERT_SUCCESS(
+                    encode_entry(&env, &object_entries[i], chunk_size));
+        }
+        VERIFY_BYTES(env, object_payload);
+    }
+}
+
+ANJ_UNIT_TEST(tlv_encoder, object_directly_into_payload) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_OBJECT_PATH(3),
+                   ANJ_ARRAY_SIZE(object_entries), object_lengths);
+    for (size_t i = 0; i < ANJ_ARRAY_SIZE(object_entries); i++) {
+        size_t copied_bytes;
+        ANJ_UNIT_ASSERT_SUCCESS(_anj_io_out_ctx_add_entry(
+                &env.ctx, &object_entries[i], &env.buf[env.out_length],
+                sizeof(env.buf) - env.out_length, &copied_bytes));
+        env.out_length += copied_bytes;
+    }
+    VERIFY_BYTES(env, object_payload);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, instance) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_INSTANCE_PATH(3, 0), 4, object_lengths);
+    for (size_t i = 0; i < 4; i++) {
+        ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &object_entries[i], 500));
+    }
+    // Resource 0 is not nested in any aggregate, so it has the minimal width
+    VERIFY_BYTES(env, "\xC1\x00\x05"
+                      "\x88\x07\x16"
+                      "\x48\x00\x08\x00\x00\x00\x00\x00\x00\x00\x01"
+                      "\x48\x01\x08\x00\x00\x00\x00\x00\x00\x00\x02"
+                      "\xC3\x0E"
+                      "UTC");
+}
+
+ANJ_UNIT_TEST(tlv_encoder, empty_read) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_OBJECT_PATH(3), 0, NULL);
+    ANJ_UNIT_ASSERT_SUCCESS(_anj_io_out_ctx_get_payload(
+            &env.ctx, env.buf, sizeof(env.buf), &env.out_length));
+    ANJ_UNIT_ASSERT_EQUAL(env.out_length, 0);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, no_length_callback) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_OBJECT_PATH(3), 1, NULL);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_new_entry(&env.ctx,
+                                                    &object_entries[0]),
+                          _ANJ_IO_ERR_LOGIC);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, value_longer_than_calculated) {
+    static const aggregate_length_t lengths[] = {
+        { ANJ_MAKE_INSTANCE_PATH(3, 0), 2 },
+        { ANJ_MAKE_ROOT_PATH(), 0 }
+    };
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_OBJECT_PATH(3), 2, lengths);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_new_entry(&env.ctx,
+                                                    &object_entries[0]),
+                          _ANJ_IO_ERR_LOGIC);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, value_shorter_than_calculated) {
+    static const aggregate_length_t lengths[] = {
+        { ANJ_MAKE_INSTANCE_PATH(3, 0), 12 },
+        { ANJ_MAKE_INSTANCE_PATH(3, 1), 3 },
+        { ANJ_MAKE_ROOT_PATH(), 0 }
+    };
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_OBJECT_PATH(3), 2, lengths);
+    ANJ_UNIT_ASSERT_SUCCESS(encode_entry(&env, &object_entries[0], 500));
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_new_entry(&env.ctx,
+                                                    &object_entries[4]),
+                          _ANJ_IO_ERR_LOGIC);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, path_outside_base) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_INSTANCE_PATH(3, 1), 1, NULL);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_new_entry(&env.ctx,
+                                                    &object_entries[0]),
+                          _ANJ_IO_ERR_INPUT_ARG);
+}
+
+ANJ_UNIT_TEST(tlv_encoder, unsupported_operations) {
+    _anj_io_out_ctx_t ctx;
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_init(&ctx, ANJ_OP_INF_CON_SEND, NULL,
+                                               1,
+                                               _ANJ_COAP_FORMAT_OMA_LWM2M_TLV),
+                          _ANJ_IO_ERR_FORMAT);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_init(&ctx, ANJ_OP_DM_READ_COMP,
+                                               &ANJ_MAKE_ROOT_PATH(), 1,
+                                               _ANJ_COAP_FORMAT_OMA_LWM2M_TLV),
+                          _ANJ_IO_ERR_FORMAT);
+}
+
+#    ifdef ANJ_WITH_EXTERNAL_DATA
+static int get_external_data(void *buffer,
+                             size_t *inout_size,
+                             size_t offset,
+                             void *user_args) {
+    (void) buffer;
+    (void) offset;
+    (void) user_args;
+    *inout_size = 0;
+    return 0;
+}
+
+ANJ_UNIT_TEST(tlv_encoder, external_data_not_supported) {
+    tlv_test_env_t env;
+    tlv_test_setup(&env, &ANJ_MAKE_RESOURCE_PATH(3, 0, 1), 1, NULL);
+    anj_io_out_entry_t entry = {
+        .path = ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+        .type = ANJ_DATA_TYPE_EXTERNAL_BYTES,
+        .value.external_data.get_external_data = get_external_data
+    };
+    ANJ_UNIT_ASSERT_EQUAL(_anj_io_out_ctx_new_entry(&env.ctx, &entry),
+                          _ANJ_IO_ERR_IO_TYPE);
+}
+#    endif // ANJ_WITH_EXTERNAL_DATA
+
+#endif // ANJ_WITH_TLV
@@ -7,14 +7,20 @@
  * See the attached LICENSE file for details.
  */
 
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <anj/anj_config.h>
 #include <anj/defs.h>
 #include <anj/utils.h>
 
+#include "../../../src/anj/utils.h"
+
 #include <anj_unit_test.h>
 
 static void test_double_to_string(double value, const char *result) {
@@ -29,7 +35,7 @@ ANJ_UNIT_TEST(utils, double_to_str_custom) {
     test_double_to_string((double) UINT32_MAX - 0.02, "4294967294.98");
     test_double_to_string((double) UINT32_MAX, "4294967295");
     test_double_to_string((double) UINT32_MAX + 1.0, "4294967296");
-    test_double_to_string(0.0005999999999999999, "0.0005999999999999999");
+    test_double_to_string(0.0005999999999999999, "0.0006");
     test_double_to_string(0.00000122, "0.00000122");
     test_double_to_string(0.000000002, "0.000000002");
     test_double_to_string(777.000760, "777.00076");
@@ -56,8 +62,265 @@ ANJ_UNIT_TEST(utils, double_to_str_custom) {
     test_double_to_string(1.0, "1");
     test_double_to_string(78e120, "7.8e+121");
     test_double_to_string(1e20, "1e+20");
+    test_double_to_string(0.1, "0.1");
+    test_double_to_string(0.1 + 0.2, "0.30000000000000004");
+    test_double_to_string(1.0 / 3.0, "0.3333333333333333");
+    test_double_to_string(123.456, "123.456");
+    test_double_to_string(1e-10, "1e-10");
+    test_double_to_string(1.5e-10, "0.00000000015");
+    test_double_to_string(1.2345678901234567e-9, "1.2345678901234566e-9");
+    test_double_to_string(DBL_MAX, "1.7976931348623157e+308");
+    test_double_to_string(-DBL_MIN, "-2.2250738585072014e-308");
+    test_double_to_string(5e-324, "5e-324");
+}
+
+#ifdef ANJ_WITH_CUSTOM_CONVERSION_FUNCTIONS
+// xorshift64, deterministic source of bit patterns for the round-trip tests
+static uint64_t next_bits(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void test_double_round_trip(double value) {
+    char buff[ANJ_DOUBLE_STR_MAX_LEN + 1] = { 0 };
+    size_t len = anj_double_to_string_value(buff, value);
+    ANJ_UNIT_ASSERT_TRUE(len <= ANJ_DOUBLE_STR_MAX_LEN);
+    ANJ_UNIT_ASSERT_EQUAL(strtod(buff, NULL), value);
+
+#    ifdef ANJ_WITH_EXACT_STRING_TO_DOUBLE
+    // exponents below DBL_MIN_10_EXP are not accepted by the parser
+    if (fabs(value) < 1e-307) {
+        return;
+    }
+    double parsed;
+    ANJ_UNIT_ASSERT_SUCCESS(anj_string_to_double_value(&parsed, buff, len));
+    ANJ_UNIT_ASSERT_EQUAL(parsed, value);
+#    endif // ANJ_WITH_EXACT_STRING_TO_DOUBLE
+}
+
+ANJ_UNIT_TEST(utils, double_to_str_round_trip) {
+    for (int exp10 = -323; exp10 <= 308; exp10++) {
+        double value = pow(10.0, exp10);
+        test_double_round_trip(value);
+        test_double_round_trip(-nextafter(value, 0.0));
+        test_double_round_trip(nextafter(value, INFINITY));
+    }
+    for (int exp2 = -1074; exp2 <= 1023; exp2++) {
+        double value = ldexp(1.0, exp2);
+        test_double_round_trip(value);
+        test_double_round_trip(nextafter(value, 0.0));
+    }
+    for (int64_t i = -10000; i <= 10000; i++) {
+        test_double_round_trip((double) i / 1000.0);
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15;
+    for (size_t i = 0; i < 200000; i++) {
+        uint64_t bits = next_bits(&state);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (isfinite(value) && value != 0.0) {
+            test_double_round_trip(value);
+        }
+    }
+}
+
+ANJ_UNIT_TEST(utils, double_to_str_shortest) {
+    // short decimal values are printed as they were written, apart from rare
+    // cases in which Grisu2 doesn't find the shortest representation
+    size_t longer_count = 0;
+    uint64_t state = 0x2545F4914F6CDD1D;
+    for (size_t i = 0; i < 100000; i++) {
+        uint64_t bits = next_bits(&state);
+        int digits = 1 + (int) (bits % 15);
+        int exponent = (int) ((bits >> 8) % 40) - 20;
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%.*e", digits - 1,
+                 (double) (bits >> 12) / (double) (UINT64_C(1) << 52));
+        double value = strtod(expected, NULL) * pow(10.0, exponent);
+        snprintf(expected, sizeof(expected), "%.*e", digits - 1, value);
+        value = strtod(expected, NULL);
+
+        char buff[ANJ_DOUBLE_STR_MAX_LEN + 1] = { 0 };
+        anj_double_to_string_value(buff, value);
+        size_t significant_digits = 0;
+        bool leading_zeros = true;
+        for (const char *c = buff; *c && *c != 'e'; c++) {
+            if (*c >= '1' && *c <= '9') {
+                leading_zeros = false;
+            }
+            if (!leading_zeros && *c >= '0' && *c <= '9') {
+                significant_digits++;
+            }
+        }
+        // trailing zeros of integers are not significant
+        if (significant_digits > (size_t) digits && strpbrk(buff, ".e")) {
+            longer_count++;
+        }
+    }
+    ANJ_UNIT_ASSERT_TRUE(longer_count < 100);
+}
+
+static void append_digits(char *buff, size_t *len, size_t count,
+                          uint64_t *state) {
+    for (size_t i = 0; i < count; i++) {
+        buff[(*len)++] = (char) ('0' + next_bits(state) % 10);
+    }
+}
+
+// random decimal or exponent notation value with various numbers of digits
+// before and after the decimal point
+static void random_decimal(char *buff, uint64_t *state) {
+    size_t len = 0;
+    uint64_t bits = next_bits(state);
+    if (bits & 1) {
+        buff[len++] = '-';
+    }
+    size_t integer_digits = (size_t) ((bits >> 1) % 22);
+    size_t fraction_digits = (size_t) ((bits >> 8) % 22);
+    bool exponent_notation = (bits >> 16) & 1;
+    if (exponent_notation) {
+        integer_digits = 1 + integer_digits % 8;
+        fraction_digits = fraction_digits % 9;
+    } else if (!integer_digits && !fraction_digits) {
+        integer_digits = 1;
+    }
+    append_digits(buff, &len, integer_digits, state);
+    if (fraction_digits) {
+        buff[len++] = '.';
+        append_digits(buff, &len, fraction_digits, state);
+    }
+    if (exponent_notation) {
+        len += (size_t) sprintf(&buff[len], "e%d",
+                                (int) ((bits >> 24) % 600) - 300);
+    }
+    buff[len] = '\0';
+}
+
+#    ifdef ANJ_WITH_EXACT_STRING_TO_DOUBLE
+static void test_string_to_double_as_strtod(const char *buff) {
+    double parsed;
+    ANJ_UNIT_ASSERT_SUCCESS(
+            anj_string_to_double_value(&parsed, buff, strlen(buff)));
+    double expected = strtod(buff, NULL);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&parsed, &expected, sizeof(double));
 }
 
+ANJ_UNIT_TEST(utils, str_to_double_compare_strtod) {
+    const char *values[] = {
+        "0.1", "0.2", "0.3", "1.7976931348623157e308",
+        "2.2250738585072014e-307", "9007199254740993", "9007199254740992.5",
+        "4503599627370497.5", "1e23", "8.98846567431158e307",
+        "123456789012345678", "0.000000000000000000001",
+        // more than 19 significant digits around halfway values
+        "9007199254740993.000000000000000000001",
+        "9007199254740992.999999999999999999999",
+        "9007199254740993.000000000000000000000",
+        "9007199254740995.000000000000000000000",
+        "179769313486231580793728971405303415079934132710037826936173778980444"
+        "968292764750946649017977587207096330286416692887910946555547851940402"
+        "630657488671505820681908902000708383676273854845817711531764475730270"
+        "069855571366959622842914819860834936475292719074168444365510704342711"
+        "559699508093042880177904174497792",
+        "179769313486231580793728971405303415079934132710037826936173778980444"
+        "968292764750946649017977587207096330286416692887910946555547851940402"
+        "630657488671505820681908902000708383676273854845817711531764475730270"
+        "069855571366959622842914819860834936475292719074168444365510704342711"
+        "559699508093042880177904174497791"
+    };
+    for (size_t i = 0; i < ANJ_ARRAY_SIZE(values); i++) {
+        test_string_to_double_as_strtod(values[i]);
+    }
+
+    uint64_t state = 0x853C49E6748FEA9B;
+    for (size_t i = 0; i < 200000; i++) {
+        char buff[64];
+        random_decimal(buff, &state);
+        test_string_to_double_as_strtod(buff);
+    }
+}
+
+#        if LDBL_MANT_DIG >= 64
+ANJ_UNIT_TEST(utils, str_to_double_halfway_compare_strtod) {
+    // values halfway between two doubles are exact in long double, and
+    // printed in full they have up to 767 significant digits
+    static char buff[1500];
+    uint64_t state = 0x2545F4914F6CDD1D;
+    for (size_t i = 0; i < 2000; i++) {
+        uint64_t bits = next_bits(&state) % UINT64_C(0x7FF0000000000000);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        long double halfway =
+                ((long double) value + nextafter(value, INFINITY)) / 2;
+        int len = snprintf(buff, sizeof(buff) - 1, "%.1100Lf", halfway);
+        ANJ_UNIT_ASSERT_TRUE(len > 0 && (size_t) len < sizeof(buff) - 1);
+        test_string_to_double_as_strtod(buff);
+        // slightly above the halfway value
+        buff[len] = '1';
+        buff[len + 1] = '\0';
+        test_string_to_double_as_strtod(buff);
+    }
+}
+#        endif // LDBL_MANT_DIG >= 64
+#    else  // ANJ_WITH_EXACT_STRING_TO_DOUBLE
+// conversion used before ANJ_WITH_EXACT_STRING_TO_DOUBLE was introduced, the
+// default one must keep returning exactly the same results
+static double legacy_string_to_double(const char *buff, size_t buff_len) {
+    for (size_t i = 0; i < buff_len; i++) {
+        if (buff[i] == 'e' || buff[i] == 'E') {
+            return legacy_string_to_double(buff, i)
+                   * pow(10, strtod(&buff[i + 1], NULL));
+        }
+    }
+    bool is_negative = buff[0] == '-';
+    if (is_negative) {
+        buff++;
+        buff_len--;
+    }
+    bool is_fractional_part = memchr(buff, '.', buff_len) != NULL;
+    double fractional_value = 0;
+    double fractional_divider = 1.0;
+    double integer_value = 0;
+    double multiplicator = 1.0;
+    for (size_t i = buff_len; i > 0; i--) {
+        if (buff[i - 1] == '.') {
+            is_fractional_part = false;
+            multiplicator = 1;
+        } else {
+            uint8_t single_value = (uint8_t) buff[i - 1] - '0';
+            if (is_fractional_part) {
+                fractional_value += single_value * multiplicator;
+                fractional_divider *= 10;
+            } else {
+                integer_value += single_value * multiplicator;
+            }
+            multiplicator = multiplicator * 10;
+        }
+    }
+    double value = integer_value;
+    if (fractional_value > 0.0) {
+        value += fractional_value / fractional_divider;
+    }
+    return is_negative ? -value : value;
+}
+
+ANJ_UNIT_TEST(utils, str_to_double_compare_legacy) {
+    uint64_t state = 0x853C49E6748FEA9B;
+    for (size_t i = 0; i < 200000; i++) {
+        char buff[64];
+        random_decimal(buff, &state);
+        double parsed;
+        ANJ_UNIT_ASSERT_SUCCESS(
+                anj_string_to_double_value(&parsed, buff, strlen(buff)));
+        double expected = legacy_string_to_double(buff, strlen(buff));
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(&parsed, &expected, sizeof(double));
+    }
+}
+#    endif     // ANJ_WITH_EXACT_STRING_TO_DOUBLE
+#endif         // ANJ_WITH_CUSTOM_CONVERSION_FUNCTIONS
+
 static void
 test_string_to_double(const char *buff, double expected, bool failed) {
     double value;
@@ -113,6 +376,12 @@ ANJ_UNIT_TEST(utils, str_to_double_custom) {
     test_string_to_double("1234ee10", 0, true);
     test_string_to_double("e", 0, true);
     test_string_to_double("20dd.4", 0, true);
+    test_string_to_double("", 0, true);
+    test_string_to_double("-", 0, true);
+    test_string_to_double(".", 0, true);
+    test_string_to_double("1.2.3", 0, true);
+    test_string_to_double("+1", 0, true);
+    test_string_to_double("12345678.12345678x", 0, true);
 }
 
 static void
@@ -147,6 +416,15 @@ ANJ_UNIT_TEST(utils, string_to_uint64) {
     test_string_to_uint64("-1", 0, true);
     test_string_to_uint64("255b", 0, true);
     test_string_to_uint64("123b5", 0, true);
+    test_string_to_uint64("12345678", 12345678, false);
+    test_string_to_uint64("123456789", 123456789, false);
+    test_string_to_uint64("1234567890123456789", 1234567890123456789, false);
+    test_string_to_uint64("00000000000000000001", 1, false);
+    test_string_to_uint64("30000000000000000000", 0, true);
+    test_string_to_uint64("1234567:", 0, true);
+    test_string_to_uint64("/1234567", 0, true);
+    test_string_to_uint64("12345678/", 0, true);
+    test_string_to_uint64("1234567812345678:", 0, true);
 }
 
 static void
@@ -307,3 +585,33 @@ ANJ_UNIT_TEST(utils, int64_to_string) {
     test_int64_to_string(INT64_MAX, "9223372036854775807");
     test_int64_to_string(INT64_MIN, "-9223372036854775808");
 }
+
+ANJ_UNIT_TEST(utils, rand_xoshiro128) {
+    // reference output of xoshiro128** for state { 1, 2, 3, 4 }
+    _anj_rand_seed_t seed = {
+        .s = { 1, 2, 3, 4 }
+    };
+    ANJ_UNIT_ASSERT_EQUAL(_anj_rand32_r(&seed), 11520);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_rand32_r(&seed), 0);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_rand32_r(&seed), 5927040);
+    ANJ_UNIT_ASSERT_EQUAL(_anj_rand32_r(&seed), 70819200);
+
+    // the same seed gives the same sequence, different seeds don't, and seed 0
+    // doesn't produce the all-zero state
+    _anj_rand_seed_t seed_a;
+    _anj_rand_seed_t seed_b;
+    _anj_rand_seed_t seed_c;
+    _anj_rand_seed(&seed_a, 0);
+    _anj_rand_seed(&seed_b, 0);
+    _anj_rand_seed(&seed_c, 1);
+    ANJ_UNIT_ASSERT_TRUE(seed_a.s[0] | seed_a.s[1] | seed_a.s[2] | seed_a.s[3]);
+    size_t differences = 0;
+    for (int i = 0; i < 100; i++) {
+        uint64_t value = _anj_rand64_r(&seed_a);
+        ANJ_UNIT_ASSERT_EQUAL(value, _anj_rand64_r(&seed_b));
+        if (value != _anj_rand64_r(&seed_c)) {
+            differences++;
+        }
+    }
+    ANJ_UNIT_ASSERT_EQUAL(differences, 100);
+}
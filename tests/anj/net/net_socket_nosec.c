@@ -12,6 +12,7 @@
 #endif
 
 #include <arpa/inet.h>
+#include <errno.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <stdint.h>
@@ -1366,3 +1367,336 @@ ANJ_UNIT_TEST(udp_socket, op_on_already_closed_socket) {
     shutdown(sockfd, SHUT_RDWR);
     close(sockfd);
 }
+
+#ifdef ANJ_NET_WITH_BATCHED_IO
+#    ifdef NET_TESTS_WITHOUT_MMSG
+// Test binary is linked with --wrap=recvmmsg,--wrap=sendmmsg, to check the
+// fallback used when the system calls are not available at runtime.
+// Arguments are not used, so there is no need for _GNU_SOURCE declarations.
+int __wrap_recvmmsg(int sockfd,
+                    void *msgvec,
+                    unsigned int vlen,
+                    int flags,
+                    void *timeout);
+int __wrap_sendmmsg(int sockfd, void *msgvec, unsigned int vlen, int flags);
+
+static size_t g_mmsg_calls;
+
+int __wrap_recvmmsg(int sockfd,
+                    void *msgvec,
+                    unsigned int vlen,
+                    int flags,
+                    void *timeout) {
+    (void) sockfd;
+    (void) msgvec;
+    (void) vlen;
+    (void) flags;
+    (void) timeout;
+    g_mmsg_calls++;
+    errno = ENOSYS;
+    return -1;
+}
+
+int __wrap_sendmmsg(int sockfd, void *msgvec, unsigned int vlen, int flags) {
+    (void) sockfd;
+    (void) msgvec;
+    (void) vlen;
+    (void) flags;
+    g_mmsg_calls++;
+    errno = ENOSYS;
+    return -1;
+}
+#    endif // NET_TESTS_WITHOUT_MMSG
+
+// Upper bound of the number of datagrams handled with a single call, the same
+// as in the POSIX socket implementation
+#    define MAX_BATCH_SIZE 16
+
+// Returns server side socket, connected to the client one
+static int setup_udp_batch_test(anj_net_ctx_t **ctx) {
+    size_t bytes_sent = 0;
+    anj_net_socket_configuration_t sock_config = {
+        .af_setting = ANJ_NET_AF_SETTING_FORCE_INET4
+    };
+    anj_net_config_t config = {
+        .raw_socket_config = sock_config
+    };
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_create_ctx(ctx, &config), ANJ_NET_OK);
+    int sockfd = test_default_udp_connection(*ctx, AF_INET);
+
+    // server learns the client address from the first datagram
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_send(*ctx, &bytes_sent,
+                                       (const uint8_t *) "hello", 5),
+                          ANJ_NET_OK);
+    uint8_t buf[100];
+    struct sockaddr_in client_addr;
+    socklen_t client_addr_len = sizeof(client_addr);
+    ANJ_UNIT_ASSERT_EQUAL(recvfrom(sockfd, buf, sizeof(buf), 0,
+                                   (struct sockaddr *) &client_addr,
+                                   &client_addr_len),
+                          5);
+    ANJ_UNIT_ASSERT_NOT_EQUAL(connect(sockfd, (struct sockaddr *) &client_addr,
+                                      client_addr_len),
+                              -1);
+    return sockfd;
+}
+
+static void teardown_udp_batch_test(anj_net_ctx_t **ctx, int sockfd) {
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_cleanup_ctx(ctx), ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_NULL(*ctx);
+    shutdown(sockfd, SHUT_RDWR);
+    close(sockfd);
+}
+
+ANJ_UNIT_TEST(udp_socket, recv_batch) {
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "first", 5, 0), 5);
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "second", 6, 0), 6);
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "third", 5, 0), 5);
+
+    uint8_t bufs[4][10];
+    anj_net_datagram_t datagrams[4];
+    for (size_t i = 0; i < 4; i++) {
+        datagrams[i] = (anj_net_datagram_t) {
+            .buf = bufs[i],
+            .length = sizeof(bufs[i])
+        };
+    }
+    size_t count = 0;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams, 4,
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 3);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[0].bytes_received, 5);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(bufs[0], "first", 5);
+    ANJ_UNIT_ASSERT_FALSE(datagrams[0].truncated);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[1].bytes_received, 6);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(bufs[1], "second", 6);
+    ANJ_UNIT_ASSERT_FALSE(datagrams[1].truncated);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[2].bytes_received, 5);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(bufs[2], "third", 5);
+    ANJ_UNIT_ASSERT_FALSE(datagrams[2].truncated);
+
+    uint64_t value;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_get_bytes_received(udp_sock_ctx, &value),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(value, 16);
+
+    // nothing more to read
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams, 4,
+                                             &count),
+                          ANJ_NET_EAGAIN);
+    ANJ_UNIT_ASSERT_EQUAL(count, 0);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+
+ANJ_UNIT_TEST(udp_socket, recv_batch_partial) {
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+
+    for (uint8_t i = 0; i < 3; i++) {
+        ANJ_UNIT_ASSERT_EQUAL(send(sockfd, &i, 1, 0), 1);
+    }
+
+    uint8_t bufs[2][10];
+    anj_net_datagram_t datagrams[2];
+    for (size_t i = 0; i < 2; i++) {
+        datagrams[i] = (anj_net_datagram_t) {
+            .buf = bufs[i],
+            .length = sizeof(bufs[i])
+        };
+    }
+    // batch is filled up, remaining datagram is left for the next call
+    size_t count = 0;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams, 2,
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 2);
+    ANJ_UNIT_ASSERT_EQUAL(bufs[0][0], 0);
+    ANJ_UNIT_ASSERT_EQUAL(bufs[1][0], 1);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams, 2,
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[0].bytes_received, 1);
+    ANJ_UNIT_ASSERT_EQUAL(bufs[0][0], 2);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+
+ANJ_UNIT_TEST(udp_socket, recv_batch_limited) {
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+
+    for (uint8_t i = 0; i < MAX_BATCH_SIZE + 2; i++) {
+        ANJ_UNIT_ASSERT_EQUAL(send(sockfd, &i, 1, 0), 1);
+    }
+
+    uint8_t bufs[MAX_BATCH_SIZE + 4][4];
+    anj_net_datagram_t datagrams[MAX_BATCH_SIZE + 4];
+    for (size_t i = 0; i < MAX_BATCH_SIZE + 4; i++) {
+        datagrams[i] = (anj_net_datagram_t) {
+            .buf = bufs[i],
+            .length = sizeof(bufs[i])
+        };
+    }
+    // single call never handles more than MAX_BATCH_SIZE datagrams
+    size_t count = 0;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams,
+                                             MAX_BATCH_SIZE + 4, &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, MAX_BATCH_SIZE);
+    for (uint8_t i = 0; i < MAX_BATCH_SIZE; i++) {
+        ANJ_UNIT_ASSERT_EQUAL(bufs[i][0], i);
+    }
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams,
+                                             MAX_BATCH_SIZE + 4, &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 2);
+    ANJ_UNIT_ASSERT_EQUAL(bufs[0][0], MAX_BATCH_SIZE);
+    ANJ_UNIT_ASSERT_EQUAL(bufs[1][0], MAX_BATCH_SIZE + 1);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+
+ANJ_UNIT_TEST(udp_socket, recv_batch_truncated) {
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "world!", 6, 0), 6);
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "Have a nice day.", 16, 0), 16);
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "bye", 3, 0), 3);
+
+    uint8_t bufs[3][10];
+    anj_net_datagram_t datagrams[3];
+    for (size_t i = 0; i < 3; i++) {
+        datagrams[i] = (anj_net_datagram_t) {
+            .buf = bufs[i],
+            .length = sizeof(bufs[i])
+        };
+    }
+    // truncated datagram doesn't stop the batch
+    size_t count = 0;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, datagrams, 3,
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 3);
+    ANJ_UNIT_ASSERT_FALSE(datagrams[0].truncated);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[0].bytes_received, 6);
+    ANJ_UNIT_ASSERT_TRUE(datagrams[1].truncated);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[1].bytes_received, 10);
+    ANJ_UNIT_ASSERT_FALSE(datagrams[2].truncated);
+    ANJ_UNIT_ASSERT_EQUAL(datagrams[2].bytes_received, 3);
+    ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(bufs[2], "bye", 3);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+
+ANJ_UNIT_TEST(udp_socket, send_batch) {
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+
+    anj_net_datagram_t datagrams[] = {
+        {
+            .buf = (uint8_t *) (uintptr_t) "first",
+            .length = 5
+        },
+        {
+            .buf = (uint8_t *) (uintptr_t) "second",
+            .length = 6
+        },
+        {
+            .buf = (uint8_t *) (uintptr_t) "third",
+            .length = 5
+        }
+    };
+    size_t count = 0;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_send_batch(udp_sock_ctx, datagrams,
+                                             ANJ_ARRAY_SIZE(datagrams),
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 3);
+
+    // datagrams are delivered separately and in order
+    uint8_t buf[100];
+    for (size_t i = 0; i < ANJ_ARRAY_SIZE(datagrams); i++) {
+        ANJ_UNIT_ASSERT_EQUAL(recv(sockfd, buf, sizeof(buf), 0),
+                              datagrams[i].length);
+        ANJ_UNIT_ASSERT_EQUAL_BYTES_SIZED(buf, datagrams[i].buf,
+                                          datagrams[i].length);
+    }
+
+    // the first datagram was sent in setup_udp_batch_test()
+    uint64_t value;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_get_bytes_sent(udp_sock_ctx, &value),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(value, 21);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+
+ANJ_UNIT_TEST(udp_socket, batch_invalid_args) {
+    uint8_t buf[10];
+    anj_net_datagram_t datagram = {
+        .buf = buf,
+        .length = sizeof(buf)
+    };
+    size_t count = 0;
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(NULL, &datagram, 1, &count),
+                          ANJ_NET_EBADFD);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_send_batch(NULL, &datagram, 1, &count),
+                          ANJ_NET_EBADFD);
+
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, &datagram, 0,
+                                             &count),
+                          ANJ_NET_EINVAL);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_send_batch(udp_sock_ctx, NULL, 1, &count),
+                          ANJ_NET_EINVAL);
+
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_shutdown(udp_sock_ctx), ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_close(udp_sock_ctx), ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, &datagram, 1,
+                                             &count),
+                          ANJ_NET_EBADFD);
+    ANJ_UNIT_ASSERT_EQUAL(count, 0);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_send_batch(udp_sock_ctx, &datagram, 1,
+                                             &count),
+                          ANJ_NET_EBADFD);
+    ANJ_UNIT_ASSERT_EQUAL(count, 0);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+
+#    ifdef NET_TESTS_WITHOUT_MMSG
+ANJ_UNIT_TEST(udp_socket, batch_fallback_used) {
+    anj_net_ctx_t *udp_sock_ctx = NULL;
+    int sockfd = setup_udp_batch_test(&udp_sock_ctx);
+
+    uint8_t buf[10];
+    anj_net_datagram_t datagram = {
+        .buf = buf,
+        .length = sizeof(buf)
+    };
+    size_t count = 0;
+    g_mmsg_calls = 0;
+    ANJ_UNIT_ASSERT_EQUAL(send(sockfd, "hello", 5, 0), 5);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_recv_batch(udp_sock_ctx, &datagram, 1,
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_mmsg_calls, 1);
+    ANJ_UNIT_ASSERT_EQUAL(anj_udp_send_batch(udp_sock_ctx, &datagram, 1,
+                                             &count),
+                          ANJ_NET_OK);
+    ANJ_UNIT_ASSERT_EQUAL(count, 1);
+    ANJ_UNIT_ASSERT_EQUAL(g_mmsg_calls, 2);
+
+    teardown_udp_batch_test(&udp_sock_ctx, sockfd);
+}
+#    endif // NET_TESTS_WITHOUT_MMSG
+#endif     // ANJ_NET_WITH_BATCHED_IO
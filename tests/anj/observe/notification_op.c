@@ -35,6 +35,7 @@ static uint64_t mock_time_value = 0;
 static double get_res_value_double = 0;
 static bool get_res_value_bool = 0;
 static int res_read_ret_val = 0;
+static int res_read_counter = 0;
 
 static int res_read(anj_t *anj,
                     const anj_dm_obj_t *obj,
@@ -47,6 +48,7 @@ static int res_read(anj_t *anj,
     (void) iid;
     (void) riid;
 
+    res_read_counter++;
     if (rid == 0) {
         out_value->bool_value = get_res_value_bool;
     } else {
@@ -286,8 +288,8 @@ static void setup_observations(_anj_observe_ctx_t *ctx,
             ctx->observations[i].last_sent_value.double_value =
                     get_res_value_double;
         }
-#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
         ctx->observations[i].accept_opt = _ANJ_COAP_FORMAT_NOT_DEFINED;
+#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
         ctx->observations[i].content_format_opt = _ANJ_COAP_FORMAT_NOT_DEFINED;
 #    endif // ANJ_WITH_OBSERVE_COMPOSITE
     }
@@ -368,6 +370,120 @@ ANJ_UNIT_TEST(notification_op, notification_change) {
     anj_process(77000, 0, 0);
 }
 
+ANJ_UNIT_TEST(notification_op, notification_schedule) {
+    NOTIFICATION_INIT();
+    INIT_OBSERVE_MODULE();
+    anj_uri_path_t paths[] = { ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+                               ANJ_MAKE_RESOURCE_PATH(3, 0, 0) };
+    _anj_attr_notification_t effective_attributes = {
+        .has_min_period = true,
+        .min_period = 5
+    };
+
+    setup_observations(&anj.observe_ctx, paths, ANJ_ARRAY_SIZE(paths),
+                       &effective_attributes);
+
+    anj_process(77000, 0, 0);
+    ASSERT_TRUE(anj.observe_ctx.schedule.valid);
+
+    // value change only brings the deadline forward, no rescan is needed
+    add_to_mock_time(1000);
+    ASSERT_OK(anj_observe_data_model_changed(
+            &anj, &ANJ_MAKE_RESOURCE_PATH(3, 0, 0),
+            ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED, 0));
+    ASSERT_TRUE(anj.observe_ctx.schedule.valid);
+    anj_process(4000, 0, 0);
+
+    add_to_mock_time(4000);
+    anj_process(0, 0x22, 1);
+    anj_exchange(false);
+    check_out_buff(false, 0x22, 1, _ANJ_COAP_FORMAT_SENML_CBOR);
+    ASSERT_FALSE(anj.observe_ctx.schedule.valid);
+
+    // first observation has pmax deadline at 77 s
+    anj_process(72000, 0, 0);
+
+    // change of the server defaults must be taken into account
+    srv.default_max_period = 30;
+    anj_process(25000, 0, 0);
+
+    // time going backwards forces sending notification immediately
+    set_mock_time(1000);
+    anj_process(0, 0x22, 1);
+}
+
+ANJ_UNIT_TEST(notification_op, notification_change_path_index) {
+    NOTIFICATION_INIT();
+    INIT_OBSERVE_MODULE();
+    anj_uri_path_t paths[] = { ANJ_MAKE_RESOURCE_PATH(3, 1, 1),
+                               ANJ_MAKE_RESOURCE_PATH(3, 0, 2),
+                               ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+                               ANJ_MAKE_OBJECT_PATH(3),
+                               ANJ_MAKE_INSTANCE_PATH(3, 0) };
+    _anj_attr_notification_t effective_attributes = { 0 };
+
+    setup_observations(&anj.observe_ctx, paths, ANJ_ARRAY_SIZE(paths),
+                       &effective_attributes);
+
+    ASSERT_OK(anj_observe_data_model_changed(
+            &anj, &ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+            ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED, 0));
+    ASSERT_FALSE(anj.observe_ctx.observations[0].notification_to_send);
+    ASSERT_FALSE(anj.observe_ctx.observations[1].notification_to_send);
+    ASSERT_TRUE(anj.observe_ctx.observations[2].notification_to_send);
+    ASSERT_TRUE(anj.observe_ctx.observations[3].notification_to_send);
+    ASSERT_TRUE(anj.observe_ctx.observations[4].notification_to_send);
+
+    ASSERT_OK(anj_observe_data_model_changed(
+            &anj, &ANJ_MAKE_INSTANCE_PATH(3, 1),
+            ANJ_OBSERVE_CHANGE_TYPE_DELETED, 0));
+    ASSERT_EQ(anj.observe_ctx.observations[0].ssid, 0);
+    ASSERT_EQ(anj.observe_ctx.observations[1].ssid, 1);
+    ASSERT_EQ(anj.observe_ctx.observations[3].ssid, 1);
+
+    ASSERT_OK(anj_observe_data_model_changed(
+            &anj, &ANJ_MAKE_RESOURCE_PATH(3, 0, 2),
+            ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED, 0));
+    ASSERT_TRUE(anj.observe_ctx.observations[1].notification_to_send);
+}
+
+ANJ_UNIT_TEST(notification_op, notification_change_batch) {
+    NOTIFICATION_INIT();
+    INIT_OBSERVE_MODULE();
+    anj_uri_path_t paths[] = { ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+                               ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+                               ANJ_MAKE_INSTANCE_PATH(3, 0),
+                               ANJ_MAKE_RESOURCE_PATH(3, 0, 0) };
+    _anj_attr_notification_t effective_attributes = { 0 };
+
+    setup_observations(&anj.observe_ctx, paths, ANJ_ARRAY_SIZE(paths),
+                       &effective_attributes);
+    anj.observe_ctx.observations[0].effective_attr =
+            (_anj_attr_notification_t) {
+                .has_greater_than = true,
+                .greater_than = 10
+            };
+    anj.observe_ctx.observations[1].effective_attr =
+            (_anj_attr_notification_t) {
+                .has_step = true,
+                .step = 50
+            };
+
+    set_res_value_double(20.0);
+    res_read_counter = 0;
+    anj_uri_path_t changed[] = { ANJ_MAKE_RESOURCE_PATH(3, 0, 1),
+                                 ANJ_MAKE_RESOURCE_PATH(3, 0, 0) };
+    ASSERT_OK(anj_observe_data_model_changed_batch(
+            &anj, changed, ANJ_ARRAY_SIZE(changed),
+            ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED, 0));
+    // both observations of /3/0/1 share a single read
+    ASSERT_EQ(res_read_counter, 1);
+    ASSERT_TRUE(anj.observe_ctx.observations[0].notification_to_send);
+    ASSERT_FALSE(anj.observe_ctx.observations[1].notification_to_send);
+    ASSERT_TRUE(anj.observe_ctx.observations[2].notification_to_send);
+    ASSERT_TRUE(anj.observe_ctx.observations[3].notification_to_send);
+}
+
 ANJ_UNIT_TEST(notification_op, notification_change_gt) {
     NOTIFICATION_INIT();
     INIT_OBSERVE_MODULE();
@@ -1059,6 +1175,86 @@ ANJ_UNIT_TEST(notification_op, notification_change_added_resource_instance) {
     anj_process(ANJ_TIME_UNDEFINED, 0, 0);
 }
 
+#    ifdef ANJ_WITH_TLV
+ANJ_UNIT_TEST(notification_op, notification_tlv_instance_with_multiple_res) {
+    NOTIFICATION_INIT();
+    INIT_OBSERVE_MODULE();
+    inst_0.res_count = 6;
+
+    _anj_coap_msg_t request = {
+        .operation = ANJ_OP_INF_OBSERVE,
+        .uri = ANJ_MAKE_INSTANCE_PATH(3, 0),
+        .accept = _ANJ_COAP_FORMAT_OMA_LWM2M_TLV,
+    };
+    request.coap_binding_data.udp.message_id = 0x1111;
+    request.token.size = 1;
+    request.token.bytes[0] = 0x21;
+    uint8_t response_code;
+    ASSERT_OK(_anj_observe_new_request(&anj, &out_handlers, &srv, &request,
+                                       &response_code));
+    ASSERT_EQ(anj.observe_ctx.observations[0].accept_opt,
+              _ANJ_COAP_FORMAT_OMA_LWM2M_TLV);
+    ASSERT_EQ(_anj_exchange_new_server_request(&exchange_ctx, response_code,
+                                               &request, &out_handlers,
+                                               payload, payload_buff_size),
+              ANJ_EXCHANGE_STATE_MSG_TO_SEND);
+    ASSERT_OK(_anj_coap_encode_udp(&request, out_buff, out_buff_size,
+                                   &out_msg_size));
+    uint8_t EXPECTED_RESPONSE[] =
+            "\x61" /* Ver = 1, Type = 2 (ACK), TKL = 1 */
+            "\x45\x11\x11\x21"
+            "\x60"         /* observe = 0 */
+            "\x62\x2D\x16" /* content format = 11542 */
+            "\xFF"
+            "\xC1\x00\x00"             /* /3/0/0 */
+            "\xC4\x01\x00\x00\x00\x00" /* /3/0/1 */
+            "\xC4\x02\x00\x00\x00\x00" /* /3/0/2 */
+            "\xC4\x03\x00\x00\x00\x00" /* /3/0/3 */
+            "\xC4\x04\x00\x00\x00\x00" /* /3/0/4 */
+            "\x88\x06\x0B"             /* /3/0/6, 11 bytes */
+            "\x48\x01\x08"             /* /3/0/6/1, 8 bytes */
+            "\x00\x00\x00\x00\x00\x00\x00\x00";
+    ASSERT_EQ_BYTES_SIZED(out_buff, EXPECTED_RESPONSE,
+                          sizeof(EXPECTED_RESPONSE) - 1);
+    ASSERT_EQ(out_msg_size, sizeof(EXPECTED_RESPONSE) - 1);
+    ASSERT_EQ(_anj_exchange_process(&exchange_ctx,
+                                    ANJ_EXCHANGE_EVENT_SEND_CONFIRMATION,
+                                    &request),
+              ANJ_EXCHANGE_STATE_FINISHED);
+
+    set_res_value_double(0.5);
+    ASSERT_OK(anj_observe_data_model_changed(
+            &anj, &ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 0, 6, 1),
+            ANJ_OBSERVE_CHANGE_TYPE_VALUE_CHANGED, 0));
+
+    anj_process(0, 0x21, 1);
+    anj_exchange(false);
+    uint8_t EXPECTED_NOTIFICATION[] =
+            "\x51" /* Ver = 1, Type = 1 (Non-con), TKL = 1 */
+            "\x45\x00\x00\x21"
+            "\x61\x01"     /* observe = 1 */
+            "\x62\x2D\x16" /* content format = 11542 */
+            "\xFF"
+            "\xC1\x00\x00"             /* /3/0/0 */
+            "\xC4\x01\x3F\x00\x00\x00" /* /3/0/1 */
+            "\xC4\x02\x3F\x00\x00\x00" /* /3/0/2 */
+            "\xC4\x03\x3F\x00\x00\x00" /* /3/0/3 */
+            "\xC4\x04\x3F\x00\x00\x00" /* /3/0/4 */
+            "\x88\x06\x0B"             /* /3/0/6, 11 bytes */
+            "\x48\x01\x08"             /* /3/0/6/1, 8 bytes */
+            "\x3F\xE0\x00\x00\x00\x00\x00\x00";
+    EXPECTED_NOTIFICATION[2] = message_id >> 8;
+    EXPECTED_NOTIFICATION[3] = message_id & 0x00FF;
+    ASSERT_EQ_BYTES_SIZED(out_buff, EXPECTED_NOTIFICATION,
+                          sizeof(EXPECTED_NOTIFICATION) - 1);
+    ASSERT_EQ(out_msg_size, sizeof(EXPECTED_NOTIFICATION) - 1);
+    memset(&out_msg, 0, sizeof(out_msg));
+    message_id++;
+
+    anj_process(77000, 0, 0);
+}
+#    endif // ANJ_WITH_TLV
+
 ANJ_UNIT_TEST(notification_op, notification_change_deleted) {
     NOTIFICATION_INIT();
     INIT_OBSERVE_MODULE();
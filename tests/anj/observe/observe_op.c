@@ -198,9 +198,9 @@ void compare_observations(_anj_observe_ctx_t *ctx1, _anj_observe_ctx_t *ctx2) {
                   (size_t) ctx2->observations[i].prev);
         ASSERT_EQ(ctx1->observations[i].content_format_opt,
                   ctx2->observations[i].content_format_opt);
+#    endif // ANJ_WITH_OBSERVE_COMPOSITE
         ASSERT_EQ(ctx1->observations[i].accept_opt,
                   ctx2->observations[i].accept_opt);
-#    endif // ANJ_WITH_OBSERVE_COMPOSITE
     }
 }
 
@@ -306,10 +306,8 @@ ANJ_UNIT_TEST(observe_op, observe_basic) {
     ASSERT_EQ(anj.observe_ctx.observations[0].ssid, 1);
     ASSERT_EQ(anj.observe_ctx.observations[0].token.size, 1);
     ASSERT_EQ(anj.observe_ctx.observations[0].token.bytes[0], 0x22);
-#    ifdef ANJ_WITH_OBSERVE_COMPOSITE
     ASSERT_EQ(anj.observe_ctx.observations[0].accept_opt,
               _ANJ_COAP_FORMAT_NOT_DEFINED);
-#    endif // ANJ_WITH_OBSERVE_COMPOSITE
     ASSERT_EQ(anj.observe_ctx.observations[1].ssid, 0);
     ASSERT_EQ(anj.observe_ctx.observations[2].ssid, 0);
     ASSERT_EQ(anj.observe_ctx.observations[3].ssid, 0);
@@ -682,8 +680,8 @@ ANJ_UNIT_TEST(observe_op, observe_check_timestamps) {
         .has_max_period = true,
         .max_period = 22,
     };
-#        ifdef ANJ_WITH_OBSERVE_COMPOSITE
     ctx_ref.observations[0].accept_opt = _ANJ_COAP_FORMAT_NOT_DEFINED;
+#        ifdef ANJ_WITH_OBSERVE_COMPOSITE
     ctx_ref.observations[0].content_format_opt = _ANJ_COAP_FORMAT_NOT_DEFINED;
 #        endif // ANJ_WITH_OBSERVE_COMPOSITE
     OBSERVE_OP_WITH_ATTR_TEST(ANJ_MAKE_RESOURCE_PATH(3, 1, 1), observe_attr, 0,
@@ -753,6 +751,7 @@ ANJ_UNIT_TEST(observe_op, observe_block) {
         .operation = ANJ_OP_INF_OBSERVE,
         .uri = ANJ_MAKE_INSTANCE_PATH(3, 1),
         .payload_size = 0,
+        .accept = _ANJ_COAP_FORMAT_NOT_DEFINED,
     };
     inout_msg.coap_binding_data.udp.message_id = 0x1111;
     inout_msg.token.size = 1;
@@ -984,6 +983,7 @@ ANJ_UNIT_TEST(observe_op, observe_cancel) {
             ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 1, 8, 1);
     anj.observe_ctx.observations[1].token.size = 1;
     anj.observe_ctx.observations[1].token.bytes[0] = 0x22;
+    anj.observe_ctx.observations[1].accept_opt = _ANJ_COAP_FORMAT_NOT_DEFINED;
     anj.observe_ctx.observations[2].ssid = 1;
     anj.observe_ctx.observations[3].ssid = 1;
     CANCEL_OBSERVE_OP_TEST(ANJ_MAKE_RESOURCE_INSTANCE_PATH(3, 1, 8, 1), 0,